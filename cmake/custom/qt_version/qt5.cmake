@@ -104,6 +104,13 @@ if (ENABLE_OPENGL)
     endif()
 endif (ENABLE_OPENGL)
 
+if (ENABLE_QUICK_VIDEO AND ENABLE_OPENGL)
+    add_definitions(-DQUICK_VIDEO_ENABLE)
+
+    find_package(Qt5Quick         REQUIRED)
+    list(APPEND QT_DEPEND_LIBS Qt5::Quick)
+endif (ENABLE_QUICK_VIDEO AND ENABLE_OPENGL)
+
 if (ENABLE_AUTO_Linguist)
     find_package(Qt5LinguistTools REQUIRED)
 
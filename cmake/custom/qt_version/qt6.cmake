@@ -110,6 +110,16 @@ if (ENABLE_OPENGL)
     endif()
 endif (ENABLE_OPENGL)
 
+if (ENABLE_QUICK_VIDEO AND ENABLE_OPENGL)
+    add_definitions(-DQUICK_VIDEO_ENABLE)
+
+    # 着色器经qt6_add_shaders编译为qsb（见CMakeLists.txt）
+    find_package(Qt6 6.6 COMPONENTS Quick ShaderTools REQUIRED)
+    list(APPEND QT_DEPEND_LIBS
+        Qt6::Quick
+    )
+endif (ENABLE_QUICK_VIDEO AND ENABLE_OPENGL)
+
 if (ENABLE_AUTO_Linguist)
     find_package(Qt6 COMPONENTS LinguistTools REQUIRED)
 
@@ -16,10 +16,17 @@ option(ENABLE_AUTO_Linguist "automatically manage translation updates" OFF)
 
 # 启用播放器模块
 option(ENABLE_MEDIA_PLAYER "using video streaming playback module" ON)
+if (ENABLE_MEDIA_PLAYER)
+    # QtQuick视频项（依赖ENABLE_OPENGL；Qt6需要6.6及以上与ShaderTools）
+    option(ENABLE_QUICK_VIDEO "using QtQuick scene graph video item" OFF)
+endif (ENABLE_MEDIA_PLAYER)
 
 # 启用地图组件模块
 option(ENABLE_MAP_COMPONENT "using map component" ON)
 if (ENABLE_MAP_COMPONENT)
     option(USE_WEB_LEAFLET "using leaflet to show mapview" OFF)
     # option(USE_QML_LOCATION "using qtlocation to show mapview" ON)
-endif (ENABLE_MAP_COMPONENT)
\ No newline at end of file
+endif (ENABLE_MAP_COMPONENT)
+
+# 构建离线工具（frame_extract、soak_runner等，依赖播放器模块的FFmpeg）
+option(BUILD_MEDIA_TOOLS "build offline media tools such as frame_extract and soak_runner" OFF)
@@ -0,0 +1,35 @@
+# 离线工具（独立可执行程序，不打包进主程序）
+if (ENABLE_MEDIA_PLAYER AND BUILD_MEDIA_TOOLS AND NOT ANDROID)
+    # 离线抽帧：复用播放器的解码器初始化流程
+    add_executable(frame_extract
+        ${SOURCE_CODE_DIR}/tools/frame_extract/main.cpp
+        ${SOURCE_CODE_DIR}/tools/frame_extract/frame_extractor.cpp
+        ${SOURCE_CODE_DIR}/view/widget/player/ffmpeg_decode_helper.cpp
+    )
+    target_link_libraries(frame_extract PRIVATE
+        Qt${QT_VERSION}::Core
+        Qt${QT_VERSION}::Gui
+        ${THIRD_DEPEND_LIBS}
+    )
+
+    # 多路播放浸泡测试：驱动完整播放器组件，需要与主程序相同的Qt模块
+    set(SOAK_RUNNER_SRCS
+        ${SOURCE_CODE_DIR}/tools/soak_runner/main.cpp
+        ${SOURCE_CODE_DIR}/tools/soak_runner/soak_runner.cpp
+        ${PLAYER_SRCS}
+    )
+    if (ENABLE_OPENGL)
+        list(APPEND SOAK_RUNNER_SRCS
+            ${SOURCE_CODE_DIR}/view/widget/opengl/opengl_video_widget.cpp
+            ${SOURCE_CODE_DIR}/view/widget/opengl/video_upload_thread.cpp
+            ${SOURCE_CODE_DIR}/view/widget/opengl/perf_hud.cpp
+            ${SOURCE_CODE_DIR}/view/widget/opengl/video_frame_renderer.cpp
+            ${SOURCE_CODE_DIR}/factory/opengl/program_cache.cpp
+        )
+    endif()
+    add_executable(soak_runner ${SOAK_RUNNER_SRCS})
+    target_link_libraries(soak_runner PRIVATE
+        ${QT_DEPEND_LIBS}
+        ${THIRD_DEPEND_LIBS}
+    )
+endif()
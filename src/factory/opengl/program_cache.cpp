@@ -0,0 +1,123 @@
+#include "program_cache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+
+QMutex SsProgramCache::s_mutex;
+QHash<QOpenGLContextGroup *, QHash<QByteArray, QOpenGLShaderProgram *>> SsProgramCache::s_programs;
+SsProgramCache::Stats SsProgramCache::s_stats;
+
+QOpenGLShaderProgram *SsProgramCache::program(const QByteArray &vertex, const QByteArray &fragment)
+{
+    const QByteArray key = sourceKey(vertex, fragment);
+
+    QOpenGLShaderProgram *shared = find(key);
+    if (shared)
+        return shared;
+
+    if (!QOpenGLContext::currentContext())
+    {
+        qWarning() << "[shader cache]: no current context";
+        return nullptr;
+    }
+
+    QOpenGLShaderProgram *created = new QOpenGLShaderProgram();
+    if (!linkCacheable(created, vertex, fragment))
+    {
+        delete created;
+        return nullptr;
+    }
+
+    insert(key, created);
+    return created;
+}
+
+QOpenGLShaderProgram *SsProgramCache::find(const QByteArray &key)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context)
+        return nullptr;
+
+    QMutexLocker locker(&s_mutex);
+    auto group = s_programs.constFind(context->shareGroup());
+    if (group == s_programs.constEnd())
+        return nullptr;
+
+    QOpenGLShaderProgram *program = group->value(key, nullptr);
+    if (program)
+        ++s_stats.hits;
+    return program;
+}
+
+void SsProgramCache::insert(const QByteArray &key, QOpenGLShaderProgram *program)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context || !program)
+        return;
+
+    QOpenGLContextGroup *group = context->shareGroup();
+
+    QMutexLocker locker(&s_mutex);
+    if (!s_programs.contains(group))
+    {
+        // 共享组随其最后一个上下文销毁，此时组内程序已失效
+        QObject::connect(group, &QObject::destroyed, [group]() { releaseGroup(group); });
+        ++s_stats.groups;
+    }
+
+    QHash<QByteArray, QOpenGLShaderProgram *> &programs = s_programs[group];
+    QOpenGLShaderProgram *old = programs.value(key, nullptr);
+    if (old && old != program)
+        delete old;
+    programs.insert(key, program);
+}
+
+bool SsProgramCache::linkCacheable(QOpenGLShaderProgram *program, const QByteArray &vertex, const QByteArray &fragment)
+{
+    // 可缓存着色器在link()时才编译：磁盘上有匹配（源码+驱动）的程序二进制时直接加载
+    if (!program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertex)
+        || !program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragment))
+    {
+        qWarning() << "[shader cache]: failed to add shader:" << program->log();
+        return false;
+    }
+
+    if (!program->link())
+    {
+        qWarning() << "[shader cache]: failed to link program:" << program->log();
+        return false;
+    }
+
+    QMutexLocker locker(&s_mutex);
+    ++s_stats.links;
+    return true;
+}
+
+QByteArray SsProgramCache::sourceKey(const QByteArray &vertex, const QByteArray &fragment)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(vertex);
+    // 分隔符避免"ab"+"c"与"a"+"bc"得到相同的键
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(fragment);
+    return hash.result();
+}
+
+SsProgramCache::Stats SsProgramCache::stats()
+{
+    QMutexLocker locker(&s_mutex);
+    return s_stats;
+}
+
+void SsProgramCache::releaseGroup(QOpenGLContextGroup *group)
+{
+    QHash<QByteArray, QOpenGLShaderProgram *> programs;
+    {
+        QMutexLocker locker(&s_mutex);
+        programs = s_programs.take(group);
+        --s_stats.groups;
+    }
+    qDeleteAll(programs);
+}
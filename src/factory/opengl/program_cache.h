@@ -0,0 +1,88 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+All rights reserved.
+File:        program_cache.h
+Version:     1.0
+Author:      cjx
+start date:  2026-10-19
+Description: 着色器程序缓存
+             - 进程内：链接好的程序按共享组（QOpenGLContextGroup）缓存，同组的所有上下文共用
+               同一个程序对象，共享组销毁时自动释放（同一顶层窗口内的QOpenGLWidget本就属于同一共享组；
+               不设置全局AA_ShareOpenGLContexts，核心模式与兼容模式的上下文在部分平台上无法共享）
+             - 磁盘：经QOpenGLShaderProgram的可缓存着色器链接，程序二进制（glGetProgramBinary）
+               按源码哈希存储，并校验GL厂商/渲染器/版本，驱动变化时自动重新编译；
+               首次运行之后不再编译着色器（驱动不支持程序二进制时退化为普通编译）
+    使用方式：
+        QOpenGLShaderProgram *program = SsProgramCache::program(vertexSource, fragmentSource);
+        program->bind();    // 程序由缓存持有，调用方不得delete
+
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifndef PROGRAM_CACHE_H_
+#define PROGRAM_CACHE_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+class QOpenGLContextGroup;
+class QOpenGLShaderProgram;
+
+class SsProgramCache
+{
+public:
+    /**
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        int hits = 0;       ///< 命中共享组内已链接的程序
+        int links = 0;      ///< 实际链接次数（含从磁盘二进制恢复）
+        int groups = 0;     ///< 当前存活的共享组数
+    };
+
+    /**
+     * @brief 获取当前上下文共享组内的程序，首次请求时链接
+     * @param vertex 顶点着色器源码
+     * @param fragment 片段着色器源码
+     * @return 程序（由缓存持有，共享组销毁时释放）；无当前上下文或链接失败时返回nullptr
+     */
+    static QOpenGLShaderProgram *program(const QByteArray &vertex, const QByteArray &fragment);
+
+    /**
+     * @brief 在当前上下文共享组内查找程序
+     * @param key 程序键（由调用方定义，如着色器文件路径）
+     */
+    static QOpenGLShaderProgram *find(const QByteArray &key);
+
+    /**
+     * @brief 把程序放入当前上下文共享组（接管所有权，共享组销毁时释放）
+     */
+    static void insert(const QByteArray &key, QOpenGLShaderProgram *program);
+
+    /**
+     * @brief 以可缓存方式添加顶点/片段着色器并链接
+     * 编译推迟到link()，命中磁盘二进制时跳过编译
+     * @return 是否链接成功
+     */
+    static bool linkCacheable(QOpenGLShaderProgram *program, const QByteArray &vertex, const QByteArray &fragment);
+
+    /** 源码键（顶点与片段源码的SHA-1） */
+    static QByteArray sourceKey(const QByteArray &vertex, const QByteArray &fragment);
+
+    static Stats stats();
+
+private:
+    /** 共享组销毁时释放其程序（组内资源已失效，析构不再调用GL） */
+    static void releaseGroup(QOpenGLContextGroup *group);
+
+    static QMutex s_mutex;
+    static QHash<QOpenGLContextGroup *, QHash<QByteArray, QOpenGLShaderProgram *>> s_programs;
+    static Stats s_stats;
+};
+
+#endif // PROGRAM_CACHE_H_
@@ -2,6 +2,7 @@
 
 #include <QOpenGLShader>
 #include <QFile>
+#include <QHash>
 #include <regex>
 
 // Qt6 兼容性处理
@@ -14,7 +15,8 @@ using RegexClass = QRegularExpression;
 #endif
 #include <QDebug>
 
-QMap<QString, SsSharderManager *> SsSharderManager::m_mapShader;
+#include "program_cache.h"
+#include "uniform_block.h"
 
 SsSharderManager::SsSharderManager()
 {
@@ -67,33 +69,41 @@ void SsSharderManager::loadShaderFromSourceCode(const QString &_vertex, const QS
     QString _vertex_code = pretreatment(_vertex);
     QString _fragment_code = pretreatment(_fragment);
 
-    if (!addShaderFromSourceCode(QOpenGLShader::Vertex, _vertex_code))
-    {
-        qDebug() << "Failed to add vertex shader";
-    }
-
-    if (!addShaderFromSourceCode(QOpenGLShader::Fragment, _fragment_code))
-    {
-        qDebug() << "Failed to add fragment shader";
-    }
-
     // 解析着色器
 
-    // 绑定数据块
-
-    if (!link())
+    // 可缓存方式链接：源码与驱动未变时直接加载磁盘上的程序二进制，不再编译
+    if (!SsProgramCache::linkCacheable(this, _vertex_code.toUtf8(), _fragment_code.toUtf8()))
     {
         qDebug() << "Failed to link shader program:" << log();
+        return;
     }
-    else
+    qDebug() << "Shader program linked successfully";
+
+    // 绑定数据块：场景公共块固定绑定点，每帧由场景统一上传一次
+    SsUniformBlocks::bindProgram(programId());
+}
+
+// 绑定Uniform块
+bool SsSharderManager::bindUniformBlock(const char *blockName, GLuint binding)
+{
+    if (!isLinked())
     {
-        qDebug() << "Shader program linked successfully";
+        return false;
     }
+    return SsUniformBlocks::bindProgramBlock(programId(), blockName, binding);
 }
 
 // 预处理
 QString SsSharderManager::pretreatment(const QString &text)
 {
+    // 正则替换开销较大，结果按原文缓存（同一着色器在多个共享组中加载时只处理一次）
+    static QHash<QString, QString> s_pretreated;
+    auto cached = s_pretreated.constFind(text);
+    if (cached != s_pretreated.constEnd())
+    {
+        return cached.value();
+    }
+
     // 移除多行注释
     QString result = text;
 
@@ -138,6 +148,7 @@ QString SsSharderManager::pretreatment(const QString &text)
     }
 #endif
 
+    s_pretreated.insert(text, result);
     return result;
 }
 
@@ -189,13 +200,11 @@ SsSharderManager *SsSharderManager::loadFile(const QString &path)
         }
     }
 
-    SsSharderManager *_shader = nullptr;
+    // 已链接的程序按共享组复用，同组的其他上下文不再重复链接
+    const QByteArray _key = "file:" + path.toUtf8();
+    SsSharderManager *_shader = static_cast<SsSharderManager *>(SsProgramCache::find(_key));
 
-    if (m_mapShader.contains(path))
-    {
-        _shader = m_mapShader[path];
-    }
-    else
+    if (!_shader)
     {
         QFile file(path);
 
@@ -217,7 +226,7 @@ SsSharderManager *SsSharderManager::loadFile(const QString &path)
         _shader->setName(path);
         _shader->loadShaderFromSourceCode(vertex, fragment);
 
-        m_mapShader.insert(path, _shader);
+        SsProgramCache::insert(_key, _shader);
     }
 
     return _shader;
@@ -226,19 +235,14 @@ SsSharderManager *SsSharderManager::loadFile(const QString &path)
 // 从文件中加载着色器
 SsSharderManager *SsSharderManager::loadFile(const QString &_vertex, const QString &_fragment)
 {
-    SsSharderManager *_shader = nullptr;
-
-    QString _name = _vertex + _fragment;
+    const QByteArray _key = "file:" + _vertex.toUtf8() + '|' + _fragment.toUtf8();
+    SsSharderManager *_shader = static_cast<SsSharderManager *>(SsProgramCache::find(_key));
 
-    if (m_mapShader.contains(_name))
-    {
-        _shader = m_mapShader[_name];
-    }
-    else
+    if (!_shader)
     {
         _shader = new SsSharderManager();
         _shader->loadShaderFromSourceFile(_vertex, _fragment);
-        m_mapShader.insert(_name, _shader);
+        SsProgramCache::insert(_key, _shader);
     }
 
     return _shader;
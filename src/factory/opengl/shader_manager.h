@@ -9,6 +9,8 @@ Description: 着色器加载管理
 Version history
 
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            loadFile按共享组缓存程序，链接经程序二进制磁盘缓存，预处理结果按原文缓存
+2             2026-10-19     cjx            链接后绑定场景公共Uniform块
 
 *****************************************************************/
 
@@ -38,6 +40,8 @@ public:
     void loadShaderFromSourceCode(const QString &_vertex, const QString &_fragment);
 
     // 将缓冲对象指定到对于的绑定点
+    // 链接成功后已自动绑定场景公共块（SsFrameBlock/SsViewBlock，见uniform_block.h），其余块由调用方绑定
+    bool bindUniformBlock(const char *blockName, GLuint binding);
 
     // 绑定纹理
 
@@ -56,13 +60,10 @@ protected:
 
 
 public:
-    // 从文件中加载着色器
+    // 从文件中加载着色器（需要当前上下文；结果按共享组缓存，由缓存持有）
     static SsSharderManager *loadFile(const QString &path);
 
     static SsSharderManager *loadFile(const QString &_vertex, const QString &_fragment);
-
-protected:
-    static QMap<QString, SsSharderManager *> m_mapShader;
 };
 
 
@@ -0,0 +1,311 @@
+#ifdef OPENGL_ENABLE
+
+#include "texture_atlas.h"
+
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLTexture>
+
+#include <climits>
+#include <cstring>
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+    : m_pageSize(qMax(64, pageSize))
+    , m_padding(qBound(0, padding, 16))
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    clear();
+}
+
+bool TextureAtlas::insert(const QString &name, const QImage &image)
+{
+    if (image.isNull())
+    {
+        return false;
+    }
+    if (image.width() > maxSpriteSize() || image.height() > maxSpriteSize())
+    {
+        qWarning() << "[atlas]:" << name << image.size() << "exceeds max sprite size" << maxSpriteSize();
+        return false;
+    }
+
+    const QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+
+    // 相同尺寸的替换原位覆盖
+    auto existing = m_regions.find(name);
+    if (existing != m_regions.end() && existing->rect.size() == rgba.size())
+    {
+        blit(m_pages[existing->page], existing->rect, rgba);
+        return true;
+    }
+
+    int pageIndex = -1;
+    QRect rect;
+    if (!allocate(rgba.width(), rgba.height(), pageIndex, rect))
+    {
+        return false;
+    }
+    blit(m_pages[pageIndex], rect, rgba);
+
+    Region region;
+    region.page = pageIndex;
+    region.rect = rect;
+    region.uv = uvFor(rect);
+    m_regions.insert(name, region);
+    return true;
+}
+
+bool TextureAtlas::allocate(int width, int height, int &pageIndex, QRect &rect)
+{
+    const int paddedWidth = width + 2 * m_padding;
+    const int paddedHeight = height + 2 * m_padding;
+
+    // 依次尝试已有页面，都放不下时新建一页
+    for (int i = 0; i <= m_pages.size(); ++i)
+    {
+        if (i == m_pages.size())
+        {
+            Page page;
+            page.image = QImage(m_pageSize, m_pageSize, QImage::Format_RGBA8888);
+            page.image.fill(Qt::transparent);
+            SkylineNode root;
+            root.width = m_pageSize;
+            page.skyline.append(root);
+            m_pages.append(page);
+        }
+
+        Page &page = m_pages[i];
+        int x = 0, y = 0;
+        const int index = findPosition(page, paddedWidth, paddedHeight, x, y);
+        if (index < 0)
+        {
+            continue;
+        }
+
+        addSkylineLevel(page, index, x, y, paddedWidth, paddedHeight);
+        page.usedArea += static_cast<qint64>(paddedWidth) * paddedHeight;
+        pageIndex = i;
+        rect = QRect(x + m_padding, y + m_padding, width, height);
+        return true;
+    }
+    return false;
+}
+
+int TextureAtlas::findPosition(const Page &page, int width, int height, int &x, int &y) const
+{
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+
+    const QVector<SkylineNode> &skyline = page.skyline;
+    for (int i = 0; i < skyline.size(); ++i)
+    {
+        const int left = skyline[i].x;
+        if (left + width > m_pageSize)
+        {
+            break;
+        }
+
+        // 跨越的各段中最高者决定放置高度
+        int top = 0;
+        int remaining = width;
+        for (int j = i; j < skyline.size() && remaining > 0; ++j)
+        {
+            top = qMax(top, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+        if (top + height > m_pageSize)
+        {
+            continue;
+        }
+
+        if (top + height < bestTop || (top + height == bestTop && skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top + height;
+            bestWidth = skyline[i].width;
+            x = left;
+            y = top;
+        }
+    }
+    return bestIndex;
+}
+
+void TextureAtlas::addSkylineLevel(Page &page, int index, int x, int y, int width, int height)
+{
+    QVector<SkylineNode> &skyline = page.skyline;
+
+    SkylineNode node;
+    node.x = x;
+    node.y = y + height;
+    node.width = width;
+    skyline.insert(index, node);
+
+    // 被新段覆盖的后续段截短或移除
+    for (int i = index + 1; i < skyline.size(); ++i)
+    {
+        const int previousRight = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= previousRight)
+        {
+            break;
+        }
+
+        const int shrink = previousRight - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0)
+        {
+            break;
+        }
+        skyline.remove(i);
+        --i;
+    }
+
+    // 合并高度相同的相邻段
+    for (int i = 0; i + 1 < skyline.size(); ++i)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.remove(i + 1);
+            --i;
+        }
+    }
+}
+
+void TextureAtlas::blit(Page &page, const QRect &rect, const QImage &image)
+{
+    QImage &target = page.image;
+    const int p = m_padding;
+    const int bytesPerPixel = 4;
+
+    // 精灵本体
+    for (int row = 0; row < rect.height(); ++row)
+    {
+        memcpy(target.scanLine(rect.y() + row) + rect.x() * bytesPerPixel,
+               image.constScanLine(row), static_cast<size_t>(rect.width()) * bytesPerPixel);
+    }
+
+    if (p > 0)
+    {
+        // 左右留边复制边缘列
+        for (int row = 0; row < rect.height(); ++row)
+        {
+            quint32 *line = reinterpret_cast<quint32 *>(target.scanLine(rect.y() + row));
+            const quint32 left = line[rect.x()];
+            const quint32 right = line[rect.x() + rect.width() - 1];
+            for (int i = 1; i <= p; ++i)
+            {
+                line[rect.x() - i] = left;
+                line[rect.x() + rect.width() - 1 + i] = right;
+            }
+        }
+
+        // 上下留边复制边缘行（含角落）
+        const int rowBytes = (rect.width() + 2 * p) * bytesPerPixel;
+        const int left = (rect.x() - p) * bytesPerPixel;
+        for (int i = 1; i <= p; ++i)
+        {
+            memcpy(target.scanLine(rect.y() - i) + left, target.constScanLine(rect.y()) + left, rowBytes);
+            memcpy(target.scanLine(rect.y() + rect.height() - 1 + i) + left,
+                   target.constScanLine(rect.y() + rect.height() - 1) + left, rowBytes);
+        }
+    }
+
+    page.dirty = page.dirty.united(rect.adjusted(-p, -p, p, p));
+}
+
+QRectF TextureAtlas::uvFor(const QRect &rect) const
+{
+    // 页面上传时上下翻转，图像第y行对应v = 1 - (y + 1) / size
+    const qreal size = m_pageSize;
+    return QRectF(rect.x() / size, (m_pageSize - rect.y() - rect.height()) / size,
+                  rect.width() / size, rect.height() / size);
+}
+
+QOpenGLTexture *TextureAtlas::pageTexture(int page)
+{
+    if (page < 0 || page >= m_pages.size())
+    {
+        return nullptr;
+    }
+
+    Page &target = m_pages[page];
+    upload(target);
+    return target.texture;
+}
+
+void TextureAtlas::flush()
+{
+    for (Page &page : m_pages)
+    {
+        upload(page);
+    }
+}
+
+void TextureAtlas::upload(Page &page)
+{
+    if (!page.texture)
+    {
+        // 图集不生成mipmap（缩小级别会跨精灵混色），只做线性过滤
+        page.texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+        page.texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+        page.texture->setSize(m_pageSize, m_pageSize);
+        page.texture->setMipLevels(1);
+        page.texture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+        page.texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
+        page.texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+        page.dirty = page.image.rect();
+    }
+
+    if (page.dirty.isEmpty())
+    {
+        return;
+    }
+
+    // 只上传脏区：翻转后写到GL坐标（原点左下）中对应的位置
+    const QRect dirty = page.dirty.intersected(page.image.rect());
+#if QT_VERSION_MAJOR < 6
+    const QImage region = page.image.copy(dirty).mirrored();
+#else
+    const QImage region = page.image.copy(dirty).flipped(Qt::Vertical);
+#endif
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+    page.texture->bind();
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    f->glTexSubImage2D(GL_TEXTURE_2D, 0, dirty.x(), m_pageSize - dirty.y() - dirty.height(),
+                       dirty.width(), dirty.height(), GL_RGBA, GL_UNSIGNED_BYTE, region.constBits());
+    page.texture->release();
+    page.dirty = QRect();
+}
+
+double TextureAtlas::occupancy() const
+{
+    if (m_pages.isEmpty())
+    {
+        return 0.0;
+    }
+    qint64 used = 0;
+    for (const Page &page : m_pages)
+    {
+        used += page.usedArea;
+    }
+    return static_cast<double>(used) / (static_cast<double>(m_pageSize) * m_pageSize * m_pages.size());
+}
+
+void TextureAtlas::clear()
+{
+    for (Page &page : m_pages)
+    {
+        delete page.texture;
+        page.texture = nullptr;
+    }
+    m_pages.clear();
+    m_regions.clear();
+}
+
+#endif
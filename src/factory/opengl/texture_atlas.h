@@ -0,0 +1,146 @@
+/*****************************************************************
+File:        texture_atlas.h
+Version:     1.0
+Author:      cjx
+start date:  2026-10-19
+Description: 小图纹理图集
+             把大量小图（船舶符号、标记、摇杆贴图、界面图标）按天际线（skyline）算法装箱到少数几张大纹理中，
+             绘制时同一页内的精灵只需绑定一次纹理，可合并为一次绘制
+             - 支持增量插入：新精灵写入CPU端页面并记录脏区，下次取页面纹理时只上传脏区
+             - 每个精灵四周留出padding并复制边缘像素，线性过滤时不会采样到相邻精灵
+             - UV与TextureManager创建的纹理一致（图像已上下翻转，v轴向上）
+    使用方式：
+        TextureAtlas atlas(2048, 2);
+        atlas.insert("ship", QImage(":/icons/ship.png"));
+        // GL线程：
+        TextureAtlas::Region region = atlas.region("ship");
+        atlas.pageTexture(region.page)->bind();
+        // 以region.uv作为纹理坐标绘制
+
+Version history
+[序号][修改日期][修改者][修改内容]
+1     2026-10-19  cjx    create
+
+*****************************************************************/
+
+#ifndef TEXTURE_ATLAS_H_
+#define TEXTURE_ATLAS_H_
+
+#include <QHash>
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+class QOpenGLTexture;
+
+class TextureAtlas
+{
+public:
+    /**
+     * @brief 精灵在图集中的位置
+     */
+    struct Region
+    {
+        int page = -1;              ///< 所在页（-1表示不存在）
+        QRect rect;                 ///< 页面内的像素区域（不含padding，图像坐标，原点左上）
+        QRectF uv;                  ///< 纹理坐标（v轴向上，left/top为uv最小值）
+
+        bool isValid() const { return page >= 0; }
+    };
+
+    /**
+     * @param pageSize 每页边长（像素）
+     * @param padding 精灵四周的留边（像素），线性过滤至少需要1
+     */
+    explicit TextureAtlas(int pageSize = 2048, int padding = 2);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    /**
+     * @brief 插入（或替换）精灵（仅更新CPU端页面，GL上传推迟到pageTexture）
+     * @return false表示图像为空或超过单页可容纳的尺寸
+     *
+     * 替换为相同尺寸时原位覆盖；尺寸不同时重新分配位置，旧位置在clear前不回收。
+     */
+    bool insert(const QString &name, const QImage &image);
+
+    /** 查询精灵位置 */
+    Region region(const QString &name) const { return m_regions.value(name); }
+    bool contains(const QString &name) const { return m_regions.contains(name); }
+
+    /**
+     * @brief 获取页面纹理（GL线程调用，需要当前上下文），有脏区时先上传脏区
+     */
+    QOpenGLTexture *pageTexture(int page);
+
+    /** 上传所有页面的脏区（GL线程调用） */
+    void flush();
+
+    int pageCount() const { return m_pages.size(); }
+    int pageSize() const { return m_pageSize; }
+    int spriteCount() const { return m_regions.size(); }
+
+    /** 单个精灵允许的最大边长（页面边长减去两侧padding） */
+    int maxSpriteSize() const { return m_pageSize - 2 * m_padding; }
+
+    /** 页面空间利用率（已分配面积/总面积） */
+    double occupancy() const;
+
+    /** 清空所有精灵与页面（需要当前上下文以释放纹理） */
+    void clear();
+
+private:
+    /**
+     * @brief 天际线的一段：从x开始宽width的区域已占用到高度y
+     */
+    struct SkylineNode
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+    };
+
+    /**
+     * @brief 一页图集
+     */
+    struct Page
+    {
+        QImage image;                       ///< CPU端页面（RGBA8888，原点左上）
+        QVector<SkylineNode> skyline;
+        QRect dirty;                        ///< 尚未上传的区域
+        QOpenGLTexture *texture = nullptr;
+        qint64 usedArea = 0;
+    };
+
+    /**
+     * @brief 在页面中寻找能放下w*h的位置（最低上沿优先，其次最窄）
+     * @return 天际线节点下标，-1表示放不下
+     */
+    int findPosition(const Page &page, int width, int height, int &x, int &y) const;
+
+    /** 分配区域后更新天际线 */
+    void addSkylineLevel(Page &page, int index, int x, int y, int width, int height);
+
+    /** 在页面中分配（含padding）区域，返回精灵区域（不含padding） */
+    bool allocate(int width, int height, int &pageIndex, QRect &rect);
+
+    /** 把图像写入页面并复制边缘像素到padding */
+    void blit(Page &page, const QRect &rect, const QImage &image);
+
+    /** 计算纹理坐标 */
+    QRectF uvFor(const QRect &rect) const;
+
+    /** 上传页面脏区 */
+    void upload(Page &page);
+
+    int m_pageSize;
+    int m_padding;
+    QVector<Page> m_pages;
+    QHash<QString, Region> m_regions;
+};
+
+#endif // TEXTURE_ATLAS_H_
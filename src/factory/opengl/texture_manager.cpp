@@ -3,13 +3,65 @@
 #include "texture_manager.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+
+#include <functional>
+#include <utility>
+
+namespace
+{
+// ==================== 解码任务 ====================
+class DecodeTask : public QRunnable
+{
+public:
+    explicit DecodeTask(std::function<void()> work)
+        : m_work(std::move(work))
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override { m_work(); }
+
+private:
+    std::function<void()> m_work;
+};
+
+/**
+ * @brief 转换为上传格式并上下翻转（GL纹理坐标原点在左下）
+ */
+QImage toGLImage(const QImage &image)
+{
+    const QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+#if QT_VERSION_MAJOR < 6
+    return rgba.mirrored();
+#else
+    return rgba.flipped(Qt::Vertical);
+#endif
+}
+} // namespace
+
+TextureManager::TextureManager()
+{
+    // 解码只占用少量线程，避免与解码视频、绘制争抢CPU
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 4, 2));
+}
+
+TextureManager::~TextureManager()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+    cleanup();
+}
 
 QOpenGLTexture *TextureManager::loadTexture(const QString &path, const QString &textureName)
 {
     // 如果纹理已缓存，直接返回
-    if (m_textures.contains(textureName))
+    if (QOpenGLTexture *texture = getTexture(textureName))
     {
-        return m_textures.value(textureName);
+        return texture;
     }
 
     // 加载图像
@@ -25,35 +77,299 @@ QOpenGLTexture *TextureManager::loadTexture(const QString &path, const QString &
 
 QOpenGLTexture *TextureManager::createTexture(const QImage &image, const QString &textureName)
 {
-    // 创建 QOpenGLTexture 对象（自动处理 OpenGL 初始化）
-#if QT_VERSION_MAJOR < 6
-    QOpenGLTexture *texture = new QOpenGLTexture(image.mirrored());
-#else
-    QOpenGLTexture *texture = new QOpenGLTexture(image.flipped(Qt::Vertical));
-#endif
+    return uploadTexture(toGLImage(image), textureName, false);
+}
+
+bool TextureManager::loadTextureAsync(const QString &path, const QString &textureName)
+{
+    // 已缓存或正在加载：直接返回，避免每帧调用时重复解码并替换正在使用的纹理
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_resident.contains(textureName) || m_loading.contains(textureName))
+        {
+            return true;
+        }
+    }
+
+    if (!QFileInfo::exists(path))
+    {
+        qWarning() << "Texture file not found:" << path;
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_loading.contains(textureName))
+        {
+            return true;
+        }
+        m_loading.insert(textureName);
+    }
+
+    const int generation = m_generation.load();
+    ++m_pendingDecodes;
+    m_pool.start(new DecodeTask([this, path, textureName, generation]() {
+        decode(path, textureName, generation);
+    }));
+    return true;
+}
+
+void TextureManager::decode(const QString &path, const QString &textureName, int generation)
+{
+    DecodedImage decoded;
+    decoded.name = textureName;
+    decoded.generation = generation;
+
+    QImage image(path);
+    if (image.isNull())
+    {
+        qWarning() << "Failed to load image:" << path;
+    }
+    else
+    {
+        decoded.image = toGLImage(image);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_decoded.enqueue(decoded);
+    }
+    --m_pendingDecodes;
+
+    // 接收方位于其他线程，信号排队送达，由其安排下一帧调用processUploads
+    emit uploadsPending();
+}
+
+int TextureManager::processUploads(double budgetMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int remaining = 0;
+    for (;;)
+    {
+        DecodedImage decoded;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_decoded.isEmpty())
+            {
+                break;
+            }
+            // 每次至少上传一张，之后超出时间片的留到下一帧
+            if (timer.nsecsElapsed() / 1e6 >= budgetMs)
+            {
+                remaining = m_decoded.size();
+                break;
+            }
+            decoded = m_decoded.dequeue();
+            // cleanup之后到达的旧结果直接丢弃，不能清除新一轮同名加载的标记
+            if (decoded.generation != m_generation.load())
+            {
+                continue;
+            }
+            m_loading.remove(decoded.name);
+        }
+
+        if (decoded.image.isNull())
+        {
+            emit textureFailed(decoded.name);
+            continue;
+        }
+
+        // 解码期间已被同步加载：保留现有纹理，调用方可能正在使用它
+        if (m_textures.contains(decoded.name))
+        {
+            emit textureLoaded(decoded.name);
+            continue;
+        }
+
+        if (uploadTexture(decoded.image, decoded.name, true))
+        {
+            emit textureLoaded(decoded.name);
+        }
+    }
+
+    m_lastUploadMs = timer.nsecsElapsed() / 1e6;
+    if (remaining > 0)
+    {
+        emit uploadsPending();
+    }
+    return remaining;
+}
+
+QOpenGLTexture *TextureManager::uploadTexture(const QImage &flipped, const QString &textureName, bool evictable)
+{
+    // 创建 QOpenGLTexture 对象（自动处理 OpenGL 初始化，构造时已生成mipmap）
+    QOpenGLTexture *texture = new QOpenGLTexture(flipped, QOpenGLTexture::GenerateMipMaps);
+    if (!texture->isCreated())
+    {
+        qWarning() << "Failed to create texture:" << textureName;
+        delete texture;
+        return nullptr;
+    }
     texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::Linear);
     texture->setWrapMode(QOpenGLTexture::Repeat);
-    texture->generateMipMaps();
+
+    // 同名纹理被替换时先释放旧纹理
+    auto existing = m_textures.find(textureName);
+    if (existing != m_textures.end())
+    {
+        m_gpuBytes -= existing->bytes;
+        delete existing->texture;
+        m_textures.erase(existing);
+    }
 
     // 缓存纹理
-    m_textures[textureName] = texture;
+    Entry entry;
+    entry.texture = texture;
+    entry.bytes = estimateBytes(flipped.width(), flipped.height(), true);
+    entry.lastUse = ++m_useClock;
+    entry.evictable = evictable;
+    m_textures.insert(textureName, entry);
+    m_gpuBytes += entry.bytes;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_resident.insert(textureName);
+    }
 
+    evictToBudget(textureName);
     return texture;
 }
 
+void TextureManager::evictToBudget(const QString &except)
+{
+    if (m_budgetBytes <= 0)
+    {
+        return;
+    }
+
+    while (m_gpuBytes > m_budgetBytes)
+    {
+        // 纹理数量有限（图标/符号集），线性查找最久未使用项即可
+        auto oldest = m_textures.end();
+        for (auto it = m_textures.begin(); it != m_textures.end(); ++it)
+        {
+            if (it->evictable && it.key() != except && (oldest == m_textures.end() || it->lastUse < oldest->lastUse))
+            {
+                oldest = it;
+            }
+        }
+        if (oldest == m_textures.end())
+        {
+            break;
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_resident.remove(oldest.key());
+        }
+        m_gpuBytes -= oldest->bytes;
+        delete oldest->texture;
+        m_textures.erase(oldest);
+        ++m_evictions;
+    }
+}
+
 QOpenGLTexture *TextureManager::getTexture(const QString &textureName) const
 {
-    return m_textures.value(textureName, nullptr);
+    auto it = m_textures.constFind(textureName);
+    if (it == m_textures.constEnd())
+    {
+        return nullptr;
+    }
+    it->lastUse = ++m_useClock;
+    return it->texture;
+}
+
+bool TextureManager::addSprite(const QImage &image, const QString &textureName)
+{
+    return m_atlas.insert(textureName, image);
+}
+
+bool TextureManager::loadSprite(const QString &path, const QString &textureName)
+{
+    if (m_atlas.contains(textureName))
+    {
+        return true;
+    }
+
+    QImage image(path);
+    if (image.isNull())
+    {
+        qWarning() << "Failed to load image:" << path;
+        return false;
+    }
+    return addSprite(image, textureName);
+}
+
+bool TextureManager::isLoading(const QString &textureName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_loading.contains(textureName);
+}
+
+void TextureManager::setMemoryBudget(qint64 bytes)
+{
+    m_budgetBytes = qMax<qint64>(0, bytes);
+}
+
+qint64 TextureManager::estimateBytes(int width, int height, bool mipmaps)
+{
+    qint64 bytes = 0;
+    int w = qMax(1, width);
+    int h = qMax(1, height);
+    for (;;)
+    {
+        bytes += static_cast<qint64>(w) * h * 4;
+        if (!mipmaps || (w == 1 && h == 1))
+        {
+            break;
+        }
+        w = qMax(1, w / 2);
+        h = qMax(1, h / 2);
+    }
+    return bytes;
+}
+
+TextureManager::Stats TextureManager::stats() const
+{
+    Stats stats;
+    stats.textures = m_textures.size();
+    stats.gpuBytes = m_gpuBytes;
+    stats.budgetBytes = m_budgetBytes;
+    stats.pendingDecodes = m_pendingDecodes.load();
+    stats.evictions = m_evictions;
+    stats.lastUploadMs = m_lastUploadMs;
+    {
+        QMutexLocker locker(&m_mutex);
+        stats.pendingUploads = m_decoded.size();
+    }
+    return stats;
 }
 
 void TextureManager::cleanup()
 {
+    // 丢弃未完成的异步加载：仍在解码的结果到达后按代数丢弃
+    ++m_generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_decoded.clear();
+        m_loading.clear();
+        m_resident.clear();
+    }
+
+    m_atlas.clear();
+
     if (!m_textures.isEmpty())
     {
-        qDeleteAll(m_textures); // 自动释放 QOpenGLTexture 对象
+        for (const Entry &entry : std::as_const(m_textures))
+        {
+            delete entry.texture; // 自动释放 QOpenGLTexture 对象
+        }
         m_textures.clear();
+        m_gpuBytes = 0;
         qDebug() << "All textures cleaned up.";
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,12 +1,28 @@
 /*****************************************************************
 File:        texture_manager.h
-Version:     1.0
+Version:     1.4
 Author:
 start date:
-Description:
+Description: 纹理加载与缓存
+             - loadTexture/createTexture：在调用线程（GL线程）同步解码并上传
+             - loadTextureAsync：解码与翻转在工作线程完成，GL线程每帧调用processUploads按时间片上传
+             - 按纹理估算显存（含各级mipmap），设置预算后超出时淘汰最久未使用的异步加载纹理
+               （同步加载/创建的纹理由调用方持有指针，不参与淘汰）
+             - addSprite/loadSprite：小图装入共享图集，按名称取页与UV，同页精灵可合并绘制
+    使用方式（异步）：
+        connect(&manager, &TextureManager::uploadsPending, widget, QOverload<>::of(&QWidget::update));
+        manager.loadTextureAsync(":/icons/ship.png", "ship");
+        // paintGL中：
+        manager.processUploads();
+        if (QOpenGLTexture *texture = manager.getTexture("ship")) { ... }
+        // 设置了显存预算时异步加载的纹理可能被淘汰，不要跨帧保存其指针，每帧通过getTexture获取
 
 Version history
 [序号][修改日期][修改者][修改内容]
+1     2026-10-19  cjx    新增异步加载（工作线程解码、时间片上传）与显存预算LRU淘汰
+2     2026-10-19  cjx    新增小图图集（addSprite/getSprite）
+3     2026-10-19  cjx    异步加载跳过已缓存的纹理，不再重复解码与替换
+4     2026-10-19  cjx    显存预算默认不限制，且只淘汰异步加载的纹理
 
 *****************************************************************/
 
@@ -14,34 +30,159 @@ Version history
 #define TEXTURE_MANAGER_H_
 
 #include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
 #include <QOpenGLTexture>
+#include <QQueue>
+#include <QSet>
 #include <QString>
+#include <QThreadPool>
+
+#include <atomic>
 
 #include "singleton.h"
+#include "texture_atlas.h"
 
-class TextureManager
+class TextureManager : public QObject
 {
+    Q_OBJECT
+
 public:
     // 单例模式，确保全局唯一纹理管理器
     friend SingletonTemplate<TextureManager>;
 
+    /**
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        int textures = 0;           ///< 缓存中的纹理数
+        qint64 gpuBytes = 0;        ///< 估算显存占用（含mipmap）
+        qint64 budgetBytes = 0;     ///< 显存预算（0表示不限制）
+        int pendingDecodes = 0;     ///< 工作线程中尚未完成的解码数
+        int pendingUploads = 0;     ///< 已解码、等待上传的纹理数
+        qint64 evictions = 0;       ///< 累计淘汰数
+        double lastUploadMs = 0.0;  ///< 最近一次processUploads的上传耗时
+    };
+
     // 从文件加载纹理并缓存
     QOpenGLTexture* loadTexture(const QString& path, const QString& textureName);
 
     // 从 QImage 创建纹理
     QOpenGLTexture* createTexture(const QImage& image, const QString& textureName);
 
-    // 获取缓存的纹理
+    /**
+     * @brief 异步加载纹理（任意线程调用）
+     * 文件解码与上下翻转在工作线程完成，之后发出uploadsPending，由GL线程在processUploads中上传
+     * @return false表示文件不存在；已缓存或正在加载时直接返回true
+     */
+    bool loadTextureAsync(const QString& path, const QString& textureName);
+
+    /**
+     * @brief 上传已解码的纹理（GL线程、上下文为当前上下文时调用，建议每帧绘制前调用一次）
+     * @param budgetMs 本次上传的时间片，超出后剩余纹理留到下一帧（至少上传一张）
+     * @return 剩余待上传的纹理数（大于0时会再次发出uploadsPending）
+     */
+    int processUploads(double budgetMs = 2.0);
+
+    // 获取缓存的纹理（同时更新最近使用时间）
     QOpenGLTexture* getTexture(const QString& textureName) const;
 
-    // 清理所有纹理
+    /**
+     * @brief 把小图加入共享图集（不创建独立纹理），绘制时按名称取图集位置
+     * @return false表示图像超过图集单页尺寸，此时应改用createTexture
+     */
+    bool addSprite(const QImage& image, const QString& textureName);
+
+    // 从文件加载小图到图集
+    bool loadSprite(const QString& path, const QString& textureName);
+
+    /**
+     * @brief 获取精灵在图集中的位置（页与UV），页面纹理通过atlas().pageTexture(page)获取
+     */
+    TextureAtlas::Region getSprite(const QString& textureName) const { return m_atlas.region(textureName); }
+
+    TextureAtlas& atlas() { return m_atlas; }
+
+    /** 纹理是否正在异步加载（解码或等待上传） */
+    bool isLoading(const QString& textureName) const;
+
+    /**
+     * @brief 设置显存预算（字节，0表示不限制，默认不限制）
+     * 超出时在GL线程的下一次上传/创建中淘汰最久未使用的异步加载纹理
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_budgetBytes; }
+
+    /** 估算纹理显存（RGBA8，mipmap时含全部级别） */
+    static qint64 estimateBytes(int width, int height, bool mipmaps);
+
+    Stats stats() const;
+
+    // 清理所有纹理（需要GL上下文），未完成的异步加载被丢弃
     void cleanup();
 
+signals:
+    /** 有已解码的纹理等待上传（工作线程发出，接收方通常连接到update()以安排下一帧） */
+    void uploadsPending();
+
+    /** 异步加载的纹理已上传（GL线程发出） */
+    void textureLoaded(const QString &textureName);
+
+    /** 异步加载失败（文件无法解码） */
+    void textureFailed(const QString &textureName);
+
 private:
-    TextureManager() = default;
-    ~TextureManager() { cleanup(); }
+    TextureManager();
+    ~TextureManager() override;
+
+    /**
+     * @brief 缓存项
+     */
+    struct Entry
+    {
+        QOpenGLTexture *texture = nullptr;
+        qint64 bytes = 0;           ///< 估算显存
+        mutable quint64 lastUse = 0;///< 最近使用序号（越大越新）
+        bool evictable = false;     ///< 是否可被淘汰（仅异步加载的纹理）
+    };
+
+    /**
+     * @brief 已解码、等待上传的图像
+     */
+    struct DecodedImage
+    {
+        QString name;
+        QImage image;               ///< 已翻转为GL行序的RGBA8888图像（解码失败时为空）
+        int generation = 0;         ///< 发起时的清理代数，cleanup后的旧结果被丢弃
+    };
+
+    /** 工作线程：解码并翻转，结果放入上传队列 */
+    void decode(const QString &path, const QString &textureName, int generation);
+
+    /** 上传已翻转的图像并放入缓存（evictable：是否允许按预算淘汰） */
+    QOpenGLTexture *uploadTexture(const QImage &flipped, const QString &textureName, bool evictable);
+
+    /** 按预算淘汰最久未使用的可淘汰纹理（except除外） */
+    void evictToBudget(const QString &except);
+
+    QHash<QString, Entry> m_textures;   // 纹理名称到纹理的映射（仅GL线程访问）
+    TextureAtlas m_atlas;               // 小图图集（仅GL线程访问）
+    qint64 m_gpuBytes = 0;
+    qint64 m_budgetBytes = 0;
+    qint64 m_evictions = 0;
+    double m_lastUploadMs = 0.0;
+    mutable quint64 m_useClock = 0;
 
-    QHash<QString, QOpenGLTexture*> m_textures; // 纹理名称到ID的映射
+    // 异步加载
+    QThreadPool m_pool;
+    mutable QMutex m_mutex;             // 保护m_loading、m_resident与m_decoded
+    QSet<QString> m_loading;            // 正在解码或等待上传的纹理名
+    QSet<QString> m_resident;           // 已缓存的纹理名（m_textures的键，供其他线程查询）
+    QQueue<DecodedImage> m_decoded;
+    std::atomic<int> m_pendingDecodes{0};
+    std::atomic<int> m_generation{0};
 };
 
-#endif // TEXTURE_MANAGER_H_
\ No newline at end of file
+#endif // TEXTURE_MANAGER_H_
@@ -0,0 +1,213 @@
+#include "uniform_block.h"
+
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <cstring>
+
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+
+// ==================== SsStd140Writer ====================
+
+void SsStd140Writer::write(const void *value, int size, int alignment)
+{
+    const int previous = m_data.size();
+    const int start = align(previous, alignment);
+    m_data.resize(start + size);
+    // resize新增的对齐间隙内容未定义，清零便于比较与调试
+    memset(m_data.data() + previous, 0, static_cast<size_t>(start - previous));
+    memcpy(m_data.data() + start, value, static_cast<size_t>(size));
+}
+
+SsStd140Writer &SsStd140Writer::scalar(float value)
+{
+    write(&value, 4, 4);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::integer(int value)
+{
+    write(&value, 4, 4);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::vec2(const QVector2D &value)
+{
+    const float v[2] = {value.x(), value.y()};
+    write(v, 8, 8);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::vec3(const QVector3D &value)
+{
+    const float v[3] = {value.x(), value.y(), value.z()};
+    write(v, 12, 16);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::vec4(const QVector4D &value)
+{
+    const float v[4] = {value.x(), value.y(), value.z(), value.w()};
+    write(v, 16, 16);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::mat3(const QMatrix3x3 &value)
+{
+    // 每列占一个vec4
+    const float *m = value.constData();
+    for (int col = 0; col < 3; ++col)
+    {
+        const float column[4] = {m[col * 3], m[col * 3 + 1], m[col * 3 + 2], 0.0f};
+        write(column, 16, 16);
+    }
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::mat4(const QMatrix4x4 &value)
+{
+    write(value.constData(), 64, 16);
+    return *this;
+}
+
+SsStd140Writer &SsStd140Writer::scalarArray(const float *values, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const float element[4] = {values[i], 0.0f, 0.0f, 0.0f};
+        write(element, 16, 16);
+    }
+    return *this;
+}
+
+QByteArray SsStd140Writer::data() const
+{
+    QByteArray result = m_data;
+    result.append(QByteArray(align(result.size(), 16) - result.size(), '\0'));
+    return result;
+}
+
+// ==================== SsUniformBuffer ====================
+
+SsUniformBuffer::~SsUniformBuffer()
+{
+    destroy();
+}
+
+bool SsUniformBuffer::isSupported(QOpenGLContext *context)
+{
+    if (!context)
+    {
+        return false;
+    }
+    const QSurfaceFormat format = context->format();
+    const int version = format.majorVersion() * 10 + format.minorVersion();
+    return context->isOpenGLES() ? version >= 30
+                                 : (version >= 31 || context->hasExtension("GL_ARB_uniform_buffer_object"));
+}
+
+bool SsUniformBuffer::create()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (m_buffer || !isSupported(context))
+    {
+        return m_buffer != 0;
+    }
+    context->functions()->glGenBuffers(1, &m_buffer);
+    m_size = 0;
+    return m_buffer != 0;
+}
+
+void SsUniformBuffer::destroy()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (m_buffer && context)
+    {
+        context->functions()->glDeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_size = 0;
+}
+
+void SsUniformBuffer::update(const QByteArray &data)
+{
+    if (!m_buffer)
+    {
+        return;
+    }
+
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+    f->glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    if (data.size() == m_size)
+    {
+        f->glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size(), data.constData());
+    }
+    else
+    {
+        f->glBufferData(GL_UNIFORM_BUFFER, data.size(), data.constData(), GL_DYNAMIC_DRAW);
+        m_size = data.size();
+    }
+    f->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void SsUniformBuffer::bind(GLuint binding)
+{
+    if (!m_buffer)
+    {
+        return;
+    }
+    QOpenGLContext::currentContext()->extraFunctions()->glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_buffer);
+}
+
+// ==================== SsUniformBlocks ====================
+
+const char *SsUniformBlocks::glslSource()
+{
+    return "layout(std140) uniform SsFrameBlock {\n"
+           "    vec4 ss_time;\n"                   // x:秒 y:帧间隔 z:帧序号 w:设备像素比
+           "};\n"
+           "layout(std140) uniform SsViewBlock {\n"
+           "    mat4 ss_projection;\n"
+           "    mat4 ss_view;\n"
+           "    mat4 ss_viewProjection;\n"
+           "    vec4 ss_viewport;\n"               // xy:逻辑尺寸 zw:设备像素尺寸
+           "};\n";
+}
+
+int SsUniformBlocks::bindProgram(GLuint programId)
+{
+    int count = 0;
+    if (bindProgramBlock(programId, FRAME_BLOCK, FRAME_BINDING))
+    {
+        ++count;
+    }
+    if (bindProgramBlock(programId, VIEW_BLOCK, VIEW_BINDING))
+    {
+        ++count;
+    }
+    return count;
+}
+
+bool SsUniformBlocks::bindProgramBlock(GLuint programId, const char *blockName, GLuint binding)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!programId || !SsUniformBuffer::isSupported(context))
+    {
+        return false;
+    }
+
+    QOpenGLExtraFunctions *f = context->extraFunctions();
+    const GLuint index = f->glGetUniformBlockIndex(programId, blockName);
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    f->glUniformBlockBinding(programId, index, binding);
+    return true;
+}
@@ -0,0 +1,142 @@
+/***************************************************************
+Copyright (c) 2022-2030, shisan233@sszc.live.
+All rights reserved.
+File:        uniform_block.h
+Version:     1.0
+Author:      cjx
+start date:  2026-10-19
+Description: Uniform块（UBO）与std140布局辅助
+             场景内所有程序共用的参数（投影、视图、视口、时间）放入UBO，每帧只上传并绑定一次，
+             各程序不再逐个setUniformValue
+             - SsStd140Writer：按std140对齐规则顺序写入，结果可直接上传
+             - SsUniformBuffer：GL_UNIFORM_BUFFER封装（需要GL 3.1/GLES 3.0）
+             - SsUniformBlocks：场景公共块的绑定点、GLSL声明与程序绑定
+    使用方式：
+        SsStd140Writer writer;
+        writer.mat4(projection);
+        writer.vec4(QVector4D(w, h, 0, 0));
+        buffer.update(writer.data());
+        buffer.bind(SsUniformBlocks::VIEW_BINDING);
+
+Version history
+
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifndef UNIFORM_BLOCK_H_
+#define UNIFORM_BLOCK_H_
+
+#include <QByteArray>
+#include <QGenericMatrix>
+#include <QMatrix4x4>
+#include <QOpenGLFunctions>
+#include <QVector2D>
+#include <QVector3D>
+#include <QVector4D>
+
+class QOpenGLContext;
+
+/**
+ * @brief std140布局写入器
+ * 标量4字节对齐；vec2按8字节；vec3/vec4按16字节；矩阵每列按vec4对齐；数组元素步长取16的倍数
+ */
+class SsStd140Writer
+{
+public:
+    SsStd140Writer &scalar(float value);
+    SsStd140Writer &integer(int value);
+    SsStd140Writer &vec2(const QVector2D &value);
+    SsStd140Writer &vec3(const QVector3D &value);
+    SsStd140Writer &vec4(const QVector4D &value);
+    SsStd140Writer &mat3(const QMatrix3x3 &value);
+    SsStd140Writer &mat4(const QMatrix4x4 &value);
+    /** float数组（每个元素占16字节） */
+    SsStd140Writer &scalarArray(const float *values, int count);
+
+    /** 当前偏移（下一个成员写入前的位置） */
+    int offset() const { return m_data.size(); }
+
+    /** 块数据（尾部按16字节补齐，与GL报告的块大小一致） */
+    QByteArray data() const;
+
+    void clear() { m_data.clear(); }
+
+    /** 按std140规则对齐后的偏移 */
+    static int align(int offset, int alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+private:
+    void write(const void *value, int size, int alignment);
+
+    QByteArray m_data;
+};
+
+/**
+ * @brief 统一缓冲对象（需要当前上下文）
+ */
+class SsUniformBuffer
+{
+public:
+    SsUniformBuffer() = default;
+    ~SsUniformBuffer();
+
+    SsUniformBuffer(const SsUniformBuffer &) = delete;
+    SsUniformBuffer &operator=(const SsUniformBuffer &) = delete;
+
+    /** 当前上下文是否支持UBO（GL 3.1+ / GLES 3.0+） */
+    static bool isSupported(QOpenGLContext *context);
+
+    bool create();
+    void destroy();
+    bool isCreated() const { return m_buffer != 0; }
+
+    /**
+     * @brief 上传块数据（尺寸不变时用glBufferSubData覆盖，否则重新分配）
+     */
+    void update(const QByteArray &data);
+
+    /** 绑定到绑定点（glBindBufferBase） */
+    void bind(GLuint binding);
+
+    GLuint bufferId() const { return m_buffer; }
+
+private:
+    GLuint m_buffer = 0;
+    int m_size = 0;
+};
+
+/**
+ * @brief 场景公共Uniform块
+ */
+class SsUniformBlocks
+{
+public:
+    static constexpr GLuint FRAME_BINDING = 0;      ///< SsFrameBlock的绑定点
+    static constexpr GLuint VIEW_BINDING = 1;       ///< SsViewBlock的绑定点
+
+    static constexpr const char *FRAME_BLOCK = "SsFrameBlock";
+    static constexpr const char *VIEW_BLOCK = "SsViewBlock";
+
+    /**
+     * @brief 公共块的GLSL声明（插入到#version之后）
+     * SsFrameBlock { vec4 ss_time; }                         x:秒 y:帧间隔(秒) z:帧序号 w:设备像素比
+     * SsViewBlock  { mat4 ss_projection; mat4 ss_view; mat4 ss_viewProjection; vec4 ss_viewport; }
+     *                                                         ss_viewport：xy逻辑尺寸，zw设备像素尺寸
+     */
+    static const char *glslSource();
+
+    /**
+     * @brief 把程序中存在的公共块绑定到约定的绑定点（程序未声明的块忽略）
+     * @param programId 已链接的程序
+     * @return 绑定的块数量
+     */
+    static int bindProgram(GLuint programId);
+
+    /**
+     * @brief 把程序中的指定块绑定到绑定点
+     * @return false表示程序中没有该块或上下文不支持UBO
+     */
+    static bool bindProgramBlock(GLuint programId, const char *blockName, GLuint binding);
+};
+
+#endif // UNIFORM_BLOCK_H_
@@ -0,0 +1,463 @@
+#include "frame_extractor.h"
+
+#include "view/widget/player/ffmpeg_decode_helper.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QImageWriter>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThread>
+
+extern "C"
+{
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace
+{
+// 每个编码线程持有自己的缩放上下文，分辨率/像素格式不变时复用
+struct ThreadScaler
+{
+    SwsContext *ctx = nullptr;
+    ~ThreadScaler() { sws_freeContext(ctx); }
+};
+
+// ==================== 缩放+编码任务 ====================
+class ScaleEncodeTask : public QRunnable
+{
+public:
+    ScaleEncodeTask(AVFrame *frame, int outWidth, int outHeight, const QString &filePath,
+                    int quality, std::atomic<int> *failed, QSemaphore *slots)
+        : m_frame(frame)
+        , m_outWidth(outWidth)
+        , m_outHeight(outHeight)
+        , m_filePath(filePath)
+        , m_quality(quality)
+        , m_failed(failed)
+        , m_slots(slots)
+    {
+        setAutoDelete(true);
+    }
+
+    ~ScaleEncodeTask() override
+    {
+        av_frame_free(&m_frame);
+        m_slots->release();
+    }
+
+    void run() override
+    {
+        if (!encode())
+            m_failed->fetch_add(1);
+    }
+
+private:
+    bool encode()
+    {
+        thread_local ThreadScaler scaler;
+
+        // 缩小时使用区域平均，放大/等尺寸时双线性
+        int flags = (m_outWidth < m_frame->width) ? SWS_AREA : SWS_BILINEAR;
+        scaler.ctx = sws_getCachedContext(scaler.ctx,
+                                          m_frame->width, m_frame->height,
+                                          static_cast<AVPixelFormat>(m_frame->format),
+                                          m_outWidth, m_outHeight, AV_PIX_FMT_RGB32,
+                                          flags, nullptr, nullptr, nullptr);
+        if (!scaler.ctx)
+        {
+            qWarning() << "Failed to create scaler for" << m_filePath;
+            return false;
+        }
+
+        QImage image(m_outWidth, m_outHeight, QImage::Format_RGB32);
+        if (image.isNull())
+            return false;
+
+        uint8_t *dstData[1] = {image.bits()};
+        int dstLinesize[1] = {static_cast<int>(image.bytesPerLine())};
+        sws_scale(scaler.ctx, m_frame->data, m_frame->linesize, 0, m_frame->height,
+                  dstData, dstLinesize);
+
+        QImageWriter writer(m_filePath);
+        if (m_quality >= 0)
+            writer.setQuality(m_quality);
+        if (!writer.write(image))
+        {
+            qWarning() << "Failed to save" << m_filePath << writer.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    AVFrame *m_frame;
+    int m_outWidth;
+    int m_outHeight;
+    QString m_filePath;
+    int m_quality;
+    std::atomic<int> *m_failed;
+    QSemaphore *m_slots;
+};
+} // namespace
+
+FrameExtractor::FrameExtractor(const Options &options)
+    : m_options(options)
+{
+    int threads = m_options.encodeThreads > 0 ? m_options.encodeThreads : QThread::idealThreadCount();
+    m_pool.setMaxThreadCount(qMax(1, threads));
+    // 在途任务上限：每个线程最多积压2帧
+    m_slots = new QSemaphore(m_pool.maxThreadCount() * 2);
+}
+
+FrameExtractor::~FrameExtractor()
+{
+    m_pool.waitForDone();
+    closeInput();
+    delete m_slots;
+}
+
+bool FrameExtractor::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_options.outputDir.isEmpty() || !QDir().mkpath(m_options.outputDir))
+    {
+        m_error = QStringLiteral("Cannot create output directory: %1").arg(m_options.outputDir);
+        return false;
+    }
+    if (!openInput())
+        return false;
+
+    if (m_options.mode == MODE_KEYFRAMES)
+    {
+        // 解码器直接丢弃非关键帧
+        m_codecCtx->skip_frame = AVDISCARD_NONKEY;
+    }
+    m_nextTargetUs = m_startTimeUs;
+
+    bool ok = decodeSequential();
+
+    // 等待所有编码任务完成后再写索引
+    m_pool.waitForDone();
+    m_result.failedFrames = m_failed.load();
+    m_result.elapsedMs = timer.elapsed();
+
+    if (!writeIndex())
+        ok = false;
+
+    closeInput();
+    return ok;
+}
+
+bool FrameExtractor::openInput()
+{
+    QByteArray url = m_options.input.toUtf8();
+    if (avformat_open_input(&m_formatCtx, url.constData(), nullptr, nullptr) < 0)
+    {
+        m_error = QStringLiteral("Cannot open input: %1").arg(m_options.input);
+        return false;
+    }
+    if (avformat_find_stream_info(m_formatCtx, nullptr) < 0)
+    {
+        m_error = QStringLiteral("Cannot find stream info: %1").arg(m_options.input);
+        return false;
+    }
+
+    // 与播放器相同的解码器初始化流程；离线场景解码线程默认占满CPU
+    int decodeThreads = m_options.decodeThreads > 0 ? m_options.decodeThreads : QThread::idealThreadCount();
+    m_codecCtx = FFmpegDecodeHelper::openVideoDecoder(m_formatCtx, m_streamIndex, decodeThreads, &m_error);
+    if (!m_codecCtx)
+        return false;
+
+    AVStream *stream = m_formatCtx->streams[m_streamIndex];
+    m_timeBase = stream->time_base;
+    m_startTimeUs = (stream->start_time != AV_NOPTS_VALUE)
+                        ? av_rescale_q(stream->start_time, m_timeBase, {1, 1000000})
+                        : 0;
+
+    // 只读取视频流
+    for (unsigned int i = 0; i < m_formatCtx->nb_streams; ++i)
+    {
+        if (static_cast<int>(i) != m_streamIndex)
+            m_formatCtx->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    // 计算输出尺寸（仅指定一边时等比缩放，结果取偶数）
+    int srcW = m_codecCtx->width;
+    int srcH = m_codecCtx->height;
+    if (m_options.outWidth <= 0 && m_options.outHeight <= 0)
+    {
+        m_options.outWidth = srcW;
+        m_options.outHeight = srcH;
+    }
+    else if (m_options.outWidth <= 0)
+    {
+        m_options.outWidth = qMax(2, static_cast<int>(static_cast<qint64>(srcW) * m_options.outHeight / srcH) & ~1);
+    }
+    else if (m_options.outHeight <= 0)
+    {
+        m_options.outHeight = qMax(2, static_cast<int>(static_cast<qint64>(srcH) * m_options.outWidth / srcW) & ~1);
+    }
+
+    qDebug() << "Input:" << m_options.input << srcW << "x" << srcH
+             << av_get_pix_fmt_name(m_codecCtx->pix_fmt)
+             << "-> output:" << m_options.outWidth << "x" << m_options.outHeight;
+    return true;
+}
+
+void FrameExtractor::closeInput()
+{
+    if (m_codecCtx)
+        avcodec_free_context(&m_codecCtx);
+    if (m_formatCtx)
+        avformat_close_input(&m_formatCtx);
+    m_streamIndex = -1;
+}
+
+bool FrameExtractor::decodeSequential()
+{
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+    {
+        m_error = QStringLiteral("Failed to allocate packet");
+        return false;
+    }
+
+    const qint64 intervalUs = m_options.intervalMs * 1000;
+    const bool canSeek = m_formatCtx->pb && (m_formatCtx->pb->seekable & AVIO_SEEKABLE_NORMAL);
+
+    bool ok = true;
+    while (!m_abort && !reachedLimit())
+    {
+        int ret = av_read_frame(m_formatCtx, pkt);
+        if (ret < 0)
+        {
+            // EOF：冲刷解码器中剩余的帧
+            decodePacket(nullptr);
+            break;
+        }
+
+        if (pkt->stream_index != m_streamIndex)
+        {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        if (pkt->flags & AV_PKT_FLAG_KEY)
+        {
+            // 统计GOP时长，用于判断是否改用seek
+            qint64 pts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+            if (pts != AV_NOPTS_VALUE)
+            {
+                qint64 ptsUs = av_rescale_q(pts, m_timeBase, {1, 1000000});
+                if (m_lastKeyPtsUs >= 0 && ptsUs > m_lastKeyPtsUs)
+                    m_gopUs = qMax(m_gopUs, ptsUs - m_lastKeyPtsUs);
+                m_lastKeyPtsUs = ptsUs;
+            }
+        }
+        else if (m_options.mode == MODE_KEYFRAMES)
+        {
+            // 仅关键帧模式：非关键帧包不送入解码器
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        bool cont = decodePacket(pkt);
+        av_packet_unref(pkt);
+        if (!cont)
+            break;
+
+        // 间隔大于GOP时，顺序解码会浪费大量时间在丢弃的帧上，改为按关键帧seek
+        if (m_options.mode == MODE_INTERVAL && canSeek && m_gopUs > 0 && intervalUs > m_gopUs)
+        {
+            qDebug() << "Interval" << intervalUs << "us exceeds GOP" << m_gopUs << "us, switching to seek mode";
+            ok = decodeBySeek(m_nextTargetUs);
+            break;
+        }
+    }
+
+    av_packet_free(&pkt);
+    return ok;
+}
+
+bool FrameExtractor::decodeBySeek(qint64 startUs)
+{
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+    {
+        m_error = QStringLiteral("Failed to allocate packet");
+        return false;
+    }
+
+    m_nextTargetUs = startUs;
+    bool eof = false;
+    while (!eof && !m_abort && !reachedLimit())
+    {
+        const qint64 target = m_nextTargetUs;
+        int64_t ts = av_rescale_q(target, {1, 1000000}, m_timeBase);
+        if (av_seek_frame(m_formatCtx, m_streamIndex, ts, AVSEEK_FLAG_BACKWARD) < 0)
+        {
+            // seek失败：解码器未flush，从当前位置顺序解码剩余目标，避免静默截断
+            qWarning() << "Seek failed at" << target << "us, continuing sequentially";
+            while (!m_abort && !reachedLimit())
+            {
+                int ret = av_read_frame(m_formatCtx, pkt);
+                if (ret < 0)
+                {
+                    decodePacket(nullptr);
+                    break;
+                }
+                bool cont = true;
+                if (pkt->stream_index == m_streamIndex)
+                    cont = decodePacket(pkt);
+                av_packet_unref(pkt);
+                if (!cont)
+                    break;
+            }
+            break;
+        }
+        avcodec_flush_buffers(m_codecCtx);
+        m_result.seekCount++;
+
+        // 从目标前的关键帧开始解码，直到输出目标帧（m_nextTargetUs前移）
+        while (m_nextTargetUs == target && !m_abort)
+        {
+            int ret = av_read_frame(m_formatCtx, pkt);
+            if (ret < 0)
+            {
+                decodePacket(nullptr);
+                eof = true;
+                break;
+            }
+            bool cont = true;
+            if (pkt->stream_index == m_streamIndex)
+                cont = decodePacket(pkt);
+            av_packet_unref(pkt);
+            if (!cont)
+            {
+                eof = true;
+                break;
+            }
+        }
+    }
+
+    av_packet_free(&pkt);
+    return true;
+}
+
+bool FrameExtractor::decodePacket(AVPacket *pkt)
+{
+    int ret = avcodec_send_packet(m_codecCtx, pkt);
+    if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+        return true; // 单个坏包不终止抽帧
+
+    AVFrame *frame = av_frame_alloc();
+    if (!frame)
+        return false;
+
+    while (!m_abort)
+    {
+        ret = avcodec_receive_frame(m_codecCtx, frame);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF || ret < 0)
+            break;
+
+        m_result.decodedFrames++;
+        qint64 ptsUs = framePtsUs(frame);
+        if (shouldExtract(frame, ptsUs))
+            submitFrame(frame, ptsUs);
+        av_frame_unref(frame);
+
+        if (reachedLimit())
+            break;
+    }
+
+    av_frame_free(&frame);
+    return !m_abort && !reachedLimit();
+}
+
+bool FrameExtractor::shouldExtract(const AVFrame *frame, qint64 ptsUs)
+{
+    switch (m_options.mode)
+    {
+    case MODE_KEYFRAMES:
+        return (frame->flags & AV_FRAME_FLAG_KEY) || frame->pict_type == AV_PICTURE_TYPE_I;
+
+    case MODE_INTERVAL:
+    {
+        if (ptsUs < m_nextTargetUs)
+            return false;
+        // 跳过已经错过的目标时间点（流中存在空洞时）
+        const qint64 intervalUs = qMax<qint64>(1, m_options.intervalMs * 1000);
+        while (m_nextTargetUs <= ptsUs)
+            m_nextTargetUs += intervalUs;
+        return true;
+    }
+
+    case MODE_EVERY_NTH:
+    default:
+        return (m_frameCounter++ % qMax(1, m_options.everyN)) == 0;
+    }
+}
+
+void FrameExtractor::submitFrame(const AVFrame *frame, qint64 ptsUs)
+{
+    // 引用帧数据（不拷贝像素），在途任务满时阻塞解码，限制内存占用
+    AVFrame *ref = av_frame_clone(frame);
+    if (!ref)
+    {
+        m_failed.fetch_add(1);
+        return;
+    }
+    m_slots->acquire();
+
+    IndexEntry entry;
+    entry.index = m_result.extractedFrames++;
+    entry.ptsUs = ptsUs;
+    entry.keyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
+    entry.fileName = QStringLiteral("frame_%1.%2").arg(entry.index, 6, 10, QLatin1Char('0')).arg(m_options.format);
+    m_index.append(entry);
+
+    m_pool.start(new ScaleEncodeTask(ref, m_options.outWidth, m_options.outHeight,
+                                     QDir(m_options.outputDir).filePath(entry.fileName),
+                                     m_options.quality, &m_failed, m_slots));
+}
+
+qint64 FrameExtractor::framePtsUs(const AVFrame *frame) const
+{
+    int64_t pts = frame->best_effort_timestamp;
+    if (pts == AV_NOPTS_VALUE)
+        pts = (frame->pts != AV_NOPTS_VALUE) ? frame->pts : frame->pkt_dts;
+    if (pts == AV_NOPTS_VALUE)
+        return 0;
+    return av_rescale_q(pts, m_timeBase, {1, 1000000});
+}
+
+bool FrameExtractor::reachedLimit() const
+{
+    return m_options.maxFrames > 0 && m_result.extractedFrames >= m_options.maxFrames;
+}
+
+bool FrameExtractor::writeIndex()
+{
+    QFile file(QDir(m_options.outputDir).filePath(QStringLiteral("index.csv")));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        m_error = QStringLiteral("Cannot write index: %1").arg(file.fileName());
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "index,pts_us,pts_time,key_frame,file\n";
+    for (const IndexEntry &entry : m_index)
+    {
+        out << entry.index << ',' << entry.ptsUs << ','
+            << QString::number((entry.ptsUs - m_startTimeUs) / 1000000.0, 'f', 6) << ','
+            << (entry.keyFrame ? 1 : 0) << ',' << entry.fileName << '\n';
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+/*****************************************************************
+File:        frame_extractor.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 离线批量抽帧（无界面）
+             复用播放器的解码器初始化流程（FFmpegDecodeHelper），
+             缩放与图片编码在线程池中并行执行，整体吞吐受限于解码速度
+    抽帧模式：
+        1. 每N帧抽取一帧
+        2. 仅关键帧（解码器跳过非关键帧）
+        3. 固定时间间隔：间隔大于GOP时按关键帧seek跳过中间数据，否则顺序解码
+    输出：
+        按序号命名的图片 + PTS索引文件（index.csv）
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            seek失败时从当前位置顺序解码，不再直接结束
+*****************************************************************/
+
+#ifndef _FRAME_EXTRACTOR_H
+#define _FRAME_EXTRACTOR_H
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+class FrameExtractor
+{
+public:
+    enum Mode
+    {
+        MODE_EVERY_NTH,     // 每N帧
+        MODE_KEYFRAMES,     // 仅关键帧
+        MODE_INTERVAL       // 固定时间间隔
+    };
+
+    struct Options
+    {
+        QString input;                  ///< 输入文件或URL
+        QString outputDir;              ///< 输出目录
+        Mode mode = MODE_EVERY_NTH;
+        int everyN = 1;                 ///< MODE_EVERY_NTH：每N帧抽一帧
+        qint64 intervalMs = 1000;       ///< MODE_INTERVAL：时间间隔（毫秒）
+        int outWidth = 0;               ///< 输出宽度，0表示按高度等比或保持原尺寸
+        int outHeight = 0;              ///< 输出高度，0表示按宽度等比或保持原尺寸
+        QString format = QStringLiteral("jpg");
+        int quality = -1;               ///< 图片质量（0~100，-1为默认）
+        int maxFrames = 0;              ///< 最多输出帧数，0表示不限
+        int encodeThreads = 0;          ///< 编码线程数，0表示自动
+        int decodeThreads = 0;          ///< 解码线程数，0表示自动
+    };
+
+    struct Result
+    {
+        int decodedFrames = 0;          ///< 解码帧数
+        int extractedFrames = 0;        ///< 提交编码的帧数
+        int failedFrames = 0;           ///< 编码/保存失败的帧数
+        int seekCount = 0;              ///< 按关键帧seek的次数
+        qint64 elapsedMs = 0;
+    };
+
+    explicit FrameExtractor(const Options &options);
+    ~FrameExtractor();
+
+    /** 执行抽帧（阻塞直到全部图片写完） */
+    bool run();
+
+    /** 请求中止（可在其他线程调用） */
+    void abort() { m_abort = true; }
+
+    const Result &result() const { return m_result; }
+    const QString &errorString() const { return m_error; }
+
+private:
+    struct IndexEntry
+    {
+        int index;
+        qint64 ptsUs;
+        bool keyFrame;
+        QString fileName;
+    };
+
+    bool openInput();
+    void closeInput();
+
+    /** 顺序解码（每N帧/关键帧/小间隔） */
+    bool decodeSequential();
+    /** 按关键帧seek的间隔抽帧（间隔大于GOP时使用） */
+    bool decodeBySeek(qint64 startUs);
+
+    /** 向解码器送入一个包并处理所有输出帧，返回false表示应停止 */
+    bool decodePacket(AVPacket *pkt);
+    /** 判断解码出的帧是否需要输出 */
+    bool shouldExtract(const AVFrame *frame, qint64 ptsUs);
+    /** 引用帧并提交到线程池缩放+编码 */
+    void submitFrame(const AVFrame *frame, qint64 ptsUs);
+
+    qint64 framePtsUs(const AVFrame *frame) const;
+    bool reachedLimit() const;
+    bool writeIndex();
+
+    Options m_options;
+    Result m_result;
+    QString m_error;
+    std::atomic<bool> m_abort{false};
+
+    AVFormatContext *m_formatCtx = nullptr;
+    AVCodecContext *m_codecCtx = nullptr;
+    int m_streamIndex = -1;
+    AVRational m_timeBase = {1, 1000000};
+    qint64 m_startTimeUs = 0;
+
+    // 抽帧状态
+    int m_frameCounter = 0;
+    qint64 m_nextTargetUs = 0;          ///< MODE_INTERVAL：下一个目标时间
+    qint64 m_lastKeyPtsUs = -1;         ///< 最近一个关键帧包的时间
+    qint64 m_gopUs = -1;                ///< 观测到的最大GOP时长
+
+    // 编码线程池与背压控制
+    QThreadPool m_pool;
+    QSemaphore *m_slots = nullptr;      ///< 在途任务上限，防止解码远快于编码时内存膨胀
+    std::atomic<int> m_failed{0};
+
+    QVector<IndexEntry> m_index;
+};
+
+#endif // _FRAME_EXTRACTOR_H
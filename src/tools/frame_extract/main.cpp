@@ -0,0 +1,97 @@
+/*****************************************************************
+File:        main.cpp
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: frame_extract 离线抽帧工具入口
+    用法示例：
+        frame_extract -i input.mp4 -o out --mode nth -n 25
+        frame_extract -i input.mp4 -o out --mode key --width 640
+        frame_extract -i input.mp4 -o out --mode interval --interval-ms 10000 --format png
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            新增--decode-threads
+*****************************************************************/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "frame_extractor.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("frame_extract");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless batch frame extraction");
+    parser.addHelpOption();
+
+    QCommandLineOption inputOpt({"i", "input"}, "Input file or URL.", "path");
+    QCommandLineOption outputOpt({"o", "output"}, "Output directory.", "dir");
+    QCommandLineOption modeOpt("mode", "Extraction mode: nth | key | interval.", "mode", "nth");
+    QCommandLineOption everyOpt({"n", "every"}, "nth mode: extract every N frames.", "N", "1");
+    QCommandLineOption intervalOpt("interval-ms", "interval mode: interval in milliseconds.", "ms", "1000");
+    QCommandLineOption widthOpt("width", "Output width (0 = keep / follow height).", "px", "0");
+    QCommandLineOption heightOpt("height", "Output height (0 = keep / follow width).", "px", "0");
+    QCommandLineOption formatOpt("format", "Image format: jpg | png.", "fmt", "jpg");
+    QCommandLineOption qualityOpt("quality", "Image quality 0-100 (-1 = default).", "q", "-1");
+    QCommandLineOption maxOpt("max", "Maximum number of frames (0 = unlimited).", "count", "0");
+    QCommandLineOption threadsOpt("threads", "Encoding threads (0 = auto).", "count", "0");
+    QCommandLineOption decodeThreadsOpt("decode-threads", "Decoding threads (0 = auto).", "count", "0");
+    parser.addOptions({inputOpt, outputOpt, modeOpt, everyOpt, intervalOpt, widthOpt, heightOpt,
+                       formatOpt, qualityOpt, maxOpt, threadsOpt, decodeThreadsOpt});
+    parser.process(app);
+
+    if (!parser.isSet(inputOpt) || !parser.isSet(outputOpt))
+    {
+        qCritical() << "Both --input and --output are required";
+        parser.showHelp(1);
+    }
+
+    FrameExtractor::Options options;
+    options.input = parser.value(inputOpt);
+    options.outputDir = parser.value(outputOpt);
+    options.everyN = parser.value(everyOpt).toInt();
+    options.intervalMs = parser.value(intervalOpt).toLongLong();
+    options.outWidth = parser.value(widthOpt).toInt();
+    options.outHeight = parser.value(heightOpt).toInt();
+    options.format = parser.value(formatOpt).toLower();
+    options.quality = parser.value(qualityOpt).toInt();
+    options.maxFrames = parser.value(maxOpt).toInt();
+    options.encodeThreads = parser.value(threadsOpt).toInt();
+    options.decodeThreads = parser.value(decodeThreadsOpt).toInt();
+
+    const QString mode = parser.value(modeOpt).toLower();
+    if (mode == "nth")
+        options.mode = FrameExtractor::MODE_EVERY_NTH;
+    else if (mode == "key")
+        options.mode = FrameExtractor::MODE_KEYFRAMES;
+    else if (mode == "interval")
+        options.mode = FrameExtractor::MODE_INTERVAL;
+    else
+    {
+        qCritical() << "Unknown mode:" << mode;
+        return 1;
+    }
+
+    FrameExtractor extractor(options);
+    bool ok = extractor.run();
+
+    const FrameExtractor::Result &result = extractor.result();
+    qInfo().noquote() << QString("decoded: %1, extracted: %2, failed: %3, seeks: %4, elapsed: %5 ms")
+                             .arg(result.decodedFrames)
+                             .arg(result.extractedFrames)
+                             .arg(result.failedFrames)
+                             .arg(result.seekCount)
+                             .arg(result.elapsedMs);
+    if (!ok)
+    {
+        qCritical().noquote() << extractor.errorString();
+        return 1;
+    }
+    return result.failedFrames > 0 ? 2 : 0;
+}
@@ -0,0 +1,93 @@
+/*****************************************************************
+File:        main.cpp
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: soak_runner 多路播放浸泡测试入口（默认以offscreen平台运行）
+    用法示例：
+        soak_runner -i a.mp4 -i b.mkv --players 8 --duration-min 240 --csv soak.csv
+        soak_runner -i rtsp://127.0.0.1:8554/cam --players 4 \
+            --feeder "ffmpeg -re -stream_loop -1 -i clip.mp4 -c copy -f rtsp rtsp://127.0.0.1:8554/cam"
+        soak_runner -i a.mp4 --players 4 --duration-min 30 --virtual-clock
+    退出码：0通过，1参数/启动错误，3检测到增长趋势
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            新增--virtual-clock
+*****************************************************************/
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include "soak_runner.h"
+
+int main(int argc, char *argv[])
+{
+    // 默认无界面运行，便于在CI/服务器上长时间执行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("soak_runner");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Long-running multi-stream playback soak test");
+    parser.addHelpOption();
+
+    QCommandLineOption inputOpt({"i", "input"}, "Input file or URL (repeatable).", "path");
+    QCommandLineOption playersOpt("players", "Number of players (0 = one per input).", "N", "0");
+    QCommandLineOption durationOpt("duration-min", "Total duration in minutes.", "min", "60");
+    QCommandLineOption warmupOpt("warmup-min", "Warmup excluded from trend checks, in minutes.", "min", "5");
+    QCommandLineOption actionOpt("action-ms", "Interval between random actions.", "ms", "5000");
+    QCommandLineOption sampleOpt("sample-ms", "Interval between resource samples.", "ms", "10000");
+    QCommandLineOption csvOpt("csv", "Write samples to CSV file.", "path");
+    QCommandLineOption feederOpt("feeder", "Command that serves the loopback RTSP stand-in (restarted to break the link for reconnect actions).", "cmd");
+    QCommandLineOption seedOpt("seed", "Random seed for the action sequence.", "n", "1");
+    QCommandLineOption openglOpt("opengl", "Render with OpenGL instead of software.");
+    QCommandLineOption virtualClockOpt("virtual-clock", "Drive each decoder with a virtual clock (plays as fast as it decodes).");
+    QCommandLineOption rssOpt("max-rss-mb-per-hour", "RSS growth limit.", "MB", "32");
+    QCommandLineOption fdOpt("max-fd-per-hour", "File descriptor growth limit.", "n", "8");
+    QCommandLineOption threadOpt("max-threads-per-hour", "Thread count growth limit.", "n", "4");
+    QCommandLineOption latencyOpt("max-latency-growth-pct", "Per-action latency growth limit in percent.", "pct", "50");
+    parser.addOptions({inputOpt, playersOpt, durationOpt, warmupOpt, actionOpt, sampleOpt, csvOpt,
+                       feederOpt, seedOpt, openglOpt, virtualClockOpt, rssOpt, fdOpt, threadOpt, latencyOpt});
+    parser.process(app);
+
+    if (!parser.isSet(inputOpt))
+    {
+        qCritical() << "At least one --input is required";
+        parser.showHelp(1);
+    }
+
+    SoakRunner::Options options;
+    options.inputs = parser.values(inputOpt);
+    options.players = parser.value(playersOpt).toInt();
+    options.durationMs = static_cast<qint64>(parser.value(durationOpt).toDouble() * 60000);
+    options.warmupMs = static_cast<qint64>(parser.value(warmupOpt).toDouble() * 60000);
+    options.actionIntervalMs = qMax(100, parser.value(actionOpt).toInt());
+    options.sampleIntervalMs = qMax(1000, parser.value(sampleOpt).toInt());
+    options.csvPath = parser.value(csvOpt);
+    options.feederCommand = parser.value(feederOpt);
+    options.seed = parser.value(seedOpt).toUInt();
+    options.useOpenGL = parser.isSet(openglOpt);
+    options.virtualClock = parser.isSet(virtualClockOpt);
+    options.maxRssGrowthMBPerHour = parser.value(rssOpt).toDouble();
+    options.maxFdGrowthPerHour = parser.value(fdOpt).toDouble();
+    options.maxThreadGrowthPerHour = parser.value(threadOpt).toDouble();
+    options.maxLatencyGrowthPercent = parser.value(latencyOpt).toDouble();
+
+    SoakRunner runner(options);
+    int exitCode = 1;
+    QObject::connect(&runner, &SoakRunner::finished, &app, [&exitCode](bool passed) {
+        exitCode = passed ? 0 : 3;
+        QCoreApplication::quit();
+    });
+
+    if (!runner.start())
+        return 1;
+
+    app.exec();
+    return exitCode;
+}
@@ -0,0 +1,644 @@
+#include "soak_runner.h"
+
+#include "view/widget/player/ffmpeg_player_widget.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QTextStream>
+
+#include <cmath>
+
+#define SEEK_PTS_TOLERANCE_MS 500       // 跳转后时间戳与目标相差不超过该值的帧视为跳转完成
+#define LATENCY_TIMEOUT_MS 30000        // 操作后超过该时长仍无满足条件的帧记为错误
+#define FEEDER_RESTART_DELAY_MS 1000    // 断开链路后替身推流停止的时长，保证播放器感知到断流
+
+SoakRunner::SoakRunner(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_random(options.seed)
+{
+    if (m_options.players <= 0)
+        m_options.players = m_options.inputs.size();
+
+    m_actionTimer.setInterval(m_options.actionIntervalMs);
+    m_sampleTimer.setInterval(m_options.sampleIntervalMs);
+    m_probeTimer.setInterval(500);
+    connect(&m_actionTimer, &QTimer::timeout, this, &SoakRunner::performRandomAction);
+    connect(&m_sampleTimer, &QTimer::timeout, this, &SoakRunner::takeSample);
+    connect(&m_probeTimer, &QTimer::timeout, this, &SoakRunner::probeLatency);
+}
+
+SoakRunner::~SoakRunner()
+{
+    for (PlayerSlot &slot : m_slots)
+    {
+        if (slot.decoder && slot.sink)
+            slot.decoder->removeVideoSink(slot.sink);
+        delete slot.player;
+    }
+    m_slots.clear();
+
+    stopFeeder();
+}
+
+bool SoakRunner::start()
+{
+    if (m_options.inputs.isEmpty())
+    {
+        qCritical() << "SoakRunner: no inputs";
+        return false;
+    }
+
+    // 可选的RTSP替身推流（例如将本地文件循环推到回环地址上的RTSP服务）
+    if (!m_options.feederCommand.isEmpty() && !startFeeder())
+        return false;
+
+    if (!m_options.csvPath.isEmpty())
+    {
+        m_csv.setFileName(m_options.csvPath);
+        if (!m_csv.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            qCritical() << "SoakRunner: cannot write" << m_options.csvPath;
+            return false;
+        }
+        QTextStream out(&m_csv);
+        out << "elapsed_ms,rss_kb,fds,threads,errors";
+        for (int i = 0; i < ACTION_COUNT; ++i)
+            out << ',' << actionName(i) << "_ms";
+        for (int i = 0; i < STAGE_COUNT; ++i)
+            out << ',' << stageName(i) << "_ms";
+        out << '\n';
+    }
+
+    m_slots.resize(m_options.players);
+    for (int i = 0; i < m_slots.size(); ++i)
+    {
+        PlayerSlot &slot = m_slots[i];
+        slot.player = new FFmpegPlayer();
+        slot.player->setUseOpenGL(m_options.useOpenGL);
+        slot.player->resize(320, 180);
+        slot.player->setWindowTitle(QString("soak-%1").arg(i));
+        // 必须显示，隐藏的播放器会跳过视频解码
+        slot.player->show();
+
+        slot.decoder = slot.player->findChild<FFmpegDecoderThread *>();
+        PlayerWidgetBase *core = slot.player->PlayerCore();
+
+        // 虚拟时钟须在首次打开前设置，之后重开/切换沿用同一时钟
+        if (slot.decoder && m_options.virtualClock)
+            slot.decoder->setMediaClock(std::make_shared<VirtualMediaClock>());
+
+        // 错误默认弹出模态对话框，浸泡测试中改为计数
+        if (slot.decoder)
+        {
+            disconnect(slot.decoder, &FFmpegDecoderThread::errorOccurred, core, &PlayerWidgetBase::errorInfoShow);
+            connect(slot.decoder, &FFmpegDecoderThread::errorOccurred, this, [this, i](const QString &error) {
+                m_errorCount++;
+                qWarning() << "SoakRunner: player" << i << "error:" << error;
+            });
+
+            // 播放到结尾时解码线程退出，重新打开以循环播放
+            connect(slot.decoder, &QThread::finished, this, [this, i]() {
+                PlayerSlot &s = m_slots[i];
+                if (m_elapsed.isValid() && s.decoder && !s.decoder->isRunning())
+                    openInput(s, s.inputIndex, ACTION_OPEN);
+            }, Qt::QueuedConnection);
+
+            // 打开类操作只统计新一轮解码的帧
+            connect(slot.decoder, &QThread::started, this, [this, i]() {
+                m_slots[i].waitRestart = false;
+            }, Qt::QueuedConnection);
+
+            // 断链后重连成功即为重连操作完成
+            connect(slot.decoder, &FFmpegDecoderThread::networkReconnected, this, [this, i]() {
+                PlayerSlot &s = m_slots[i];
+                if (s.pendingAction != ACTION_RECONNECT)
+                    return;
+                m_latencySumMs[ACTION_RECONNECT] += s.actionTimer.elapsed();
+                m_latencyCount[ACTION_RECONNECT]++;
+                s.pendingAction = -1;
+            }, Qt::QueuedConnection);
+
+            // 显示帧的时间戳（只取时间戳，不做格式转换）
+            slot.sink = new VideoFrameSink(this);
+            connect(slot.sink, &VideoFrameSink::frameAvailable, this, [this, i]() {
+                onFrameArrived(i);
+            }, Qt::QueuedConnection);
+            slot.decoder->addVideoSink(slot.sink);
+        }
+
+        connect(core, &PlayerWidgetBase::currentDuration, this, [this, i](long long len) {
+            m_slots[i].durationMs = len;
+        });
+
+        openInput(slot, i % m_options.inputs.size(), ACTION_OPEN);
+    }
+
+    m_elapsed.start();
+    m_actionTimer.start();
+    m_sampleTimer.start();
+    m_probeTimer.start();
+    QTimer::singleShot(m_options.durationMs, this, &SoakRunner::finish);
+
+    qInfo() << "SoakRunner: started" << m_slots.size() << "players for" << m_options.durationMs / 1000 << "s";
+    takeSample();
+    return true;
+}
+
+// 按空白拆分命令行，双引号内的空白保留（与QProcess::splitCommand一致，Qt 5.15之前无该接口）
+static QStringList splitCommand(const QString &command)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    return QProcess::splitCommand(command);
+#else
+    QStringList args;
+    QString arg;
+    bool inQuote = false;
+    bool hasArg = false;
+    for (int i = 0; i < command.size(); ++i)
+    {
+        const QChar c = command.at(i);
+        if (c == QLatin1Char('"'))
+        {
+            // 引号内连续两个引号表示一个字面引号
+            if (inQuote && i + 1 < command.size() && command.at(i + 1) == QLatin1Char('"'))
+            {
+                arg += c;
+                ++i;
+            }
+            else
+            {
+                inQuote = !inQuote;
+            }
+            hasArg = true;
+        }
+        else if (!inQuote && c.isSpace())
+        {
+            if (hasArg)
+                args << arg;
+            arg.clear();
+            hasArg = false;
+        }
+        else
+        {
+            arg += c;
+            hasArg = true;
+        }
+    }
+    if (hasArg)
+        args << arg;
+    return args;
+#endif
+}
+
+bool SoakRunner::startFeeder()
+{
+    QStringList args = splitCommand(m_options.feederCommand);
+    if (args.isEmpty())
+    {
+        qCritical() << "SoakRunner: invalid feeder command";
+        return false;
+    }
+    QString program = args.takeFirst();
+    m_feeder.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    m_feeder.start(program, args);
+    if (!m_feeder.waitForStarted(5000))
+    {
+        qCritical() << "SoakRunner: failed to start feeder" << m_options.feederCommand;
+        return false;
+    }
+    return true;
+}
+
+void SoakRunner::stopFeeder()
+{
+    if (m_feeder.state() != QProcess::NotRunning)
+    {
+        m_feeder.terminate();
+        if (!m_feeder.waitForFinished(3000))
+            m_feeder.kill();
+    }
+}
+
+/**
+ * @brief 断开网络链路：停止替身推流，间隔后重新拉起
+ * 替身推流由所有网络输入共用，断开后每路网络播放器都要自动重连，分别计时到networkReconnected
+ */
+void SoakRunner::breakNetworkLink()
+{
+    for (PlayerSlot &slot : m_slots)
+    {
+        if (!slot.paused && isNetworkUrl(m_options.inputs.at(slot.inputIndex)))
+            beginLatency(slot, ACTION_RECONNECT);
+    }
+
+    stopFeeder();
+    m_feederRestarting = true;
+    QTimer::singleShot(FEEDER_RESTART_DELAY_MS, this, [this]() {
+        m_feederRestarting = false;
+        if (m_elapsed.isValid() && !startFeeder())
+            m_errorCount++;
+    });
+}
+
+void SoakRunner::openInput(PlayerSlot &slot, int inputIndex, Action action)
+{
+    slot.inputIndex = inputIndex;
+    slot.durationMs = 0;
+    slot.paused = false;
+    beginLatency(slot, action);
+
+    const QString input = m_options.inputs.at(inputIndex);
+    PlayerWidgetBase *core = slot.player->PlayerCore();
+    if (isNetworkUrl(input))
+    {
+        slot.player->setAutoReconnect(true, 10);
+        emit core->setPlayerUrl(input);
+    }
+    else
+    {
+        emit core->setPlayerFile(input);
+    }
+}
+
+void SoakRunner::performRandomAction()
+{
+    if (m_slots.isEmpty())
+        return;
+
+    PlayerSlot &slot = m_slots[m_random.bounded(m_slots.size())];
+    PlayerWidgetBase *core = slot.player->PlayerCore();
+
+    // 断链重连进行中不叠加其他操作，避免打断重连计时
+    if (m_feederRestarting || slot.pendingAction == ACTION_RECONNECT)
+        return;
+
+    // 暂停中的播放器先恢复，避免长期停在暂停状态
+    if (slot.paused)
+    {
+        emit core->changePlayState();
+        slot.paused = false;
+        beginLatency(slot, ACTION_PAUSE);
+        return;
+    }
+
+    const int action = 1 + m_random.bounded(ACTION_COUNT - 1);
+    switch (action)
+    {
+    case ACTION_SEEK:
+        if (slot.durationMs > 0)
+        {
+            beginLatency(slot, ACTION_SEEK);
+            slot.seekTargetMs = m_random.bounded(slot.durationMs);
+            emit core->seekPlay(slot.seekTargetMs);
+        }
+        break;
+    case ACTION_RATE:
+    {
+        // 倍速切换没有可观测的完成时刻，不统计延迟
+        static const float rates[] = {0.5f, 1.0f, 1.5f, 2.0f};
+        emit core->setPlaybackRate(rates[m_random.bounded(4)]);
+        break;
+    }
+    case ACTION_PAUSE:
+        emit core->changePlayState();
+        slot.paused = true;
+        slot.pendingAction = -1;
+        break;
+    case ACTION_RECONNECT:
+        // 需要真实断开链路，只对网络输入且替身推流在运行时执行
+        if (isNetworkUrl(m_options.inputs.at(slot.inputIndex)) && m_feeder.state() == QProcess::Running)
+            breakNetworkLink();
+        break;
+    case ACTION_SWITCH:
+        openInput(slot, (slot.inputIndex + 1) % m_options.inputs.size(), ACTION_SWITCH);
+        break;
+    default:
+        break;
+    }
+}
+
+void SoakRunner::beginLatency(PlayerSlot &slot, Action action)
+{
+    slot.pendingAction = action;
+    slot.waitRestart = action == ACTION_OPEN || action == ACTION_SWITCH;
+    slot.seekTargetMs = -1;
+    slot.actionTimer.start();
+}
+
+/**
+ * @brief 显示帧到达（解码线程投递到显示阶段）：累计解码端各阶段耗时，判断待测操作是否完成
+ * 打开类操作等待解码线程重新启动，跳转等待时间戳落在目标附近，旧帧不会被误判为完成
+ */
+void SoakRunner::onFrameArrived(int index)
+{
+    PlayerSlot &slot = m_slots[index];
+    VideoFramePtr frame;
+    qint64 ptsMs = 0;
+    if (!slot.sink->takeLatestFrame(frame, &ptsMs))
+        return;
+    frame.reset();  // 只需要时间戳，尽早归还解码器缓冲
+
+    std::shared_ptr<const PerfHudCounters> counters = slot.decoder->perfCounters();
+    const qint64 decodeUs = counters->decodeUs.load(std::memory_order_relaxed);
+    const qint64 convertUs = counters->convertUs.load(std::memory_order_relaxed);
+    if (decodeUs >= 0)
+        addStage(STAGE_DECODE, decodeUs / 1000.0);
+    if (convertUs >= 0)
+        addStage(STAGE_CONVERT, convertUs / 1000.0);
+
+    // 重连以networkReconnected为准，断流前缓冲的帧不算
+    if (slot.pendingAction < 0 || slot.pendingAction == ACTION_RECONNECT || slot.waitRestart)
+        return;
+    if (slot.pendingAction == ACTION_SEEK && qAbs(ptsMs - slot.seekTargetMs) > SEEK_PTS_TOLERANCE_MS)
+        return;
+
+    m_latencySumMs[slot.pendingAction] += slot.actionTimer.elapsed();
+    m_latencyCount[slot.pendingAction]++;
+    slot.pendingAction = -1;
+}
+
+/**
+ * @brief 检查待测操作是否超时
+ */
+void SoakRunner::probeLatency()
+{
+    for (PlayerSlot &slot : m_slots)
+    {
+        if (slot.pendingAction >= 0 && slot.actionTimer.elapsed() > LATENCY_TIMEOUT_MS)
+        {
+            qWarning() << "SoakRunner: no matching frame within" << LATENCY_TIMEOUT_MS / 1000
+                       << "s after" << actionName(slot.pendingAction);
+            m_errorCount++;
+            slot.pendingAction = -1;
+        }
+    }
+}
+
+void SoakRunner::addStage(Stage stage, double ms, int count)
+{
+    m_stageSumMs[stage] += ms * count;
+    m_stageCount[stage] += count;
+}
+
+/**
+ * @brief 取渲染端本窗口的上传/上屏平均耗时并清零（仅OpenGL渲染有这两项统计）
+ */
+void SoakRunner::collectRenderStages()
+{
+#if OPENGL_AVAILABLE
+    for (PlayerSlot &slot : m_slots)
+    {
+        // 渲染组件可能在回退软件渲染时重建，每次重新查找
+        OpenGLVideoWidget *glWidget = slot.player->findChild<OpenGLVideoWidget *>();
+        if (!glWidget || !slot.player->isUsingOpenGL())
+            continue;
+
+        const OpenGLVideoWidget::UploadStats upload = glWidget->getUploadStats();
+        if (upload.frames > 0)
+            addStage(STAGE_UPLOAD, upload.avgUploadMs, static_cast<int>(upload.frames));
+        glWidget->resetUploadStats();
+
+        const OpenGLVideoWidget::PresentStats present = glWidget->getPresentStats();
+        if (present.presentedFrames > 0)
+            addStage(STAGE_PRESENT, present.avgLatencyMs, static_cast<int>(present.presentedFrames));
+        glWidget->resetPresentStats();
+    }
+#endif
+}
+
+void SoakRunner::takeSample()
+{
+    collectRenderStages();
+
+    Sample sample;
+    sample.elapsedMs = m_elapsed.isValid() ? m_elapsed.elapsed() : 0;
+    sample.rssKB = readRssKB();
+    sample.fdCount = readFdCount();
+    sample.threadCount = readThreadCount();
+    sample.errors = m_errorCount;
+    for (int i = 0; i < ACTION_COUNT; ++i)
+    {
+        sample.latencyCount[i] = m_latencyCount[i];
+        sample.latencyMs[i] = m_latencyCount[i] > 0 ? m_latencySumMs[i] / m_latencyCount[i] : 0.0;
+        m_latencySumMs[i] = 0.0;
+        m_latencyCount[i] = 0;
+    }
+    for (int i = 0; i < STAGE_COUNT; ++i)
+    {
+        sample.stageCount[i] = m_stageCount[i];
+        sample.stageMs[i] = m_stageCount[i] > 0 ? m_stageSumMs[i] / m_stageCount[i] : 0.0;
+        m_stageSumMs[i] = 0.0;
+        m_stageCount[i] = 0;
+    }
+    m_samples.append(sample);
+
+    if (m_csv.isOpen())
+    {
+        QTextStream out(&m_csv);
+        out << sample.elapsedMs << ',' << sample.rssKB << ',' << sample.fdCount << ','
+            << sample.threadCount << ',' << sample.errors;
+        for (int i = 0; i < ACTION_COUNT; ++i)
+            out << ',' << QString::number(sample.latencyMs[i], 'f', 1);
+        for (int i = 0; i < STAGE_COUNT; ++i)
+            out << ',' << QString::number(sample.stageMs[i], 'f', 2);
+        out << '\n';
+        out.flush();
+    }
+
+    qInfo().noquote() << QString("[%1 s] rss: %2 MB, fds: %3, threads: %4, errors: %5, "
+                                 "decode/convert/upload/present: %6/%7/%8/%9 ms")
+                             .arg(sample.elapsedMs / 1000)
+                             .arg(sample.rssKB / 1024.0, 0, 'f', 1)
+                             .arg(sample.fdCount)
+                             .arg(sample.threadCount)
+                             .arg(sample.errors)
+                             .arg(sample.stageMs[STAGE_DECODE], 0, 'f', 2)
+                             .arg(sample.stageMs[STAGE_CONVERT], 0, 'f', 2)
+                             .arg(sample.stageMs[STAGE_UPLOAD], 0, 'f', 2)
+                             .arg(sample.stageMs[STAGE_PRESENT], 0, 'f', 2);
+}
+
+void SoakRunner::finish()
+{
+    m_actionTimer.stop();
+    m_probeTimer.stop();
+    m_sampleTimer.stop();
+    takeSample();
+
+    evaluate();
+    for (const QString &failure : m_failures)
+        qCritical().noquote() << "FAIL:" << failure;
+    if (m_failures.isEmpty())
+        qInfo() << "SoakRunner: PASS";
+
+    // 停止循环播放后再关闭播放器
+    m_elapsed.invalidate();
+    for (PlayerSlot &slot : m_slots)
+        slot.player->stop();
+
+    emit finished(m_failures.isEmpty());
+}
+
+void SoakRunner::evaluate()
+{
+    // 剔除预热期
+    QVector<Sample> steady;
+    for (const Sample &sample : m_samples)
+    {
+        if (sample.elapsedMs >= m_options.warmupMs)
+            steady.append(sample);
+    }
+    if (steady.size() < 4)
+    {
+        m_failures << QString("not enough samples after warmup (%1)").arg(steady.size());
+        return;
+    }
+
+    // 资源增长趋势
+    if (steady.first().rssKB >= 0)
+    {
+        double rss = slopePerHour(steady, [](const Sample &s) { return s.rssKB / 1024.0; });
+        if (rss > m_options.maxRssGrowthMBPerHour)
+            m_failures << QString("RSS grows %1 MB/h (limit %2)").arg(rss, 0, 'f', 2).arg(m_options.maxRssGrowthMBPerHour);
+        double fds = slopePerHour(steady, [](const Sample &s) { return static_cast<double>(s.fdCount); });
+        if (fds > m_options.maxFdGrowthPerHour)
+            m_failures << QString("fd count grows %1 /h (limit %2)").arg(fds, 0, 'f', 2).arg(m_options.maxFdGrowthPerHour);
+        double threads = slopePerHour(steady, [](const Sample &s) { return static_cast<double>(s.threadCount); });
+        if (threads > m_options.maxThreadGrowthPerHour)
+            m_failures << QString("thread count grows %1 /h (limit %2)").arg(threads, 0, 'f', 2).arg(m_options.maxThreadGrowthPerHour);
+    }
+    else
+    {
+        qWarning() << "SoakRunner: /proc not available, resource trends not checked";
+    }
+
+    // 各操作延迟与各阶段耗时：比较前后1/4窗口的加权均值
+    const int quarter = qMax(1, steady.size() / 4);
+    auto checkGrowth = [&](const QString &name, double minGrowthMs,
+                           double (*value)(const Sample &, int), int (*count)(const Sample &, int), int index) {
+        auto windowMean = [&](int begin, int end) {
+            double sum = 0.0;
+            int n = 0;
+            for (int i = begin; i < end; ++i)
+            {
+                sum += value(steady[i], index) * count(steady[i], index);
+                n += count(steady[i], index);
+            }
+            return n > 0 ? sum / n : -1.0;
+        };
+        double head = windowMean(0, quarter);
+        double tail = windowMean(steady.size() - quarter, steady.size());
+        if (head <= 0.0 || tail <= 0.0)
+            return;
+
+        qInfo().noquote() << QString("%1: %2 ms -> %3 ms").arg(name).arg(head, 0, 'f', 2).arg(tail, 0, 'f', 2);
+        if (tail - head > minGrowthMs && (tail - head) * 100.0 / head > m_options.maxLatencyGrowthPercent)
+        {
+            m_failures << QString("%1 grows %2 ms -> %3 ms").arg(name).arg(head, 0, 'f', 2).arg(tail, 0, 'f', 2);
+        }
+    };
+
+    for (int action = 0; action < ACTION_COUNT; ++action)
+    {
+        checkGrowth(actionName(action) + " latency", m_options.minLatencyGrowthMs,
+                    [](const Sample &s, int i) { return s.latencyMs[i]; },
+                    [](const Sample &s, int i) { return s.latencyCount[i]; }, action);
+    }
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        checkGrowth(stageName(stage) + " time", m_options.minStageGrowthMs,
+                    [](const Sample &s, int i) { return s.stageMs[i]; },
+                    [](const Sample &s, int i) { return s.stageCount[i]; }, stage);
+    }
+}
+
+QString SoakRunner::actionName(int action)
+{
+    switch (action)
+    {
+    case ACTION_OPEN:      return "open";
+    case ACTION_SEEK:      return "seek";
+    case ACTION_RATE:      return "rate";
+    case ACTION_PAUSE:     return "resume";
+    case ACTION_RECONNECT: return "reconnect";
+    case ACTION_SWITCH:    return "switch";
+    default:               return "unknown";
+    }
+}
+
+QString SoakRunner::stageName(int stage)
+{
+    switch (stage)
+    {
+    case STAGE_DECODE:  return "decode";
+    case STAGE_CONVERT: return "convert";
+    case STAGE_UPLOAD:  return "upload";
+    case STAGE_PRESENT: return "present";
+    default:            return "unknown";
+    }
+}
+
+bool SoakRunner::isNetworkUrl(const QString &url)
+{
+    return url.startsWith("rtsp://") || url.startsWith("http://") || url.startsWith("https://");
+}
+
+qint64 SoakRunner::readRssKB()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    for (const QByteArray &line : file.readAll().split('\n'))
+    {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+int SoakRunner::readThreadCount()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    for (const QByteArray &line : file.readAll().split('\n'))
+    {
+        if (line.startsWith("Threads:"))
+            return line.mid(8).trimmed().toInt();
+    }
+    return -1;
+}
+
+int SoakRunner::readFdCount()
+{
+    QDir dir("/proc/self/fd");
+    if (!dir.exists())
+        return -1;
+    return dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System).size();
+}
+
+/**
+ * @brief 最小二乘线性回归斜率，换算为每小时增量
+ */
+double SoakRunner::slopePerHour(const QVector<Sample> &samples, double (*value)(const Sample &))
+{
+    const int n = samples.size();
+    double meanX = 0.0, meanY = 0.0;
+    for (const Sample &s : samples)
+    {
+        meanX += s.elapsedMs / 3600000.0;
+        meanY += value(s);
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double num = 0.0, den = 0.0;
+    for (const Sample &s : samples)
+    {
+        double dx = s.elapsedMs / 3600000.0 - meanX;
+        num += dx * (value(s) - meanY);
+        den += dx * dx;
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
@@ -0,0 +1,179 @@
+/*****************************************************************
+File:        soak_runner.h
+Version:     1.3
+Author:      cjx
+Date:        2026-10-19
+Description: 多路播放长时间浸泡测试
+             同时播放N路本地文件或本地RTSP替身流并循环，定期通过PlayerWidgetBase信号
+             执行跳转、倍速、暂停、重连、切换媒体，按固定间隔采样进程RSS、句柄数、线程数、
+             各操作的完成延迟以及解码/转换/上传/上屏各阶段耗时，结束时按增长趋势判定是否通过
+    延迟口径（显示帧经挂接在解码线程上的VideoFrameSink取得时间戳）：
+        打开/切换：解码线程重新启动后的第一帧；跳转：时间戳落在目标附近的第一帧；恢复：恢复后的第一帧
+        重连：重启替身推流进程断开链路，到各路网络播放器发出networkReconnected为止
+              （仅对网络输入且配置了--feeder时执行）
+    判定规则：
+        1. 预热期之后的采样做线性回归，RSS/句柄/线程增长斜率超过阈值即失败
+        2. 各操作延迟与各阶段耗时：后1/4采样窗口均值相对前1/4增长超过比例且超过绝对下限即失败
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            延迟改为按帧时间戳判定操作完成，并采样各阶段耗时
+3             2026-10-19     cjx            重连操作改为重启替身推流断开链路，测到networkReconnected的耗时
+4             2026-10-19     cjx            可选虚拟时钟，各路解码不按实时节奏等待，压缩浸泡时长
+5             2026-10-19     cjx            Qt 5.15之前手动拆分替身推流命令行
+*****************************************************************/
+
+#ifndef _SOAK_RUNNER_H
+#define _SOAK_RUNNER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMap>
+#include <QObject>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class FFmpegPlayer;
+class FFmpegDecoderThread;
+class VideoFrameSink;
+
+class SoakRunner : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options
+    {
+        QStringList inputs;                 // 本地文件或rtsp/http地址
+        int players = 0;                    // 播放器数量（0=与输入数相同）
+        qint64 durationMs = 3600000;        // 总时长
+        qint64 warmupMs = 300000;           // 预热时长（不参与趋势判定）
+        int actionIntervalMs = 5000;        // 操作间隔
+        int sampleIntervalMs = 10000;       // 采样间隔
+        QString csvPath;                    // 采样输出（为空不输出）
+        QString feederCommand;              // RTSP替身推流命令（可选，启动时拉起，重连操作时重启，结束时结束）
+        quint32 seed = 1;                   // 随机种子，保证操作序列可复现
+        bool useOpenGL = false;
+        bool virtualClock = false;          // 各路解码线程使用独立的虚拟时钟（以CPU速度播放）
+
+        // 判定阈值
+        double maxRssGrowthMBPerHour = 32.0;
+        double maxFdGrowthPerHour = 8.0;
+        double maxThreadGrowthPerHour = 4.0;
+        double maxLatencyGrowthPercent = 50.0;
+        qint64 minLatencyGrowthMs = 50;
+        double minStageGrowthMs = 2.0;      // 单帧阶段耗时增长的绝对下限
+    };
+
+    explicit SoakRunner(const Options &options, QObject *parent = nullptr);
+    ~SoakRunner() override;
+
+    /** 启动测试，结束时发出finished */
+    bool start();
+
+    /** 判定失败原因，为空表示通过 */
+    QStringList failures() const { return m_failures; }
+
+signals:
+    void finished(bool passed);
+
+private:
+    // 单个操作类型（也是延迟统计的分类）
+    enum Action
+    {
+        ACTION_OPEN = 0,
+        ACTION_SEEK,
+        ACTION_RATE,
+        ACTION_PAUSE,
+        ACTION_RECONNECT,
+        ACTION_SWITCH,
+        ACTION_COUNT
+    };
+
+    // 显示管线各阶段（耗时统计的分类）
+    enum Stage
+    {
+        STAGE_DECODE = 0,
+        STAGE_CONVERT,
+        STAGE_UPLOAD,
+        STAGE_PRESENT,
+        STAGE_COUNT
+    };
+
+    struct PlayerSlot
+    {
+        FFmpegPlayer *player = nullptr;
+        FFmpegDecoderThread *decoder = nullptr;
+        VideoFrameSink *sink = nullptr;         // 取显示帧的时间戳
+        int inputIndex = 0;
+        qint64 durationMs = 0;
+        bool paused = false;
+
+        // 延迟测量：操作发出后等待满足条件的第一帧
+        int pendingAction = -1;
+        bool waitRestart = false;               // 打开类操作：解码线程重新启动前的帧不计
+        qint64 seekTargetMs = -1;               // 跳转目标
+        QElapsedTimer actionTimer;
+    };
+
+    struct Sample
+    {
+        qint64 elapsedMs = 0;
+        qint64 rssKB = -1;
+        int fdCount = -1;
+        int threadCount = -1;
+        double latencyMs[ACTION_COUNT] = {};
+        int latencyCount[ACTION_COUNT] = {};
+        double stageMs[STAGE_COUNT] = {};
+        int stageCount[STAGE_COUNT] = {};
+        int errors = 0;
+    };
+
+    bool startFeeder();
+    void stopFeeder();
+    void breakNetworkLink();
+    void openInput(PlayerSlot &slot, int inputIndex, Action action);
+    void performRandomAction();
+    void beginLatency(PlayerSlot &slot, Action action);
+    void onFrameArrived(int index);
+    void probeLatency();
+    void addStage(Stage stage, double ms, int count = 1);
+    void collectRenderStages();
+    void takeSample();
+    void finish();
+    void evaluate();
+
+    static QString actionName(int action);
+    static QString stageName(int stage);
+    static bool isNetworkUrl(const QString &url);
+    static qint64 readRssKB();
+    static int readThreadCount();
+    static int readFdCount();
+    static double slopePerHour(const QVector<Sample> &samples, double (*value)(const Sample &));
+
+    Options m_options;
+    QVector<PlayerSlot> m_slots;
+    QRandomGenerator m_random;
+    QTimer m_actionTimer;
+    QTimer m_sampleTimer;
+    QTimer m_probeTimer;
+    QElapsedTimer m_elapsed;
+    QProcess m_feeder;
+    bool m_feederRestarting = false;        // 替身推流已停止、等待重新拉起
+    QFile m_csv;
+
+    // 当前采样窗口内的延迟累计
+    double m_latencySumMs[ACTION_COUNT] = {};
+    int m_latencyCount[ACTION_COUNT] = {};
+    double m_stageSumMs[STAGE_COUNT] = {};
+    int m_stageCount[STAGE_COUNT] = {};
+    int m_errorCount = 0;
+
+    QVector<Sample> m_samples;
+    QStringList m_failures;
+};
+
+#endif // _SOAK_RUNNER_H
@@ -3,10 +3,27 @@
 #ifdef OPENGL_ENABLE
 
 #include <QCoreApplication>
+#include <QGuiApplication>
+#include <QKeyEvent>
 #include <QMatrix4x4>
 #include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QScreen>
 #include <QSurfaceFormat>
 #include <QThread>
+#include <QWindow>
+
+#include <cmath>
+#include <cstring>
+
+#include "factory/opengl/program_cache.h"
+#include "video_frame_renderer.h"
+#include "video_upload_thread.h"
+
+// GLES2头文件未定义行步长常量（GLES3/GL_EXT_unpack_subimage中取值相同）
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
 
 // ==================== 着色器源码 ====================
 
@@ -43,58 +60,107 @@ static const char *fragmentShaderSourceRGB =
     "}\n";
 
 /**
- * @brief YUV转RGB片段着色器 - BT.601标准
+ * @brief YUV转RGB片段着色器（按变体宏选择采样方式）
  * 
- * BT.601公式（标清电视标准）：
- * R = Y + 1.402 * (V - 128)
- * G = Y - 0.344 * (U - 128) - 0.714 * (V - 128)
- * B = Y + 1.772 * (U - 128)
+ * 宏定义：
+ * - SAMPLE_16BIT: 样本为16位小端，Y/U/V平面以LUMINANCE_ALPHA上传（低字节在r，高字节在a），
+ *   半平面UV以RGBA上传（U在rg，V在ba）；线性插值对高低字节分别进行，重组后结果不变
+ * - SEMI_PLANAR: 双平面格式，u_textureU中为交错的色度
+ * - SWAP_UV: 交错色度为VU顺序（NV21）
  * 
- * 适用范围：DVD、VCD、标清电视、老旧视频文件
- * 兼容性：最好，几乎所有播放器都支持
+ * 色彩转换：rgb = u_colorMatrix * (yuv - u_colorOffset)
+ * 矩阵与偏移由色彩空间（BT.601/709/2020）与取值范围计算，作为uniform传入，
+ * 切换色彩空间无需重新编译；u_sampleScale将16位样本归一化到"码值/(2^位深-1)"
  */
-static const char *fragmentShaderSourceYUV_BT601 =
+static const char *fragmentShaderSourceYUV =
+    "#ifdef GL_ES\n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"               // 16位样本重组需要高精度
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "#endif\n"
     "uniform sampler2D u_textureY;\n"        // Y平面纹理采样器
-    "uniform sampler2D u_textureU;\n"        // U平面纹理采样器
-    "uniform sampler2D u_textureV;\n"        // V平面纹理采样器
-    "varying vec2 v_texCoord;\n"             // 纹理坐标
+    "uniform sampler2D u_textureU;\n"        // U平面（或交错UV）纹理采样器
+    "uniform sampler2D u_textureV;\n"        // V平面纹理采样器（半平面格式不使用）
+    "uniform mat3 u_colorMatrix;\n"          // YUV到RGB转换矩阵（含范围缩放）
+    "uniform vec3 u_colorOffset;\n"          // YUV偏移（黑电平与色度中心）
+    "uniform float u_sampleScale;\n"         // 样本归一化系数
+    "varying vec2 v_texCoord;\n"
+    "float sample16(vec2 lh) {\n"            // 低/高字节重组为16位值并归一化
+    "    return (lh.x * 255.0 + lh.y * 65280.0) / 65535.0;\n"
+    "}\n"
     "void main() {\n"
-    "    float y = texture2D(u_textureY, v_texCoord).r;\n"      // 获取Y值（亮度）
-    "    float u = texture2D(u_textureU, v_texCoord).r - 0.5;\n" // 获取U值（色度），归一化到[-0.5,0.5]
-    "    float v = texture2D(u_textureV, v_texCoord).r - 0.5;\n" // 获取V值（色度），归一化到[-0.5,0.5]
-    "    // BT.601标准YUV转RGB公式\n"
-    "    float r = y + 1.402 * v;\n"         // 红色分量计算
-    "    float g = y - 0.344 * u - 0.714 * v;\n"  // 绿色分量计算
-    "    float b = y + 1.772 * u;\n"         // 蓝色分量计算
-    "    gl_FragColor = vec4(r, g, b, 1.0);\n"
+    "    vec3 yuv;\n"
+    "#ifdef SAMPLE_16BIT\n"
+    "    yuv.x = sample16(texture2D(u_textureY, v_texCoord).ra);\n"
+    "#else\n"
+    "    yuv.x = texture2D(u_textureY, v_texCoord).r;\n"
+    "#endif\n"
+    "#ifdef SEMI_PLANAR\n"
+    "#ifdef SAMPLE_16BIT\n"
+    "    vec4 c = texture2D(u_textureU, v_texCoord);\n"
+    "    yuv.yz = vec2(sample16(c.rg), sample16(c.ba));\n"
+    "#else\n"
+    "    yuv.yz = texture2D(u_textureU, v_texCoord).ra;\n"
+    "#endif\n"
+    "#ifdef SWAP_UV\n"
+    "    yuv.yz = yuv.zy;\n"
+    "#endif\n"
+    "#else\n"
+    "#ifdef SAMPLE_16BIT\n"
+    "    yuv.y = sample16(texture2D(u_textureU, v_texCoord).ra);\n"
+    "    yuv.z = sample16(texture2D(u_textureV, v_texCoord).ra);\n"
+    "#else\n"
+    "    yuv.y = texture2D(u_textureU, v_texCoord).r;\n"
+    "    yuv.z = texture2D(u_textureV, v_texCoord).r;\n"
+    "#endif\n"
+    "#endif\n"
+    "    yuv *= u_sampleScale;\n"
+    "    vec3 rgb = u_colorMatrix * (yuv - u_colorOffset);\n"
+    "    gl_FragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);\n"
     "}\n";
 
 /**
- * @brief YUV转RGB片段着色器 - BT.709标准
- * 
- * BT.709公式（高清电视标准）：
- * R = Y + 1.28033 * (V - 128)
- * G = Y - 0.21482 * (U - 128) - 0.38059 * (V - 128)
- * B = Y + 2.12798 * (U - 128)
- * 
- * 适用范围：720p、1080p、4K、蓝光、现代视频
- * 色彩准确性：更高，色域更广
+ * @brief 各着色器变体的宏定义前缀（顺序与ShaderVariant一致）
  */
-static const char *fragmentShaderSourceYUV_BT709 =
-    "uniform sampler2D u_textureY;\n"
-    "uniform sampler2D u_textureU;\n"
-    "uniform sampler2D u_textureV;\n"
-    "varying vec2 v_texCoord;\n"
-    "void main() {\n"
-    "    float y = texture2D(u_textureY, v_texCoord).r;\n"
-    "    float u = texture2D(u_textureU, v_texCoord).r - 0.5;\n"
-    "    float v = texture2D(u_textureV, v_texCoord).r - 0.5;\n"
-    "    // BT.709标准YUV转RGB公式（适用于高清视频）\n"
-    "    float r = y + 1.28033 * v;\n"       // 红色分量系数略有不同
-    "    float g = y - 0.21482 * u - 0.38059 * v;\n"  // 绿色分量系数调整
-    "    float b = y + 2.12798 * u;\n"       // 蓝色分量系数调整
-    "    gl_FragColor = vec4(r, g, b, 1.0);\n"
-    "}\n";
+static const char *yuvShaderDefines[] = {
+    "",                                                         // SHADER_PLANAR8
+    "#define SAMPLE_16BIT\n",                                   // SHADER_PLANAR16
+    "#define SEMI_PLANAR\n",                                    // SHADER_NV12
+    "#define SEMI_PLANAR\n#define SWAP_UV\n",                   // SHADER_NV21
+    "#define SEMI_PLANAR\n#define SAMPLE_16BIT\n"               // SHADER_NV12_16
+};
+
+/**
+ * @brief 组合指定变体的YUV片段着色器源码
+ */
+static QByteArray yuvFragmentSource(OpenGLVideoWidget::ShaderVariant variant)
+{
+    QByteArray source(yuvShaderDefines[variant]);
+    source += fragmentShaderSourceYUV;
+    return source;
+}
+
+static const char *colorSpaceName(int space)
+{
+    switch (space) {
+        case 1: return "BT.709";
+        case 2: return "BT.2020";
+        default: return "BT.601";
+    }
+}
+
+static const char *layoutName(int layout)
+{
+    switch (layout) {
+        case 1: return "YUV422P";
+        case 2: return "YUV444P";
+        case 3: return "NV12";
+        case 4: return "NV21";
+        default: return "YUV420P";
+    }
+}
 
 // ==================== OpenGLVideoWidget 实现 ====================
 
@@ -103,6 +169,11 @@ OpenGLVideoWidget::OpenGLVideoWidget(QWidget *parent)
     , m_vertexBuffer(QOpenGLBuffer::VertexBuffer)
     , m_indexBuffer(QOpenGLBuffer::IndexBuffer)
 {
+    for (QOpenGLBuffer &pbo : m_uploadPbos) {
+        pbo = QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
+        pbo.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    }
+
     // 设置OpenGL上下文格式
     QSurfaceFormat format;
     format.setRenderableType(QSurfaceFormat::OpenGL);
@@ -118,8 +189,16 @@ OpenGLVideoWidget::OpenGLVideoWidget(QWidget *parent)
     setAutoFillBackground(false);               // 禁止自动填充背景
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     
+    // 点击获得焦点后可用F12切换性能浮层
+    setFocusPolicy(Qt::ClickFocus);
+    m_perfHud.setRenderCounters(&m_renderCounters);
+
     // 启动帧率计时器
     m_fpsTimer.start();
+    m_presentTimer.start();
+
+    // 交换缓冲后（开启垂直同步时即新画面上屏）记录上屏时刻
+    connect(this, &QOpenGLWidget::frameSwapped, this, &OpenGLVideoWidget::onFrameSwapped);
     
     qDebug() << "OpenGLVideoWidget created with OpenGL 2.1 context";
 }
@@ -174,19 +253,14 @@ bool OpenGLVideoWidget::isOpenGLAvailable()
 
 void OpenGLVideoWidget::setColorSpace(ColorSpace space)
 {
+    m_colorSpaceExplicit = true;
     if (m_colorSpace == space) return;
     
     m_colorSpace = space;
-    qDebug() << "Color space changed to:" << (space == COLOR_BT601 ? "BT.601" : "BT.709");
+    qDebug() << "Color space changed to:" << colorSpaceName(space);
     
-    // 重新创建YUV着色器以应用新的色彩空间
-    if (m_initialized && m_programYUV) {
-        makeCurrent();
-        delete m_programYUV;
-        m_programYUV = nullptr;
-        createShaders();
-        doneCurrent();
-    }
+    // 色彩矩阵在每次绘制时以uniform传入，重绘即可生效
+    update();
 }
 
 QString OpenGLVideoWidget::getRenderMode() const
@@ -194,7 +268,12 @@ QString OpenGLVideoWidget::getRenderMode() const
     switch (m_renderMode) {
         case ModeRGB: return "OpenGL RGB";
         case ModeYUV: 
-            return QString("OpenGL YUV (%1)").arg(m_colorSpace == COLOR_BT601 ? "BT.601" : "BT.709");
+            return QString("OpenGL YUV %1 %2bit (%3, %4)%5")
+                .arg(layoutName(m_yuvFormat.layout))
+                .arg(m_yuvFormat.bitDepth)
+                .arg(colorSpaceName(m_activeColorSpace))
+                .arg(m_yuvFormat.range == RANGE_FULL ? "full" : "limited")
+                .arg(m_uploadThread ? " [threaded upload]" : "");
         default: return "None";
     }
 }
@@ -210,70 +289,159 @@ OpenGLVideoWidget::ColorSpace OpenGLVideoWidget::autoSelectColorSpace(int width,
     }
 }
 
-bool OpenGLVideoWidget::createShaders()
+OpenGLVideoWidget::ShaderVariant OpenGLVideoWidget::shaderVariantFor(const YUVFormat &format)
 {
-    // 此函数假定已经在有效的OpenGL上下文中调用
+    if (format.isSemiPlanar()) {
+        if (format.bytesPerSample() > 1) return SHADER_NV12_16;
+        return format.layout == LAYOUT_NV21 ? SHADER_NV21 : SHADER_NV12;
+    }
+    return format.bytesPerSample() > 1 ? SHADER_PLANAR16 : SHADER_PLANAR8;
+}
+
+GLenum OpenGLVideoWidget::pixelFormatForBytes(int bytesPerPixel)
+{
+    switch (bytesPerPixel) {
+        case 2: return GL_LUMINANCE_ALPHA;
+        case 4: return GL_RGBA;
+        default: return GL_LUMINANCE;
+    }
+}
+
+void OpenGLVideoWidget::computeColorMatrix(ColorSpace space, ColorRange range, int bitDepth,
+                                           QMatrix3x3 &matrix, QVector3D &offset)
+{
+    // 亮度系数Kr/Kb
+    float kr = 0.299f, kb = 0.114f;
+    if (space == COLOR_BT709) {
+        kr = 0.2126f; kb = 0.0722f;
+    } else if (space == COLOR_BT2020) {
+        kr = 0.2627f; kb = 0.0593f;
+    }
+    const float kg = 1.0f - kr - kb;
+    
+    // 样本已归一化为"码值/(2^位深-1)"，有限范围的黑电平与量程随位深等比放大
+    const int depth = qBound(8, bitDepth, 16);
+    const float maxCode = static_cast<float>((1 << depth) - 1);
+    const float unit = static_cast<float>(1 << (depth - 8));
+    
+    float yScale = 1.0f, cScale = 1.0f, yOffset = 0.0f;
+    const float cOffset = 128.0f * unit / maxCode;
+    if (range == RANGE_LIMITED) {
+        yOffset = 16.0f * unit / maxCode;
+        yScale = maxCode / (219.0f * unit);
+        cScale = maxCode / (224.0f * unit);
+    }
     
-    // ==================== 创建RGB着色器 ====================
-    m_programRGB = new QOpenGLShaderProgram(this);
+    // R = Y + 2(1-Kr)V
+    // G = Y - 2Kb(1-Kb)/Kg U - 2Kr(1-Kr)/Kg V
+    // B = Y + 2(1-Kb)U
+    const float values[9] = {
+        yScale, 0.0f,                                   cScale * 2.0f * (1.0f - kr),
+        yScale, -cScale * 2.0f * kb * (1.0f - kb) / kg, -cScale * 2.0f * kr * (1.0f - kr) / kg,
+        yScale, cScale * 2.0f * (1.0f - kb),            0.0f
+    };
+    matrix = QMatrix3x3(values);
+    offset = QVector3D(yOffset, cOffset, cOffset);
+}
+
+QOpenGLShaderProgram *OpenGLVideoWidget::createYUVProgram(ShaderVariant variant, QObject *parent)
+{
+    // 此函数假定已经在有效的OpenGL上下文中调用
+    QOpenGLShaderProgram *program = new QOpenGLShaderProgram(parent);
     
-    // 添加顶点着色器
-    if (!m_programRGB->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource)) {
-        qWarning() << "RGB: Vertex shader compilation failed:" << m_programRGB->log();
-        delete m_programRGB;
-        m_programRGB = nullptr;
-        return false;
+    // 片段着色器：变体宏 + 通用源码；可缓存方式链接，命中磁盘程序二进制时不再编译
+    if (!SsProgramCache::linkCacheable(program, vertexShaderSource, yuvFragmentSource(variant))) {
+        qWarning() << "YUV: Shader program creation failed, variant" << variant;
+        delete program;
+        return nullptr;
     }
     
-    // 添加片段着色器
-    if (!m_programRGB->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSourceRGB)) {
-        qWarning() << "RGB: Fragment shader compilation failed:" << m_programRGB->log();
-        delete m_programRGB;
-        m_programRGB = nullptr;
-        return false;
+    qDebug() << "YUV shader variant" << variant << "created";
+    return program;
+}
+
+QOpenGLShaderProgram *OpenGLVideoWidget::sharedYUVProgram(ShaderVariant variant)
+{
+    // 此函数假定已经在有效的OpenGL上下文中调用
+    return SsProgramCache::program(vertexShaderSource, yuvFragmentSource(variant));
+}
+
+QOpenGLShaderProgram *OpenGLVideoWidget::yuvProgram(ShaderVariant variant)
+{
+    // 此函数假定已经在有效的OpenGL上下文中调用
+    // 程序在共享组内共用：同组的其他窗口（如视频墙）直接复用已链接的程序
+    if (!m_programsYUV[variant]) {
+        m_programsYUV[variant] = sharedYUVProgram(variant);
     }
-    
-    // 链接着色器程序
-    if (!m_programRGB->link()) {
-        qWarning() << "RGB: Shader program link failed:" << m_programRGB->log();
-        delete m_programRGB;
-        m_programRGB = nullptr;
-        return false;
+    return m_programsYUV[variant];
+}
+
+void OpenGLVideoWidget::setYUVUniforms(QOpenGLShaderProgram *program, const YUVFormat &format, ColorSpace colorSpace)
+{
+    program->setUniformValue("u_textureY", 0);
+    program->setUniformValue("u_textureU", 1);
+    if (!format.isSemiPlanar()) {
+        program->setUniformValue("u_textureV", 2);
     }
     
-    // ==================== 创建YUV着色器 ====================
-    m_programYUV = new QOpenGLShaderProgram(this);
+    QMatrix3x3 colorMatrix;
+    QVector3D colorOffset;
+    computeColorMatrix(format.hasColorSpace ? format.colorSpace : colorSpace,
+                       format.range, format.bitDepth, colorMatrix, colorOffset);
+    program->setUniformValue("u_colorMatrix", colorMatrix);
+    program->setUniformValue("u_colorOffset", colorOffset);
     
-    // 添加顶点着色器（与RGB模式共用）
-    if (!m_programYUV->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource)) {
-        qWarning() << "YUV: Vertex shader compilation failed:" << m_programYUV->log();
-        delete m_programYUV;
-        m_programYUV = nullptr;
-        return false;
+    program->setUniformValue("u_sampleScale", sampleScale(format));
+}
+
+float OpenGLVideoWidget::sampleScale(const YUVFormat &format)
+{
+    // 16位样本归一化到"码值/(2^位深-1)"；高位对齐时码值左移了(16-位深)位
+    if (format.bytesPerSample() <= 1) {
+        return 1.0f;
+    }
+    const int depth = qBound(8, format.bitDepth, 16);
+    const int shift = format.msbAligned ? 16 - depth : 0;
+    return 65535.0f / static_cast<float>(((1 << depth) - 1) << shift);
+}
+
+int OpenGLVideoWidget::planeGeometry(const YUVFormat &format, int width, int height,
+                                     int planeWidth[3], int planeHeight[3], int bytesPerPixel[3])
+{
+    const int sx = format.chromaShiftX();
+    const int sy = format.chromaShiftY();
+    const int bps = format.bytesPerSample();
+    const int count = format.planeCount();
+    
+    // 亮度平面每像素bps字节；半平面格式的色度平面每像素含U、V两个样本；色度尺寸向上取整
+    for (int i = 0; i < count; ++i) {
+        planeWidth[i] = (i == 0) ? width : (width + (1 << sx) - 1) >> sx;
+        planeHeight[i] = (i == 0) ? height : (height + (1 << sy) - 1) >> sy;
+        bytesPerPixel[i] = (i > 0 && format.isSemiPlanar()) ? bps * 2 : bps;
     }
     
-    // 根据色彩空间选择对应的片段着色器
-    const char* yuvFragmentShader = (m_colorSpace == COLOR_BT601) 
-        ? fragmentShaderSourceYUV_BT601 
-        : fragmentShaderSourceYUV_BT709;
+    return count;
+}
+
+bool OpenGLVideoWidget::createShaders()
+{
+    // 此函数假定已经在有效的OpenGL上下文中调用
     
-    if (!m_programYUV->addShaderFromSourceCode(QOpenGLShader::Fragment, yuvFragmentShader)) {
-        qWarning() << "YUV: Fragment shader compilation failed:" << m_programYUV->log();
-        delete m_programYUV;
-        m_programYUV = nullptr;
+    // ==================== 创建RGB着色器 ====================
+    // 共享组内已有时直接复用，否则链接（命中磁盘程序二进制时不编译）
+    m_programRGB = SsProgramCache::program(vertexShaderSource, fragmentShaderSourceRGB);
+    if (!m_programRGB) {
+        qWarning() << "RGB: Shader program creation failed";
         return false;
     }
     
-    // 链接着色器程序
-    if (!m_programYUV->link()) {
-        qWarning() << "YUV: Shader program link failed:" << m_programYUV->log();
-        delete m_programYUV;
-        m_programYUV = nullptr;
+    // ==================== 创建YUV着色器 ====================
+    // 预先编译最常用的三平面8位变体，其余变体在首次遇到对应格式时编译
+    if (!yuvProgram(SHADER_PLANAR8)) {
         return false;
     }
     
-    qDebug() << "Shaders created successfully - YUV using" 
-             << (m_colorSpace == COLOR_BT601 ? "BT.601" : "BT.709");
+    qDebug() << "Shaders created successfully";
     
     return true;
 }
@@ -307,6 +475,37 @@ void OpenGLVideoWidget::initializeGL()
     initRGBTextures();
     initYUVTextures();
     
+    // 检测上传能力并创建PBO环形队列
+    detectUploadCapabilities();
+
+    if (!m_perfHud.initialize()) {
+        qWarning() << "Failed to initialize performance HUD";
+    }
+    
+    // 支持共享上下文与栅栏同步时，YUV帧改由上传线程写入纹理环
+    // 上下文重建（如重新挂接父窗口）后旧的共享组失效，需重建上传线程
+    releaseUploadThread();
+    if (m_threadedUploadEnabled && VideoUploadThread::isSupported(context())) {
+        VideoUploadThread *thread = new VideoUploadThread(this);
+        connect(thread, &VideoUploadThread::frameUploaded,
+                this, QOverload<>::of(&OpenGLVideoWidget::update), Qt::QueuedConnection);
+        // 上传上下文无法激活：释放线程，后续帧回到paintGL内上传
+        connect(thread, &VideoUploadThread::uploadFailed, this, [this, thread]() {
+            if (m_uploadThread == thread) {
+                qWarning() << "Texture upload thread failed, uploading in paintGL";
+                releaseUploadThread();
+                update();
+            }
+        }, Qt::QueuedConnection);
+        if (thread->startUpload(context())) {
+            QMutexLocker locker(&m_uploadThreadMutex);
+            m_uploadThread = thread;
+        } else {
+            qWarning() << "Failed to start texture upload thread, uploading in paintGL";
+            delete thread;
+        }
+    }
+    
     // 创建着色器程序
     if (!createShaders()) {
         qWarning() << "Failed to create shaders, video rendering may not work correctly";
@@ -368,6 +567,8 @@ void OpenGLVideoWidget::initRGBTextures()
     unsigned char blackPixel[4] = {0, 0, 0, 255};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, 
                  GL_RGBA, GL_UNSIGNED_BYTE, blackPixel);
+    m_texWidth = 1;
+    m_texHeight = 1;
     
     glBindTexture(GL_TEXTURE_2D, 0);
     
@@ -392,6 +593,353 @@ void OpenGLVideoWidget::initYUVTextures()
     }
     
     glBindTexture(GL_TEXTURE_2D, 0);
+    
+    // 存储在首帧到达时按分辨率分配
+    m_yuvTexWidth = 0;
+    m_yuvTexHeight = 0;
+}
+
+void OpenGLVideoWidget::detectUploadCapabilities()
+{
+    QOpenGLContext *ctx = context();
+    if (!ctx) {
+        m_pboSupported = false;
+        m_rowLengthSupported = false;
+        return;
+    }
+    
+    const QSurfaceFormat fmt = ctx->format();
+    const int version = fmt.majorVersion() * 10 + fmt.minorVersion();
+    
+    if (ctx->isOpenGLES()) {
+        // GLES2需扩展才能按行步长读取，PBO从GLES3开始提供
+        m_rowLengthSupported = version >= 30 || ctx->hasExtension("GL_EXT_unpack_subimage");
+        m_pboSupported = version >= 30 || ctx->hasExtension("GL_NV_pixel_buffer_object");
+    } else {
+        // 桌面GL始终支持行步长，PBO为2.1核心功能
+        m_rowLengthSupported = true;
+        m_pboSupported = version >= 21 || ctx->hasExtension("GL_ARB_pixel_buffer_object");
+    }
+    
+    if (m_pboSupported) {
+        for (QOpenGLBuffer &pbo : m_uploadPbos) {
+            if (!pbo.isCreated() && !pbo.create()) {
+                m_pboSupported = false;
+                break;
+            }
+        }
+    }
+    m_pboIndex = 0;
+    
+    qDebug() << "Texture upload - PBO:" << m_pboSupported
+             << "Row length:" << m_rowLengthSupported;
+}
+
+void OpenGLVideoWidget::allocateTexture(GLuint texture, GLenum format, int width, int height)
+{
+    // 仅在分辨率变化时调用，后续逐帧用glTexSubImage2D更新
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0,
+                 format, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OpenGLVideoWidget::copyPlane(uint8_t *dst, int dstStride, const PlaneUpload &plane)
+{
+    const int rowBytes = plane.width * plane.bytesPerPixel;
+    
+    if (dstStride == plane.linesize) {
+        // 行步长一致，整块拷贝（最后一行只拷有效部分，避免越过源数据末尾）
+        memcpy(dst, plane.data, static_cast<size_t>(plane.linesize) * (plane.height - 1) + rowBytes);
+        return;
+    }
+    
+    for (int row = 0; row < plane.height; ++row) {
+        memcpy(dst + static_cast<size_t>(row) * dstStride,
+               plane.data + static_cast<size_t>(row) * plane.linesize,
+               rowBytes);
+    }
+}
+
+void OpenGLVideoWidget::uploadPlanes(const PlaneUpload *planes, int count)
+{
+    // 此函数必须在有效的OpenGL上下文中调用，纹理存储已按尺寸分配
+    QElapsedTimer timer;
+    timer.start();
+    
+    // ==================== 计算各平面在上传缓冲中的布局 ====================
+    // 支持行步长时保留源数据的行填充（整块拷贝 + GL_UNPACK_ROW_LENGTH），否则紧凑重排
+    size_t offsets[4] = {0, 0, 0, 0};
+    int strides[4] = {0, 0, 0, 0};
+    size_t totalSize = 0;
+    
+    for (int i = 0; i < count; ++i) {
+        const PlaneUpload &plane = planes[i];
+        const int rowBytes = plane.width * plane.bytesPerPixel;
+        const bool keepStride = m_rowLengthSupported && plane.linesize % plane.bytesPerPixel == 0;
+        strides[i] = keepStride ? plane.linesize : rowBytes;
+        offsets[i] = totalSize;
+        totalSize += static_cast<size_t>(strides[i]) * plane.height;
+        totalSize = (totalSize + 63) & ~static_cast<size_t>(63);   // 平面起始按64字节对齐
+    }
+    
+    // ==================== 写入PBO ====================
+    QOpenGLBuffer *pbo = nullptr;
+    uint8_t *mapped = nullptr;
+    
+    if (m_pboSupported && m_pboEnabled) {
+        pbo = &m_uploadPbos[m_pboIndex];
+        m_pboIndex = (m_pboIndex + 1) % PBO_RING_SIZE;
+        
+        pbo->bind();
+        // 重新指定存储（orphan），驱动为仍在被读取的旧数据保留原存储，映射不会等待GPU
+        pbo->allocate(static_cast<int>(totalSize));
+        mapped = static_cast<uint8_t*>(pbo->mapRange(0, static_cast<int>(totalSize),
+            QOpenGLBuffer::RangeWrite | QOpenGLBuffer::RangeInvalidateBuffer));
+        if (!mapped) {
+            mapped = static_cast<uint8_t*>(pbo->map(QOpenGLBuffer::WriteOnly));
+        }
+        
+        if (mapped) {
+            for (int i = 0; i < count; ++i) {
+                copyPlane(mapped + offsets[i], strides[i], planes[i]);
+            }
+            pbo->unmap();
+        } else {
+            qWarning() << "Failed to map pixel buffer, falling back to direct texture upload";
+            pbo->release();
+            pbo = nullptr;
+            m_pboSupported = false;
+        }
+    }
+    
+    // ==================== 提交纹理更新 ====================
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    
+    for (int i = 0; i < count; ++i) {
+        const PlaneUpload &plane = planes[i];
+        const void *pixels = nullptr;
+        
+        if (pbo) {
+            // 绑定PBO时指针参数为缓冲区内偏移
+            pixels = reinterpret_cast<const void*>(offsets[i]);
+        } else if (strides[i] == plane.linesize) {
+            pixels = plane.data;
+        } else {
+            // 无PBO且不支持行步长：在CPU上紧凑重排
+            m_repackBuffer.resize(strides[i] * plane.height);
+            copyPlane(reinterpret_cast<uint8_t*>(m_repackBuffer.data()), strides[i], plane);
+            pixels = m_repackBuffer.constData();
+        }
+        
+        if (m_rowLengthSupported) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, strides[i] / plane.bytesPerPixel);
+        }
+        
+        glBindTexture(GL_TEXTURE_2D, plane.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height,
+                        plane.format, GL_UNSIGNED_BYTE, pixels);
+    }
+    
+    if (m_rowLengthSupported) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    if (pbo) {
+        pbo->release();
+    }
+    
+    recordUploadStats(timer.nsecsElapsed() / 1000000.0, static_cast<qint64>(totalSize), pbo != nullptr, false);
+}
+
+void OpenGLVideoWidget::recordUploadStats(double elapsedMs, qint64 bytes, bool pbo, bool threaded)
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_uploadStats.frames++;
+    m_uploadStats.bytes += bytes;
+    m_uploadTotalMs += elapsedMs;
+    m_uploadStats.avgUploadMs = m_uploadTotalMs / m_uploadStats.frames;
+    m_uploadStats.maxUploadMs = qMax(m_uploadStats.maxUploadMs, elapsedMs);
+    m_uploadStats.pboEnabled = pbo;
+    m_uploadStats.rowLengthEnabled = m_rowLengthSupported || threaded;
+    m_uploadStats.threaded = threaded;
+    m_renderCounters.uploadUs.store(static_cast<qint64>(elapsedMs * 1000.0), std::memory_order_relaxed);
+}
+
+OpenGLVideoWidget::UploadStats OpenGLVideoWidget::getUploadStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_uploadStats;
+}
+
+void OpenGLVideoWidget::resetUploadStats()
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_uploadStats = UploadStats();
+    m_uploadTotalMs = 0.0;
+}
+
+void OpenGLVideoWidget::recordDroppedFrame()
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_presentStats.droppedFrames++;
+    m_renderCounters.renderDroppedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OpenGLVideoWidget::markFramePainted(qint64 ptsMs, qint64 submitUs)
+{
+    m_framePainted = true;
+    m_paintedPtsMs = ptsMs;
+    m_paintedSubmitUs = submitUs;
+}
+
+OpenGLVideoWidget::PresentStats OpenGLVideoWidget::getPresentStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_presentStats;
+}
+
+void OpenGLVideoWidget::resetPresentStats()
+{
+    QMutexLocker locker(&m_statsMutex);
+    const double vsyncMs = m_presentStats.vsyncIntervalMs;
+    m_presentStats = PresentStats();
+    m_presentStats.vsyncIntervalMs = vsyncMs;
+    m_latencyTotalMs = 0.0;
+}
+
+void OpenGLVideoWidget::onFrameSwapped()
+{
+    const qint64 now = m_presentTimer.nsecsElapsed() / 1000;
+
+    // ==================== vsync间隔 ====================
+    // 以屏幕标称刷新率为基准，交换间隔为整数个标称周期时折算为单周期后平滑，
+    // 间隔不规则（窗口遮挡、合成器降频）的样本直接丢弃
+    QScreen *screen = window()->windowHandle() ? window()->windowHandle()->screen()
+                                               : QGuiApplication::primaryScreen();
+    const double nominalUs = (screen && screen->refreshRate() > 1.0) ? 1000000.0 / screen->refreshRate() : 0.0;
+    if (nominalUs > 0.0 && m_lastSwapUs > 0) {
+        const double delta = static_cast<double>(now - m_lastSwapUs);
+        const double periods = std::round(delta / nominalUs);
+        if (periods >= 1.0 && periods <= 4.0) {
+            const double sample = delta / periods;
+            if (sample > nominalUs * 0.5 && sample < nominalUs * 1.5 && qAbs(delta - periods * nominalUs) < nominalUs * 0.25) {
+                m_vsyncIntervalUs = m_vsyncIntervalUs > 0.0 ? m_vsyncIntervalUs * 0.9 + sample * 0.1 : sample;
+            }
+        }
+    }
+    m_lastSwapUs = now;
+    const double vsyncUs = m_vsyncIntervalUs > 0.0 ? m_vsyncIntervalUs : nominalUs;
+
+    if (!m_framePainted) {
+        return;
+    }
+    m_framePainted = false;
+
+    // ==================== 上屏延迟 ====================
+    const double latencyMs = qMax<qint64>(0, now - m_paintedSubmitUs) / 1000.0;
+    m_renderCounters.latencyUs.store(static_cast<qint64>(latencyMs * 1000.0), std::memory_order_relaxed);
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_presentStats.presentedFrames++;
+        m_presentStats.vsyncIntervalMs = vsyncUs / 1000.0;
+        m_presentStats.lastLatencyMs = latencyMs;
+        m_latencyTotalMs += latencyMs;
+        m_presentStats.avgLatencyMs = m_latencyTotalMs / m_presentStats.presentedFrames;
+    }
+
+    if (m_paintedPtsMs >= 0) {
+        emit framePresented(m_paintedPtsMs, static_cast<qint64>(vsyncUs));
+    }
+}
+
+void OpenGLVideoWidget::setPerfHudVisible(bool visible)
+{
+    m_perfHud.setVisible(visible);
+    update();
+}
+
+void OpenGLVideoWidget::setPerfSourceCounters(std::shared_ptr<const PerfHudCounters> counters)
+{
+    m_perfHud.setSourceCounters(std::move(counters));
+}
+
+void OpenGLVideoWidget::setPerfHudTitle(const QString &title)
+{
+    m_perfHud.setTitle(title);
+}
+
+bool OpenGLVideoWidget::prepareFrameRenderer()
+{
+    if (!m_initialized || !context() || !m_drawnTextures[0]) {
+        return false;
+    }
+    
+    if (!m_frameRenderer) {
+        m_frameRenderer = new VideoFrameRenderer(this);
+        connect(m_frameRenderer, &VideoFrameRenderer::imageReady, this, &OpenGLVideoWidget::frameImageReady);
+        if (!m_frameRenderer->create(context())) {
+            delete m_frameRenderer;
+            m_frameRenderer = nullptr;
+            return false;
+        }
+    }
+    
+    // 确保本上下文的纹理写入已提交，共享上下文中可见
+    makeCurrent();
+    glFlush();
+    doneCurrent();
+    
+    const bool rgb = m_drawnRGB;
+    m_frameRenderer->setSharedTextures(m_drawnTextures,
+                                       rgb ? m_frameWidth : m_yWidth,
+                                       rgb ? m_frameHeight : m_yHeight,
+                                       m_yuvFormat, m_activeColorSpace, rgb);
+    return true;
+}
+
+int OpenGLVideoWidget::requestFrameImage(const QSize &size)
+{
+    if (!prepareFrameRenderer()) {
+        qWarning() << "OpenGLVideoWidget::requestFrameImage - no frame rendered";
+        return -1;
+    }
+    return m_frameRenderer->requestImage(size);
+}
+
+QImage OpenGLVideoWidget::grabFrameImage(const QSize &size)
+{
+    if (!prepareFrameRenderer()) {
+        qWarning() << "OpenGLVideoWidget::grabFrameImage - no frame rendered";
+        return QImage();
+    }
+    return m_frameRenderer->render(size);
+}
+
+void OpenGLVideoWidget::keyPressEvent(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_F12) {
+        setPerfHudVisible(!m_perfHud.isVisible());
+        event->accept();
+        return;
+    }
+    QOpenGLWidget::keyPressEvent(event);
+}
+
+void OpenGLVideoWidget::setThreadedUploadEnabled(bool enabled)
+{
+    if (m_initialized && enabled != (m_uploadThread != nullptr)) {
+        qWarning() << "Threaded upload setting takes effect on next OpenGL initialization";
+    }
+    m_threadedUploadEnabled = enabled;
+}
+
+void OpenGLVideoWidget::setPboUploadEnabled(bool enabled)
+{
+    m_pboEnabled = enabled;
+    qDebug() << "PBO texture upload" << (enabled ? "enabled" : "disabled");
 }
 
 void OpenGLVideoWidget::resizeGL(int w, int h)
@@ -434,7 +982,15 @@ void OpenGLVideoWidget::paintGL()
     // Qt已经调用了makeCurrent()，可以直接进行OpenGL操作
     // 确保我们在正确的线程
     Q_ASSERT(QThread::currentThread() == this->thread());
-    
+
+    m_perfHud.beginFrame();
+    renderVideo();
+    // 浮层在同一绘制过程中叠加，未显示时只记录帧耗时
+    m_perfHud.render(width(), height(), devicePixelRatioF());
+}
+
+void OpenGLVideoWidget::renderVideo()
+{
     if (!m_initialized) {
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -445,21 +1001,42 @@ void OpenGLVideoWidget::paintGL()
     
     // ==================== 处理待处理的YUV数据 ====================
     // 注意：这部分操作在OpenGL上下文中是安全的
-    {
-        QMutexLocker locker(&m_yuvMutex);
-        if (m_pendingYUV.valid) {
-            // 直接调用内部函数更新纹理
-            updateYUVTexturesInternal(
-                reinterpret_cast<const uint8_t*>(m_pendingYUV.yData.constData()),
-                reinterpret_cast<const uint8_t*>(m_pendingYUV.uData.constData()),
-                reinterpret_cast<const uint8_t*>(m_pendingYUV.vData.constData()),
-                m_pendingYUV.yLinesize,
-                m_pendingYUV.uLinesize,
-                m_pendingYUV.vLinesize,
-                m_pendingYUV.width,
-                m_pendingYUV.height
-            );
-            m_pendingYUV.valid = false;
+    GLuint yuvTextures[3] = {m_textureY, m_textureU, m_textureV};
+    
+    if (m_uploadThread && m_uploadThread->isUploading()) {
+        // 线程上传：只取最新的已完成纹理，新帧栅栏未完成时继续显示上一帧并稍后重试
+        bool pending = false;
+        VideoUploadThread::DisplayTextures display =
+            m_uploadThread->acquireDisplay(context()->extraFunctions(), &pending);
+        if (display.valid) {
+            yuvTextures[0] = display.textures[0];
+            yuvTextures[1] = display.textures[1];
+            yuvTextures[2] = display.textures[2];
+            m_yWidth = display.width;
+            m_yHeight = display.height;
+            m_yuvFormat = display.format;
+            if (display.sequence != m_displayedSequence) {
+                m_displayedSequence = display.sequence;
+                markFramePainted(display.ptsMs, display.submitUs);
+            }
+        }
+        if (pending) {
+            update();
+        }
+    } else {
+        // 持锁仅交换缓冲区，上传期间解码线程可继续写入下一帧
+        {
+            QMutexLocker locker(&m_yuvMutex);
+            if (m_pendingYUV.valid) {
+                m_uploadYUV.swap(m_pendingYUV);
+                m_pendingYUV.valid = false;
+            }
+        }
+        
+        if (m_uploadYUV.valid) {
+            updateYUVTexturesInternal(m_uploadYUV);
+            markFramePainted(m_uploadYUV.ptsMs, m_uploadYUV.submitUs);
+            m_uploadYUV.valid = false;
         }
     }
     
@@ -473,17 +1050,9 @@ void OpenGLVideoWidget::paintGL()
         
         // 如果有新的RGB帧，更新纹理
         if (m_renderMode == ModeRGB && !m_currentFrame.isNull() && m_rgbTextureNeedsUpdate) {
-            QImage textureImage = m_currentFrame.convertToFormat(QImage::Format_RGBA8888);
-            
-            glBindTexture(GL_TEXTURE_2D, m_textureRGB);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 
-                         textureImage.width(), textureImage.height(), 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, textureImage.constBits());
-            glBindTexture(GL_TEXTURE_2D, 0);
-            
-            m_frameWidth = textureImage.width();
-            m_frameHeight = textureImage.height();
+            updateTextureFromImage(m_currentFrame);
             m_rgbTextureNeedsUpdate = false;
+            markFramePainted(m_rgbPtsMs, m_rgbSubmitUs);
             
             checkGLError("paintGL - RGB texture update");
         }
@@ -510,11 +1079,13 @@ void OpenGLVideoWidget::paintGL()
     // ==================== 选择着色器并渲染 ====================
     QOpenGLShaderProgram *program = nullptr;
     
-    if (m_renderMode == ModeRGB && m_programRGB) {
+    if (m_renderMode == ModeRGB) {
         program = m_programRGB;
-    } else if (m_renderMode == ModeYUV && m_programYUV) {
-        program = m_programYUV;
-    } else {
+    } else if (m_renderMode == ModeYUV) {
+        program = yuvProgram(shaderVariantFor(m_yuvFormat));
+    }
+    
+    if (!program) {
         return;
     }
     
@@ -530,18 +1101,36 @@ void OpenGLVideoWidget::paintGL()
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_textureRGB);
         program->setUniformValue("u_texture", 0);
+        
+        // 记录本次绘制的纹理，离屏渲染时复用
+        m_drawnTextures[0] = m_textureRGB;
+        m_drawnTextures[1] = m_drawnTextures[2] = 0;
+        m_drawnRGB = true;
     } else if (m_renderMode == ModeYUV) {
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_textureY);
-        program->setUniformValue("u_textureY", 0);
+        glBindTexture(GL_TEXTURE_2D, yuvTextures[0]);
         
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, m_textureU);
-        program->setUniformValue("u_textureU", 1);
+        glBindTexture(GL_TEXTURE_2D, yuvTextures[1]);
         
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, m_textureV);
-        program->setUniformValue("u_textureV", 2);
+        if (!m_yuvFormat.isSemiPlanar()) {
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, yuvTextures[2]);
+        }
+        
+        // 色彩矩阵：优先使用帧携带的色彩空间，否则使用设置值或按分辨率自动选择
+        if (m_yuvFormat.hasColorSpace) {
+            m_activeColorSpace = m_yuvFormat.colorSpace;
+        } else {
+            m_activeColorSpace = m_colorSpaceExplicit ? m_colorSpace : autoSelectColorSpace(m_yWidth, m_yHeight);
+        }
+        setYUVUniforms(program, m_yuvFormat, m_activeColorSpace);
+        glActiveTexture(GL_TEXTURE0);
+        
+        m_drawnTextures[0] = yuvTextures[0];
+        m_drawnTextures[1] = yuvTextures[1];
+        m_drawnTextures[2] = yuvTextures[2];
+        m_drawnRGB = false;
     }
     
     // 绘制
@@ -592,55 +1181,104 @@ void OpenGLVideoWidget::updateTextureFromImage(const QImage &image)
     m_frameWidth = textureImage.width();
     m_frameHeight = textureImage.height();
     
-    // 更新纹理数据
-    glBindTexture(GL_TEXTURE_2D, m_textureRGB);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_frameWidth, m_frameHeight, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, textureImage.constBits());
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // 分辨率变化时才重新分配纹理存储
+    if (m_texWidth != m_frameWidth || m_texHeight != m_frameHeight) {
+        allocateTexture(m_textureRGB, GL_RGBA, m_frameWidth, m_frameHeight);
+        m_texWidth = m_frameWidth;
+        m_texHeight = m_frameHeight;
+    }
+    
+    // 更新纹理数据（bytesPerLine可能含行尾填充）
+    PlaneUpload plane;
+    plane.texture = m_textureRGB;
+    plane.format = GL_RGBA;
+    plane.bytesPerPixel = 4;
+    plane.data = textureImage.constBits();
+    plane.linesize = static_cast<int>(textureImage.bytesPerLine());
+    plane.width = m_frameWidth;
+    plane.height = m_frameHeight;
+    uploadPlanes(&plane, 1);
     
     checkGLError("updateTextureFromImage");
 }
 
-void OpenGLVideoWidget::updateYUVTexturesInternal(const uint8_t *y_data, const uint8_t *u_data, const uint8_t *v_data,
-                                                   int y_linesize, int u_linesize, int v_linesize,
-                                                   int width, int height)
+int OpenGLVideoWidget::buildPlaneUploads(const YUVData &data, const GLuint textures[3], PlaneUpload planes[3])
 {
-    // 此函数必须在有效的OpenGL上下文中调用（由paintGL调用）
-    if (!y_data || !u_data || !v_data) return;
-    if (width <= 0 || height <= 0) return;
-    
-    m_yWidth = width;
-    m_yHeight = height;
-    m_uvWidth = width / 2;
-    m_uvHeight = height / 2;
-    
-    // 上传Y平面
-    glBindTexture(GL_TEXTURE_2D, m_textureY);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_yWidth, m_yHeight, 0,
-                 GL_LUMINANCE, GL_UNSIGNED_BYTE, y_data);
-    
-    // 上传U平面
-    glBindTexture(GL_TEXTURE_2D, m_textureU);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_uvWidth, m_uvHeight, 0,
-                 GL_LUMINANCE, GL_UNSIGNED_BYTE, u_data);
+    const YUVFormat &format = data.format;
+    if (data.width <= 0 || data.height <= 0) return 0;
+    
+    int widths[3], heights[3], bytesPerPixel[3];
+    const int count = planeGeometry(format, data.width, data.height, widths, heights, bytesPerPixel);
+    
+    const QByteArray *sources[3] = {&data.yData, &data.uData, &data.vData};
+    const int linesizes[3] = {data.yLinesize, data.uLinesize, data.vLinesize};
+    
+    for (int i = 0; i < count; ++i) {
+        const int bytes = bytesPerPixel[i];
+        planes[i].texture = textures[i];
+        planes[i].format = pixelFormatForBytes(bytes);
+        planes[i].bytesPerPixel = bytes;
+        planes[i].data = reinterpret_cast<const uint8_t*>(sources[i]->constData());
+        planes[i].linesize = linesizes[i];
+        planes[i].width = widths[i];
+        planes[i].height = heights[i];
+        
+        // 数据长度不足（调用方传入错误步长）时放弃本帧，避免越界读取
+        if (sources[i]->size() < planes[i].linesize * (planes[i].height - 1) + planes[i].width * bytes) {
+            qWarning() << "YUV plane" << i << "data too short, frame skipped";
+            return 0;
+        }
+    }
     
-    // 上传V平面
-    glBindTexture(GL_TEXTURE_2D, m_textureV);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_uvWidth, m_uvHeight, 0,
-                 GL_LUMINANCE, GL_UNSIGNED_BYTE, v_data);
+    return count;
+}
+
+void OpenGLVideoWidget::updateYUVTexturesInternal(const YUVData &data)
+{
+    // 此函数必须在有效的OpenGL上下文中调用（由paintGL调用）
+    const GLuint textures[3] = {m_textureY, m_textureU, m_textureV};
+    PlaneUpload planes[3];
+    const int count = buildPlaneUploads(data, textures, planes);
+    if (count == 0) return;
+    
+    const YUVFormat &format = data.format;
+    m_yWidth = data.width;
+    m_yHeight = data.height;
+    m_uvWidth = planes[1].width;
+    m_uvHeight = planes[1].height;
+    
+    // 分辨率或格式变化时才重新分配纹理存储
+    if (m_yuvTexWidth != data.width || m_yuvTexHeight != data.height ||
+        m_yuvTexFormat.layout != format.layout || m_yuvTexFormat.bytesPerSample() != format.bytesPerSample()) {
+        for (int i = 0; i < count; ++i) {
+            allocateTexture(planes[i].texture, planes[i].format, planes[i].width, planes[i].height);
+        }
+        m_yuvTexWidth = data.width;
+        m_yuvTexHeight = data.height;
+        m_yuvTexFormat = format;
+        
+        qDebug() << "YUV textures allocated:" << data.width << "x" << data.height
+                 << layoutName(format.layout) << format.bitDepth << "bit";
+    }
+    m_yuvFormat = format;
     
-    glBindTexture(GL_TEXTURE_2D, 0);
+    uploadPlanes(planes, count);
     
     checkGLError("updateYUVTexturesInternal");
 }
 
-void OpenGLVideoWidget::updateFrame(const QImage &frame)
+void OpenGLVideoWidget::updateFrame(const QImage &frame, qint64 ptsMs)
 {
     // 线程安全：只复制数据，不进行OpenGL操作
     if (frame.isNull()) return;
     
     {
         QMutexLocker locker(&m_frameMutex);
+        if (m_rgbTextureNeedsUpdate) {
+            recordDroppedFrame();   // 上一帧尚未绘制即被覆盖
+        }
+        m_rgbPtsMs = ptsMs;
+        m_rgbSubmitUs = m_presentTimer.nsecsElapsed() / 1000;
         // 深拷贝图像数据，确保数据生命周期
         m_currentFrame = frame.copy();
         m_renderMode = ModeRGB;
@@ -655,31 +1293,39 @@ void OpenGLVideoWidget::updateFrame(const QImage &frame)
 void OpenGLVideoWidget::updateFrameYUV(const uint8_t *y_data, const uint8_t *u_data, const uint8_t *v_data,
                                         int y_linesize, int u_linesize, int v_linesize,
                                         int width, int height)
+{
+    const uint8_t *data[3] = {y_data, u_data, v_data};
+    const int linesize[3] = {y_linesize, u_linesize, v_linesize};
+    updateFrameYUV(data, linesize, width, height, YUVFormat());
+}
+
+void OpenGLVideoWidget::updateFrameYUV(const uint8_t *const data[3], const int linesize[3],
+                                        int width, int height, const YUVFormat &format, qint64 ptsMs)
 {
     // 线程安全：只复制数据到缓冲区，不进行OpenGL操作
-    if (!y_data || !u_data || !v_data) return;
+    const int planeCount = format.planeCount();
+    for (int i = 0; i < planeCount; ++i) {
+        if (!data[i] || linesize[i] <= 0) return;
+    }
     if (width <= 0 || height <= 0) return;
     
-    {
-        QMutexLocker locker(&m_yuvMutex);
-        
-        // 计算数据大小
-        int ySize = y_linesize * height;
-        int uvHeight = height / 2;
-        int uSize = u_linesize * uvHeight;
-        int vSize = v_linesize * uvHeight;
-        
-        // 复制数据到缓冲区
-        m_pendingYUV.yData = QByteArray(reinterpret_cast<const char*>(y_data), ySize);
-        m_pendingYUV.uData = QByteArray(reinterpret_cast<const char*>(u_data), uSize);
-        m_pendingYUV.vData = QByteArray(reinterpret_cast<const char*>(v_data), vSize);
-        m_pendingYUV.yLinesize = y_linesize;
-        m_pendingYUV.uLinesize = u_linesize;
-        m_pendingYUV.vLinesize = v_linesize;
-        m_pendingYUV.width = width;
-        m_pendingYUV.height = height;
-        m_pendingYUV.valid = true;
+    // 计算数据大小并复制到缓冲区（锁外完成，缩短持锁时间）
+    YUVData frame;
+    const int uvHeight = (height + (1 << format.chromaShiftY()) - 1) >> format.chromaShiftY();
+    frame.yData = QByteArray(reinterpret_cast<const char*>(data[0]), linesize[0] * height);
+    frame.uData = QByteArray(reinterpret_cast<const char*>(data[1]), linesize[1] * uvHeight);
+    frame.yLinesize = linesize[0];
+    frame.uLinesize = linesize[1];
+    if (planeCount > 2) {
+        frame.vData = QByteArray(reinterpret_cast<const char*>(data[2]), linesize[2] * uvHeight);
+        frame.vLinesize = linesize[2];
     }
+    frame.width = width;
+    frame.height = height;
+    frame.format = format;
+    frame.ptsMs = ptsMs;
+    frame.submitUs = m_presentTimer.nsecsElapsed() / 1000;
+    frame.valid = true;
     
     {
         QMutexLocker locker(&m_frameMutex);
@@ -687,6 +1333,23 @@ void OpenGLVideoWidget::updateFrameYUV(const uint8_t *y_data, const uint8_t *u_d
         m_hasFrame = true;
     }
     
+    // 线程上传：交给上传线程，完成后由frameUploaded触发重绘
+    // 持锁期间GUI线程无法释放上传线程；线程未运行时submit返回false，回退到paintGL内上传
+    {
+        QMutexLocker locker(&m_uploadThreadMutex);
+        if (m_uploadThread && m_uploadThread->submit(frame)) {
+            return;
+        }
+    }
+    
+    {
+        QMutexLocker locker(&m_yuvMutex);
+        if (m_pendingYUV.valid) {
+            recordDroppedFrame();   // 上一帧尚未上传即被覆盖
+        }
+        m_pendingYUV.swap(frame);
+    }
+    
     // 请求重绘（在GUI线程中执行paintGL）
     update();
 }
@@ -706,6 +1369,9 @@ void OpenGLVideoWidget::clear()
         m_pendingYUV.clear();
     }
     
+    // 清空后不再提供离屏渲染
+    m_drawnTextures[0] = m_drawnTextures[1] = m_drawnTextures[2] = 0;
+    
     update();
     
     qDebug() << "OpenGLVideoWidget cleared";
@@ -723,26 +1389,48 @@ void OpenGLVideoWidget::updateFpsStats()
         // 每10秒输出一次FPS信息（避免日志过多）
         static int logCounter = 0;
         if (++logCounter >= 10) {
+            const UploadStats stats = getUploadStats();
             qDebug() << "OpenGL renderer FPS:" << m_currentFps 
-                     << "Mode:" << getRenderMode();
+                     << "Mode:" << getRenderMode()
+                     << "Upload avg/max ms:" << stats.avgUploadMs << "/" << stats.maxUploadMs
+                     << (stats.pboEnabled ? "(PBO)" : "(direct)");
             logCounter = 0;
         }
     }
 }
 
-void OpenGLVideoWidget::cleanupGL()
+void OpenGLVideoWidget::releaseUploadThread()
 {
-    // 此函数会在析构函数中调用，此时Qt已经调用了makeCurrent()
-    // 释放着色器程序
-    if (m_programRGB)
+    VideoUploadThread *thread = nullptr;
     {
-        delete m_programRGB;
-        m_programRGB = nullptr;
+        QMutexLocker locker(&m_uploadThreadMutex);
+        thread = m_uploadThread;
+        m_uploadThread = nullptr;
+    }
+    if (thread) {
+        thread->stopUpload();
+        delete thread;
     }
-    if (m_programYUV)
+}
+
+void OpenGLVideoWidget::cleanupGL()
+{
+    // 此函数会在析构函数中调用，此时Qt已经调用了makeCurrent()
+    // 先停止上传线程：纹理环属于上传上下文，由上传线程在退出前释放
+    releaseUploadThread();
+
+    m_perfHud.cleanup();
+
+    // 离屏渲染器的上下文与本上下文共享，上下文重建后需重新创建
+    delete m_frameRenderer;
+    m_frameRenderer = nullptr;
+    m_drawnTextures[0] = m_drawnTextures[1] = m_drawnTextures[2] = 0;
+
+    // 着色器程序由共享组缓存持有（同组其他窗口可能仍在使用），只解除引用
+    m_programRGB = nullptr;
+    for (QOpenGLShaderProgram *&program : m_programsYUV)
     {
-        delete m_programYUV;
-        m_programYUV = nullptr;
+        program = nullptr;
     }
 
     // 删除纹理
@@ -776,6 +1464,15 @@ void OpenGLVideoWidget::cleanupGL()
     {
         m_indexBuffer.destroy();
     }
+    for (QOpenGLBuffer &pbo : m_uploadPbos)
+    {
+        if (pbo.isCreated())
+        {
+            pbo.destroy();
+        }
+    }
+    m_texWidth = m_texHeight = 0;
+    m_yuvTexWidth = m_yuvTexHeight = 0;
 
     m_initialized = false;
 
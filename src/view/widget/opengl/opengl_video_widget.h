@@ -1,15 +1,32 @@
 /*****************************************************************
 File:        opengl_video_widget.h
-Version:     1.1
+Version:     1.11
 Author:      cjx
 Date:        2026-04-13
 Description: OpenGL视频渲染组件，用于高性能4K视频播放
              支持YUV纹理直接渲染，减少CPU到GPU的转换开销
+             纹理按分辨率一次分配，逐帧经像素缓冲对象（PBO）环形队列以glTexSubImage2D异步上传
+             直接采样YUV420P/422P/444P、NV12/NV21、P010/P016及10/12位平面格式，
+             色彩矩阵（BT.601/709/2020，有限/全范围）按帧元数据以uniform传入
+             支持共享上下文与栅栏同步时由上传线程写入纹理环，paintGL只绘制最新已完成的纹理
+             以frameSwapped近似上屏时刻，统计提交到上屏的延迟、vsync间隔与未上屏即被覆盖的帧
+             可选性能浮层（F12切换）在同一绘制过程中叠加帧耗时曲线与解码/上传/延迟指标
+             当前显示帧可经离屏帧缓冲按任意尺寸渲染为QImage（PBO异步回读）
              通过OPENGL_ENABLE宏控制是否启用
 
 Version history
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
 1             2026-4-13      cjx            create
+2             2026-10-19     cjx            PBO环形上传，纹理按分辨率复用，按行步长上传
+3             2026-10-19     cjx            新增半平面/高位深格式着色器，色彩矩阵改为uniform
+4             2026-10-19     cjx            YUV纹理改由共享上下文的上传线程写入，栅栏同步
+5             2026-10-19     cjx            公开YUV着色器/色彩矩阵/平面尺寸辅助函数，供视频墙复用
+6             2026-10-19     cjx            新增上屏反馈：framePresented信号与呈现统计
+7             2026-10-19     cjx            新增性能浮层（PerfHud），F12切换
+8             2026-10-19     cjx            新增离屏渲染到图像：requestFrameImage/grabFrameImage
+9             2026-10-19     cjx            着色器程序按共享组复用并经程序二进制磁盘缓存链接
+10            2026-10-19     cjx            上传线程指针加锁，线程启动失败时回退到paintGL内上传
+11            2026-10-19     cjx            公开共享组内的YUV程序获取接口，视频墙不再各自编译
 *****************************************************************/
 
 #ifndef OPENGL_VIDEO_WIDGET_H
@@ -17,18 +34,28 @@ Version history
 
 #include <QWidget>
 #include <QDateTime>
+#include <QImage>
+
+#include <memory>
+
+#include "perf_hud.h"
 
 #ifdef OPENGL_ENABLE
 
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QGenericMatrix>
 #include <QMutex>
 #include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLWidget>
+#include <QVector3D>
 #include <QWaitCondition>
 
+class VideoFrameRenderer;
+class VideoUploadThread;
+
 /**
  * @brief OpenGL视频渲染Widget
  * 
@@ -38,6 +65,7 @@ Version history
  * 线程安全说明：
  * - updateFrame/updateFrameYUV 可在任意线程调用（数据会被复制到缓冲区）
  * - 实际OpenGL操作在paintGL中执行（GUI线程）
+ * - 启用线程上传时YUV纹理由VideoUploadThread在共享上下文中写入，paintGL只绑定并绘制
  */
 class OpenGLVideoWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -49,10 +77,52 @@ public:
      * 
      * BT.601: 标清电视标准，兼容性最好，适用于老视频
      * BT.709: 高清电视标准，色彩更准确，适用于720p/1080p/4K
+     * BT.2020: 超高清标准，适用于HDR/广色域的HEVC视频（非恒定亮度）
      */
     enum ColorSpace {
         COLOR_BT601,    ///< ITU-R BT.601标准（标清，默认）
-        COLOR_BT709     ///< ITU-R BT.709标准（高清）
+        COLOR_BT709,    ///< ITU-R BT.709标准（高清）
+        COLOR_BT2020    ///< ITU-R BT.2020标准（超高清）
+    };
+
+    /**
+     * @brief 色彩取值范围
+     */
+    enum ColorRange {
+        RANGE_LIMITED,  ///< 有限范围（8位Y:16-235，UV:16-240），视频默认
+        RANGE_FULL      ///< 全范围（0-255），JPEG/部分摄像头输出
+    };
+
+    /**
+     * @brief YUV平面布局
+     */
+    enum PixelLayout {
+        LAYOUT_YUV420P, ///< 三平面，色度水平/垂直减半
+        LAYOUT_YUV422P, ///< 三平面，色度水平减半
+        LAYOUT_YUV444P, ///< 三平面，色度不降采样
+        LAYOUT_NV12,    ///< 双平面，Y + UV交错（4:2:0）
+        LAYOUT_NV21     ///< 双平面，Y + VU交错（4:2:0）
+    };
+
+    /**
+     * @brief YUV帧格式描述
+     *
+     * 位深大于8时每个样本按16位小端存储（如P010、YUV420P10LE），
+     * msbAligned表示有效位位于高位（P010/P016），否则位于低位。
+     */
+    struct YUVFormat {
+        PixelLayout layout = LAYOUT_YUV420P;    ///< 平面布局
+        int bitDepth = 8;                       ///< 有效位深（8/10/12/16）
+        bool msbAligned = false;                ///< 16位样本的有效位是否高位对齐
+        bool hasColorSpace = false;             ///< 帧是否携带色彩空间信息，否则使用setColorSpace的设置
+        ColorSpace colorSpace = COLOR_BT601;    ///< 色彩空间（hasColorSpace为true时有效）
+        ColorRange range = RANGE_LIMITED;       ///< 取值范围
+
+        bool isSemiPlanar() const { return layout == LAYOUT_NV12 || layout == LAYOUT_NV21; }
+        int planeCount() const { return isSemiPlanar() ? 2 : 3; }
+        int bytesPerSample() const { return bitDepth > 8 ? 2 : 1; }
+        int chromaShiftX() const { return layout == LAYOUT_YUV444P ? 0 : 1; }
+        int chromaShiftY() const { return (layout == LAYOUT_YUV422P || layout == LAYOUT_YUV444P) ? 0 : 1; }
     };
     
     /**
@@ -75,11 +145,12 @@ public:
     /**
      * @brief 更新视频帧（RGB格式）
      * @param frame QImage格式的视频帧
+     * @param ptsMs 帧时间戳（毫秒），上屏后随framePresented发出，-1表示不需要上屏反馈
      * 
      * 使用RGB模式渲染，适用于已经转换为RGB的图像。
      * 线程安全，可在任意线程调用。
      */
-    void updateFrame(const QImage &frame);
+    void updateFrame(const QImage &frame, qint64 ptsMs = -1);
     
     /**
      * @brief 更新视频帧（YUV420P格式）
@@ -99,6 +170,20 @@ public:
     void updateFrameYUV(const uint8_t *y_data, const uint8_t *u_data, const uint8_t *v_data,
                         int y_linesize, int u_linesize, int v_linesize,
                         int width, int height);
+
+    /**
+     * @brief 更新视频帧（任意支持的YUV格式）
+     * @param data 各平面数据（半平面格式只使用前两个）
+     * @param linesize 各平面行步长（字节）
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param format 平面布局、位深与色彩信息
+     * @param ptsMs 帧时间戳（毫秒），上屏后随framePresented发出，-1表示不需要上屏反馈
+     *
+     * 线程安全，可在任意线程调用。
+     */
+    void updateFrameYUV(const uint8_t *const data[3], const int linesize[3],
+                        int width, int height, const YUVFormat &format, qint64 ptsMs = -1);
     
     /**
      * @brief 检查OpenGL是否可用
@@ -111,10 +196,10 @@ public:
     
     /**
      * @brief 设置色彩空间标准
-     * @param space BT.601或BT.709
+     * @param space BT.601/BT.709/BT.2020
      * 
-     * 影响YUV到RGB转换的色彩准确性。
-     * BT.601兼容性最好，BT.709色彩更准确。
+     * 仅用于帧未携带色彩空间信息时；未设置时按分辨率自动选择。
+     * 色彩矩阵以uniform传入着色器，切换无需重新编译。
      */
     void setColorSpace(ColorSpace space);
     
@@ -141,6 +226,205 @@ public:
      */
     QString getRenderMode() const;
 
+    /**
+     * @brief 纹理上传统计
+     */
+    struct UploadStats {
+        qint64 frames = 0;              ///< 已上传帧数
+        qint64 bytes = 0;               ///< 已上传字节数
+        double avgUploadMs = 0.0;       ///< GUI线程单帧上传平均耗时（映射+拷贝+提交）
+        double maxUploadMs = 0.0;       ///< GUI线程单帧上传最大耗时
+        bool pboEnabled = false;        ///< 是否经PBO上传
+        bool rowLengthEnabled = false;  ///< 是否以GL_UNPACK_ROW_LENGTH按行步长上传
+        bool threaded = false;          ///< 是否由上传线程上传（此时耗时不占用GUI线程）
+    };
+
+    /**
+     * @brief 获取纹理上传统计
+     */
+    UploadStats getUploadStats() const;
+
+    /**
+     * @brief 重置纹理上传统计
+     */
+    void resetUploadStats();
+
+    /**
+     * @brief 上屏统计（以frameSwapped近似实际上屏时刻）
+     */
+    struct PresentStats {
+        qint64 presentedFrames = 0;     ///< 已上屏的新帧数
+        qint64 droppedFrames = 0;       ///< 提交后未上屏即被新帧覆盖的帧数
+        double vsyncIntervalMs = 0.0;   ///< 测得的垂直同步间隔（未测得时为屏幕标称值）
+        double lastLatencyMs = 0.0;     ///< 最近一帧从提交到上屏的耗时
+        double avgLatencyMs = 0.0;      ///< 提交到上屏的平均耗时
+    };
+
+    /**
+     * @brief 获取上屏统计
+     */
+    PresentStats getPresentStats() const;
+
+    /**
+     * @brief 重置上屏统计
+     */
+    void resetPresentStats();
+
+    /**
+     * @brief 显示/隐藏性能浮层（获得焦点时也可按F12切换）
+     */
+    void setPerfHudVisible(bool visible);
+    bool isPerfHudVisible() const { return m_perfHud.isVisible(); }
+
+    /**
+     * @brief 设置性能浮层显示的解码端计数器（GUI线程调用）
+     * @param counters 解码线程写入的计数器，为空表示只显示渲染端指标
+     */
+    void setPerfSourceCounters(std::shared_ptr<const PerfHudCounters> counters);
+
+    /**
+     * @brief 设置性能浮层标题
+     */
+    void setPerfHudTitle(const QString &title);
+
+    /**
+     * @brief 把当前显示帧经GL管线（色彩转换+缩放）渲染为图像，异步回读
+     * @param size 输出尺寸（空表示视频原始尺寸），画面按比例居中，其余区域为黑色
+     * @return 请求序号，结果通过frameImageReady发出；尚未绘制过帧或GL不可用时返回-1
+     *
+     * 在共享上下文的离屏帧缓冲中绘制，不影响屏幕显示，也不包含性能浮层；
+     * 须在GUI线程调用，不要在paintGL中调用。
+     */
+    int requestFrameImage(const QSize &size = QSize());
+
+    /**
+     * @brief 同requestFrameImage，但同步回读（阻塞到GPU完成）
+     * @return RGBA8888图像，失败时为空
+     */
+    QImage grabFrameImage(const QSize &size = QSize());
+
+    /**
+     * @brief 启用/禁用PBO上传（默认启用，驱动不支持时自动回退为直接上传）
+     * @param enabled 是否启用
+     *
+     * 主要用于对比测量两种上传方式的耗时。
+     */
+    void setPboUploadEnabled(bool enabled);
+
+    /**
+     * @brief 启用/禁用线程上传（默认启用，需在OpenGL初始化前设置）
+     * @param enabled 是否启用
+     *
+     * 上下文不支持共享上下文线程或栅栏同步（GL 3.2/ARB_sync/GLES3）时自动使用paintGL内上传。
+     */
+    void setThreadedUploadEnabled(bool enabled);
+
+    /**
+     * @brief 是否正在使用线程上传
+     */
+    bool isThreadedUpload() const { return m_uploadThread != nullptr; }
+
+    // ==================== YUV渲染辅助（供同一上下文中的其他视频渲染器复用） ====================
+
+    /**
+     * @brief YUV着色器变体（按采样方式区分，色彩矩阵为uniform，与变体无关）
+     */
+    enum ShaderVariant {
+        SHADER_PLANAR8,     ///< 三平面8位
+        SHADER_PLANAR16,    ///< 三平面16位存储
+        SHADER_NV12,        ///< 双平面8位
+        SHADER_NV21,        ///< 双平面8位，VU顺序
+        SHADER_NV12_16,     ///< 双平面16位存储（P010/P016）
+        SHADER_VARIANT_COUNT
+    };
+
+    /**
+     * @brief 根据帧格式选择着色器变体
+     */
+    static ShaderVariant shaderVariantFor(const YUVFormat &format);
+
+    /**
+     * @brief 编译并链接YUV着色器程序（顶点属性a_position/a_texCoord，uniform u_transform）
+     * @param variant 着色器变体
+     * @param parent 程序对象的父对象
+     * @return 着色器程序，编译失败返回nullptr
+     * 必须在有效的OpenGL上下文中调用；以可缓存方式链接，命中磁盘程序二进制时不编译。
+     * 返回的程序归调用方所有，本类自身使用的程序取自共享组缓存（SsProgramCache）
+     */
+    static QOpenGLShaderProgram *createYUVProgram(ShaderVariant variant, QObject *parent);
+
+    /**
+     * @brief 获取当前上下文共享组内的YUV着色器程序（首次请求时链接）
+     * @param variant 着色器变体
+     * @return 着色器程序（由SsProgramCache持有，调用方不得delete），失败返回nullptr
+     */
+    static QOpenGLShaderProgram *sharedYUVProgram(ShaderVariant variant);
+
+    /**
+     * @brief 设置YUV着色器的采样器（Y/U/V依次为纹理单元0/1/2）、色彩矩阵与样本归一化系数
+     * @param program 已绑定的YUV着色器程序
+     * @param format 帧格式
+     * @param colorSpace 帧未携带色彩空间信息时使用的色彩空间
+     */
+    static void setYUVUniforms(QOpenGLShaderProgram *program, const YUVFormat &format, ColorSpace colorSpace);
+
+    /**
+     * @brief 16位存储样本的归一化系数（8位格式为1），使样本值变为"码值/(2^位深-1)"
+     */
+    static float sampleScale(const YUVFormat &format);
+
+    /**
+     * @brief 计算YUV到RGB的转换参数：rgb = matrix * (yuv - offset)
+     * @param space 色彩空间
+     * @param range 取值范围
+     * @param bitDepth 有效位深（决定有限范围的偏移量）
+     * @param matrix 输出的3x3转换矩阵（已包含范围缩放）
+     * @param offset 输出的YUV偏移
+     */
+    static void computeColorMatrix(ColorSpace space, ColorRange range, int bitDepth,
+                                   QMatrix3x3 &matrix, QVector3D &offset);
+
+    /**
+     * @brief 计算各平面的纹理尺寸与每像素字节数
+     * @param format 帧格式
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param planeWidth 输出的平面宽度（像素）
+     * @param planeHeight 输出的平面高度（像素）
+     * @param bytesPerPixel 输出的每像素字节数（像素格式由pixelFormatForBytes得到）
+     * @return 平面数量
+     */
+    static int planeGeometry(const YUVFormat &format, int width, int height,
+                             int planeWidth[3], int planeHeight[3], int bytesPerPixel[3]);
+
+    /**
+     * @brief 按字节数选择上传用的像素格式（1:LUMINANCE 2:LUMINANCE_ALPHA 4:RGBA）
+     */
+    static GLenum pixelFormatForBytes(int bytesPerPixel);
+
+    /**
+     * @brief 根据分辨率自动选择色彩空间
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @return 推荐的色彩空间
+     */
+    static ColorSpace autoSelectColorSpace(int width, int height);
+
+signals:
+    /**
+     * @brief 一个新帧已上屏（GUI线程，缓冲交换之后发出）
+     * @param ptsMs 帧时间戳（毫秒），提交时未给出时间戳的帧不发出
+     * @param vsyncIntervalUs 垂直同步间隔（微秒），0表示未知
+     */
+    void framePresented(qint64 ptsMs, qint64 vsyncIntervalUs);
+
+    /**
+     * @brief requestFrameImage的结果（GUI线程）
+     * @param requestId requestFrameImage返回的序号
+     * @param image RGBA8888图像
+     */
+    void frameImageReady(int requestId, const QImage &image);
+
 protected:
     /**
      * @brief OpenGL初始化
@@ -164,7 +448,20 @@ protected:
      */
     void paintGL() override;
 
+    /**
+     * @brief F12切换性能浮层
+     */
+    void keyPressEvent(QKeyEvent *event) override;
+
+private slots:
+    /**
+     * @brief 缓冲交换完成：测量vsync间隔，新帧上屏时记录延迟并发出framePresented
+     */
+    void onFrameSwapped();
+
 private:
+    friend class VideoUploadThread;
+
     /**
      * @brief 渲染模式枚举
      */
@@ -173,6 +470,21 @@ private:
         ModeRGB,    ///< RGB纹理模式
         ModeYUV     ///< YUV纹理模式（GPU转换）
     };
+
+    /**
+     * @brief 单个平面的上传描述
+     */
+    struct PlaneUpload {
+        GLuint texture = 0;         ///< 目标纹理
+        GLenum format = 0;          ///< 像素格式（GL_LUMINANCE/GL_RGBA等）
+        int bytesPerPixel = 1;      ///< 每像素字节数
+        const uint8_t *data = nullptr;  ///< 源数据
+        int linesize = 0;           ///< 源数据行步长（字节）
+        int width = 0;              ///< 平面宽度（像素）
+        int height = 0;             ///< 平面高度（像素）
+    };
+
+    static constexpr int PBO_RING_SIZE = 3;     ///< PBO环形队列长度
     
     /**
      * @brief 初始化RGB纹理
@@ -191,6 +503,12 @@ private:
      * 必须在有效的OpenGL上下文中调用
      */
     void cleanupGL();
+
+    /**
+     * @brief 停止并释放上传线程（GUI线程调用）
+     * 先在m_uploadThreadMutex下取走指针，解码线程此后不会再访问该对象，再停止线程
+     */
+    void releaseUploadThread();
     
     /**
      * @brief 从QImage更新RGB纹理
@@ -199,22 +517,45 @@ private:
      */
     void updateTextureFromImage(const QImage &image);
     
+    struct YUVData;
+
     /**
      * @brief 更新YUV纹理（内部调用，必须在OpenGL上下文中）
-     * @param y_data Y平面数据
-     * @param u_data U平面数据
-     * @param v_data V平面数据
-     * @param y_linesize Y平面行步长
-     * @param u_linesize U平面行步长
-     * @param v_linesize V平面行步长
-     * @param width 视频宽度
-     * @param height 视频高度
+     * @param data 待上传的YUV数据
      * 
+     * 格式或分辨率变化时重新分配纹理存储。
      * 注意：此函数必须在有效的OpenGL上下文中调用（如paintGL内部）
      */
-    void updateYUVTexturesInternal(const uint8_t *y_data, const uint8_t *u_data, const uint8_t *v_data,
-                                   int y_linesize, int u_linesize, int v_linesize,
-                                   int width, int height);
+    void updateYUVTexturesInternal(const YUVData &data);
+
+    /**
+     * @brief 按帧格式生成各平面的上传描述（纹理像素格式、尺寸、源数据）
+     * @param data YUV帧数据
+     * @param textures 各平面目标纹理
+     * @param planes 输出的平面描述
+     * @return 平面数量，数据无效时返回0
+     */
+    static int buildPlaneUploads(const YUVData &data, const GLuint textures[3], PlaneUpload planes[3]);
+
+    /**
+     * @brief 记录一次上传的耗时与字节数（可在上传线程中调用）
+     */
+    void recordUploadStats(double elapsedMs, qint64 bytes, bool pbo, bool threaded);
+
+    /**
+     * @brief 记录一帧未上屏即被覆盖（可在任意线程调用）
+     */
+    void recordDroppedFrame();
+
+    /**
+     * @brief 标记本次paintGL绘制的是新帧（swap后由onFrameSwapped上报）
+     */
+    void markFramePainted(qint64 ptsMs, qint64 submitUs);
+
+    /**
+     * @brief 绘制视频画面（paintGL去掉性能浮层记录后的主体）
+     */
+    void renderVideo();
     
     /**
      * @brief 创建OpenGL着色器程序
@@ -222,19 +563,18 @@ private:
      * @return 是否创建成功
      */
     bool createShaders();
-    
+
     /**
-     * @brief 更新帧率统计
+     * @brief 获取YUV着色器程序（首次使用时编译）
+     * @param variant 着色器变体
+     * @return 着色器程序，编译失败返回nullptr
      */
-    void updateFpsStats();
-    
+    QOpenGLShaderProgram *yuvProgram(ShaderVariant variant);
+
     /**
-     * @brief 根据分辨率自动选择色彩空间
-     * @param width 视频宽度
-     * @param height 视频高度
-     * @return 推荐的色彩空间
+     * @brief 更新帧率统计
      */
-    ColorSpace autoSelectColorSpace(int width, int height);
+    void updateFpsStats();
     
     /**
      * @brief 检查OpenGL错误并记录
@@ -250,10 +590,41 @@ private:
      */
     QMatrix4x4 calculateTransformMatrix(int frameWidth, int frameHeight) const;
 
+    /**
+     * @brief 检测PBO与GL_UNPACK_ROW_LENGTH支持情况
+     * 必须在有效的OpenGL上下文中调用
+     */
+    void detectUploadCapabilities();
+
+    /**
+     * @brief 尺寸变化时重新分配纹理存储（相同尺寸直接复用）
+     * @param texture 纹理ID
+     * @param format 像素格式
+     * @param width 宽度
+     * @param height 高度
+     */
+    void allocateTexture(GLuint texture, GLenum format, int width, int height);
+
+    /**
+     * @brief 上传一组平面到已分配的纹理
+     * @param planes 平面描述数组
+     * @param count 平面数量
+     *
+     * 所有平面写入同一个PBO（环形队列中的下一个），再逐个glTexSubImage2D，
+     * 实际拷贝由驱动异步完成，不阻塞本帧绘制。
+     * 必须在有效的OpenGL上下文中调用
+     */
+    void uploadPlanes(const PlaneUpload *planes, int count);
+
+    /**
+     * @brief 按行拷贝平面数据（去除或保留行尾填充）
+     */
+    static void copyPlane(uint8_t *dst, int dstStride, const PlaneUpload &plane);
+
     // ==================== OpenGL资源 ====================
     
-    QOpenGLShaderProgram *m_programRGB = nullptr;   ///< RGB模式着色器程序
-    QOpenGLShaderProgram *m_programYUV = nullptr;   ///< YUV模式着色器程序
+    QOpenGLShaderProgram *m_programRGB = nullptr;   ///< RGB模式着色器程序（由共享组缓存持有）
+    QOpenGLShaderProgram *m_programsYUV[SHADER_VARIANT_COUNT] = {};  ///< YUV模式着色器程序（按变体，由共享组缓存持有）
     
     GLuint m_textureRGB = 0;    ///< RGB纹理ID
     GLuint m_textureY = 0;      ///< Y平面纹理ID
@@ -272,6 +643,10 @@ private:
     int m_yHeight = 0;          ///< Y平面高度
     int m_uvWidth = 0;          ///< UV平面宽度（YUV420中为宽度/2）
     int m_uvHeight = 0;         ///< UV平面高度（YUV420中为高度/2）
+    int m_yuvTexWidth = 0;      ///< YUV纹理已分配宽度
+    int m_yuvTexHeight = 0;     ///< YUV纹理已分配高度
+    YUVFormat m_yuvTexFormat;   ///< YUV纹理已分配的格式
+    YUVFormat m_yuvFormat;      ///< 当前显示帧的格式
     
     // ==================== 帧数据（线程安全）====================
     
@@ -286,6 +661,50 @@ private:
     
     QOpenGLBuffer m_vertexBuffer;   ///< 顶点缓冲区（位置+纹理坐标）
     QOpenGLBuffer m_indexBuffer;    ///< 索引缓冲区（三角形索引）
+
+    // ==================== 纹理上传 ====================
+
+    QOpenGLBuffer m_uploadPbos[PBO_RING_SIZE];  ///< 像素上传缓冲区环形队列
+    int m_pboIndex = 0;                         ///< 下一个使用的PBO
+    bool m_pboSupported = false;                ///< 驱动是否支持PBO
+    bool m_pboEnabled = true;                   ///< 是否允许使用PBO
+    bool m_rowLengthSupported = false;          ///< 是否支持GL_UNPACK_ROW_LENGTH
+    QByteArray m_repackBuffer;                  ///< 不支持行步长且无PBO时的紧凑重排缓冲
+    VideoUploadThread *m_uploadThread = nullptr;    ///< YUV纹理上传线程（不支持时为空；只在GUI线程中替换，替换与跨线程访问都持m_uploadThreadMutex）
+    QMutex m_uploadThreadMutex;                 ///< 保护m_uploadThread指针
+    bool m_threadedUploadEnabled = true;        ///< 是否允许线程上传
+
+    mutable QMutex m_statsMutex;                ///< 上传统计互斥锁
+    UploadStats m_uploadStats;                  ///< 上传统计
+    double m_uploadTotalMs = 0.0;               ///< 累计上传耗时
+
+    // ==================== 上屏反馈 ====================
+
+    QElapsedTimer m_presentTimer;               ///< 呈现计时器（单调时钟，提交/上屏时刻均以此计）
+    PresentStats m_presentStats;                ///< 上屏统计（m_statsMutex保护）
+    double m_latencyTotalMs = 0.0;              ///< 累计提交到上屏耗时
+    qint64 m_lastSwapUs = 0;                    ///< 上一次缓冲交换时刻
+    double m_vsyncIntervalUs = 0.0;             ///< 测得的vsync间隔（0表示尚未测得）
+    bool m_framePainted = false;                ///< 本次绘制是否为新帧
+    qint64 m_paintedPtsMs = -1;                 ///< 本次绘制帧的时间戳
+    qint64 m_paintedSubmitUs = 0;               ///< 本次绘制帧的提交时刻
+    quint64 m_displayedSequence = 0;            ///< 线程上传时已绘制的纹理环帧序号
+    qint64 m_rgbPtsMs = -1;                     ///< 待上传RGB帧的时间戳（m_frameMutex保护）
+    qint64 m_rgbSubmitUs = 0;                   ///< 待上传RGB帧的提交时刻
+
+    // ==================== 性能浮层 ====================
+
+    PerfHud m_perfHud;                          ///< 性能浮层（GUI线程）
+    PerfHudCounters m_renderCounters;           ///< 渲染端计数器（GUI线程/上传线程写入）
+
+    // ==================== 离屏渲染 ====================
+
+    /** 把最近绘制的纹理交给离屏渲染器，按需创建渲染器 */
+    bool prepareFrameRenderer();
+
+    VideoFrameRenderer *m_frameRenderer = nullptr;  ///< 离屏渲染器（与本组件上下文共享）
+    GLuint m_drawnTextures[3] = {0, 0, 0};          ///< 最近一次绘制使用的纹理（RGB模式只用第一个）
+    bool m_drawnRGB = false;                        ///< 最近一次绘制是否为RGB模式
     
     // ==================== 性能统计 ====================
     
@@ -295,7 +714,9 @@ private:
     
     // ==================== 色彩空间 ====================
     
-    ColorSpace m_colorSpace = COLOR_BT601;  ///< 当前色彩空间，默认BT.601确保兼容性
+    ColorSpace m_colorSpace = COLOR_BT601;  ///< 帧未携带色彩信息时使用的色彩空间
+    bool m_colorSpaceExplicit = false;      ///< 是否由setColorSpace显式设置（否则按分辨率自动选择）
+    ColorSpace m_activeColorSpace = COLOR_BT601;    ///< 当前帧实际使用的色彩空间
     
     // ==================== YUV数据缓冲区（线程安全）====================
     
@@ -304,26 +725,48 @@ private:
      */
     struct YUVData {
         QByteArray yData;       ///< Y平面数据
-        QByteArray uData;       ///< U平面数据
-        QByteArray vData;       ///< V平面数据
+        QByteArray uData;       ///< U平面数据（半平面格式为UV交错数据）
+        QByteArray vData;       ///< V平面数据（半平面格式为空）
         int yLinesize = 0;      ///< Y平面行步长
         int uLinesize = 0;      ///< U平面行步长
         int vLinesize = 0;      ///< V平面行步长
         int width = 0;          ///< 视频宽度
         int height = 0;         ///< 视频高度
+        YUVFormat format;       ///< 帧格式
+        qint64 ptsMs = -1;      ///< 帧时间戳（毫秒）
+        qint64 submitUs = 0;    ///< 提交时刻（呈现计时器）
         bool valid = false;     ///< 数据是否有效
         
+        void swap(YUVData &other) {
+            yData.swap(other.yData);
+            uData.swap(other.uData);
+            vData.swap(other.vData);
+            std::swap(yLinesize, other.yLinesize);
+            std::swap(uLinesize, other.uLinesize);
+            std::swap(vLinesize, other.vLinesize);
+            std::swap(width, other.width);
+            std::swap(height, other.height);
+            std::swap(format, other.format);
+            std::swap(ptsMs, other.ptsMs);
+            std::swap(submitUs, other.submitUs);
+            std::swap(valid, other.valid);
+        }
+
         void clear() {
             yData.clear();
             uData.clear();
             vData.clear();
             yLinesize = uLinesize = vLinesize = 0;
             width = height = 0;
+            format = YUVFormat();
+            ptsMs = -1;
+            submitUs = 0;
             valid = false;
         }
     };
     
     YUVData m_pendingYUV;       ///< 待处理的YUV数据
+    YUVData m_uploadYUV;        ///< 正在上传的YUV数据（与m_pendingYUV交换，上传时不持锁）
     QMutex m_yuvMutex;          ///< YUV数据互斥锁
     
     // 标记是否有新的RGB帧需要更新纹理
@@ -348,7 +791,27 @@ public:
      */
     enum ColorSpace {
         COLOR_BT601,
-        COLOR_BT709
+        COLOR_BT709,
+        COLOR_BT2020
+    };
+    enum ColorRange {
+        RANGE_LIMITED,
+        RANGE_FULL
+    };
+    enum PixelLayout {
+        LAYOUT_YUV420P,
+        LAYOUT_YUV422P,
+        LAYOUT_YUV444P,
+        LAYOUT_NV12,
+        LAYOUT_NV21
+    };
+    struct YUVFormat {
+        PixelLayout layout = LAYOUT_YUV420P;
+        int bitDepth = 8;
+        bool msbAligned = false;
+        bool hasColorSpace = false;
+        ColorSpace colorSpace = COLOR_BT601;
+        ColorRange range = RANGE_LIMITED;
     };
     
     explicit OpenGLVideoWidget(QWidget *parent = nullptr) : QWidget(parent) 
@@ -357,13 +820,49 @@ public:
     }
     
     bool isInitialized() const { return false; }
-    void updateFrame(const QImage &) {}
+    void updateFrame(const QImage &, qint64 = -1) {}
     void updateFrameYUV(const uint8_t*, const uint8_t*, const uint8_t*, int, int, int, int, int) {}
+    void updateFrameYUV(const uint8_t *const[3], const int[3], int, int, const YUVFormat &, qint64 = -1) {}
     static bool isOpenGLAvailable() { return false; }
     void setColorSpace(ColorSpace) {}
     void clear() {}
     float getCurrentFps() const { return 0.0f; }
     QString getRenderMode() const { return "Software (OpenGL disabled)"; }
+
+    struct UploadStats {
+        qint64 frames = 0;
+        qint64 bytes = 0;
+        double avgUploadMs = 0.0;
+        double maxUploadMs = 0.0;
+        bool pboEnabled = false;
+        bool rowLengthEnabled = false;
+        bool threaded = false;
+    };
+    UploadStats getUploadStats() const { return UploadStats(); }
+    void resetUploadStats() {}
+
+    struct PresentStats {
+        qint64 presentedFrames = 0;
+        qint64 droppedFrames = 0;
+        double vsyncIntervalMs = 0.0;
+        double lastLatencyMs = 0.0;
+        double avgLatencyMs = 0.0;
+    };
+    PresentStats getPresentStats() const { return PresentStats(); }
+    void resetPresentStats() {}
+    void setPerfHudVisible(bool) {}
+    bool isPerfHudVisible() const { return false; }
+    void setPerfSourceCounters(std::shared_ptr<const PerfHudCounters>) {}
+    void setPerfHudTitle(const QString &) {}
+    int requestFrameImage(const QSize & = QSize()) { return -1; }
+    QImage grabFrameImage(const QSize & = QSize()) { return QImage(); }
+    void setPboUploadEnabled(bool) {}
+    void setThreadedUploadEnabled(bool) {}
+    bool isThreadedUpload() const { return false; }
+
+signals:
+    void framePresented(qint64 ptsMs, qint64 vsyncIntervalUs);
+    void frameImageReady(int requestId, const QImage &image);
 };
 
 #endif // OPENGL_ENABLE
@@ -0,0 +1,518 @@
+#include "perf_hud.h"
+
+#ifdef OPENGL_ENABLE
+
+#include <QDebug>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QPainter>
+#include <QStringList>
+#include <QVector2D>
+
+// ==================== 着色器源码（版本声明由shaderSource按上下文补全） ====================
+
+/**
+ * @brief 顶点着色器：输入为窗口像素坐标（左上角为原点），第二个属性为颜色或纹理坐标
+ */
+static const char *hudVertexShaderSource =
+    "attribute vec2 a_position;\n"
+    "attribute vec4 a_data;\n"
+    "uniform vec2 u_viewport;\n"
+    "varying vec4 v_data;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(a_position.x / u_viewport.x * 2.0 - 1.0,\n"
+    "                       1.0 - a_position.y / u_viewport.y * 2.0, 0.0, 1.0);\n"
+    "    v_data = a_data;\n"
+    "}\n";
+
+/** 顶点颜色（已预乘alpha） */
+static const char *hudSolidFragmentSource =
+    "varying vec4 v_data;\n"
+    "void main() {\n"
+    "    gl_FragColor = v_data;\n"
+    "}\n";
+
+/** 文字纹理（已预乘alpha） */
+static const char *hudTextFragmentSource =
+    "uniform sampler2D u_texture;\n"
+    "varying vec4 v_data;\n"
+    "void main() {\n"
+    "    gl_FragColor = texture2D(u_texture, v_data.xy);\n"
+    "}\n";
+
+namespace {
+
+constexpr int FLOATS_PER_VERTEX = 6;    // x, y, r/u, g/v, b, a
+constexpr int QUAD_VERTICES = 6;        // 两个三角形
+
+/** 追加一个矩形（两个三角形），颜色需已预乘alpha */
+float *appendQuad(float *out, float x0, float y0, float x1, float y1,
+                  float r, float g, float b, float a)
+{
+    const float corners[QUAD_VERTICES][2] = {
+        {x0, y0}, {x1, y0}, {x1, y1},
+        {x0, y0}, {x1, y1}, {x0, y1}
+    };
+    for (const auto &c : corners) {
+        *out++ = c[0];
+        *out++ = c[1];
+        *out++ = r;
+        *out++ = g;
+        *out++ = b;
+        *out++ = a;
+    }
+    return out;
+}
+
+/** 追加一个带纹理坐标的矩形 */
+float *appendTexturedQuad(float *out, float x0, float y0, float x1, float y1)
+{
+    const float corners[QUAD_VERTICES][4] = {
+        {x0, y0, 0.0f, 0.0f}, {x1, y0, 1.0f, 0.0f}, {x1, y1, 1.0f, 1.0f},
+        {x0, y0, 0.0f, 0.0f}, {x1, y1, 1.0f, 1.0f}, {x0, y1, 0.0f, 1.0f}
+    };
+    for (const auto &c : corners) {
+        *out++ = c[0];
+        *out++ = c[1];
+        *out++ = c[2];
+        *out++ = c[3];
+        *out++ = 0.0f;
+        *out++ = 0.0f;
+    }
+    return out;
+}
+
+} // namespace
+
+// 背景 + 两条参考线 + 每个采样一根柱 + 文字
+static constexpr int HUD_MAX_VERTICES = QUAD_VERTICES * (1 + 2 + 120 + 1);
+
+// ==================== PerfHud ====================
+
+PerfHud::PerfHud()
+    : m_vertexBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    static_assert(HUD_MAX_VERTICES >= QUAD_VERTICES * (3 + HISTORY_SIZE + 1), "vertex budget too small");
+    m_vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+}
+
+PerfHud::~PerfHud()
+{
+    // GL资源由宿主在上下文有效时调用cleanup释放，上下文销毁时随之释放
+}
+
+void PerfHud::setVisible(bool visible)
+{
+    if (m_visible == visible) {
+        return;
+    }
+    m_visible = visible;
+    m_textDirty = true;
+    qDebug() << "Performance HUD" << (visible ? "shown" : "hidden");
+}
+
+void PerfHud::setTitle(const QString &title)
+{
+    m_title = title;
+    m_textDirty = true;
+}
+
+void PerfHud::setSourceCounters(std::shared_ptr<const PerfHudCounters> counters)
+{
+    m_source = std::move(counters);
+    m_textDirty = true;
+}
+
+void PerfHud::setRenderCounters(const PerfHudCounters *counters)
+{
+    m_render = counters;
+    m_textDirty = true;
+}
+
+QByteArray PerfHud::shaderSource(const char *body, bool vertex)
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    const QSurfaceFormat format = context->format();
+
+    QByteArray source;
+    if (context->isOpenGLES()) {
+        source = "#version 100\nprecision mediump float;\n";
+    } else if (format.profile() == QSurfaceFormat::CoreProfile &&
+               format.version() >= qMakePair(3, 2)) {
+        // Core Profile不支持attribute/varying/gl_FragColor，以宏映射到130+语法
+        source = "#version 150\n";
+        if (vertex) {
+            source += "#define attribute in\n#define varying out\n";
+        } else {
+            source += "#define varying in\n#define texture2D texture\n"
+                      "out vec4 fragColor;\n#define gl_FragColor fragColor\n";
+        }
+    } else {
+        source = "#version 120\n";
+    }
+    source += body;
+    return source;
+}
+
+bool PerfHud::createPrograms()
+{
+    struct ProgramDesc {
+        QOpenGLShaderProgram **program;
+        const char *fragment;
+        const char *name;
+    } descs[] = {
+        {&m_solidProgram, hudSolidFragmentSource, "solid"},
+        {&m_textProgram, hudTextFragmentSource, "text"}
+    };
+
+    for (const ProgramDesc &desc : descs) {
+        QOpenGLShaderProgram *program = new QOpenGLShaderProgram();
+        program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, shaderSource(hudVertexShaderSource, true));
+        program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, shaderSource(desc.fragment, false));
+        program->bindAttributeLocation("a_position", 0);
+        program->bindAttributeLocation("a_data", 1);
+        if (!program->link()) {
+            qWarning() << "PerfHud: failed to link" << desc.name << "program:" << program->log();
+            delete program;
+            return false;
+        }
+        *desc.program = program;
+    }
+    return true;
+}
+
+bool PerfHud::initialize()
+{
+    // 宿主上下文重建时旧资源随旧上下文失效，只丢弃句柄，不能在新上下文中按旧ID删除
+    delete m_solidProgram;
+    m_solidProgram = nullptr;
+    delete m_textProgram;
+    m_textProgram = nullptr;
+    delete m_vao;
+    m_vao = nullptr;
+    m_vertexBuffer = QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    m_vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_textTexture = 0;
+    m_initialized = false;
+
+    initializeOpenGLFunctions();
+
+    if (!createPrograms()) {
+        cleanup();
+        return false;
+    }
+
+    // Core Profile下没有默认顶点数组对象，兼容模式下创建失败也可直接绘制
+    m_vao = new QOpenGLVertexArrayObject();
+    if (!m_vao->create()) {
+        delete m_vao;
+        m_vao = nullptr;
+        const QSurfaceFormat format = QOpenGLContext::currentContext()->format();
+        if (format.profile() == QSurfaceFormat::CoreProfile) {
+            qWarning() << "PerfHud: vertex array object unavailable in core profile";
+            cleanup();
+            return false;
+        }
+    }
+
+    m_vertexBuffer.create();
+    m_vertexBuffer.bind();
+    m_vertexBuffer.allocate(HUD_MAX_VERTICES * FLOATS_PER_VERTEX * static_cast<int>(sizeof(float)));
+    m_vertexBuffer.release();
+
+    glGenTextures(1, &m_textTexture);
+    glBindTexture(GL_TEXTURE_2D, m_textTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_textTextureSize = QSize();
+    m_textDirty = true;
+
+    m_initialized = true;
+    return true;
+}
+
+void PerfHud::cleanup()
+{
+    if (!QOpenGLContext::currentContext()) {
+        return;
+    }
+
+    delete m_solidProgram;
+    m_solidProgram = nullptr;
+    delete m_textProgram;
+    m_textProgram = nullptr;
+
+    if (m_vao) {
+        m_vao->destroy();
+        delete m_vao;
+        m_vao = nullptr;
+    }
+    if (m_vertexBuffer.isCreated()) {
+        m_vertexBuffer.destroy();
+    }
+    if (m_textTexture) {
+        glDeleteTextures(1, &m_textTexture);
+        m_textTexture = 0;
+    }
+    m_initialized = false;
+}
+
+void PerfHud::beginFrame()
+{
+    if (m_frameTimer.isValid()) {
+        m_frameMs[m_historyIndex] = static_cast<float>(m_frameTimer.nsecsElapsed() / 1000000.0);
+        m_historyIndex = (m_historyIndex + 1) % HISTORY_SIZE;
+        m_historyCount = qMin(m_historyCount + 1, HISTORY_SIZE);
+        m_frameTimer.restart();
+    } else {
+        m_frameTimer.start();
+    }
+    m_paintTimer.start();
+}
+
+QString PerfHud::buildText() const
+{
+    QStringList lines;
+    lines << (m_title.isEmpty() ? QStringLiteral("Performance  [F12]") : m_title + QStringLiteral("  [F12]"));
+
+    // 帧间隔统计
+    double sum = 0.0, maxMs = 0.0;
+    for (int i = 0; i < m_historyCount; ++i) {
+        sum += m_frameMs[i];
+        maxMs = qMax(maxMs, static_cast<double>(m_frameMs[i]));
+    }
+    const double avgMs = m_historyCount > 0 ? sum / m_historyCount : 0.0;
+    lines << QString("Frame   %1 ms avg  %2 ms max  %3 fps")
+                 .arg(avgMs, 0, 'f', 1).arg(maxMs, 0, 'f', 1)
+                 .arg(avgMs > 0.0 ? 1000.0 / avgMs : 0.0, 0, 'f', 1);
+    lines << QString("Paint   %1 ms  HUD %2 ms").arg(m_avgPaintMs, 0, 'f', 2).arg(m_hudMs, 0, 'f', 3);
+
+    const auto ms = [](qint64 us) {
+        return us < 0 ? QStringLiteral("--") : QString::number(us / 1000.0, 'f', 2);
+    };
+
+    if (m_source) {
+        const PerfHudCounters &c = *m_source;
+        lines << QString("Decode  %1 ms  Convert %2 ms")
+                     .arg(ms(c.decodeUs.load(std::memory_order_relaxed)))
+                     .arg(ms(c.convertUs.load(std::memory_order_relaxed)));
+
+        const int capacity = c.queueCapacity.load(std::memory_order_relaxed);
+        const QString queue = capacity > 0
+            ? QString("%1/%2").arg(c.queueDepth.load(std::memory_order_relaxed)).arg(capacity)
+            : QStringLiteral("off");
+        lines << QString("Queue   %1  Decoded %2  Dropped %3")
+                     .arg(queue)
+                     .arg(c.decodedFrames.load(std::memory_order_relaxed))
+                     .arg(c.droppedFrames.load(std::memory_order_relaxed));
+
+        const qint64 bitrate = c.bitrate.load(std::memory_order_relaxed);
+        lines << QString("Bitrate %1 Mbps  A/V %2 ms")
+                     .arg(bitrate < 0 ? QStringLiteral("--") : QString::number(bitrate / 1000000.0, 'f', 2))
+                     .arg(c.avDriftUs.load(std::memory_order_relaxed) / 1000.0, 0, 'f', 1);
+    }
+
+    if (m_render) {
+        const PerfHudCounters &c = *m_render;
+        lines << QString("Upload  %1 ms  Latency %2 ms  Overwritten %3")
+                     .arg(ms(c.uploadUs.load(std::memory_order_relaxed)))
+                     .arg(ms(c.latencyUs.load(std::memory_order_relaxed)))
+                     .arg(c.renderDroppedFrames.load(std::memory_order_relaxed));
+    }
+
+    return lines.join('\n');
+}
+
+void PerfHud::updateTextImage(qreal devicePixelRatio)
+{
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPixelSize(12);
+    const QFontMetrics metrics(font);
+
+    const QStringList lines = buildText().split('\n');
+    int textWidth = 0;
+    for (const QString &line : lines) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        textWidth = qMax(textWidth, metrics.horizontalAdvance(line));
+#else
+        textWidth = qMax(textWidth, metrics.width(line));
+#endif
+    }
+    const QSize logicalSize(textWidth, metrics.lineSpacing() * lines.size());
+    const QSize pixelSize = logicalSize * devicePixelRatio;
+
+    if (m_textImage.size() != pixelSize) {
+        m_textImage = QImage(pixelSize, QImage::Format_RGBA8888_Premultiplied);
+    }
+    m_textImage.setDevicePixelRatio(devicePixelRatio);
+    m_textImage.fill(Qt::transparent);
+
+    QPainter painter(&m_textImage);
+    painter.setFont(font);
+    painter.setPen(QColor(230, 230, 230));
+    for (int i = 0; i < lines.size(); ++i) {
+        painter.drawText(0, metrics.ascent() + i * metrics.lineSpacing(), lines[i]);
+    }
+    painter.end();
+
+    glBindTexture(GL_TEXTURE_2D, m_textTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (m_textTextureSize != pixelSize) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pixelSize.width(), pixelSize.height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, m_textImage.constBits());
+        m_textTextureSize = pixelSize;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pixelSize.width(), pixelSize.height(),
+                        GL_RGBA, GL_UNSIGNED_BYTE, m_textImage.constBits());
+    }
+
+    m_textDirty = false;
+    m_textTimer.start();
+}
+
+void PerfHud::render(int width, int height, qreal devicePixelRatio)
+{
+    if (m_paintTimer.isValid()) {
+        m_paintMs = m_paintTimer.nsecsElapsed() / 1000000.0;
+        m_avgPaintMs = m_avgPaintMs > 0.0 ? m_avgPaintMs * 0.9 + m_paintMs * 0.1 : m_paintMs;
+    }
+    if (!m_visible || !m_initialized || width <= 0 || height <= 0) {
+        return;
+    }
+
+    QElapsedTimer hudTimer;
+    hudTimer.start();
+
+    const float dpr = static_cast<float>(devicePixelRatio);
+    const int fbWidth = qRound(width * devicePixelRatio);
+    const int fbHeight = qRound(height * devicePixelRatio);
+
+    // ==================== 保存宿主GL状态 ====================
+    GLint viewport[4];
+    GLint program = 0, arrayBuffer = 0, activeTexture = 0, texture = 0;
+    GLint blendSrcRGB = 0, blendDstRGB = 0, blendSrcAlpha = 0, blendDstAlpha = 0;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRGB);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRGB);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+    const GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    const GLboolean depthEnabled = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean scissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+
+    // ==================== 文字纹理（限频重绘） ====================
+    if (m_textDirty || !m_textTimer.isValid() || m_textTimer.elapsed() >= TEXT_REFRESH_MS) {
+        updateTextImage(devicePixelRatio);
+    }
+
+    // ==================== 生成顶点（窗口像素坐标） ====================
+    const float margin = 8.0f * dpr;
+    const float padding = 6.0f * dpr;
+    const float barWidth = 2.0f * dpr;
+    const float graphWidth = HISTORY_SIZE * barWidth;
+    const float graphHeight = 60.0f * dpr;
+    const float textWidth = static_cast<float>(m_textTextureSize.width());
+    const float textHeight = static_cast<float>(m_textTextureSize.height());
+
+    const float panelX = margin;
+    const float panelY = margin;
+    const float panelW = qMax(graphWidth, textWidth) + 2.0f * padding;
+    const float panelH = textHeight + graphHeight + 3.0f * padding;
+    const float textX = panelX + padding;
+    const float textY = panelY + padding;
+    const float graphX = panelX + padding;
+    const float graphBottom = textY + textHeight + padding + graphHeight;
+
+    float vertices[HUD_MAX_VERTICES * FLOATS_PER_VERTEX];
+    float *out = vertices;
+
+    out = appendQuad(out, panelX, panelY, panelX + panelW, panelY + panelH, 0.0f, 0.0f, 0.0f, 0.6f);
+
+    // 60Hz/30Hz参考线
+    const float guideMs[2] = {1000.0f / 60.0f, 1000.0f / 30.0f};
+    for (float guide : guideMs) {
+        const float y = graphBottom - guide / GRAPH_RANGE_MS * graphHeight;
+        out = appendQuad(out, graphX, y, graphX + graphWidth, y + dpr, 0.3f, 0.3f, 0.3f, 0.3f);
+    }
+
+    // 帧间隔柱状图，从旧到新；超过一个/两个60Hz周期分别标为黄/红
+    const int start = (m_historyIndex - m_historyCount + HISTORY_SIZE) % HISTORY_SIZE;
+    for (int i = 0; i < m_historyCount; ++i) {
+        const float frameMs = m_frameMs[(start + i) % HISTORY_SIZE];
+        const float h = qMin(frameMs, GRAPH_RANGE_MS) / GRAPH_RANGE_MS * graphHeight;
+        const float x = graphX + (HISTORY_SIZE - m_historyCount + i) * barWidth;
+        if (frameMs <= guideMs[0] * 1.1f) {
+            out = appendQuad(out, x, graphBottom - h, x + barWidth, graphBottom, 0.2f, 0.8f, 0.3f, 1.0f);
+        } else if (frameMs <= guideMs[1] * 1.1f) {
+            out = appendQuad(out, x, graphBottom - h, x + barWidth, graphBottom, 0.9f, 0.8f, 0.2f, 1.0f);
+        } else {
+            out = appendQuad(out, x, graphBottom - h, x + barWidth, graphBottom, 0.95f, 0.25f, 0.2f, 1.0f);
+        }
+    }
+    const int solidVertexCount = static_cast<int>(out - vertices) / FLOATS_PER_VERTEX;
+
+    out = appendTexturedQuad(out, textX, textY, textX + textWidth, textY + textHeight);
+    const int totalVertexCount = static_cast<int>(out - vertices) / FLOATS_PER_VERTEX;
+
+    // ==================== 绘制 ====================
+    glViewport(0, 0, fbWidth, fbHeight);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);    // 顶点颜色与文字均为预乘alpha
+
+    if (m_vao) {
+        m_vao->bind();
+    }
+    m_vertexBuffer.bind();
+    m_vertexBuffer.write(0, vertices, totalVertexCount * FLOATS_PER_VERTEX * static_cast<int>(sizeof(float)));
+
+    const int stride = FLOATS_PER_VERTEX * sizeof(float);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void *>(2 * sizeof(float)));
+
+    m_solidProgram->bind();
+    m_solidProgram->setUniformValue("u_viewport", QVector2D(fbWidth, fbHeight));
+    glDrawArrays(GL_TRIANGLES, 0, solidVertexCount);
+
+    m_textProgram->bind();
+    m_textProgram->setUniformValue("u_viewport", QVector2D(fbWidth, fbHeight));
+    m_textProgram->setUniformValue("u_texture", 0);
+    glBindTexture(GL_TEXTURE_2D, m_textTexture);
+    glDrawArrays(GL_TRIANGLES, solidVertexCount, totalVertexCount - solidVertexCount);
+
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    m_vertexBuffer.release();
+    if (m_vao) {
+        m_vao->release();
+    }
+
+    // ==================== 恢复宿主GL状态 ====================
+    glUseProgram(static_cast<GLuint>(program));
+    glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(arrayBuffer));
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture));
+    glActiveTexture(static_cast<GLenum>(activeTexture));
+    glBlendFuncSeparate(blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha);
+    if (!blendEnabled) glDisable(GL_BLEND);
+    if (depthEnabled) glEnable(GL_DEPTH_TEST);
+    if (scissorEnabled) glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    m_hudMs = hudTimer.nsecsElapsed() / 1000000.0;
+}
+
+#endif // OPENGL_ENABLE
@@ -0,0 +1,183 @@
+/*****************************************************************
+File:        perf_hud.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: 性能浮层（HUD）
+             在宿主QOpenGLWidget的同一绘制过程中叠加帧耗时曲线与解码/转换/上传耗时、
+             队列深度、丢帧、码率、延迟等指标，现场无需性能分析工具即可判断卡顿来源
+             - 指标来自PerfHudCounters中的原子计数器，生产线程只做relaxed写入，读取端不加锁
+             - 帧耗时曲线、背景与参考线合并为一次绘制，文字每250ms重绘到纹理后一次绘制
+             - 着色器按上下文选择GLSL版本，兼容GL 2.1兼容模式、Core Profile与GLES2
+             计数器结构不依赖OpenGL，未启用OPENGL_ENABLE时解码端仍可包含本头文件并写入
+    使用方式（宿主组件）：
+        initializeGL():  m_perfHud.initialize();
+        paintGL()开头:    m_perfHud.beginFrame();
+        paintGL()结尾:    m_perfHud.render(width(), height(), devicePixelRatioF());
+        按键/菜单:        m_perfHud.toggle();
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <QtGlobal>
+
+#include <atomic>
+
+/**
+ * @brief 性能计数器（无锁）
+ *
+ * 各字段由所属线程以relaxed方式写入，HUD在GUI线程读取；
+ * 每个生产者只填写自己负责的字段，未填写的字段保持初始值，HUD不显示对应项。
+ */
+struct PerfHudCounters
+{
+    // ==================== 解码端（解码线程写入） ====================
+    std::atomic<qint64> decodeUs{-1};           ///< 最近一帧解码耗时（微秒，-1表示无数据）
+    std::atomic<qint64> convertUs{-1};          ///< 最近一帧格式转换/平面提取耗时（微秒）
+    std::atomic<int> queueDepth{0};             ///< 帧队列当前深度
+    std::atomic<int> queueCapacity{0};          ///< 帧队列容量（0表示未启用队列）
+    std::atomic<qint64> decodedFrames{0};       ///< 已解码帧数
+    std::atomic<qint64> droppedFrames{0};       ///< 同步丢弃的帧数
+    std::atomic<qint64> bitrate{-1};            ///< 码率（bps，-1表示无数据）
+    std::atomic<qint64> avDriftUs{0};           ///< 最近显示帧相对主时钟的偏差（微秒）
+
+    // ==================== 渲染端（渲染组件/上传线程写入） ====================
+    std::atomic<qint64> uploadUs{-1};           ///< 最近一帧纹理上传耗时（微秒）
+    std::atomic<qint64> latencyUs{-1};          ///< 最近一帧提交到上屏的耗时（微秒）
+    std::atomic<qint64> renderDroppedFrames{0}; ///< 未上屏即被新帧覆盖的帧数
+
+    /** 重置所有字段（打开新媒体时调用） */
+    void reset()
+    {
+        decodeUs.store(-1, std::memory_order_relaxed);
+        convertUs.store(-1, std::memory_order_relaxed);
+        queueDepth.store(0, std::memory_order_relaxed);
+        queueCapacity.store(0, std::memory_order_relaxed);
+        decodedFrames.store(0, std::memory_order_relaxed);
+        droppedFrames.store(0, std::memory_order_relaxed);
+        bitrate.store(-1, std::memory_order_relaxed);
+        avDriftUs.store(0, std::memory_order_relaxed);
+        uploadUs.store(-1, std::memory_order_relaxed);
+        latencyUs.store(-1, std::memory_order_relaxed);
+        renderDroppedFrames.store(0, std::memory_order_relaxed);
+    }
+};
+
+#ifdef OPENGL_ENABLE
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QString>
+
+#include <memory>
+
+class QOpenGLShaderProgram;
+class QOpenGLVertexArrayObject;
+
+class PerfHud : protected QOpenGLFunctions
+{
+public:
+    PerfHud();
+    ~PerfHud();
+
+    PerfHud(const PerfHud &) = delete;
+    PerfHud &operator=(const PerfHud &) = delete;
+
+    /** 显示/隐藏（隐藏时仍记录帧耗时，打开后曲线立即完整） */
+    void setVisible(bool visible);
+    bool isVisible() const { return m_visible; }
+    void toggle() { setVisible(!m_visible); }
+
+    /** 浮层标题（如组件名或URL） */
+    void setTitle(const QString &title);
+
+    /**
+     * @brief 设置解码端计数器（GUI线程调用）
+     * @param counters 由解码线程写入的计数器，为空表示不显示解码端指标
+     */
+    void setSourceCounters(std::shared_ptr<const PerfHudCounters> counters);
+
+    /**
+     * @brief 设置渲染端计数器（GUI线程调用，计数器生命周期由宿主保证）
+     */
+    void setRenderCounters(const PerfHudCounters *counters);
+
+    /**
+     * @brief 创建着色器与缓冲（宿主上下文为当前上下文时调用，可重复调用）
+     * @return 是否创建成功，失败时render不绘制
+     */
+    bool initialize();
+
+    /**
+     * @brief 释放GL资源（宿主上下文为当前上下文时调用）
+     */
+    void cleanup();
+
+    /**
+     * @brief 记录一帧开始（宿主paintGL开头调用）
+     */
+    void beginFrame();
+
+    /**
+     * @brief 在当前帧缓冲上叠加绘制浮层（宿主paintGL结尾调用）
+     * @param width 宿主逻辑宽度
+     * @param height 宿主逻辑高度
+     * @param devicePixelRatio 设备像素比
+     *
+     * 修改的GL状态（视口、混合、深度测试、程序、纹理与缓冲绑定）在返回前恢复。
+     */
+    void render(int width, int height, qreal devicePixelRatio);
+
+    /** 最近一次render自身的耗时（毫秒） */
+    double lastRenderMs() const { return m_hudMs; }
+
+private:
+    static constexpr int HISTORY_SIZE = 120;            ///< 帧耗时曲线采样数
+    static constexpr int TEXT_REFRESH_MS = 250;         ///< 文字重绘间隔
+    static constexpr float GRAPH_RANGE_MS = 50.0f;      ///< 曲线纵轴满量程
+
+    bool createPrograms();
+    /** 按上下文类型补全GLSL版本声明 */
+    static QByteArray shaderSource(const char *body, bool vertex);
+    /** 重新排版文字纹理 */
+    void updateTextImage(qreal devicePixelRatio);
+    QString buildText() const;
+
+    bool m_visible = false;
+    QString m_title;
+    std::shared_ptr<const PerfHudCounters> m_source;
+    const PerfHudCounters *m_render = nullptr;
+
+    // ==================== 帧耗时记录（GUI线程） ====================
+    float m_frameMs[HISTORY_SIZE] = {};     ///< 帧间隔环形队列
+    int m_historyIndex = 0;
+    int m_historyCount = 0;
+    QElapsedTimer m_frameTimer;             ///< 两次beginFrame的间隔
+    QElapsedTimer m_paintTimer;             ///< 宿主本帧绘制耗时
+    double m_paintMs = 0.0;
+    double m_avgPaintMs = 0.0;
+    double m_hudMs = 0.0;
+
+    // ==================== OpenGL资源 ====================
+    QOpenGLShaderProgram *m_solidProgram = nullptr;     ///< 顶点颜色（背景/曲线/参考线）
+    QOpenGLShaderProgram *m_textProgram = nullptr;      ///< 文字纹理
+    QOpenGLVertexArrayObject *m_vao = nullptr;          ///< Core Profile要求的顶点数组对象
+    QOpenGLBuffer m_vertexBuffer;
+    GLuint m_textTexture = 0;
+    QSize m_textTextureSize;
+    QImage m_textImage;                                 ///< 文字图像（预乘alpha）
+    QElapsedTimer m_textTimer;
+    bool m_textDirty = true;
+    bool m_initialized = false;
+};
+
+#endif // OPENGL_ENABLE
+
+#endif // PERF_HUD_H
@@ -0,0 +1,693 @@
+#include "video_frame_renderer.h"
+
+#ifdef OPENGL_ENABLE
+
+#include <QDebug>
+#include <QMatrix4x4>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <QTimer>
+#include <QVector>
+
+#include <cstring>
+
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
+// ==================== 着色器源码（RGB模式，与OpenGLVideoWidget一致） ====================
+
+static const char *vertexShaderSource =
+    "attribute vec4 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform mat4 u_transform;\n"
+    "void main() {\n"
+    "    gl_Position = u_transform * a_position;\n"
+    "    v_texCoord = a_texCoord;\n"
+    "}\n";
+
+static const char *fragmentShaderSourceRGB =
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform sampler2D u_texture;\n"
+    "varying vec2 v_texCoord;\n"
+    "void main() {\n"
+    "    gl_FragColor = texture2D(u_texture, v_texCoord);\n"
+    "}\n";
+
+// ==================== 上下文切换 ====================
+
+VideoFrameRenderer::ContextScope::ContextScope(VideoFrameRenderer *renderer)
+    : m_renderer(renderer)
+    , m_previous(QOpenGLContext::currentContext())
+{
+    if (!renderer->m_context)
+        return;
+
+    if (m_previous == renderer->m_context)
+    {
+        m_current = true;
+        return;
+    }
+
+    m_previousSurface = m_previous ? m_previous->surface() : nullptr;
+    m_current = renderer->m_context->makeCurrent(renderer->m_surface);
+    m_switched = true;
+    if (!m_current)
+        qWarning() << "VideoFrameRenderer: failed to make context current";
+}
+
+VideoFrameRenderer::ContextScope::~ContextScope()
+{
+    if (!m_switched)
+        return;
+
+    // 恢复调用方的当前上下文（QOpenGLWidget的上下文需由宿主重新makeCurrent才会绑定其帧缓冲）
+    if (m_previous && m_previousSurface)
+        m_previous->makeCurrent(m_previousSurface);
+    else
+        m_renderer->m_context->doneCurrent();
+}
+
+// ==================== 创建与释放 ====================
+
+VideoFrameRenderer::VideoFrameRenderer(QObject *parent)
+    : QObject(parent)
+    , m_vertexBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    for (QOpenGLBuffer &pbo : m_packPbos)
+    {
+        pbo = QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        pbo.setUsagePattern(QOpenGLBuffer::StreamRead);
+    }
+
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(POLL_INTERVAL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &VideoFrameRenderer::pollReadbacks);
+}
+
+VideoFrameRenderer::~VideoFrameRenderer()
+{
+    destroy();
+}
+
+bool VideoFrameRenderer::create(QOpenGLContext *shareContext)
+{
+    if (m_context)
+        return true;
+
+    QSurfaceFormat format;
+    if (shareContext)
+    {
+        format = shareContext->format();
+    }
+    else
+    {
+        // 与OpenGLVideoWidget相同的GL 2.1兼容模式，着色器可直接复用
+        format.setRenderableType(QSurfaceFormat::OpenGL);
+        format.setProfile(QSurfaceFormat::CompatibilityProfile);
+        format.setVersion(2, 1);
+    }
+
+    // 离屏表面必须在GUI线程创建
+    m_surface = new QOffscreenSurface();
+    m_surface->setFormat(format);
+    m_surface->create();
+    if (!m_surface->isValid())
+    {
+        qWarning() << "VideoFrameRenderer: failed to create offscreen surface";
+        delete m_surface;
+        m_surface = nullptr;
+        return false;
+    }
+
+    m_context = new QOpenGLContext();
+    m_context->setFormat(format);
+    m_context->setShareContext(shareContext);
+    if (!m_context->create())
+    {
+        qWarning() << "VideoFrameRenderer: failed to create context";
+        delete m_context;
+        m_context = nullptr;
+        delete m_surface;
+        m_surface = nullptr;
+        return false;
+    }
+
+    bool ok = false;
+    {
+        ContextScope scope(this);
+        if (scope.isCurrent())
+        {
+            initializeOpenGLFunctions();
+            detectCapabilities();
+            ok = initializeResources();
+        }
+    }
+    if (!ok)
+    {
+        destroy();
+        return false;
+    }
+
+    qDebug() << "VideoFrameRenderer created, shared:" << (shareContext != nullptr)
+             << "PBO readback:" << m_pboSupported << "fence:" << m_fenceSupported;
+    return true;
+}
+
+void VideoFrameRenderer::destroy()
+{
+    m_pollTimer->stop();
+    if (m_context)
+    {
+        ContextScope scope(this);
+        if (scope.isCurrent())
+            releaseResources();
+    }
+
+    // 先让上下文不再是当前上下文再删除
+    delete m_context;
+    m_context = nullptr;
+    delete m_surface;
+    m_surface = nullptr;
+
+    m_readbacks.clear();
+    for (bool &busy : m_pboBusy)
+        busy = false;
+    for (GLuint &texture : m_textures)
+        texture = 0;
+    m_frameWidth = m_frameHeight = 0;
+    m_sharedTextures = false;
+}
+
+void VideoFrameRenderer::detectCapabilities()
+{
+    const QSurfaceFormat fmt = m_context->format();
+    const int version = fmt.majorVersion() * 10 + fmt.minorVersion();
+
+    if (m_context->isOpenGLES())
+    {
+        // GLES2没有GL_PIXEL_PACK_BUFFER，只能同步回读
+        m_rowLengthSupported = version >= 30 || m_context->hasExtension("GL_EXT_unpack_subimage");
+        m_pboSupported = version >= 30;
+        m_fenceSupported = version >= 30;
+        m_mapRangeSupported = version >= 30;
+    }
+    else
+    {
+        m_rowLengthSupported = true;
+        m_pboSupported = version >= 21 || m_context->hasExtension("GL_ARB_pixel_buffer_object");
+        m_fenceSupported = version >= 32 || m_context->hasExtension("GL_ARB_sync");
+        m_mapRangeSupported = version >= 30 || m_context->hasExtension("GL_ARB_map_buffer_range");
+    }
+}
+
+bool VideoFrameRenderer::initializeResources()
+{
+    // 全视口四边形（三角形带），纹理坐标v向下，与OpenGLVideoWidget的顶点数据一致
+    static const float vertices[] = {
+        // 位置         纹理坐标
+        -1.0f, -1.0f,   0.0f, 1.0f,
+         1.0f, -1.0f,   1.0f, 1.0f,
+        -1.0f,  1.0f,   0.0f, 0.0f,
+         1.0f,  1.0f,   1.0f, 0.0f
+    };
+    if (!m_vertexBuffer.create())
+    {
+        qWarning() << "VideoFrameRenderer: failed to create vertex buffer";
+        return false;
+    }
+    m_vertexBuffer.bind();
+    m_vertexBuffer.allocate(vertices, sizeof(vertices));
+    m_vertexBuffer.release();
+
+    if (m_pboSupported)
+    {
+        for (QOpenGLBuffer &pbo : m_packPbos)
+        {
+            if (!pbo.create())
+            {
+                m_pboSupported = false;
+                break;
+            }
+        }
+    }
+
+    glGenTextures(3, m_ownTextures);
+    for (GLuint texture : m_ownTextures)
+    {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        m_ownTextureSize[i] = QSize();
+        m_ownTextureFormat[i] = 0;
+    }
+
+    // 平面行宽不一定是4的倍数；回读的RGBA行总是4字节对齐
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    return true;
+}
+
+void VideoFrameRenderer::releaseResources()
+{
+    QOpenGLExtraFunctions *gl = m_fenceSupported ? m_context->extraFunctions() : nullptr;
+    for (Readback &readback : m_readbacks)
+    {
+        if (readback.fence && gl)
+            gl->glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+
+    delete m_fbo;
+    m_fbo = nullptr;
+    delete m_programRGB;
+    m_programRGB = nullptr;
+    for (QOpenGLShaderProgram *&program : m_programsYUV)
+    {
+        delete program;
+        program = nullptr;
+    }
+
+    if (m_ownTextures[0])
+    {
+        glDeleteTextures(3, m_ownTextures);
+        for (GLuint &texture : m_ownTextures)
+            texture = 0;
+    }
+
+    if (m_vertexBuffer.isCreated())
+        m_vertexBuffer.destroy();
+    for (QOpenGLBuffer &pbo : m_packPbos)
+    {
+        if (pbo.isCreated())
+            pbo.destroy();
+    }
+}
+
+// ==================== 帧来源 ====================
+
+void VideoFrameRenderer::setColorSpace(OpenGLVideoWidget::ColorSpace space)
+{
+    m_colorSpace = space;
+    m_colorSpaceExplicit = true;
+}
+
+void VideoFrameRenderer::uploadPlane(int index, GLenum format, int width, int height, int bytesPerPixel,
+                                     const uint8_t *data, int linesize)
+{
+    glBindTexture(GL_TEXTURE_2D, m_ownTextures[index]);
+
+    // 尺寸或格式变化时才重新分配存储
+    const QSize size(width, height);
+    if (m_ownTextureSize[index] != size || m_ownTextureFormat[index] != format)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        m_ownTextureSize[index] = size;
+        m_ownTextureFormat[index] = format;
+    }
+
+    const int rowBytes = width * bytesPerPixel;
+    if (linesize == rowBytes)
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    }
+    else if (m_rowLengthSupported)
+    {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, linesize / bytesPerPixel);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    else
+    {
+        // 不支持行步长时去掉行尾填充
+        m_repackBuffer.resize(rowBytes * height);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(m_repackBuffer.data());
+        for (int y = 0; y < height; ++y)
+            memcpy(dst + y * rowBytes, data + y * linesize, rowBytes);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, dst);
+    }
+}
+
+bool VideoFrameRenderer::setFrame(const QImage &image)
+{
+    if (image.isNull())
+        return false;
+
+    ContextScope scope(this);
+    if (!scope.isCurrent())
+        return false;
+
+    const QImage rgba = image.format() == QImage::Format_RGBA8888
+                            ? image : image.convertToFormat(QImage::Format_RGBA8888);
+    uploadPlane(0, GL_RGBA, rgba.width(), rgba.height(), 4,
+                rgba.constBits(), static_cast<int>(rgba.bytesPerLine()));
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_textures[0] = m_ownTextures[0];
+    m_textures[1] = m_textures[2] = 0;
+    m_sharedTextures = false;
+    m_rgb = true;
+    m_frameWidth = rgba.width();
+    m_frameHeight = rgba.height();
+    return true;
+}
+
+bool VideoFrameRenderer::setFrameYUV(const uint8_t *const data[3], const int linesize[3],
+                                     int width, int height, const OpenGLVideoWidget::YUVFormat &format)
+{
+    if (!data || !linesize || width <= 0 || height <= 0)
+        return false;
+
+    ContextScope scope(this);
+    if (!scope.isCurrent())
+        return false;
+
+    int planeWidth[3] = {0, 0, 0};
+    int planeHeight[3] = {0, 0, 0};
+    int bytesPerPixel[3] = {1, 1, 1};
+    const int count = OpenGLVideoWidget::planeGeometry(format, width, height,
+                                                       planeWidth, planeHeight, bytesPerPixel);
+    for (int i = 0; i < count; ++i)
+    {
+        if (!data[i])
+            return false;
+        uploadPlane(i, OpenGLVideoWidget::pixelFormatForBytes(bytesPerPixel[i]),
+                    planeWidth[i], planeHeight[i], bytesPerPixel[i], data[i], linesize[i]);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (int i = 0; i < 3; ++i)
+        m_textures[i] = i < count ? m_ownTextures[i] : 0;
+    m_sharedTextures = false;
+    m_rgb = false;
+    m_format = format;
+    m_frameWidth = width;
+    m_frameHeight = height;
+    return true;
+}
+
+void VideoFrameRenderer::setSharedTextures(const GLuint textures[3], int width, int height,
+                                           const OpenGLVideoWidget::YUVFormat &format,
+                                           OpenGLVideoWidget::ColorSpace colorSpace, bool rgb)
+{
+    for (int i = 0; i < 3; ++i)
+        m_textures[i] = textures[i];
+    m_sharedTextures = true;
+    m_rgb = rgb;
+    m_format = format;
+    m_frameColorSpace = colorSpace;
+    m_frameWidth = width;
+    m_frameHeight = height;
+}
+
+// ==================== 绘制与回读 ====================
+
+QOpenGLShaderProgram *VideoFrameRenderer::programForFrame()
+{
+    if (m_rgb)
+    {
+        if (!m_programRGB)
+        {
+            QOpenGLShaderProgram *program = new QOpenGLShaderProgram(this);
+            if (!program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource)
+                || !program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSourceRGB)
+                || !program->link())
+            {
+                qWarning() << "VideoFrameRenderer: RGB shader failed:" << program->log();
+                delete program;
+                return nullptr;
+            }
+            m_programRGB = program;
+        }
+        return m_programRGB;
+    }
+
+    const OpenGLVideoWidget::ShaderVariant variant = OpenGLVideoWidget::shaderVariantFor(m_format);
+    if (!m_programsYUV[variant])
+        m_programsYUV[variant] = OpenGLVideoWidget::createYUVProgram(variant, this);
+    return m_programsYUV[variant];
+}
+
+QSize VideoFrameRenderer::drawFrame(const QSize &requested)
+{
+    if (m_frameWidth <= 0 || m_frameHeight <= 0 || !m_textures[0])
+        return QSize();
+
+    const QSize size = requested.isEmpty() ? QSize(m_frameWidth, m_frameHeight) : requested;
+
+    // 输出尺寸变化时重建帧缓冲
+    if (!m_fbo || m_fbo->size() != size)
+    {
+        delete m_fbo;
+        m_fbo = new QOpenGLFramebufferObject(size);
+        if (!m_fbo->isValid())
+        {
+            qWarning() << "VideoFrameRenderer: failed to create framebuffer" << size;
+            delete m_fbo;
+            m_fbo = nullptr;
+            return QSize();
+        }
+    }
+
+    QOpenGLShaderProgram *program = programForFrame();
+    if (!program || !program->bind())
+        return QSize();
+
+    m_fbo->bind();
+    glViewport(0, 0, size.width(), size.height());
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // 保持宽高比居中（与OpenGLVideoWidget::calculateTransformMatrix一致）
+    const float targetAspect = static_cast<float>(size.width()) / size.height();
+    const float frameAspect = static_cast<float>(m_frameWidth) / m_frameHeight;
+    QMatrix4x4 transform;
+    if (frameAspect > targetAspect)
+        transform.scale(1.0f, targetAspect / frameAspect, 1.0f);
+    else
+        transform.scale(frameAspect / targetAspect, 1.0f, 1.0f);
+    program->setUniformValue("u_transform", transform);
+
+    if (m_rgb)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_textures[0]);
+        program->setUniformValue("u_texture", 0);
+    }
+    else
+    {
+        const int count = m_format.planeCount();
+        for (int i = 0; i < count; ++i)
+        {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+        }
+        glActiveTexture(GL_TEXTURE0);
+
+        OpenGLVideoWidget::ColorSpace space = m_frameColorSpace;
+        if (!m_sharedTextures)
+        {
+            space = m_colorSpaceExplicit ? m_colorSpace
+                                         : OpenGLVideoWidget::autoSelectColorSpace(m_frameWidth, m_frameHeight);
+        }
+        OpenGLVideoWidget::setYUVUniforms(program, m_format, space);
+    }
+
+    m_vertexBuffer.bind();
+    const int posLocation = program->attributeLocation("a_position");
+    const int texCoordLocation = program->attributeLocation("a_texCoord");
+    if (posLocation >= 0)
+    {
+        program->enableAttributeArray(posLocation);
+        program->setAttributeBuffer(posLocation, GL_FLOAT, 0, 2, 4 * sizeof(float));
+    }
+    if (texCoordLocation >= 0)
+    {
+        program->enableAttributeArray(texCoordLocation);
+        program->setAttributeBuffer(texCoordLocation, GL_FLOAT, 2 * sizeof(float), 2, 4 * sizeof(float));
+    }
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    if (posLocation >= 0)
+        program->disableAttributeArray(posLocation);
+    if (texCoordLocation >= 0)
+        program->disableAttributeArray(texCoordLocation);
+    m_vertexBuffer.release();
+    program->release();
+
+    // 共享纹理可能在本次采样执行前被其他上下文覆盖（如上传线程回收纹理环槽位），
+    // 等待采样完成；绘制量很小，不影响后续的异步回读
+    if (m_sharedTextures)
+        glFinish();
+
+    return size;
+}
+
+QImage VideoFrameRenderer::imageFromBottomUp(const uchar *pixels, const QSize &size)
+{
+    QImage image(size, QImage::Format_RGBA8888);
+    const int rowBytes = size.width() * 4;
+    for (int y = 0; y < size.height(); ++y)
+        memcpy(image.scanLine(y), pixels + static_cast<size_t>(size.height() - 1 - y) * rowBytes, rowBytes);
+    return image;
+}
+
+QImage VideoFrameRenderer::readPixels(const QSize &size)
+{
+    QByteArray pixels(size.width() * size.height() * 4, Qt::Uninitialized);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return imageFromBottomUp(reinterpret_cast<const uchar *>(pixels.constData()), size);
+}
+
+QImage VideoFrameRenderer::render(const QSize &size)
+{
+    ContextScope scope(this);
+    if (!scope.isCurrent())
+        return QImage();
+
+    const QSize outputSize = drawFrame(size);
+    if (outputSize.isEmpty())
+        return QImage();
+
+    QImage image = readPixels(outputSize);
+    m_fbo->release();
+    return image;
+}
+
+int VideoFrameRenderer::requestImage(const QSize &size)
+{
+    ContextScope scope(this);
+    if (!scope.isCurrent())
+        return -1;
+
+    const QSize outputSize = drawFrame(size);
+    if (outputSize.isEmpty())
+        return -1;
+
+    Readback readback;
+    readback.requestId = m_nextRequestId++;
+    readback.size = outputSize;
+
+    // 选一个空闲的回读缓冲
+    if (m_pboSupported)
+    {
+        for (int i = 0; i < READBACK_RING_SIZE; ++i)
+        {
+            if (!m_pboBusy[i])
+            {
+                readback.pbo = i;
+                break;
+            }
+        }
+    }
+
+    if (readback.pbo >= 0)
+    {
+        // 读入PBO：glReadPixels立即返回，像素由GPU异步写入缓冲
+        QOpenGLBuffer &pbo = m_packPbos[readback.pbo];
+        const int bytes = outputSize.width() * outputSize.height() * 4;
+        pbo.bind();
+        if (pbo.size() != bytes)
+            pbo.allocate(bytes);
+        glReadPixels(0, 0, outputSize.width(), outputSize.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        pbo.release();
+        m_pboBusy[readback.pbo] = true;
+
+        if (m_fenceSupported)
+            readback.fence = m_context->extraFunctions()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+    }
+    else
+    {
+        // GLES2或回读缓冲均在使用中：同步回读，结果仍按请求顺序异步发出
+        readback.image = readPixels(outputSize);
+    }
+    m_fbo->release();
+
+    m_readbacks.enqueue(readback);
+    if (!m_pollTimer->isActive())
+        m_pollTimer->start();
+    return readback.requestId;
+}
+
+void VideoFrameRenderer::pollReadbacks()
+{
+    QVector<Readback> finished;
+    {
+        ContextScope scope(this);
+        if (!scope.isCurrent())
+        {
+            m_pollTimer->stop();
+            return;
+        }
+
+        QOpenGLExtraFunctions *gl = m_fenceSupported ? m_context->extraFunctions() : nullptr;
+        while (!m_readbacks.isEmpty())
+        {
+            Readback &readback = m_readbacks.head();
+            if (readback.pbo >= 0)
+            {
+                bool ready = true;
+                if (readback.fence)
+                {
+                    const GLenum status = gl->glClientWaitSync(readback.fence, 0, 0);
+                    ready = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+                }
+                else
+                {
+                    // 无栅栏时至少推迟一个检查间隔再映射（映射会等待回读完成）
+                    ready = readback.polls > 0;
+                }
+                ++readback.polls;
+                if (!ready)
+                    break;
+
+                QOpenGLBuffer &pbo = m_packPbos[readback.pbo];
+                pbo.bind();
+                // GLES没有glMapBuffer，只能按范围映射；桌面GL 2.1可能不支持按范围映射，退回整体映射
+                const int bytes = readback.size.width() * readback.size.height() * 4;
+                const uchar *pixels = m_mapRangeSupported
+                    ? static_cast<const uchar *>(pbo.mapRange(0, bytes, QOpenGLBuffer::RangeRead))
+                    : static_cast<const uchar *>(pbo.map(QOpenGLBuffer::ReadOnly));
+                if (pixels)
+                {
+                    readback.image = imageFromBottomUp(pixels, readback.size);
+                    pbo.unmap();
+                }
+                else
+                {
+                    qWarning() << "VideoFrameRenderer: failed to map readback buffer";
+                }
+                pbo.release();
+
+                if (readback.fence)
+                    gl->glDeleteSync(readback.fence);
+                readback.fence = nullptr;
+                m_pboBusy[readback.pbo] = false;
+            }
+            finished.append(m_readbacks.dequeue());
+        }
+
+        if (m_readbacks.isEmpty())
+            m_pollTimer->stop();
+    }
+
+    // 恢复调用方上下文后再发出，槽函数中可安全使用其他上下文
+    for (const Readback &readback : finished)
+        emit imageReady(readback.requestId, readback.image);
+}
+
+#endif // OPENGL_ENABLE
@@ -0,0 +1,226 @@
+/*****************************************************************
+File:        video_frame_renderer.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 离屏视频帧渲染器
+             持有基于QOffscreenSurface的独立上下文，把视频帧经与OpenGLVideoWidget相同的
+             YUV着色器（色彩矩阵、位深归一化）绘制到任意尺寸的QOpenGLFramebufferObject，
+             再回读为QImage；不依赖可见窗口，可用于GPU缩略图与无界面（如Mesa软件渲染）的像素级测试
+             - 帧来源：自有纹理（setFrame/setFrameYUV上传）或共享组内的外部纹理（setSharedTextures）
+             - 同步回读：render()直接glReadPixels
+             - 异步回读：requestImage()把像素读入PBO（GL_PIXEL_PACK_BUFFER）后立即返回，
+               栅栏完成（不支持栅栏时为下一轮事件循环）后映射并通过imageReady发出
+    使用方式（无界面）：
+        VideoFrameRenderer renderer;
+        renderer.create();
+        renderer.setFrameYUV(data, linesize, 1920, 1080, format);
+        QImage thumb = renderer.render(QSize(320, 180));
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            PBO回读改用按范围映射，修复GLES上回读为空
+*****************************************************************/
+
+#ifndef VIDEO_FRAME_RENDERER_H
+#define VIDEO_FRAME_RENDERER_H
+
+#ifdef OPENGL_ENABLE
+
+#include <QImage>
+#include <QObject>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QQueue>
+#include <QSize>
+
+#include "opengl_video_widget.h"
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+class QOpenGLShaderProgram;
+class QSurface;
+class QTimer;
+
+class VideoFrameRenderer : public QObject, protected QOpenGLFunctions
+{
+    Q_OBJECT
+
+public:
+    explicit VideoFrameRenderer(QObject *parent = nullptr);
+    ~VideoFrameRenderer() override;
+
+    /**
+     * @brief 创建离屏表面与上下文（GUI线程调用）
+     * @param shareContext 共享上下文，需要绘制其纹理时传入；为空时使用GL 2.1兼容模式
+     * @return 是否创建成功
+     */
+    bool create(QOpenGLContext *shareContext = nullptr);
+
+    /**
+     * @brief 释放GL资源、上下文与表面，未完成的异步请求被丢弃
+     */
+    void destroy();
+
+    bool isValid() const { return m_context != nullptr; }
+
+    /**
+     * @brief 设置帧未携带色彩空间信息时使用的色彩空间（默认按分辨率自动选择）
+     */
+    void setColorSpace(OpenGLVideoWidget::ColorSpace space);
+
+    /**
+     * @brief 上传RGB帧到自有纹理
+     */
+    bool setFrame(const QImage &image);
+
+    /**
+     * @brief 上传YUV帧到自有纹理
+     * @param data 各平面数据指针（半平面格式只用前两个）
+     * @param linesize 各平面行步长（字节）
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param format 帧格式
+     */
+    bool setFrameYUV(const uint8_t *const data[3], const int linesize[3],
+                     int width, int height, const OpenGLVideoWidget::YUVFormat &format);
+
+    /**
+     * @brief 绘制共享组内的外部纹理（不复制，纹理生命周期由调用方保证）
+     * @param textures YUV各平面纹理，rgb为true时只用第一个（RGBA）
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param format 帧格式（rgb为true时忽略）
+     * @param colorSpace 帧未携带色彩空间信息时使用的色彩空间
+     * @param rgb 是否为RGBA单平面纹理
+     *
+     * 外部纹理可能在绘制提交后被其他上下文覆盖，此模式下绘制完成前（glFinish）不返回；
+     * 回读仍为异步。
+     */
+    void setSharedTextures(const GLuint textures[3], int width, int height,
+                           const OpenGLVideoWidget::YUVFormat &format,
+                           OpenGLVideoWidget::ColorSpace colorSpace, bool rgb);
+
+    /** 当前帧尺寸（无帧时为空） */
+    QSize frameSize() const { return QSize(m_frameWidth, m_frameHeight); }
+
+    /**
+     * @brief 渲染当前帧并同步回读
+     * @param size 输出尺寸（空表示视频原始尺寸），画面按比例居中，其余区域为黑色
+     * @return RGBA8888图像，无帧或失败时为空
+     *
+     * 输出尺寸等于视频尺寸时每个像素恰好采样纹素中心，结果与CPU端按同一矩阵转换一致。
+     */
+    QImage render(const QSize &size = QSize());
+
+    /**
+     * @brief 渲染当前帧并异步回读
+     * @param size 输出尺寸，含义同render
+     * @return 请求序号，结果通过imageReady按请求顺序发出；无帧或失败时返回-1
+     *
+     * 不支持PBO（GLES2）或回读队列已满时改为同步回读，结果仍在下一轮事件循环发出。
+     */
+    int requestImage(const QSize &size = QSize());
+
+    /** 尚未发出结果的异步请求数 */
+    int pendingRequests() const { return m_readbacks.size(); }
+
+signals:
+    /**
+     * @brief 异步回读完成
+     * @param requestId requestImage返回的序号
+     * @param image RGBA8888图像
+     */
+    void imageReady(int requestId, const QImage &image);
+
+private:
+    static constexpr int READBACK_RING_SIZE = 3;    ///< 同时在途的PBO回读数
+    static constexpr int POLL_INTERVAL_MS = 1;      ///< 回读完成检查间隔
+
+    /**
+     * @brief 一次在途的异步回读
+     */
+    struct Readback
+    {
+        int requestId = -1;
+        int pbo = -1;               ///< m_packPbos下标（-1表示已同步回读）
+        QSize size;
+        GLsync fence = nullptr;     ///< 回读完成栅栏（不支持栅栏时为空）
+        int polls = 0;              ///< 已检查次数
+        QImage image;               ///< 同步回读的结果（pbo为-1时有效）
+    };
+
+    /**
+     * @brief 切换到本渲染器上下文，析构时恢复之前的当前上下文
+     */
+    class ContextScope
+    {
+    public:
+        explicit ContextScope(VideoFrameRenderer *renderer);
+        ~ContextScope();
+        bool isCurrent() const { return m_current; }
+
+    private:
+        VideoFrameRenderer *m_renderer = nullptr;
+        QOpenGLContext *m_previous = nullptr;
+        QSurface *m_previousSurface = nullptr;
+        bool m_current = false;
+        bool m_switched = false;    ///< 是否切换过上下文（需要恢复）
+    };
+
+    bool initializeResources();
+    void releaseResources();
+    void detectCapabilities();
+    /** 按需创建着色器（上下文为当前上下文时调用） */
+    QOpenGLShaderProgram *programForFrame();
+    /** 上传一个平面到自有纹理（尺寸/格式变化时重新分配） */
+    void uploadPlane(int index, GLenum format, int width, int height, int bytesPerPixel,
+                     const uint8_t *data, int linesize);
+    /** 把当前帧绘制到离屏帧缓冲，返回实际输出尺寸（失败时为空） */
+    QSize drawFrame(const QSize &requested);
+    /** 从当前绑定的帧缓冲同步读取并翻转为自上而下的图像 */
+    QImage readPixels(const QSize &size);
+    /** 把映射后的像素（自下而上）复制为图像 */
+    static QImage imageFromBottomUp(const uchar *pixels, const QSize &size);
+    /** 映射已完成的回读并按请求顺序发出结果 */
+    void pollReadbacks();
+
+    QOffscreenSurface *m_surface = nullptr;
+    QOpenGLContext *m_context = nullptr;
+    QOpenGLFramebufferObject *m_fbo = nullptr;
+    QOpenGLShaderProgram *m_programsYUV[OpenGLVideoWidget::SHADER_VARIANT_COUNT] = {};
+    QOpenGLShaderProgram *m_programRGB = nullptr;
+    QOpenGLBuffer m_vertexBuffer;                   ///< 全视口四边形（位置+纹理坐标）
+    QOpenGLBuffer m_packPbos[READBACK_RING_SIZE];   ///< 像素回读缓冲
+    bool m_pboBusy[READBACK_RING_SIZE] = {};
+    bool m_pboSupported = false;
+    bool m_fenceSupported = false;
+    bool m_mapRangeSupported = false;               ///< 是否支持按范围映射（GLES只能用glMapBufferRange）
+    bool m_rowLengthSupported = false;
+    QByteArray m_repackBuffer;                      ///< 不支持行步长时的紧凑重排缓冲
+
+    // ==================== 当前帧 ====================
+    GLuint m_ownTextures[3] = {0, 0, 0};            ///< 自有纹理
+    QSize m_ownTextureSize[3];                      ///< 自有纹理已分配尺寸
+    GLenum m_ownTextureFormat[3] = {0, 0, 0};       ///< 自有纹理已分配格式
+    GLuint m_textures[3] = {0, 0, 0};               ///< 本次绘制使用的纹理
+    bool m_sharedTextures = false;                  ///< 纹理来自共享组（绘制后需glFinish）
+    bool m_rgb = false;
+    int m_frameWidth = 0;
+    int m_frameHeight = 0;
+    OpenGLVideoWidget::YUVFormat m_format;
+    OpenGLVideoWidget::ColorSpace m_colorSpace = OpenGLVideoWidget::COLOR_BT601;
+    OpenGLVideoWidget::ColorSpace m_frameColorSpace = OpenGLVideoWidget::COLOR_BT601;
+    bool m_colorSpaceExplicit = false;
+
+    // ==================== 异步回读 ====================
+    QQueue<Readback> m_readbacks;                   ///< 未发出结果的回读（按请求顺序）
+    QTimer *m_pollTimer = nullptr;
+    int m_nextRequestId = 1;
+};
+
+#endif // OPENGL_ENABLE
+
+#endif // VIDEO_FRAME_RENDERER_H
@@ -0,0 +1,386 @@
+#include "video_upload_thread.h"
+
+#ifdef OPENGL_ENABLE
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QOffscreenSurface>
+#include <QOpenGLExtraFunctions>
+
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
+VideoUploadThread::VideoUploadThread(OpenGLVideoWidget *widget)
+    : QThread(nullptr)
+    , m_widget(widget)
+{
+    setObjectName("VideoUploadThread");
+}
+
+VideoUploadThread::~VideoUploadThread()
+{
+    stopUpload();
+}
+
+bool VideoUploadThread::isSupported(QOpenGLContext *context)
+{
+    if (!context || !QOpenGLContext::supportsThreadedOpenGL())
+        return false;
+
+    // 栅栏同步：GL 3.2 / ARB_sync / GLES 3.0
+    const QSurfaceFormat fmt = context->format();
+    const int version = fmt.majorVersion() * 10 + fmt.minorVersion();
+    if (context->isOpenGLES())
+        return version >= 30;
+    return version >= 32 || context->hasExtension("GL_ARB_sync");
+}
+
+bool VideoUploadThread::startUpload(QOpenGLContext *shareContext)
+{
+    if (isRunning() || !shareContext)
+        return false;
+
+    // 离屏表面必须在GUI线程创建
+    m_surface = new QOffscreenSurface();
+    m_surface->setFormat(shareContext->format());
+    m_surface->create();
+    if (!m_surface->isValid())
+    {
+        qWarning() << "VideoUploadThread: failed to create offscreen surface";
+        delete m_surface;
+        m_surface = nullptr;
+        return false;
+    }
+
+    m_context = new QOpenGLContext();
+    m_context->setFormat(shareContext->format());
+    m_context->setShareContext(shareContext);
+    if (!m_context->create())
+    {
+        qWarning() << "VideoUploadThread: failed to create shared context";
+        delete m_context;
+        m_context = nullptr;
+        delete m_surface;
+        m_surface = nullptr;
+        return false;
+    }
+    m_context->moveToThread(this);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = true;
+        m_displayedSlot = -1;
+    }
+    start();
+
+    qDebug() << "VideoUploadThread started, ring size:" << RING_SIZE;
+    return true;
+}
+
+void VideoUploadThread::stopUpload()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = false;
+        m_condition.wakeAll();
+    }
+    wait();
+
+    // 线程退出前已把上下文移回本线程
+    delete m_context;
+    m_context = nullptr;
+    delete m_surface;
+    m_surface = nullptr;
+}
+
+bool VideoUploadThread::submit(OpenGLVideoWidget::YUVData &data)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_running)
+        return false;
+
+    // 只保留最新一帧，上传线程来不及处理的旧帧直接覆盖
+    if (m_pending.valid)
+        m_widget->recordDroppedFrame();
+    m_pending.swap(data);
+    m_pending.valid = true;
+    m_condition.wakeOne();
+    return true;
+}
+
+bool VideoUploadThread::isUploading() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+VideoUploadThread::DisplayTextures VideoUploadThread::acquireDisplay(QOpenGLExtraFunctions *gl, bool *pending)
+{
+    DisplayTextures result;
+    if (pending)
+        *pending = false;
+
+    QMutexLocker locker(&m_mutex);
+
+    // ==================== 切换到最新的已完成帧 ====================
+    for (int i = 0; i < RING_SIZE; ++i)
+    {
+        TextureSlot &slot = m_slots[i];
+        if (slot.state != SLOT_READY)
+            continue;
+
+        // 超时为0：只查询状态，不在GUI线程中等待上传
+        GLenum status = gl->glClientWaitSync(slot.uploadFence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+        {
+            if (pending)
+                *pending = true;
+            break;
+        }
+        if (status == GL_WAIT_FAILED)
+            qWarning() << "VideoUploadThread: fence wait failed, displaying slot" << i << "anyway";
+
+        gl->glDeleteSync(slot.uploadFence);
+        slot.uploadFence = nullptr;
+
+        // 旧显示槽位交还上传线程；插入栅栏覆盖之前所有对它的绘制命令
+        if (m_displayedSlot >= 0)
+        {
+            TextureSlot &old = m_slots[m_displayedSlot];
+            old.releaseFence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            old.state = SLOT_FREE;
+            gl->glFlush();      // 确保栅栏已提交，另一上下文才能等待
+        }
+
+        slot.state = SLOT_DISPLAYED;
+        m_displayedSlot = i;
+        break;
+    }
+
+    // ==================== 输出当前显示槽位 ====================
+    if (m_displayedSlot >= 0)
+    {
+        const TextureSlot &slot = m_slots[m_displayedSlot];
+        for (int i = 0; i < 3; ++i)
+            result.textures[i] = slot.textures[i];
+        result.width = slot.width;
+        result.height = slot.height;
+        result.format = slot.format;
+        result.sequence = slot.sequence;
+        result.ptsMs = slot.ptsMs;
+        result.submitUs = slot.submitUs;
+        result.valid = true;
+    }
+
+    return result;
+}
+
+void VideoUploadThread::run()
+{
+    if (!m_context->makeCurrent(m_surface))
+    {
+        qWarning() << "VideoUploadThread: makeCurrent failed";
+        {
+            // 停止接收帧，submit返回false后调用方改为自行上传
+            QMutexLocker locker(&m_mutex);
+            m_running = false;
+            m_pending.clear();
+        }
+        m_context->moveToThread(QCoreApplication::instance()->thread());
+        emit uploadFailed();
+        return;
+    }
+
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+
+    // 创建纹理环（存储在首帧到达时按分辨率分配）
+    for (TextureSlot &slot : m_slots)
+    {
+        gl->glGenTextures(3, slot.textures);
+        for (GLuint tex : slot.textures)
+        {
+            gl->glBindTexture(GL_TEXTURE_2D, tex);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    OpenGLVideoWidget::YUVData frame;
+    QElapsedTimer timer;
+
+    while (true)
+    {
+        int slotIndex = -1;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_running && !m_pending.valid)
+                m_condition.wait(&m_mutex);
+            if (!m_running)
+                break;
+
+            frame.swap(m_pending);
+            m_pending.valid = false;
+
+            // 取序号最小的空闲槽位（显示1 + 就绪1 + 上传1，空闲槽位始终存在）
+            for (int i = 0; i < RING_SIZE; ++i)
+            {
+                if (m_slots[i].state == SLOT_FREE &&
+                    (slotIndex < 0 || m_slots[i].sequence < m_slots[slotIndex].sequence))
+                    slotIndex = i;
+            }
+            if (slotIndex < 0)
+                continue;
+            m_slots[slotIndex].state = SLOT_UPLOADING;
+        }
+
+        // 上传中的槽位只有本线程访问，可在锁外操作
+        TextureSlot &slot = m_slots[slotIndex];
+
+        // GPU侧等待之前对该槽位的绘制完成后再覆盖，不阻塞本线程
+        if (slot.releaseFence)
+        {
+            gl->glWaitSync(slot.releaseFence, 0, GL_TIMEOUT_IGNORED);
+            gl->glDeleteSync(slot.releaseFence);
+            slot.releaseFence = nullptr;
+        }
+
+        timer.start();
+        bool ok = uploadToSlot(slot, frame);
+        if (ok)
+        {
+            slot.uploadFence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            gl->glFlush();
+        }
+        const double elapsedMs = timer.nsecsElapsed() / 1000000.0;
+        const qint64 bytes = frame.yData.size() + frame.uData.size() + frame.vData.size();
+
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!ok)
+            {
+                slot.state = SLOT_FREE;
+                continue;
+            }
+
+            // 尚未被显示的旧就绪帧作废
+            for (TextureSlot &other : m_slots)
+            {
+                if (other.state == SLOT_READY)
+                {
+                    gl->glDeleteSync(other.uploadFence);
+                    other.uploadFence = nullptr;
+                    other.state = SLOT_FREE;
+                    m_widget->recordDroppedFrame();
+                }
+            }
+
+            slot.sequence = m_nextSequence++;
+            slot.state = SLOT_READY;
+        }
+
+        m_widget->recordUploadStats(elapsedMs, bytes, false, true);
+        emit frameUploaded();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        releaseSlots();
+    }
+    m_context->doneCurrent();
+    m_context->moveToThread(QCoreApplication::instance()->thread());
+}
+
+bool VideoUploadThread::uploadToSlot(TextureSlot &slot, const OpenGLVideoWidget::YUVData &data)
+{
+    QOpenGLFunctions *f = m_context->functions();
+
+    OpenGLVideoWidget::PlaneUpload planes[3];
+    const int count = OpenGLVideoWidget::buildPlaneUploads(data, slot.textures, planes);
+    if (count == 0)
+        return false;
+
+    // 行步长不是整像素时无法用GL_UNPACK_ROW_LENGTH表达，与GUI线程路径一样紧凑重排
+    size_t repackOffsets[3] = {0, 0, 0};
+    size_t repackSize = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (planes[i].linesize % planes[i].bytesPerPixel == 0)
+            continue;
+        repackOffsets[i] = repackSize;
+        repackSize += static_cast<size_t>(planes[i].width) * planes[i].bytesPerPixel * planes[i].height;
+    }
+    if (repackSize > 0)
+    {
+        if (static_cast<size_t>(m_repackBuffer.size()) < repackSize)
+            m_repackBuffer.resize(static_cast<int>(repackSize));
+        uint8_t *base = reinterpret_cast<uint8_t *>(m_repackBuffer.data());
+        for (int i = 0; i < count; ++i)
+        {
+            if (planes[i].linesize % planes[i].bytesPerPixel == 0)
+                continue;
+            const int rowBytes = planes[i].width * planes[i].bytesPerPixel;
+            OpenGLVideoWidget::copyPlane(base + repackOffsets[i], rowBytes, planes[i]);
+            planes[i].data = base + repackOffsets[i];
+            planes[i].linesize = rowBytes;
+        }
+    }
+
+    // 分辨率或格式变化时才重新分配该槽位的纹理存储
+    if (slot.texWidth != data.width || slot.texHeight != data.height ||
+        slot.texFormat.layout != data.format.layout ||
+        slot.texFormat.bytesPerSample() != data.format.bytesPerSample())
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            f->glBindTexture(GL_TEXTURE_2D, planes[i].texture);
+            f->glTexImage2D(GL_TEXTURE_2D, 0, planes[i].format, planes[i].width, planes[i].height, 0,
+                            planes[i].format, GL_UNSIGNED_BYTE, nullptr);
+        }
+        slot.texWidth = data.width;
+        slot.texHeight = data.height;
+        slot.texFormat = data.format;
+    }
+
+    // 上传线程可以阻塞，直接按行步长提交，无需PBO
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < count; ++i)
+    {
+        const OpenGLVideoWidget::PlaneUpload &plane = planes[i];
+        f->glPixelStorei(GL_UNPACK_ROW_LENGTH, plane.linesize / plane.bytesPerPixel);
+        f->glBindTexture(GL_TEXTURE_2D, plane.texture);
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height,
+                           plane.format, GL_UNSIGNED_BYTE, plane.data);
+    }
+    f->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    f->glBindTexture(GL_TEXTURE_2D, 0);
+
+    slot.width = data.width;
+    slot.height = data.height;
+    slot.format = data.format;
+    slot.ptsMs = data.ptsMs;
+    slot.submitUs = data.submitUs;
+    return true;
+}
+
+void VideoUploadThread::releaseSlots()
+{
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+    for (TextureSlot &slot : m_slots)
+    {
+        if (slot.uploadFence)
+            gl->glDeleteSync(slot.uploadFence);
+        if (slot.releaseFence)
+            gl->glDeleteSync(slot.releaseFence);
+        gl->glDeleteTextures(3, slot.textures);
+        slot = TextureSlot();
+    }
+    m_displayedSlot = -1;
+}
+
+#endif // OPENGL_ENABLE
@@ -0,0 +1,164 @@
+/*****************************************************************
+File:        video_upload_thread.h
+Version:     1.2
+Author:      cjx
+Date:        2026-10-19
+Description: 视频纹理上传线程
+             持有与OpenGLVideoWidget共享的QOpenGLContext，在独立线程中把YUV帧上传到
+             小型纹理环，上传完成后插入glFenceSync；paintGL只取最新的已完成纹理绘制，
+             GUI线程每帧耗时不再随视频分辨率增长
+    纹理环状态流转（RING_SIZE = 3，保证上传线程始终有空闲槽位）：
+        Free --上传--> Ready（带上传栅栏） --paintGL确认栅栏已完成--> Displayed
+        Displayed --被新帧替换--> Free（带释放栅栏，上传线程覆盖前在GPU侧等待）
+        较新的Ready出现时，未被显示的旧Ready直接回到Free
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            上下文激活失败时停止接收帧并发出uploadFailed
+3             2026-10-19     cjx            行步长非整像素的平面在上传线程中紧凑重排，不再丢帧
+*****************************************************************/
+
+#ifndef VIDEO_UPLOAD_THREAD_H
+#define VIDEO_UPLOAD_THREAD_H
+
+#ifdef OPENGL_ENABLE
+
+#include <QByteArray>
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "opengl_video_widget.h"
+
+class QOffscreenSurface;
+class QOpenGLExtraFunctions;
+
+class VideoUploadThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RING_SIZE = 3;     ///< 纹理环槽位数量
+
+    /**
+     * @brief 可供绘制的纹理（paintGL持有期间不会被上传线程覆盖）
+     */
+    struct DisplayTextures {
+        GLuint textures[3] = {0, 0, 0};         ///< Y/U/V（半平面格式V为0）
+        int width = 0;                          ///< 视频宽度
+        int height = 0;                         ///< 视频高度
+        OpenGLVideoWidget::YUVFormat format;    ///< 帧格式
+        quint64 sequence = 0;                   ///< 帧序号
+        qint64 ptsMs = -1;                      ///< 帧时间戳（毫秒，-1表示未知）
+        qint64 submitUs = 0;                    ///< 帧提交时刻（渲染组件的呈现计时器）
+        bool valid = false;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param widget 所属渲染组件（提供上传统计与纹理布局计算）
+     */
+    explicit VideoUploadThread(OpenGLVideoWidget *widget);
+    ~VideoUploadThread() override;
+
+    /**
+     * @brief 当前上下文是否支持共享上下文线程上传与栅栏同步
+     * @param context 渲染组件的上下文
+     */
+    static bool isSupported(QOpenGLContext *context);
+
+    /**
+     * @brief 创建共享上下文并启动线程（必须在GUI线程、渲染组件上下文创建后调用）
+     * @param shareContext 渲染组件的上下文
+     * @return 是否启动成功
+     */
+    bool startUpload(QOpenGLContext *shareContext);
+
+    /**
+     * @brief 停止线程并在上传上下文中释放纹理与栅栏（阻塞至线程退出）
+     */
+    void stopUpload();
+
+    /**
+     * @brief 提交待上传帧，只保留最新一帧（任意线程调用）
+     * @param data YUV帧数据（接收时交换进内部缓冲，调用后data被清空）
+     * @return false表示线程未运行（启动失败或已停止），data保持不变，调用方应自行上传
+     */
+    bool submit(OpenGLVideoWidget::YUVData &data);
+
+    /**
+     * @brief 线程是否正在接收并上传帧（任意线程调用）
+     */
+    bool isUploading() const;
+
+    /**
+     * @brief 获取最新可绘制的纹理（GUI线程，渲染组件上下文为当前上下文时调用）
+     * @param gl 渲染组件上下文的扩展函数
+     * @param pending 输出：是否还有未完成的上传（需要稍后再次重绘）
+     * @return 当前应绘制的纹理；新帧的上传栅栏未完成时返回上一帧
+     */
+    DisplayTextures acquireDisplay(QOpenGLExtraFunctions *gl, bool *pending);
+
+signals:
+    /**
+     * @brief 一帧上传完成（在上传线程中发出）
+     */
+    void frameUploaded();
+
+    /**
+     * @brief 上传上下文无法激活，线程已退出（在上传线程中发出），渲染组件应改回paintGL内上传
+     */
+    void uploadFailed();
+
+protected:
+    void run() override;
+
+private:
+    enum SlotState {
+        SLOT_FREE,          ///< 空闲，可上传
+        SLOT_UPLOADING,     ///< 上传线程写入中
+        SLOT_READY,         ///< 上传命令已提交，等待栅栏完成
+        SLOT_DISPLAYED      ///< 正在被paintGL使用
+    };
+
+    struct TextureSlot {
+        GLuint textures[3] = {0, 0, 0};
+        int texWidth = 0;                       ///< 已分配的纹理尺寸
+        int texHeight = 0;
+        OpenGLVideoWidget::YUVFormat texFormat; ///< 已分配的纹理格式
+        int width = 0;                          ///< 当前内容尺寸
+        int height = 0;
+        OpenGLVideoWidget::YUVFormat format;    ///< 当前内容格式
+        qint64 ptsMs = -1;                      ///< 当前内容的时间戳
+        qint64 submitUs = 0;                    ///< 当前内容的提交时刻
+        GLsync uploadFence = nullptr;           ///< 上传完成栅栏（上传线程插入）
+        GLsync releaseFence = nullptr;          ///< 绘制完成栅栏（GUI线程在替换显示时插入）
+        quint64 sequence = 0;
+        SlotState state = SLOT_FREE;
+    };
+
+    /** 在上传上下文中把一帧写入指定槽位 */
+    bool uploadToSlot(TextureSlot &slot, const OpenGLVideoWidget::YUVData &data);
+    /** 释放所有槽位的纹理与栅栏（上传上下文为当前上下文） */
+    void releaseSlots();
+
+    OpenGLVideoWidget *m_widget = nullptr;
+    QOpenGLContext *m_context = nullptr;        ///< 与渲染组件共享的上传上下文（仅上传线程使用）
+    QOffscreenSurface *m_surface = nullptr;     ///< 上传上下文的离屏表面（须在GUI线程创建）
+
+    mutable QMutex m_mutex;                     ///< 保护待上传帧、槽位状态与运行标志
+    QWaitCondition m_condition;
+    OpenGLVideoWidget::YUVData m_pending;       ///< 待上传的最新帧
+    QByteArray m_repackBuffer;                  ///< 行步长非整像素时的紧凑重排缓冲（仅上传线程使用）
+    TextureSlot m_slots[RING_SIZE];
+    quint64 m_nextSequence = 1;
+    int m_displayedSlot = -1;
+    bool m_running = false;
+};
+
+#endif // OPENGL_ENABLE
+
+#endif // VIDEO_UPLOAD_THREAD_H
@@ -0,0 +1,130 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "ffmpeg_decode_helper.h"
+
+#include <QDebug>
+#include <QThread>
+
+namespace FFmpegDecodeHelper
+{
+static void setError(QString *error, const QString &message)
+{
+    qWarning() << message;
+    if (error)
+        *error = message;
+}
+
+AVCodecContext *openVideoDecoder(AVFormatContext *formatCtx, int &streamIndex,
+                                 int threadCount, QString *error)
+{
+    streamIndex = -1;
+    if (!formatCtx)
+    {
+        setError(error, QStringLiteral("Format context is null"));
+        return nullptr;
+    }
+
+    // 查找最佳视频流
+    int index = av_find_best_stream(formatCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (index < 0)
+    {
+        setError(error, QStringLiteral("No video stream found"));
+        return nullptr;
+    }
+
+    // 获取解码器参数
+    AVCodecParameters *params = formatCtx->streams[index]->codecpar;
+    const AVCodec *codec = avcodec_find_decoder(params->codec_id);
+    if (!codec)
+    {
+        setError(error, QStringLiteral("Video codec not found"));
+        return nullptr;
+    }
+
+    // 分配解码器上下文并填充参数
+    AVCodecContext *codecCtx = avcodec_alloc_context3(codec);
+    if (!codecCtx)
+    {
+        setError(error, QStringLiteral("Failed to allocate video codec context"));
+        return nullptr;
+    }
+    if (avcodec_parameters_to_context(codecCtx, params) < 0)
+    {
+        avcodec_free_context(&codecCtx);
+        setError(error, QStringLiteral("Failed to copy video codec parameters"));
+        return nullptr;
+    }
+    codecCtx->pkt_timebase = formatCtx->streams[index]->time_base;
+
+    // ========== 解码线程配置 ==========
+    if (threadCount > 0)
+    {
+        codecCtx->thread_count = threadCount;
+        codecCtx->thread_type = FF_THREAD_SLICE | FF_THREAD_FRAME;
+    }
+    else if (isHighResolution(codecCtx->width, codecCtx->height))
+    {
+        // 4K视频：启用多线程解码
+        codecCtx->thread_count = qMax(4, QThread::idealThreadCount());
+        codecCtx->thread_type = FF_THREAD_SLICE | FF_THREAD_FRAME;
+        qDebug() << "4K optimization enabled - thread count:" << codecCtx->thread_count;
+    }
+    else
+    {
+        // 普通视频：适度多线程
+        codecCtx->thread_count = qMin(2, QThread::idealThreadCount());
+        codecCtx->thread_type = FF_THREAD_SLICE;
+    }
+
+    // 打开解码器（不使用额外选项，避免兼容性问题）
+    AVDictionary *opts = nullptr;
+    int ret = avcodec_open2(codecCtx, codec, &opts);
+    av_dict_free(&opts);
+    if (ret < 0)
+    {
+        avcodec_free_context(&codecCtx);
+        setError(error, QStringLiteral("Failed to open video codec"));
+        return nullptr;
+    }
+
+    // 分辨率有效性检查
+    if (codecCtx->width <= 0 || codecCtx->height <= 0)
+    {
+        setError(error, QStringLiteral("Invalid video resolution: %1x%2")
+                            .arg(codecCtx->width).arg(codecCtx->height));
+        avcodec_free_context(&codecCtx);
+        return nullptr;
+    }
+
+    streamIndex = index;
+    return codecCtx;
+}
+
+AVRational guessVideoFrameRate(AVFormatContext *formatCtx, int streamIndex,
+                               const AVCodecContext *codecCtx)
+{
+    if (!formatCtx || streamIndex < 0)
+        return {25, 1};
+
+    AVStream *stream = formatCtx->streams[streamIndex];
+
+    // 方法1: 从流中获取帧率
+    AVRational fps = av_guess_frame_rate(formatCtx, stream, nullptr);
+    if (fps.num > 0 && fps.den > 0)
+        return fps;
+
+    // 方法2: 从codec中获取
+    if (codecCtx && codecCtx->framerate.num > 0 && codecCtx->framerate.den > 0)
+        return codecCtx->framerate;
+
+    // 方法3: 从平均帧率推算
+    if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
+        return stream->avg_frame_rate;
+
+    // 默认值：25fps
+    qDebug() << "Using default frame rate: 25fps";
+    return {25, 1};
+}
+} // namespace FFmpegDecodeHelper
+
+#endif // CAN_USE_FFMPEG
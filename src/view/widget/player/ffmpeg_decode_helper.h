@@ -0,0 +1,59 @@
+/*****************************************************************
+File:        ffmpeg_decode_helper.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: FFmpeg解码公共流程（查找视频流、打开解码器、推算帧率）
+             播放器解码线程与离线抽帧工具共用，保证两者解码行为一致
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _FFMPEG_DECODE_HELPER_H
+#define _FFMPEG_DECODE_HELPER_H
+
+#include <QString>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace FFmpegDecodeHelper
+{
+constexpr int HIGH_RES_WIDTH_THRESHOLD = 3840;
+constexpr int HIGH_RES_HEIGHT_THRESHOLD = 2160;
+
+/** 是否为4K及以上分辨率 */
+inline bool isHighResolution(int width, int height)
+{
+    return width >= HIGH_RES_WIDTH_THRESHOLD || height >= HIGH_RES_HEIGHT_THRESHOLD;
+}
+
+/**
+ * @brief 打开视频解码器
+ * @param formatCtx 已打开并探测过的格式上下文
+ * @param streamIndex 输出：视频流索引，失败时为-1
+ * @param threadCount 解码线程数，0表示按分辨率自动选择（4K多线程帧+片级并行，其余适度并行）
+ * @param error 可选，输出失败原因
+ * @return 已打开的解码器上下文，调用方负责avcodec_free_context；失败返回nullptr
+ */
+AVCodecContext *openVideoDecoder(AVFormatContext *formatCtx, int &streamIndex,
+                                 int threadCount = 0, QString *error = nullptr);
+
+/**
+ * @brief 推算视频帧率
+ * 依次尝试av_guess_frame_rate、解码器帧率、平均帧率，均无效时返回25fps
+ */
+AVRational guessVideoFrameRate(AVFormatContext *formatCtx, int streamIndex,
+                               const AVCodecContext *codecCtx = nullptr);
+} // namespace FFmpegDecodeHelper
+
+#endif // _FFMPEG_DECODE_HELPER_H
+
+#endif // CAN_USE_FFMPEG
@@ -1,6 +1,7 @@
 #ifdef CAN_USE_FFMPEG
 
 #include "ffmpeg_player_widget.h"
+#include "ffmpeg_decode_helper.h"
 
 #include <QCloseEvent>
 #include <QCoreApplication>
@@ -8,12 +9,14 @@
 #include <QDir>
 #include <QHideEvent>
 #include <QPainter>
+#include <QRandomGenerator>
 #include <QResizeEvent>
 #include <QShowEvent>
 #include <QThread>
 #include <QTimer>
 
 #include <cmath>
+#include <cstring>
 
 // ==================== 4K视频优化配置常量 ====================
 #define _4K_WIDTH_THRESHOLD   3840
@@ -122,14 +125,151 @@ void FFmpegDecoderThread::setMemoryLimit(int limitMB)
     qDebug() << "Memory limit set to" << m_memoryLimitMB << "MB";
 }
 
+void FFmpegDecoderThread::setSyncMode(AVSyncManager::SyncMode mode)
+{
+    QMutexLocker lock(&m_mutex);
+    m_preferredSyncMode = mode;
+    qDebug() << "Preferred sync mode set to" << mode;
+}
+
+void FFmpegDecoderThread::setExternalClock(std::shared_ptr<SyncClock> clock)
+{
+    if (isRunning())
+    {
+        qWarning() << "setExternalClock ignored while decoding, call before openMedia";
+        return;
+    }
+    m_syncManager.setExternalClock(std::move(clock));
+}
+
+void FFmpegDecoderThread::setMediaClock(std::shared_ptr<MediaClock> clock)
+{
+    if (isRunning())
+    {
+        qWarning() << "setMediaClock ignored while decoding, call before openMedia";
+        return;
+    }
+    m_clock = clock ? std::move(clock) : MediaClock::systemClock();
+    m_syncManager.setMediaClock(m_clock);
+    qDebug() << "Media clock set, virtual:" << m_clock->isVirtual();
+}
+
 FFmpegDecoderThread::Statistics FFmpegDecoderThread::getStatistics() const
 {
     Statistics stats = m_stats;
     stats.currentPlaybackRate = m_playbackRate;
     stats.currentFps = m_currentFps;
+
+    QMutexLocker lock(&m_presentMutex);
+    stats.displayLatencyUs = m_present.latencyUs;
+    stats.vsyncIntervalUs = m_present.vsyncUs;
+    stats.presentDriftUs = m_present.driftUs;
+    stats.presentedFrames = m_present.presented;
+    stats.judderFrames = m_present.judder;
+    stats.skippedFrames = m_present.skipped;
     return stats;
 }
 
+/**
+ * @brief 上屏反馈（GUI线程）
+ * 管线耗时 = 上屏时刻 - 投递时刻，交给同步管理器后解码线程按vsync相位提前投递；
+ * 相邻两帧停留的vsync数与内容时长不符时计为一次抖动
+ */
+void FFmpegDecoderThread::reportFramePresented(qint64 ptsMs, qint64 vsyncIntervalUs)
+{
+    const qint64 now = m_syncManager.currentTime();
+
+    QMutexLocker lock(&m_presentMutex);
+    PresentState &state = m_present;
+
+    qint64 pipelineUs = 0;
+    for (int i = 0; i < PUBLISH_HISTORY_SIZE; ++i)
+    {
+        if (state.publishPtsMs[i] == ptsMs)
+        {
+            pipelineUs = qMax<qint64>(0, now - state.publishTime[i]);
+            break;
+        }
+    }
+    m_syncManager.updatePresentTiming(now, vsyncIntervalUs, pipelineUs);
+
+    if (pipelineUs > 0)
+        state.latencyUs = state.latencyUs > 0 ? (state.latencyUs * 7 + pipelineUs) / 8 : pipelineUs;
+    state.vsyncUs = vsyncIntervalUs;
+    if (m_syncManager.hasMasterClock())
+        state.driftUs = ptsMs * 1000 - m_syncManager.getCurrentClock();
+    ++state.presented;
+
+    // 节奏检查：只比较连续播放中的相邻帧，跳转/回绕（间隔超过1秒或倒退）不计
+    const qint64 ptsDeltaUs = (ptsMs - state.lastPtsMs) * 1000;
+    if (state.lastPtsMs >= 0 && ptsDeltaUs > 0 && ptsDeltaUs < 1000000)
+    {
+        if (vsyncIntervalUs > 0)
+        {
+            const double rate = state.playbackRate > 0.0 ? state.playbackRate : 1.0;
+            const double held = std::round(double(now - state.lastTime) / vsyncIntervalUs);
+            const double expected = ptsDeltaUs / rate / vsyncIntervalUs;
+            if (held > std::ceil(expected - 0.1) || held < std::floor(expected + 0.1))
+                ++state.judder;
+        }
+        if (state.frameIntervalUs > 0)
+        {
+            const qint64 skipped = (ptsDeltaUs + state.frameIntervalUs / 2) / state.frameIntervalUs - 1;
+            if (skipped > 0)
+                state.skipped += int(skipped);
+        }
+    }
+    state.lastPtsMs = ptsMs;
+    state.lastTime = now;
+}
+
+/**
+ * @brief 把倍速与帧间隔同步到上屏状态（两者修改后调用）
+ * reportFramePresented在GUI线程执行，只读取该快照
+ */
+void FFmpegDecoderThread::snapshotPresentTiming()
+{
+    QMutexLocker lock(&m_presentMutex);
+    m_present.playbackRate = m_playbackRate;
+    m_present.frameIntervalUs = m_frameInterval;
+}
+
+void FFmpegDecoderThread::setVideoVisible(bool visible)
+{
+    if (m_videoVisible.exchange(visible) != visible)
+        qDebug() << "Video visibility changed:" << visible;
+}
+
+void FFmpegDecoderThread::setHiddenVideoPolicy(HiddenVideoPolicy policy, int keyframeRefreshMs)
+{
+    m_hiddenPolicy = policy;
+    m_keyframeRefreshMs = qMax(0, keyframeRefreshMs);
+}
+
+void FFmpegDecoderThread::addVideoSink(VideoFrameSink *sink)
+{
+    if (!sink)
+        return;
+
+    QMutexLocker lock(&m_sinkMutex);
+    if (!m_sinks.contains(sink))
+    {
+        m_sinks.append(sink);
+        m_sinkCount = m_sinks.size();
+        qDebug() << "Video sink attached, total:" << m_sinks.size();
+    }
+}
+
+void FFmpegDecoderThread::removeVideoSink(VideoFrameSink *sink)
+{
+    QMutexLocker lock(&m_sinkMutex);
+    if (m_sinks.removeAll(sink) > 0)
+    {
+        m_sinkCount = m_sinks.size();
+        qDebug() << "Video sink detached, remaining:" << m_sinks.size();
+    }
+}
+
 // ==================== 倍速播放核心实现 ====================
 
 void FFmpegDecoderThread::setPlaybackRate(float rate)
@@ -143,6 +283,8 @@ void FFmpegDecoderThread::setPlaybackRate(float rate)
 
     m_playbackRate = rate;
     m_stats.currentPlaybackRate = rate;
+    m_syncManager.setSpeed(rate);
+    snapshotPresentTiming();
 
     qDebug() << "Playback rate changed to:" << rate << "x";
 
@@ -155,9 +297,40 @@ void FFmpegDecoderThread::setPlaybackRate(float rate)
     emit playbackRateChanged(rate);
 }
 
+/**
+ * @brief 按当前输出采样率重建重采样器（倍速切换后调用）
+ */
+void FFmpegDecoderThread::reinitResampler()
+{
+    if (m_audio.swrCtx)
+    {
+        swr_free(&m_audio.swrCtx);
+        m_audio.swrCtx = swr_alloc();
+        if (m_audio.swrCtx)
+        {
+            // 设置输入参数
+            av_opt_set_chlayout(m_audio.swrCtx, "in_chlayout", &m_audio.codecCtx->ch_layout, 0);
+            av_opt_set_int(m_audio.swrCtx, "in_sample_rate", m_audio.codecCtx->sample_rate, 0);
+            av_opt_set_sample_fmt(m_audio.swrCtx, "in_sample_fmt", m_audio.codecCtx->sample_fmt, 0);
+
+            // 设置输出参数（立体声，16位整数）
+            AVChannelLayout out_layout = AV_CHANNEL_LAYOUT_STEREO;
+            av_opt_set_chlayout(m_audio.swrCtx, "out_chlayout", &out_layout, 0);
+            av_opt_set_int(m_audio.swrCtx, "out_sample_rate", m_out_sample_rate, 0);
+            av_opt_set_sample_fmt(m_audio.swrCtx, "out_sample_fmt", AV_SAMPLE_FMT_S16, 0);
+            av_opt_set_int(m_audio.swrCtx, "precision", 16, 0);
+
+            if (swr_init(m_audio.swrCtx) < 0)
+            {
+                qWarning() << "Failed to reinitialize audio resampler";
+            }
+        }
+    }
+}
+
 void FFmpegDecoderThread::reinitAudioOutput()
 {
-    if (!m_hasAudio || !m_audio.output)
+    if (!m_hasAudio || (!m_audio.output && !m_clock->isVirtual()))
         return;
 
     qDebug() << "Reinitializing audio output for playback rate:" << m_playbackRate;
@@ -174,6 +347,19 @@ void FFmpegDecoderThread::reinitAudioOutput()
     // 限制采样率范围（常见音频设备支持范围 8kHz ~ 48kHz）
     newSampleRate = qBound(8000, newSampleRate, 48000);
 
+    // 虚拟设备与真实设备一致：重启时清空排队数据，按新采样率输出
+    if (m_clock->isVirtual())
+    {
+        m_virtualAudioEndUs = 0;
+        if (newSampleRate != m_out_sample_rate || m_audio.targetSampleRate != newSampleRate)
+        {
+            m_out_sample_rate = newSampleRate;
+            m_audio.targetSampleRate = newSampleRate;
+            reinitResampler();
+        }
+        return;
+    }
+
     if (newSampleRate == m_out_sample_rate && m_audio.targetSampleRate == newSampleRate)
     {
         // 采样率没变，只需重启音频
@@ -182,7 +368,7 @@ void FFmpegDecoderThread::reinitAudioOutput()
             m_audio.device = m_audio.output->start();
             if (m_audio.device)
             {
-                m_audioWriter.setDevice(m_audio.device, m_audio.output);
+                m_audioWriter.setDevice(m_audio.device, m_audio.output, m_out_sample_rate * 4);
                 m_audioWriter.start();
             }
         }
@@ -272,34 +458,10 @@ void FFmpegDecoderThread::reinitAudioOutput()
         return;
     }
 
-    m_audioWriter.setDevice(m_audio.device, m_audio.output);
+    m_audioWriter.setDevice(m_audio.device, m_audio.output, m_out_sample_rate * 4);
     m_audioWriter.start();
 
-    // 重新配置重采样器
-    if (m_audio.swrCtx)
-    {
-        swr_free(&m_audio.swrCtx);
-        m_audio.swrCtx = swr_alloc();
-        if (m_audio.swrCtx)
-        {
-            // 设置输入参数
-            av_opt_set_chlayout(m_audio.swrCtx, "in_chlayout", &m_audio.codecCtx->ch_layout, 0);
-            av_opt_set_int(m_audio.swrCtx, "in_sample_rate", m_audio.codecCtx->sample_rate, 0);
-            av_opt_set_sample_fmt(m_audio.swrCtx, "in_sample_fmt", m_audio.codecCtx->sample_fmt, 0);
-
-            // 设置输出参数（立体声，16位整数）
-            AVChannelLayout out_layout = AV_CHANNEL_LAYOUT_STEREO;
-            av_opt_set_chlayout(m_audio.swrCtx, "out_chlayout", &out_layout, 0);
-            av_opt_set_int(m_audio.swrCtx, "out_sample_rate", m_out_sample_rate, 0);
-            av_opt_set_sample_fmt(m_audio.swrCtx, "out_sample_fmt", AV_SAMPLE_FMT_S16, 0);
-            av_opt_set_int(m_audio.swrCtx, "precision", 16, 0);
-
-            if (swr_init(m_audio.swrCtx) < 0)
-            {
-                qWarning() << "Failed to reinitialize audio resampler";
-            }
-        }
-    }
+    reinitResampler();
 
     qDebug() << "Audio reinitialized - Target sample rate:" << m_out_sample_rate
              << "Playback rate:" << m_playbackRate;
@@ -329,6 +491,9 @@ bool FFmpegDecoderThread::openMedia(const QString &url)
     m_currentUrl = url;
     m_syncManager.reset();
     m_frameBuffer.clear();
+    // 线程已停止，可安全清空显示信箱
+    m_displayMailbox.reset();
+    m_positionMs.store(0, std::memory_order_relaxed);
     m_isReconnecting = false;
     m_currentReconnectAttempt = 0;
     m_lastVideoPts = 0;
@@ -337,15 +502,82 @@ bool FFmpegDecoderThread::openMedia(const QString &url)
     m_playbackRate = 1.0f;      // 重置倍速
     m_needReinitAudio = false;
     m_seekTargetPts = -1;;      // 重置seek目标
+    m_packetIndex = 0;
+    m_virtualAudioEndUs = 0;
+    m_videoActive = true;       // 新解码器为默认状态，隐藏策略在首个视频包时重新应用
+    m_waitVideoKeyframe = false;
     m_pauseStartTime = 0;
     m_totalPausedTime = 0;
     m_wasPaused = false;
 
     m_stats = Statistics();
     m_stats.currentPlaybackRate = 1.0f;
-    m_lastBitrateCalcTime = av_gettime_relative();
+    {
+        QMutexLocker presentLock(&m_presentMutex);
+        m_present = PresentState();
+        m_present.playbackRate = m_playbackRate;
+        m_present.frameIntervalUs = m_frameInterval;
+    }
+    m_perfCounters->reset();
+    m_lastBitrateCalcTime = m_clock->nowUs();
     m_lastBitrateBytes = 0;
 
+    // 打开输入流并获取流信息
+    QString openError;
+    if (!openFormatContext(url, &m_formatCtx, &openError))
+    {
+        emit errorOccurred(openError);
+        return false;
+    }
+
+    // 初始化视频和音频解码器
+    bool videoOk = initVideo();
+    bool audioOk = initAudio();
+
+    if (!videoOk && !audioOk)
+    {
+        emit errorOccurred(tr("No valid streams"));
+        return false;
+    }
+
+    // 设置同步模式：优先使用指定模式，音频主时钟但无音频时退化为视频主时钟
+    AVSyncManager::SyncMode syncMode = m_preferredSyncMode;
+    if (syncMode == AVSyncManager::SYNC_AUDIO_MASTER && !m_hasAudio)
+    {
+        syncMode = AVSyncManager::SYNC_VIDEO_MASTER;
+        qDebug() << "No audio, using video master clock";
+    }
+    m_syncManager.setSyncMode(syncMode);
+    m_syncManager.setSpeed(m_playbackRate);
+    qDebug() << "Sync mode:" << syncMode;
+
+    // 获取总时长
+    qint64 duration = (m_formatCtx->duration != AV_NOPTS_VALUE)
+                          ? m_formatCtx->duration * 1000 / AV_TIME_BASE : 0;
+    emit durationChanged(duration);
+
+    // 启动音频缓冲区定时器
+    if (m_audioBufferTimer)
+        m_audioBufferTimer->start();
+
+    // 启动解码线程
+    m_running = true;
+    emit playStateChanged(PlayerWidgetBase::PlayingState);
+    start();
+
+    qDebug() << "Media opened - Video:" << videoOk << "Audio:" << m_hasAudio
+             << "Duration:" << duration << "ms";
+    return true;
+}
+
+/**
+ * @brief 打开输入流并获取流信息
+ * @param url 文件路径或网络URL
+ * @param formatCtx 输出：打开的格式上下文，失败时为nullptr
+ * @param error 输出：失败原因
+ */
+bool FFmpegDecoderThread::openFormatContext(const QString &url, AVFormatContext **formatCtx, QString *error)
+{
     // 设置FFmpeg选项
     AVDictionary *options = nullptr;
     bool isNetwork = url.startsWith("rtsp://") || url.startsWith("http://");
@@ -370,7 +602,7 @@ bool FFmpegDecoderThread::openMedia(const QString &url)
     }
 
     // 打开输入流
-    int ret = avformat_open_input(&m_formatCtx, url.toUtf8().constData(), nullptr, &options);
+    int ret = avformat_open_input(formatCtx, url.toUtf8().constData(), nullptr, &options);
     if (options)
         av_dict_free(&options);
 
@@ -378,63 +610,113 @@ bool FFmpegDecoderThread::openMedia(const QString &url)
     {
         char errbuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errbuf, sizeof(errbuf));
-        emit errorOccurred(tr("Failed to open: %1").arg(errbuf));
+        if (error)
+            *error = tr("Failed to open: %1").arg(errbuf);
         return false;
     }
 
     // 获取流信息
-    if (avformat_find_stream_info(m_formatCtx, nullptr) < 0)
+    if (avformat_find_stream_info(*formatCtx, nullptr) < 0)
     {
-        emit errorOccurred(tr("No stream info"));
+        avformat_close_input(formatCtx);
+        if (error)
+            *error = tr("No stream info");
         return false;
     }
+    return true;
+}
 
-    // 初始化视频和音频解码器
-    bool videoOk = initVideo();
-    bool audioOk = initAudio();
-
-    if (!videoOk && !audioOk)
-    {
-        emit errorOccurred(tr("No valid streams"));
+/**
+ * @brief 比较两组编解码参数是否一致（一致时解码器可直接复用）
+ */
+static bool isSameCodecParameters(const AVCodecParameters *a, const AVCodecParameters *b)
+{
+    if (!a || !b)
+        return a == b;
+    if (a->codec_type != b->codec_type || a->codec_id != b->codec_id || a->format != b->format)
         return false;
-    }
 
-    // 设置同步模式
-    if (m_hasAudio)
+    if (a->codec_type == AVMEDIA_TYPE_VIDEO)
     {
-        m_syncManager.setSyncMode(AVSyncManager::SYNC_AUDIO_MASTER);
-        qDebug() << "Using audio master clock for sync";
+        if (a->width != b->width || a->height != b->height)
+            return false;
     }
-    else
+    else if (a->codec_type == AVMEDIA_TYPE_AUDIO)
     {
-        m_syncManager.setSyncMode(AVSyncManager::SYNC_VIDEO_MASTER);
-        qDebug() << "No audio, using video master clock";
+        if (a->sample_rate != b->sample_rate || av_channel_layout_compare(&a->ch_layout, &b->ch_layout) != 0)
+            return false;
     }
 
-    // 获取总时长
-    qint64 duration = (m_formatCtx->duration != AV_NOPTS_VALUE)
-                          ? m_formatCtx->duration * 1000 / AV_TIME_BASE : 0;
-    emit durationChanged(duration);
+    // SPS/PPS等头信息变化时需要重建解码器
+    if (a->extradata_size != b->extradata_size)
+        return false;
+    return a->extradata_size == 0 || memcmp(a->extradata, b->extradata, a->extradata_size) == 0;
+}
 
-    // 启动音频缓冲区定时器
-    if (m_audioBufferTimer)
-        m_audioBufferTimer->start();
+/**
+ * @brief 新打开的输入能否沿用当前解码器
+ * @param videoIndex/audioIndex 输出：新输入中对应的流索引
+ */
+bool FFmpegDecoderThread::canReuseDecoders(AVFormatContext *newCtx, int &videoIndex, int &audioIndex) const
+{
+    videoIndex = -1;
+    audioIndex = -1;
 
-    // 启动解码线程
-    m_running = true;
-    emit playStateChanged(PlayerWidgetBase::PlayingState);
-    start();
+    // 上次重建失败时解码器为空，没有可复用的解码器，必须重新初始化
+    if (!m_video.codecCtx && !(m_hasAudio && m_audio.codecCtx))
+        return false;
 
-    qDebug() << "Media opened - Video:" << videoOk << "Audio:" << m_hasAudio
-             << "Duration:" << duration << "ms";
+    // 新输入带视频流而视频解码器缺失（上次只重建出音频）时同样需要重建
+    if (!m_video.codecCtx && av_find_best_stream(newCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0) >= 0)
+        return false;
+
+    if (m_video.codecCtx)
+    {
+        videoIndex = av_find_best_stream(newCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (videoIndex < 0 || !m_formatCtx ||
+            !isSameCodecParameters(m_formatCtx->streams[m_video.streamIndex]->codecpar,
+                                   newCtx->streams[videoIndex]->codecpar))
+            return false;
+    }
+
+    if (m_hasAudio && m_audio.codecCtx)
+    {
+        audioIndex = av_find_best_stream(newCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if (audioIndex < 0 || !m_formatCtx ||
+            !isSameCodecParameters(m_formatCtx->streams[m_audio.streamIndex]->codecpar,
+                                   newCtx->streams[audioIndex]->codecpar))
+            return false;
+    }
     return true;
 }
 
 /**
- * @brief 网络重连
+ * @brief 可被close()打断的等待
+ * @return false表示等待期间播放已停止
+ */
+bool FFmpegDecoderThread::waitForReconnect(int delayMs)
+{
+    QMutexLocker lock(&m_mutex);
+    const qint64 deadline = m_clock->nowUs() + static_cast<qint64>(delayMs) * 1000;
+    while (m_running)
+    {
+        qint64 remaining = deadline - m_clock->nowUs();
+        if (remaining <= 0)
+            break;
+        m_clock->wait(m_pauseCondition, m_mutex, remaining);
+    }
+    return m_running;
+}
+
+/**
+ * @brief 网络重连（在解码线程中调用）
  * @return true表示重连成功
- * 
- * 使用指数退避策略：1s, 2s, 4s, 8s... 最大30秒
+ *
+ * 只重新打开AVFormatContext：编解码参数不变时沿用解码器（flush后继续）、
+ * 缩放上下文、RGB缓冲区与音频设备，链路抖动只损失几百毫秒；
+ * 参数变化时在解码线程内重建解码器，音频设备仍然保留。
+ * 退避策略：200ms起按2倍递增（上限5s），每次在[base/2, base]内随机抖动，
+ * 避免多路摄像头同时掉线后同时重连。
  */
 bool FFmpegDecoderThread::reconnectMedia()
 {
@@ -442,55 +724,113 @@ bool FFmpegDecoderThread::reconnectMedia()
         return false;
 
     m_isReconnecting = true;
-    m_currentReconnectAttempt++;
 
-    emit networkReconnecting(m_currentReconnectAttempt, m_maxReconnectRetries);
-    qDebug() << "Attempting reconnect" << m_currentReconnectAttempt << "of"
-             << m_maxReconnectRetries;
+    // 记录断线前的播放位置（点播流重连后恢复）
+    const qint64 resumePosUs = m_lastVideoPts;
 
-    // 保存当前播放位置
-    qint64 currentPos = 0;
+    while (m_running && m_currentReconnectAttempt < m_maxReconnectRetries)
     {
-        QMutexLocker lock(&m_mutex);
-        currentPos = m_seekPos;
-    }
+        m_currentReconnectAttempt++;
+        emit networkReconnecting(m_currentReconnectAttempt, m_maxReconnectRetries);
 
-    close(false);
+        // 抖动退避
+        int baseMs = qMin(200 * (1 << qMin(m_currentReconnectAttempt - 1, 5)), 5000);
+        int delayMs = baseMs / 2 + QRandomGenerator::global()->bounded(baseMs / 2 + 1);
+        qDebug() << "Attempting reconnect" << m_currentReconnectAttempt << "of"
+                 << m_maxReconnectRetries << "in" << delayMs << "ms";
+        if (!waitForReconnect(delayMs))
+            break;
 
-    // 指数退避延迟
-    int delayMs = qMin(1000 * (1 << (m_currentReconnectAttempt - 1)), 30000);
-    QThread::msleep(delayMs);
+        QElapsedTimer timer;
+        timer.start();
 
-    // 重新打开媒体
-    if (openMedia(m_currentUrl))
-    {
-        // 恢复倍速设置
-        if (m_playbackRate != 1.0f)
+        AVFormatContext *newCtx = nullptr;
+        QString openError;
+        if (!openFormatContext(m_currentUrl, &newCtx, &openError))
+        {
+            qWarning() << "Reconnect attempt failed:" << openError;
+            continue;
+        }
+
+        int videoIndex = -1;
+        int audioIndex = -1;
+        bool reuse = canReuseDecoders(newCtx, videoIndex, audioIndex);
+
+        // 替换格式上下文
+        avformat_close_input(&m_formatCtx);
+        m_formatCtx = newCtx;
+
+        if (reuse)
         {
-            setPlaybackRate(m_playbackRate);
+            // 快速路径：解码器只需flush，缩放/重采样/音频设备全部保留
+            if (m_video.codecCtx)
+            {
+                avcodec_flush_buffers(m_video.codecCtx);
+                m_video.streamIndex = videoIndex;
+                m_video.timeBase = m_formatCtx->streams[videoIndex]->time_base;
+            }
+            if (m_hasAudio && m_audio.codecCtx)
+            {
+                avcodec_flush_buffers(m_audio.codecCtx);
+                m_audio.streamIndex = audioIndex;
+                m_audio.timeBase = m_formatCtx->streams[audioIndex]->time_base;
+            }
+        }
+        else
+        {
+            // 参数变化：在解码线程内重建解码器，音频设备保留
+            qDebug() << "Codec parameters changed, rebuilding decoders";
+            if (m_video.swsCtx)
+            {
+                sws_freeContext(m_video.swsCtx);
+                m_video.swsCtx = nullptr;
+            }
+            avcodec_free_context(&m_video.codecCtx);
+            delete[] m_rgbBuffer;
+            m_rgbBuffer = nullptr;
+            m_rgbBufferSize = 0;
+            swr_free(&m_audio.swrCtx);
+            avcodec_free_context(&m_audio.codecCtx);
+            m_video.streamIndex = -1;
+            m_audio.streamIndex = -1;
+
+            bool videoOk = initVideo();
+            bool audioOk = reinitAudioDecoder();
+            if (!videoOk && !audioOk)
+            {
+                qWarning() << "Reconnect: no valid streams after rebuild";
+                continue;
+            }
         }
 
-        // 恢复播放位置
-        if (currentPos > 0)
+        // 恢复点播流位置（直播流没有时长，从最新数据开始）
+        if (m_formatCtx->duration > 0 && resumePosUs > 0)
         {
-            seekTo(currentPos);
+            av_seek_frame(m_formatCtx, -1, av_rescale_q(resumePosUs, {1, 1000000}, AV_TIME_BASE_Q),
+                          AVSEEK_FLAG_BACKWARD);
         }
+
+        // 时间戳可能重新开始，重置同步状态与帧缓冲
+        m_frameBuffer.clear();
+        m_syncManager.reset();
+        m_lastVideoPts = 0;
+        m_videoActive = true;
+        m_waitVideoKeyframe = false;
+
         m_isReconnecting = false;
         m_currentReconnectAttempt = 0;
         m_stats.reconnectCount++;
         emit networkReconnected();
-        qDebug() << "Reconnect successful";
+        qDebug() << "Reconnect successful in" << timer.elapsed() << "ms, decoders reused:" << reuse;
         return true;
     }
 
     m_isReconnecting = false;
 
-    if (m_currentReconnectAttempt >= m_maxReconnectRetries)
+    if (m_running && m_currentReconnectAttempt >= m_maxReconnectRetries)
     {
         emit errorOccurred(tr("Max reconnection attempts reached"));
-        return false;
     }
-
     return false;
 }
 
@@ -536,30 +876,68 @@ void FFmpegDecoderThread::adjustBufferForResolution()
     m_frameBuffer.setMaxSize(bufferSize);
 }
 
+bool FFmpegDecoderThread::isDirectRenderFormat(AVPixelFormat format)
+{
+    // 与OpenGLVideoWidget的着色器变体对应：8位三平面、双平面，16位小端存储的高位深格式
+    switch (format)
+    {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+    case AV_PIX_FMT_YUV422P:
+    case AV_PIX_FMT_YUVJ422P:
+    case AV_PIX_FMT_YUV444P:
+    case AV_PIX_FMT_YUVJ444P:
+    case AV_PIX_FMT_NV12:
+    case AV_PIX_FMT_NV21:
+    case AV_PIX_FMT_P010LE:
+    case AV_PIX_FMT_P016LE:
+    case AV_PIX_FMT_YUV420P10LE:
+    case AV_PIX_FMT_YUV422P10LE:
+    case AV_PIX_FMT_YUV444P10LE:
+    case AV_PIX_FMT_YUV420P12LE:
+    case AV_PIX_FMT_YUV422P12LE:
+    case AV_PIX_FMT_YUV444P12LE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 YUVFrameData FFmpegDecoderThread::extractYUVData(AVFrame *frame)
 {
     YUVFrameData data;
 
-    if (!frame || frame->format != AV_PIX_FMT_YUV420P)
+    if (!frame || !isDirectRenderFormat(static_cast<AVPixelFormat>(frame->format)))
     {
         return data;
     }
 
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+    if (!desc)
+        return data;
+
     data.width = frame->width;
     data.height = frame->height;
+    data.pixelFormat = static_cast<AVPixelFormat>(frame->format);
+    data.colorSpace = frame->colorspace;
+    data.colorRange = frame->color_range;
     data.yLinesize = frame->linesize[0];
     data.uLinesize = frame->linesize[1];
-    data.vLinesize = frame->linesize[2];
 
     int ySize = data.yLinesize * data.height;
     data.yData = QByteArray(reinterpret_cast<const char *>(frame->data[0]), ySize);
 
-    int uvHeight = data.height / 2;
+    // 色度平面高度按格式的垂直降采样计算（奇数高度向上取整）
+    int uvHeight = AV_CEIL_RSHIFT(data.height, desc->log2_chroma_h);
     int uSize = data.uLinesize * uvHeight;
     data.uData = QByteArray(reinterpret_cast<const char *>(frame->data[1]), uSize);
 
-    int vSize = data.vLinesize * uvHeight;
-    data.vData = QByteArray(reinterpret_cast<const char *>(frame->data[2]), vSize);
+    if (!data.isSemiPlanar())
+    {
+        data.vLinesize = frame->linesize[2];
+        int vSize = data.vLinesize * uvHeight;
+        data.vData = QByteArray(reinterpret_cast<const char *>(frame->data[2]), vSize);
+    }
 
     return data;
 }
@@ -568,81 +946,21 @@ YUVFrameData FFmpegDecoderThread::extractYUVData(AVFrame *frame)
 
 bool FFmpegDecoderThread::initVideo()
 {
-    // 查找最佳视频流
-    m_video.streamIndex = av_find_best_stream(m_formatCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
-    if (m_video.streamIndex < 0)
-    {
-        qWarning() << "No video stream found";
-        return false;
-    }
-
-    // 获取解码器参数
-    AVCodecParameters *params = m_formatCtx->streams[m_video.streamIndex]->codecpar;
-    const AVCodec *codec = avcodec_find_decoder(params->codec_id);
-    if (!codec)
-    {
-        qWarning() << "Video codec not found";
-        return false;
-    }
-
-    // 分配解码器上下文
-    m_video.codecCtx = avcodec_alloc_context3(codec);
+    // 查找视频流并打开解码器（与离线抽帧工具共用）
+    m_video.codecCtx = FFmpegDecodeHelper::openVideoDecoder(m_formatCtx, m_video.streamIndex);
     if (!m_video.codecCtx)
         return false;
 
-    // 将参数填充到上下文
-    if (avcodec_parameters_to_context(m_video.codecCtx, params) < 0)
-    {
-        avcodec_free_context(&m_video.codecCtx);
-        return false;
-    }
-
     // 保存像素格式
     m_video.pixFmt = m_video.codecCtx->pix_fmt;
 
-    // ========== 4K性能优化 ==========
-    bool is4K = (m_video.codecCtx->width >= _4K_WIDTH_THRESHOLD ||
-                 m_video.codecCtx->height >= _4K_HEIGHT_THRESHOLD);
-
-    if (is4K)
-    {
-        // 4K视频：启用多线程解码
-        int threadCount = qMax(4, QThread::idealThreadCount());
-        m_video.codecCtx->thread_count = threadCount;
-        m_video.codecCtx->thread_type = FF_THREAD_SLICE | FF_THREAD_FRAME;
-        qDebug() << "4K optimization enabled - thread count:" << threadCount;
-    }
-    else
-    {
-        // 普通视频：适度多线程
-        m_video.codecCtx->thread_count = qMin(2, QThread::idealThreadCount());
-        m_video.codecCtx->thread_type = FF_THREAD_SLICE;
-    }
-
-    // 打开解码器（不使用额外选项，避免兼容性问题）
-    AVDictionary *opts = nullptr;
-    if (avcodec_open2(m_video.codecCtx, codec, &opts) < 0)
-    {
-        av_dict_free(&opts);
-        avcodec_free_context(&m_video.codecCtx);
-        qWarning() << "Failed to open video codec";
-        return false;
-    }
-    av_dict_free(&opts);
+    bool is4K = FFmpegDecodeHelper::isHighResolution(m_video.codecCtx->width, m_video.codecCtx->height);
 
     // 获取视频尺寸和时间基
     m_video.width = m_video.codecCtx->width;
     m_video.height = m_video.codecCtx->height;
     m_video.timeBase = m_formatCtx->streams[m_video.streamIndex]->time_base;
 
-    // 分辨率有效性检查
-    if (m_video.width <= 0 || m_video.height <= 0)
-    {
-        qCritical() << "Invalid video resolution:" << m_video.width << "x" << m_video.height;
-        avcodec_free_context(&m_video.codecCtx);
-        return false;
-    }
-
     qDebug() << "Video resolution:" << m_video.width << "x" << m_video.height
              << "format:" << av_get_pix_fmt_name(m_video.pixFmt);
 
@@ -686,48 +1004,19 @@ void FFmpegDecoderThread::updateFrameRate()
     if (!m_formatCtx || m_video.streamIndex < 0)
         return;
 
-    AVStream *stream = m_formatCtx->streams[m_video.streamIndex];
-
-    // 方法1: 从流中获取帧率
-    AVRational fps = av_guess_frame_rate(m_formatCtx, stream, nullptr);
-    if (fps.num > 0 && fps.den > 0)
-    {
-        m_video.frameRate = fps;
-        m_frameInterval = 1000000 * fps.den / fps.num;
-        return;
-    }
-
-    // 方法2: 从codec中获取
-    if (m_video.codecCtx && m_video.codecCtx->framerate.num > 0)
-    {
-        m_video.frameRate = m_video.codecCtx->framerate;
-        m_frameInterval = 1000000 * m_video.frameRate.den / m_video.frameRate.num;
-        return;
-    }
-
-    // 方法3: 从平均帧率推算
-    if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
-    {
-        m_video.frameRate = stream->avg_frame_rate;
-        m_frameInterval = 1000000 * m_video.frameRate.den / m_video.frameRate.num;
-        return;
-    }
-
-    // 默认值：25fps
-    m_video.frameRate = {25, 1};
-    m_frameInterval = 40000; // 40ms = 25fps
-    qDebug() << "Using default frame rate: 25fps";
+    m_video.frameRate = FFmpegDecodeHelper::guessVideoFrameRate(m_formatCtx, m_video.streamIndex, m_video.codecCtx);
+    m_frameInterval = 1000000LL * m_video.frameRate.den / m_video.frameRate.num;
+    snapshotPresentTiming();
 }
 
-bool FFmpegDecoderThread::initAudio()
+bool FFmpegDecoderThread::initAudioDecoder()
 {
     // 查找音频流（可选，没有音频不影响视频播放）
     m_audio.streamIndex = av_find_best_stream(m_formatCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
     if (m_audio.streamIndex < 0)
     {
         qDebug() << "No audio stream found, audio disabled";
-        m_hasAudio = false;
-        return true;  // 音频不存在不代表失败
+        return false;
     }
 
     // 获取解码器参数
@@ -736,8 +1025,7 @@ bool FFmpegDecoderThread::initAudio()
     if (!codec)
     {
         qDebug() << "Audio codec not found, audio disabled";
-        m_hasAudio = false;
-        return true;
+        return false;
     }
 
     // 初始化解码上下文
@@ -746,16 +1034,14 @@ bool FFmpegDecoderThread::initAudio()
     {
         qWarning() << "Failed to allocate audio codec context";
         avcodec_free_context(&m_audio.codecCtx);
-        m_hasAudio = false;
-        return true;
+        return false;
     }
 
     // 打开解码器
     if (avcodec_open2(m_audio.codecCtx, codec, nullptr) < 0)
     {
         avcodec_free_context(&m_audio.codecCtx);
-        m_hasAudio = false;
-        return true;
+        return false;
     }
 
     // ========== 音频采样率兼容性处理 ==========
@@ -789,8 +1075,7 @@ bool FFmpegDecoderThread::initAudio()
     if (!m_audio.swrCtx)
     {
         avcodec_free_context(&m_audio.codecCtx);
-        m_hasAudio = false;
-        return true;
+        return false;
     }
 
     // 设置输入参数
@@ -811,6 +1096,17 @@ bool FFmpegDecoderThread::initAudio()
         qWarning() << "Failed to initialize audio resampler";
         swr_free(&m_audio.swrCtx);
         avcodec_free_context(&m_audio.codecCtx);
+        return false;
+    }
+
+    return true;
+}
+
+bool FFmpegDecoderThread::initAudio()
+{
+    // 音频不存在或初始化失败不代表失败，没有音频不影响视频播放
+    if (!initAudioDecoder())
+    {
         m_hasAudio = false;
         return true;
     }
@@ -828,8 +1124,54 @@ bool FFmpegDecoderThread::initAudio()
     return true;
 }
 
+/**
+ * @brief 重连时重建音频解码器，尽量保留现有音频设备
+ * 输出采样率不变时沿用设备，否则重建设备
+ */
+bool FFmpegDecoderThread::reinitAudioDecoder()
+{
+    const int oldSampleRate = m_out_sample_rate;
+    if (!initAudioDecoder())
+    {
+        m_hasAudio = false;
+        return false;
+    }
+
+    if (m_audio.output && oldSampleRate == m_out_sample_rate)
+    {
+        m_hasAudio = true;
+        return true;
+    }
+
+    m_audioWriter.stop();
+    if (m_audio.output)
+    {
+        m_audio.output->stop();
+        delete m_audio.output;
+        m_audio.output = nullptr;
+        m_audio.device = nullptr;
+    }
+
+    m_hasAudio = initAudioOutput();
+    if (!m_hasAudio)
+    {
+        swr_free(&m_audio.swrCtx);
+        avcodec_free_context(&m_audio.codecCtx);
+        qWarning() << "Audio output initialization failed, continuing without audio";
+    }
+    return m_hasAudio;
+}
+
+
 bool FFmpegDecoderThread::initAudioOutput()
 {
+    // 虚拟时间下不打开真实设备，数据由writeVirtualAudio按虚拟时间消耗
+    if (m_clock->isVirtual())
+    {
+        m_virtualAudioEndUs = 0;
+        return true;
+    }
+
     QAudioFormat format = createAudioFormat();
 
 #if QT_VERSION_MAJOR < 6
@@ -898,7 +1240,7 @@ bool FFmpegDecoderThread::initAudioOutput()
     }
 
     // 设置音频写入器
-    m_audioWriter.setDevice(m_audio.device, m_audio.output);
+    m_audioWriter.setDevice(m_audio.device, m_audio.output, m_out_sample_rate * 4);
     m_audioWriter.start();
 
     return true;
@@ -1085,6 +1427,7 @@ void FFmpegDecoderThread::cleanupResources()
     m_hasAudio = false;
     m_video.frameRate = {0, 0};
     m_frameInterval = 40000;
+    snapshotPresentTiming();
     m_lastVideoPts = 0;
     m_firstVideoPts = -1;
     m_startTime = 0;
@@ -1168,13 +1511,9 @@ void FFmpegDecoderThread::run()
     }
 
     bool isNetwork = m_currentUrl.startsWith("rtsp://") || m_currentUrl.startsWith("http://");
-    m_lastStatTime = av_gettime_relative();
+    m_lastStatTime = m_clock->nowUs();
     int consecutiveErrors = 0;
 
-    // 无音频模式的时间基准
-    qint64 systemStartTime = 0;
-    qint64 firstPts = -1;
-
     while (m_running)
     {
         // 空指针检查
@@ -1197,8 +1536,10 @@ void FFmpegDecoderThread::run()
             if (m_paused && !m_wasPaused)
             {
                 // 刚进入暂停状态，记录暂停开始时间
-                m_pauseStartTime = av_gettime_relative();
+                m_pauseStartTime = m_clock->nowUs();
                 m_wasPaused = true;
+                m_syncManager.setPaused(true);
+                m_virtualAudioEndUs = 0;    // 真实设备暂停时不消耗数据，虚拟设备同样清空
                 qDebug() << "Entered paused state at" << m_pauseStartTime;
             }
             else if (!m_paused && m_wasPaused)
@@ -1206,24 +1547,22 @@ void FFmpegDecoderThread::run()
                 // 刚退出暂停状态，计算总暂停时间
                 if (m_pauseStartTime > 0)
                 {
-                    qint64 pauseDuration = av_gettime_relative() - m_pauseStartTime;
+                    qint64 pauseDuration = m_clock->nowUs() - m_pauseStartTime;
                     m_totalPausedTime += pauseDuration;
                     qDebug() << "Exited paused state, duration:" << pauseDuration 
                              << "us, total:" << m_totalPausedTime << "us";
                 }
                 m_pauseStartTime = 0;
                 m_wasPaused = false;
+                m_syncManager.setPaused(false);
                 // 重置显示时间，避免时间累积问题
                 m_lastDisplayTime = 0;
             }
             
             while (m_paused && m_running && !m_seekRequested)
             {
-                // 使用较短的超时，确保能及时响应状态变化
-                if (!m_pauseCondition.wait(&m_mutex, 50))
-                {
-                    // 超时后继续循环，检查状态
-                }
+                // 使用较短的超时，确保能及时响应状态变化（虚拟时钟下只推进虚拟时间）
+                m_clock->wait(m_pauseCondition, m_mutex, 50000);
             }
             if (!m_running)
                 break;
@@ -1250,13 +1589,12 @@ void FFmpegDecoderThread::run()
             // 重置同步状态
             m_syncManager.reset();
             m_lastVideoPts = 0;
-            firstPts = -1;
-            systemStartTime = 0;
             // seek后重置暂停时间累积
             m_totalPausedTime = 0;
             
-            // 发送位置更新信号
-            emit positionChanged(seekTargetMs);
+            m_virtualAudioEndUs = 0;
+            // 更新播放位置（GUI轮询读取）
+            m_positionMs.store(seekTargetMs, std::memory_order_relaxed);
         }
 
         // 检查缓冲区是否过满
@@ -1266,22 +1604,30 @@ void FFmpegDecoderThread::run()
         // ========== 缓冲区检查 ==========
         if (m_useBuffer && !m_paused && m_frameBuffer.size() >= maxBufferSize)
         {
-            QThread::msleep(is4K ? 3 : 2);
+            m_clock->sleepUs(is4K ? 3000 : 2000);
             continue;
         }
 
+        // 故障注入：模拟网络卡顿
+        if (m_faultHooks)
+            m_clock->sleepUs(m_faultHooks->readStallUs(m_packetIndex));
+        m_packetIndex++;
+
         // 读取数据包
         av_packet_unref(pkt);
         int ret = av_read_frame(m_formatCtx, pkt);
 
         if (ret < 0)
         {
-            if (ret == AVERROR_EOF)
+            // 直播网络流的EOF通常意味着连接断开，直接进入重连
+            bool liveDisconnected = (ret == AVERROR_EOF && isNetwork && m_autoReconnect &&
+                                     m_formatCtx->duration <= 0);
+            if (ret == AVERROR_EOF && !liveDisconnected)
             {
                 // EOF 后等待一段时间再退出
                 if (m_frameBuffer.size() > 0)
                 {
-                    QThread::msleep(10);
+                    m_clock->sleepUs(10000);
                     continue;
                 }
                 break;
@@ -1290,7 +1636,7 @@ void FFmpegDecoderThread::run()
             consecutiveErrors++;
 
             // 网络流重连
-            if (isNetwork && m_autoReconnect && consecutiveErrors > 5)
+            if (isNetwork && m_autoReconnect && (consecutiveErrors > 5 || liveDisconnected))
             {
                 if (reconnectMedia())
                 {
@@ -1302,17 +1648,18 @@ void FFmpegDecoderThread::run()
 
             // 错误退避
             int waitMs = qMin(10 * consecutiveErrors, 100);
-            QThread::msleep(waitMs);
+            m_clock->sleepUs(waitMs * 1000);
             continue;
         }
 
         consecutiveErrors = 0;
 
-        qint64 now = av_gettime_relative();
+        qint64 now = m_clock->nowUs();
         if (now - m_lastBitrateCalcTime >= 1000000)
         {
             qint64 bytesDiff = m_lastBitrateBytes;
             m_stats.currentBitrate = bytesDiff * 8 / ((now - m_lastBitrateCalcTime) / 1000000);
+            m_perfCounters->bitrate.store(m_stats.currentBitrate, std::memory_order_relaxed);
             m_lastBitrateCalcTime = now;
             m_lastBitrateBytes = 0;
         }
@@ -1321,56 +1668,31 @@ void FFmpegDecoderThread::run()
         // 分发数据包
         if (pkt->stream_index == m_video.streamIndex)
         {
-            decodeVideoPacket(pkt);
+            if (acceptVideoPacket(pkt))
+                decodeVideoPacket(pkt);
         }
         else if (pkt->stream_index == m_audio.streamIndex && m_hasAudio)
         {
             decodeAudioPacket(pkt);
         }
 
-        if (m_useBuffer && !m_paused)
+        // 故障注入：模拟解码耗时
+        if (m_faultHooks)
+        {
+            qint64 ptsUs = (pkt->pts == AV_NOPTS_VALUE)
+                               ? AV_NOPTS_VALUE
+                               : av_rescale_q(pkt->pts, m_formatCtx->streams[pkt->stream_index]->time_base, {1, 1000000});
+            m_clock->sleepUs(m_faultHooks->decodeDelayUs(pkt->stream_index == m_video.streamIndex, ptsUs));
+        }
+
+        if (m_useBuffer && !m_paused && m_videoActive)
         {
             OptionalFrameBuffer::VideoFrame frame = m_frameBuffer.pop(5);
+            m_perfCounters->queueDepth.store(m_frameBuffer.size(), std::memory_order_relaxed);
             if (frame.isValid())
             {
-                qint64 waitTime = 0;
-
-                if (m_hasAudio && m_syncManager.isAudioClockValid())
-                {
-                    waitTime = m_syncManager.calculateWaitTime(frame.pts, frame.duration, m_playbackRate);
-                }
-                else if (m_hasAudio && !m_syncManager.isAudioClockValid())
-                {
-                    waitTime = 10000;
-                }
-                else
-                {
-                    qint64 adjustedDuration = static_cast<qint64>(frame.duration / m_playbackRate);
-                    if (firstPts < 0)
-                    {
-                        firstPts = frame.pts;
-                        systemStartTime = av_gettime_relative() - m_totalPausedTime;
-                        waitTime = 0;
-                    }
-                    else
-                    {
-                        // 考虑暂停时间
-                        qint64 expectedTime = systemStartTime + m_totalPausedTime +
-                                              static_cast<qint64>((frame.pts - firstPts) / m_playbackRate);
-                        qint64 currentTime = av_gettime_relative();
-                        waitTime = expectedTime - currentTime;
-
-                        if (waitTime > adjustedDuration * 2)
-                            waitTime = adjustedDuration * 2;
-                        if (waitTime < -adjustedDuration * 3)
-                        {
-                            // 落后太多，重置时间基准
-                            firstPts = frame.pts;
-                            systemStartTime = av_gettime_relative() - m_totalPausedTime;
-                            waitTime = 0;
-                        }
-                    }
-                }
+                // 按当前同步模式计算等待时间（主时钟暂停期间冻结，无需再扣除暂停时长）
+                qint64 waitTime = m_syncManager.calculateWaitTime(frame.pts, frame.duration, m_playbackRate);
 
                 if (waitTime == -1)
                 {
@@ -1392,41 +1714,28 @@ void FFmpegDecoderThread::run()
                     }
                     waitTime = qMin(waitTime, maxWait);
 
-                    if (waitTime < 10000)
-                    {
-                        QThread::usleep(static_cast<unsigned long>(waitTime));
-                    }
-                    else
-                    {
-                        QThread::msleep(waitTime / 1000);
-                    }
+                    m_clock->sleepUs(waitTime);
                 }
 
                 if (!m_running)
                     break;
 
-                // 正确发送帧数据
-                // 根据帧类型发送对应的信号
+                // 投递到显示信箱，GUI未取走的旧帧直接被覆盖
                 if (frame.isValid())
                 {
-                    if (frame.isYUV)
-                    {
-                        // 发送YUV帧数据（OpenGL渲染性能更好）
-                        emit frameReadyYUV(frame.yuvData);
-                    }
-                    else
-                    {
-                        // 发送RGB图像数据
-                        emit frameReady(frame.image);
-                    }
-                    // 使用微秒精度发送位置（毫秒）
-                    emit positionChanged(frame.pts / 1000);
+                    DisplayFrame display;
+                    display.isYUV = frame.isYUV;
+                    display.image = frame.image;
+                    display.yuvData = frame.yuvData;
+                    display.ptsMs = frame.pts / 1000;
+                    display.source = frame.source;
+                    publishFrame(std::move(display));
                     m_stats.totalFramesDisplayed++;
                     m_framesSinceLastFpsCalc++;
-                    m_syncManager.frameDisplayed();
+                    m_syncManager.frameDisplayed(frame.pts);
                 }
 
-                m_lastDisplayTime = av_gettime_relative();
+                m_lastDisplayTime = m_clock->nowUs();
             }
         }
         else if (!m_useBuffer)
@@ -1434,7 +1743,7 @@ void FFmpegDecoderThread::run()
             // 非缓冲模式，在decodeVideoPacket中已处理
         }
 
-        now = av_gettime_relative();
+        now = m_clock->nowUs();
         if (now - m_lastStatTime >= 1000000)
         {
             updatePerformanceStats();
@@ -1448,22 +1757,23 @@ void FFmpegDecoderThread::run()
         }
     }
 
-    // 清空剩余的帧缓冲区
+    // 清空剩余的帧缓冲区（信箱只保留最新一帧，中间帧不再逐帧投递）
+    OptionalFrameBuffer::VideoFrame lastFrame;
     while (m_frameBuffer.size() > 0 && m_running)
     {
         OptionalFrameBuffer::VideoFrame frame = m_frameBuffer.pop(10);
         if (frame.isValid())
-        {
-            if (frame.isYUV)
-            {
-                emit frameReadyYUV(frame.yuvData);
-            }
-            else
-            {
-                emit frameReady(frame.image);
-            }
-            emit positionChanged(frame.pts / 1000);
-        }
+            lastFrame = frame;
+    }
+    if (lastFrame.isValid())
+    {
+        DisplayFrame display;
+        display.isYUV = lastFrame.isYUV;
+        display.image = lastFrame.image;
+        display.yuvData = lastFrame.yuvData;
+        display.ptsMs = lastFrame.pts / 1000;
+        display.source = lastFrame.source;
+        publishFrame(std::move(display));
     }
 
     av_packet_free(&pkt);
@@ -1482,6 +1792,10 @@ void FFmpegDecoderThread::decodeVideoPacket(AVPacket *pkt)
         return;
     }
 
+    // 解码耗时：send_packet + 得到该帧的receive_frame，不含后续转换与等待
+    QElapsedTimer decodeTimer;
+    decodeTimer.start();
+
     int ret = avcodec_send_packet(m_video.codecCtx, pkt);
     if (ret < 0)
         return;
@@ -1509,6 +1823,15 @@ void FFmpegDecoderThread::decodeVideoPacket(AVPacket *pkt)
         }
 
         m_stats.totalFramesDecoded++;
+        m_perfCounters->decodeUs.store(decodeTimer.nsecsElapsed() / 1000, std::memory_order_relaxed);
+        m_perfCounters->decodedFrames.store(m_stats.totalFramesDecoded, std::memory_order_relaxed);
+
+        // 不可见时只维持解码器状态，跳过格式转换与显示
+        if (!m_videoActive)
+        {
+            av_frame_free(&frame);
+            continue;
+        }
 
         // 计算PTS
         qint64 pts = (frame->pts == AV_NOPTS_VALUE) ? frame->pkt_dts : frame->pts;
@@ -1538,6 +1861,7 @@ void FFmpegDecoderThread::decodeVideoPacket(AVPacket *pkt)
             processVideoFrameDirect(frame);
 
         av_frame_free(&frame);
+        decodeTimer.restart();
     }
 }
 
@@ -1563,39 +1887,8 @@ void FFmpegDecoderThread::processVideoFrameDirect(AVFrame *frame)
     frameDuration = qBound(8333LL, frameDuration, 1000000LL);
     m_lastVideoPts = pts;
 
-    // 计算等待时间
-    qint64 waitTime = 0;
-
-    if (m_hasAudio && m_syncManager.isAudioClockValid())
-    {
-        waitTime = m_syncManager.calculateWaitTime(pts, frameDuration, m_playbackRate);
-    }
-    else if (m_hasAudio && !m_syncManager.isAudioClockValid())
-    {
-        // 音频时钟尚未建立，按帧间隔显示
-        qint64 adjustedDuration = static_cast<qint64>(frameDuration / m_playbackRate);
-        if (m_lastDisplayTime > 0)
-        {
-            qint64 elapsed = av_gettime_relative() - m_lastDisplayTime;
-            if (elapsed < adjustedDuration)
-            {
-                waitTime = adjustedDuration - elapsed;
-            }
-        }
-    }
-    else
-    {
-        // 无音频：使用帧间隔控制
-        qint64 adjustedDuration = static_cast<qint64>(frameDuration / m_playbackRate);
-        if (m_lastDisplayTime > 0)
-        {
-            qint64 elapsed = av_gettime_relative() - m_lastDisplayTime;
-            if (elapsed < adjustedDuration)
-            {
-                waitTime = adjustedDuration - elapsed;
-            }
-        }
-    }
+    // 计算等待时间（音频时钟未建立时由同步管理器按帧间隔控制）
+    qint64 waitTime = m_syncManager.calculateWaitTime(pts, frameDuration, m_playbackRate);
 
     if (waitTime == -1)
     {
@@ -1606,28 +1899,37 @@ void FFmpegDecoderThread::processVideoFrameDirect(AVFrame *frame)
     if (waitTime > 0)
     {
         waitTime = qMin(waitTime, static_cast<qint64>(frameDuration / m_playbackRate) * 2);
-        if (waitTime < 10000)
-        {
-            QThread::usleep(static_cast<unsigned long>(waitTime));
-        }
-        else
+        m_clock->sleepUs(waitTime);
+    }
+
+    // 转换并显示帧（无自身显示时只向分发端点投递原始帧引用）
+    DisplayFrame display;
+    display.ptsMs = pts / 1000;
+    if (m_primaryOutput)
+    {
+        QElapsedTimer convertTimer;
+        convertTimer.start();
+        // YUV直出时可直接渲染的格式跳过CPU转换
+        if (m_useYUVMode)
         {
-            QThread::msleep(waitTime / 1000);
+            display.yuvData = extractYUVData(frame);
+            display.isYUV = display.yuvData.isValid();
         }
+        if (!display.isYUV)
+            display.image = convertFrameToImage(frame);
+        m_perfCounters->convertUs.store(convertTimer.nsecsElapsed() / 1000, std::memory_order_relaxed);
     }
-
-    // 转换并显示帧
-    QImage image = convertFrameToImage(frame);
-    if (!image.isNull())
+    if (m_sinkCount > 0)
+        display.source = makeVideoFramePtr(frame);
+    if (display.isValid())
     {
-        emit frameReady(image);
-        emit positionChanged(pts / 1000);
+        publishFrame(std::move(display));
         m_stats.totalFramesDisplayed++;
         m_framesSinceLastFpsCalc++;
-        m_syncManager.frameDisplayed();
+        m_syncManager.frameDisplayed(pts);
     }
 
-    m_lastDisplayTime = av_gettime_relative();
+    m_lastDisplayTime = m_clock->nowUs();
 }
 
 void FFmpegDecoderThread::processVideoFrameBuffered(AVFrame *frame)
@@ -1654,17 +1956,31 @@ void FFmpegDecoderThread::processVideoFrameBuffered(AVFrame *frame)
     frameDuration = qBound(8333LL, frameDuration, 1000000LL);
     m_lastVideoPts = pts;
 
-    // 转换为RGB图像
-    QImage image = convertFrameToImage(frame);
-    if (!image.isNull())
-    {
-        // 创建VideoFrame并推入缓冲区
-        OptionalFrameBuffer::VideoFrame videoFrame(image, pts, frameDuration);
+    // 转换为RGB图像或提取YUV平面（无自身显示时跳过），挂接了分发端点时附带原始帧引用
+    QElapsedTimer convertTimer;
+    convertTimer.start();
+    YUVFrameData yuvData;
+    if (m_primaryOutput && m_useYUVMode)
+        yuvData = extractYUVData(frame);
+
+    OptionalFrameBuffer::VideoFrame videoFrame = yuvData.isValid()
+        ? OptionalFrameBuffer::VideoFrame(yuvData, pts, frameDuration)
+        : OptionalFrameBuffer::VideoFrame(m_primaryOutput ? convertFrameToImage(frame) : QImage(),
+                                          pts, frameDuration);
+    if (m_primaryOutput)
+        m_perfCounters->convertUs.store(convertTimer.nsecsElapsed() / 1000, std::memory_order_relaxed);
+    if (m_sinkCount > 0)
+        videoFrame.source = makeVideoFramePtr(frame);
+    if (videoFrame.isValid())
+    {
+        // 视频时钟在帧实际显示时更新（frameDisplayed），解码时刻的PTS领先于画面
         m_frameBuffer.push(videoFrame);
-        m_syncManager.updateVideoClock(pts);
+        m_perfCounters->queueDepth.store(m_frameBuffer.size(), std::memory_order_relaxed);
+        m_perfCounters->queueCapacity.store(m_frameBuffer.maxSize(), std::memory_order_relaxed);
     }
-    else
+    else if (m_primaryOutput)
     {
+        // 无自身显示且最后一个分发端点已解除时没有输出对象，直接跳过
         qWarning() << "Failed to convert frame to image";
     }
 }
@@ -1695,21 +2011,13 @@ QImage FFmpegDecoderThread::convertFrameToImage(AVFrame *frame)
     return image.copy();
 }
 
-bool FFmpegDecoderThread::takeScreenshot(const QString &filePath)
-{
-    OptionalFrameBuffer::VideoFrame frame = m_frameBuffer.pop(100);
-    if (!frame.isValid())
-        return false;
-    return frame.image.save(filePath);
-}
-
 QImage FFmpegDecoderThread::convertYUVToImageStatic(const YUVFrameData &yuvData)
 {
     if (!yuvData.isValid())
         return QImage();
 
     SwsContext *swsCtx = sws_getContext(
-        yuvData.width, yuvData.height, AV_PIX_FMT_YUV420P,
+        yuvData.width, yuvData.height, yuvData.pixelFormat,
         yuvData.width, yuvData.height, AV_PIX_FMT_RGB32,
         SWS_BILINEAR, nullptr, nullptr, nullptr);
 
@@ -1724,10 +2032,11 @@ QImage FFmpegDecoderThread::convertYUVToImageStatic(const YUVFrameData &yuvData)
         return QImage();
     }
 
+    // 半平面格式只使用前两个平面
     const uint8_t *srcData[3] = {
         reinterpret_cast<const uint8_t *>(yuvData.yData.constData()),
         reinterpret_cast<const uint8_t *>(yuvData.uData.constData()),
-        reinterpret_cast<const uint8_t *>(yuvData.vData.constData())};
+        yuvData.isSemiPlanar() ? nullptr : reinterpret_cast<const uint8_t *>(yuvData.vData.constData())};
     int srcLinesize[3] = {yuvData.yLinesize, yuvData.uLinesize, yuvData.vLinesize};
 
     uint8_t *dstData[1] = {rgbBuffer};
@@ -1744,6 +2053,161 @@ QImage FFmpegDecoderThread::convertYUVToImageStatic(const YUVFrameData &yuvData)
     return image;
 }
 
+// ==================== 可见性控制 ====================
+
+/**
+ * @brief 在解码线程中应用可见状态变化
+ * 隐藏：解码器只输出关键帧并清空帧缓冲；
+ * 恢复：flush解码器，丢弃后续非关键帧直到下一个关键帧，从该处重新同步显示
+ */
+void FFmpegDecoderThread::applyVideoVisibility()
+{
+    bool visible = m_videoVisible.load(std::memory_order_relaxed);
+    if (visible == m_videoActive)
+        return;
+    m_videoActive = visible;
+
+    if (!m_video.codecCtx)
+        return;
+
+    if (!visible)
+    {
+        m_video.codecCtx->skip_frame = AVDISCARD_NONKEY;
+        m_frameBuffer.clear();
+        m_lastKeyframeRefresh = 0;
+        qDebug() << "Video hidden, policy:" << m_hiddenPolicy.load();
+    }
+    else
+    {
+        m_video.codecCtx->skip_frame = AVDISCARD_DEFAULT;
+        avcodec_flush_buffers(m_video.codecCtx);
+        m_waitVideoKeyframe = true;
+        m_lastVideoPts = 0;
+        m_lastDisplayTime = 0;
+        qDebug() << "Video visible, waiting for next keyframe";
+    }
+}
+
+/**
+ * @brief 判断视频包是否需要送入解码器
+ * @return false表示丢弃该包
+ */
+bool FFmpegDecoderThread::acceptVideoPacket(AVPacket *pkt)
+{
+    applyVideoVisibility();
+    const bool isKey = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+
+    if (!m_videoActive)
+    {
+        // 无音频时读包不受音频设备节流，按主时钟控制读取速度
+        if (!m_hasAudio)
+        {
+            paceHiddenPacket(pkt);
+        }
+        else if (pkt->dts != AV_NOPTS_VALUE)
+        {
+            m_positionMs.store(av_rescale_q(pkt->dts, m_video.timeBase, {1, 1000}), std::memory_order_relaxed);
+        }
+
+        if (!isKey)
+            return false;
+
+        if (m_hiddenPolicy.load(std::memory_order_relaxed) == HIDDEN_DISCARD_ALL)
+        {
+            qint64 now = m_clock->nowUs();
+            qint64 refreshUs = static_cast<qint64>(m_keyframeRefreshMs.load(std::memory_order_relaxed)) * 1000;
+            if (m_lastKeyframeRefresh > 0 && now - m_lastKeyframeRefresh < refreshUs)
+                return false;
+            m_lastKeyframeRefresh = now;
+        }
+        return true;
+    }
+
+    if (m_waitVideoKeyframe)
+    {
+        if (!isKey)
+            return false;
+        m_waitVideoKeyframe = false;
+    }
+    return true;
+}
+
+/**
+ * @brief 不可见且无音频时按包时间戳节流
+ * 视频包不再经过显示等待，否则点播文件会被全速读完；同时维护视频时钟与播放位置
+ */
+void FFmpegDecoderThread::paceHiddenPacket(AVPacket *pkt)
+{
+    qint64 ts = (pkt->dts != AV_NOPTS_VALUE) ? pkt->dts : pkt->pts;
+    if (ts == AV_NOPTS_VALUE)
+    {
+        m_clock->sleepUs(static_cast<qint64>(m_frameInterval / m_playbackRate));
+        return;
+    }
+
+    qint64 pts = av_rescale_q(ts, m_video.timeBase, {1, 1000000});
+    qint64 waitTime = m_syncManager.calculateWaitTime(pts, m_frameInterval, m_playbackRate);
+    if (waitTime > 0)
+    {
+        // 封顶等待，保证暂停/seek/可见性变化能及时响应
+        waitTime = qMin(waitTime, static_cast<qint64>(m_frameInterval / m_playbackRate) * 2);
+        m_clock->sleepUs(waitTime);
+    }
+    m_syncManager.frameDisplayed(pts);
+    m_positionMs.store(pts / 1000, std::memory_order_relaxed);
+}
+
+// ==================== 显示帧投递 ====================
+
+/**
+ * @brief 发布待显示帧（解码线程）
+ * 信箱只保存最新一帧；仅当GUI已取走上一帧时才发出通知，
+ * GUI卡顿期间既不会在事件队列中积压帧，也不会增加内存占用
+ */
+void FFmpegDecoderThread::publishFrame(DisplayFrame frame)
+{
+    m_positionMs.store(frame.ptsMs, std::memory_order_relaxed);
+
+    // 记录投递时刻，上屏反馈据此计算管线耗时
+    {
+        QMutexLocker lock(&m_presentMutex);
+        m_present.publishPtsMs[m_present.publishIndex] = frame.ptsMs;
+        m_present.publishTime[m_present.publishIndex] = m_syncManager.currentTime();
+        m_present.publishIndex = (m_present.publishIndex + 1) % PUBLISH_HISTORY_SIZE;
+    }
+
+    // 记录显示时刻的音画偏差
+    if (m_syncManager.hasMasterClock())
+    {
+        m_stats.avDriftUs = frame.ptsMs * 1000 - m_syncManager.getCurrentClock();
+        m_stats.maxAvDriftUs = qMax(m_stats.maxAvDriftUs, qAbs(m_stats.avDriftUs));
+        m_perfCounters->avDriftUs.store(m_stats.avDriftUs, std::memory_order_relaxed);
+    }
+    m_perfCounters->droppedFrames.store(m_stats.droppedFrames, std::memory_order_relaxed);
+
+    // 分发端点共享同一解码帧引用
+    if (frame.source)
+    {
+        QMutexLocker lock(&m_sinkMutex);
+        for (VideoFrameSink *sink : m_sinks)
+            sink->pushFrame(frame.source, frame.ptsMs);
+    }
+
+    if (!frame.hasImage())
+        return;
+    frame.source.reset();   // 自身显示不需要原始帧，尽早归还解码器缓冲
+    if (m_displayMailbox.publish(std::move(frame)))
+        emit frameAvailable();
+}
+
+bool FFmpegDecoderThread::takeLatestFrame(DisplayFrame &frame)
+{
+    if (!m_displayMailbox.fetch())
+        return false;
+    frame = m_displayMailbox.current();
+    return true;
+}
+
 // ==================== 音频解码与处理 ====================
 
 void FFmpegDecoderThread::decodeAudioPacket(AVPacket *pkt)
@@ -1780,15 +2244,27 @@ void FFmpegDecoderThread::decodeAudioPacket(AVPacket *pkt)
             break;
         }
 
-        // 计算时间戳并更新音频时钟
+        // 计算时间戳（音频时钟在数据写入设备后按播放位置更新）
         qint64 pts = (frame->pts == AV_NOPTS_VALUE) ? frame->pkt_dts : frame->pts;
         pts = av_rescale_q(pts, m_audio.timeBase, {1, 1000000});
-        m_syncManager.updateAudioClock(pts);
 
-        // 计算输出样本数（考虑倍速影响）
+        // 非音频主时钟模式下，通过重采样补偿让音频追随主时钟
+        int wantedSamples = m_syncManager.synchronizeAudio(frame->nb_samples, frame->sample_rate);
+        if (wantedSamples != frame->nb_samples)
+        {
+            int delta = static_cast<int>(av_rescale(wantedSamples - frame->nb_samples,
+                                                    m_out_sample_rate, frame->sample_rate));
+            int distance = static_cast<int>(av_rescale(wantedSamples, m_out_sample_rate, frame->sample_rate));
+            if (swr_set_compensation(m_audio.swrCtx, delta, distance) < 0)
+            {
+                qWarning() << "swr_set_compensation failed, delta:" << delta;
+            }
+        }
+
+        // 计算输出样本数（考虑倍速影响与漂移补偿）
         int out_samples = av_rescale_rnd(
-            swr_get_delay(m_audio.swrCtx, frame->sample_rate) + frame->nb_samples,
-            m_out_sample_rate, frame->sample_rate, AV_ROUND_UP);
+            swr_get_delay(m_audio.swrCtx, frame->sample_rate) + qMax(wantedSamples, frame->nb_samples),
+            m_out_sample_rate, frame->sample_rate, AV_ROUND_UP) + 256;
 
         // 分配输出缓冲区
         uint8_t *output = nullptr;
@@ -1802,8 +2278,17 @@ void FFmpegDecoderThread::decodeAudioPacket(AVPacket *pkt)
         int realSamples = swr_convert(m_audio.swrCtx, &output, out_samples,
                                       (const uint8_t **)frame->data, frame->nb_samples);
 
-        if (realSamples > 0 && m_audio.device)
+        if (realSamples > 0 && (m_audio.device || m_clock->isVirtual()))
         {
+            // 故障注入：丢弃本次写入，模拟设备欠载
+            if (m_faultHooks && m_faultHooks->dropAudioWrite(pts))
+            {
+                m_stats.audioUnderrunCount++;
+                av_freep(&output);
+                av_frame_free(&frame);
+                continue;
+            }
+
             int dataSize = realSamples * 4;
             if (m_volume != 100)
             {
@@ -1814,6 +2299,11 @@ void FFmpegDecoderThread::decodeAudioPacket(AVPacket *pkt)
                 memset(output, 0, dataSize);
             }
             writeAudioData(output, dataSize);
+
+            // 已写入数据末尾PTS = 帧PTS + 帧时长 - 重采样器内部滞留
+            qint64 endPts = pts + av_rescale(frame->nb_samples, 1000000, frame->sample_rate)
+                            - swr_get_delay(m_audio.swrCtx, 1000000);
+            updateAudioClockFromDevice(endPts);
         }
 
         av_freep(&output);
@@ -1823,12 +2313,65 @@ void FFmpegDecoderThread::decodeAudioPacket(AVPacket *pkt)
 
 void FFmpegDecoderThread::writeAudioData(const uint8_t *data, int size)
 {
+    if (m_clock->isVirtual())
+    {
+        writeVirtualAudio(size);
+        return;
+    }
+
     if (!m_audioWriter.write(data, size, 100))
     {
         m_stats.audioUnderrunCount++;
     }
 }
 
+/**
+ * @brief 按设备播放位置重建音频时钟
+ * @param endPts 已写入设备的数据末尾PTS（微秒）
+ *
+ * 正在播放的位置 = 末尾PTS - 设备中排队的数据时长。
+ * 每次写入后重建基准，因此欠载（排队为0）和倍速重建设备（写入计数清零）后都会自动校正。
+ */
+void FFmpegDecoderThread::updateAudioClockFromDevice(qint64 endPts)
+{
+    qint64 queuedUs = audioQueuedUSecs();
+    if (queuedUs < 0)
+        return;
+
+    m_syncManager.updateAudioClock(endPts - queuedUs, endPts);
+}
+
+/**
+ * @brief 虚拟时间下的音频设备
+ * 与AudioWriter一致，按输出格式的每秒字节数消耗数据（倍速已体现在输出采样率中），
+ * 排队超过设备缓冲时间时写入"阻塞"（推进虚拟时间），排队数据在下一次写入前已播完则计为欠载
+ */
+void FFmpegDecoderThread::writeVirtualAudio(int size)
+{
+    const qint64 now = m_clock->nowUs();
+    if (m_virtualAudioEndUs > 0 && m_virtualAudioEndUs < now)
+        m_stats.audioUnderrunCount++;
+
+    const qint64 bytesPerSecond = static_cast<qint64>(m_out_sample_rate) * 4;
+    qint64 durationUs = static_cast<qint64>(size) * 1000000 / bytesPerSecond;
+    m_virtualAudioEndUs = qMax(m_virtualAudioEndUs, now) + durationUs;
+
+    qint64 queuedUs = m_virtualAudioEndUs - now;
+    if (queuedUs > VIRTUAL_AUDIO_BUFFER_US)
+        m_clock->sleepUs(queuedUs - VIRTUAL_AUDIO_BUFFER_US);
+}
+
+/**
+ * @brief 音频设备中排队数据的媒体时长（微秒），失败返回-1
+ */
+qint64 FFmpegDecoderThread::audioQueuedUSecs()
+{
+    if (!m_clock->isVirtual())
+        return m_audioWriter.queuedUSecs();
+
+    return qMax<qint64>(0, m_virtualAudioEndUs - m_clock->nowUs());
+}
+
 void FFmpegDecoderThread::applyVolume(int16_t *samples, int count)
 {
     float factor = m_volume / 100.0f;
@@ -1848,7 +2391,7 @@ void FFmpegDecoderThread::updatePerformanceStats()
     }
 
     // 计算帧率
-    qint64 now = av_gettime_relative();
+    qint64 now = m_clock->nowUs();
     if (now - m_lastFpsCalcTime >= 1000000)
     {
         m_currentFps = m_framesSinceLastFpsCalc;
@@ -1915,9 +2458,11 @@ void FFmpegDecoderThread::setMute()
 FFmpegPlayer::FFmpegPlayer(QWidget *parent)
     : QWidget(parent)
     , m_displayWidget_(nullptr)
-    , m_displayLabel_(nullptr)
+    , m_rasterSurface_(nullptr)
     , m_playerCore_(new PlayerWidgetBase(this))
     , m_decoder_(new FFmpegDecoderThread(this))
+    , m_capturer_(new FrameCapturer(this))
+    , m_positionTimer_(new QTimer(this))
     , m_useOpenGL(true)
     , m_openglAvailable(false)
     , m_firstFrameReceived(false)
@@ -2001,6 +2546,7 @@ void FFmpegPlayer::closeEvent(QCloseEvent *event)
     {
         QMutexLocker lock(&m_frameMutex);
         m_currentFrame = QImage();
+        m_currentYUV = YUVFrameData();
     }
 
 #if OPENGL_AVAILABLE
@@ -2010,9 +2556,9 @@ void FFmpegPlayer::closeEvent(QCloseEvent *event)
     }
 #endif
 
-    if (m_displayLabel_)
+    if (m_rasterSurface_)
     {
-        m_displayLabel_->clear();
+        m_rasterSurface_->clear();
     }
 
     event->accept();
@@ -2022,6 +2568,12 @@ void FFmpegPlayer::hideEvent(QHideEvent *event)
 {
     qDebug() << "FFmpegPlayer hideEvent";
     QWidget::hideEvent(event);
+
+    // 最小化、切换标签页等情况下画面不可见，停止视频解码与转换
+    if (m_decoder_ && !m_isClosing)
+    {
+        m_decoder_->setVideoVisible(false);
+    }
 }
 
 void FFmpegPlayer::showEvent(QShowEvent *event)
@@ -2029,6 +2581,11 @@ void FFmpegPlayer::showEvent(QShowEvent *event)
     qDebug() << "FFmpegPlayer showEvent";
     QWidget::showEvent(event);
 
+    if (m_decoder_)
+    {
+        m_decoder_->setVideoVisible(true);
+    }
+
     if (m_displayWidget_)
     {
         m_displayWidget_->show();
@@ -2050,23 +2607,28 @@ void FFmpegPlayer::initRenderWidget()
         // 使用OpenGL硬件加速渲染
         m_glWidget_ = new OpenGLVideoWidget(this);
         m_displayWidget_ = m_glWidget_;
-        m_displayLabel_ = nullptr;
+        // 上屏反馈交给解码线程，用于按vsync相位投递与统计显示延迟
+        connect(m_glWidget_, &OpenGLVideoWidget::framePresented, this, &FFmpegPlayer::onFramePresented);
+        // 性能浮层（F12）直接读取解码线程的无锁计数器
+        m_glWidget_->setPerfSourceCounters(m_decoder_->perfCounters());
+        m_rasterSurface_ = nullptr;
         m_displayWidget_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
         m_displayWidget_->setAttribute(Qt::WA_OpaquePaintEvent);
         m_displayWidget_->setAutoFillBackground(false);
+        // 可直接采样的YUV格式交给着色器转换，省去CPU上的sws_scale
+        m_decoder_->setYUVModeEnabled(true);
         qDebug() << "Using OpenGL renderer";
     }
     else
 #endif
     {
-        // 降级使用QLabel软件渲染
-        m_displayLabel_ = new QLabel(this);
-        m_displayLabel_->setAlignment(Qt::AlignCenter);
-        m_displayLabel_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
-        m_displayLabel_->setStyleSheet("background-color: black;");
-        m_displayLabel_->setAttribute(Qt::WA_OpaquePaintEvent);
-        m_displayWidget_ = m_displayLabel_;
-        qDebug() << "Using QLabel software renderer";
+        m_decoder_->setYUVModeEnabled(false);
+        m_decoder_->clearPresentFeedback();
+        // 降级使用软件渲染：直接绘制复用的缩放图像，不逐帧新建QPixmap
+        m_rasterSurface_ = new RasterVideoSurface(this);
+        m_rasterSurface_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+        m_displayWidget_ = m_rasterSurface_;
+        qDebug() << "Using raster software renderer";
     }
 
     m_displayWidget_->setGeometry(rect());
@@ -2100,6 +2662,11 @@ void FFmpegPlayer::setUseOpenGL(bool enabled)
 }
 
 void FFmpegPlayer::updateFrame(const QImage &image)
+{
+    presentFrame(image, -1);
+}
+
+void FFmpegPlayer::presentFrame(const QImage &image, qint64 ptsMs)
 {
     if (image.isNull())
     {
@@ -2116,6 +2683,7 @@ void FFmpegPlayer::updateFrame(const QImage &image)
     {
         QMutexLocker lock(&m_frameMutex);
         m_currentFrame = image;
+        m_currentPtsMs = ptsMs;
     }
 
     // 更新显示
@@ -2137,35 +2705,26 @@ void FFmpegPlayer::updateDisplay()
     // 优先使用OpenGL渲染
     if (m_useOpenGL && m_glWidget_ && m_glWidget_->isInitialized())
     {
-        m_glWidget_->updateFrame(m_currentFrame);
+        m_glWidget_->updateFrame(m_currentFrame, m_currentPtsMs);
         return;
     }
 #endif
 
-    // 降级使用QLabel软件渲染
-    if (m_displayLabel_)
+    // 降级使用软件渲染（隐式共享，不拷贝像素；缩放推迟到绘制时）
+    if (m_rasterSurface_)
     {
-        QPixmap pixmap = QPixmap::fromImage(m_currentFrame)
-                             .scaled(m_displayLabel_->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        m_displayLabel_->setPixmap(pixmap);
+        m_rasterSurface_->setFrame(m_currentFrame);
     }
 }
 
 void FFmpegPlayer::resizeEvent(QResizeEvent *event)
 {
+    // 显示组件随尺寸变化自行重新缩放，无需重新投递当前帧
     if (m_displayWidget_)
     {
         m_displayWidget_->setGeometry(rect());
     }
 
-#if OPENGL_AVAILABLE
-    // OpenGL模式下不需要手动调用updateDisplay，OpenGLWidget会自动处理
-    if (!(m_useOpenGL && m_glWidget_))
-#endif
-    {
-        updateDisplay();
-    }
-
     QWidget::resizeEvent(event);
 }
 
@@ -2205,6 +2764,7 @@ void FFmpegPlayer::stop()
     {
         QMutexLocker lock(&m_frameMutex);
         m_currentFrame = QImage();
+        m_currentYUV = YUVFrameData();
     }
 
     m_firstFrameReceived = false;
@@ -2216,9 +2776,9 @@ void FFmpegPlayer::stop()
     }
 #endif
 
-    if (m_displayLabel_)
+    if (m_rasterSurface_)
     {
-        m_displayLabel_->clear();
+        m_rasterSurface_->clear();
     }
 
     update();
@@ -2226,55 +2786,15 @@ void FFmpegPlayer::stop()
 
 void FFmpegPlayer::setupConnections()
 {
-    // ========== 连接RGB帧信号 ==========
-    connect(m_decoder_, &FFmpegDecoderThread::frameReady, this, [this](const QImage &image)
-            {
-                if (m_isClosing) return;
-                if (!m_firstFrameReceived) {
-                    m_firstFrameReceived = true;
-                    qDebug() << "First RGB frame received, size:" << image.size();
-                }
-                updateFrame(image); }, Qt::QueuedConnection);
-
-    // ========== 连接YUV帧信号 ==========
-    connect(m_decoder_, &FFmpegDecoderThread::frameReadyYUV, this, [this](const YUVFrameData &yuvData)
-            {
-                if (m_isClosing) return;
-                if (!yuvData.isValid()) {
-                    qWarning() << "Received invalid YUV frame";
-                    return;
-                }
-                if (!m_firstFrameReceived) {
-                    m_firstFrameReceived = true;
-                    qDebug() << "First YUV frame received, size:" 
-                             << yuvData.width << "x" << yuvData.height;
-                }
-
-#if OPENGL_AVAILABLE
-                // 优先使用OpenGL渲染YUV数据（性能最佳）
-                if (m_useOpenGL && m_glWidget_ && m_glWidget_->isInitialized()) {
-                    m_glWidget_->updateFrameYUV(
-                        reinterpret_cast<const uint8_t*>(yuvData.yData.constData()),
-                        reinterpret_cast<const uint8_t*>(yuvData.uData.constData()),
-                        reinterpret_cast<const uint8_t*>(yuvData.vData.constData()),
-                        yuvData.yLinesize, 
-                        yuvData.uLinesize, 
-                        yuvData.vLinesize,
-                        yuvData.width, 
-                        yuvData.height);
-                    return;
-                }
-#endif
-                // 如果没有OpenGL或OpenGL不可用，转换为RGB再显示
-                QImage rgbImage = FFmpegDecoderThread::convertYUVToImageStatic(yuvData);
-                if (!rgbImage.isNull()) {
-                    updateFrame(rgbImage);
-                } else {
-                    qWarning() << "Failed to convert YUV to RGB";
-                } }, Qt::QueuedConnection);
+    // ========== 连接帧信号 ==========
+    // 解码线程只在GUI取走上一帧后才通知，事件队列中最多一个在途通知
+    connect(m_decoder_, &FFmpegDecoderThread::frameAvailable, this, &FFmpegPlayer::onFrameAvailable, Qt::QueuedConnection);
 
     // ========== 连接位置和时长信号 ==========
-    connect(m_decoder_, &FFmpegDecoderThread::positionChanged, m_playerCore_, &PlayerWidgetBase::currentPosition, Qt::QueuedConnection);
+    // 播放位置按界面刷新频率轮询，不再逐帧投递信号
+    m_positionTimer_->setInterval(100);
+    connect(m_positionTimer_, &QTimer::timeout, this, &FFmpegPlayer::pollPosition);
+    m_positionTimer_->start();
     connect(m_decoder_, &FFmpegDecoderThread::durationChanged, m_playerCore_, &PlayerWidgetBase::currentDuration, Qt::QueuedConnection);
 
     // ========== 连接播放状态信号 ==========
@@ -2301,6 +2821,165 @@ void FFmpegPlayer::setupConnections()
     connect(m_playerCore_, &PlayerWidgetBase::setPlaybackRate, this, &FFmpegPlayer::setPlaybackRate, Qt::QueuedConnection);
 }
 
+void FFmpegPlayer::onFrameAvailable()
+{
+    // 必须先取帧再判断状态，否则信箱保持"未取走"状态将不再收到通知
+    DisplayFrame frame;
+    if (!m_decoder_ || !m_decoder_->takeLatestFrame(frame))
+        return;
+    if (m_isClosing || !frame.hasImage())
+        return;
+
+    if (frame.isYUV)
+        onFrameReadyYUV(frame.yuvData, frame.ptsMs);
+    else
+        onFrameReady(frame.image, frame.ptsMs);
+}
+
+void FFmpegPlayer::pollPosition()
+{
+    if (m_isClosing || !m_decoder_)
+        return;
+
+    qint64 pos = m_decoder_->currentPosition();
+    if (pos != m_lastPositionMs)
+    {
+        m_lastPositionMs = pos;
+        emit m_playerCore_->currentPosition(pos);
+    }
+}
+
+void FFmpegPlayer::onFramePresented(qint64 ptsMs, qint64 vsyncIntervalUs)
+{
+    if (m_isClosing || !m_decoder_)
+        return;
+    m_decoder_->reportFramePresented(ptsMs, vsyncIntervalUs);
+}
+
+void FFmpegPlayer::onFrameReady(const QImage &image, qint64 ptsMs)
+{
+    if (m_isClosing)
+        return;
+    if (!m_firstFrameReceived)
+    {
+        m_firstFrameReceived = true;
+        qDebug() << "First RGB frame received, size:" << image.size();
+    }
+    {
+        QMutexLocker lock(&m_frameMutex);
+        m_currentYUV = YUVFrameData();
+    }
+    presentFrame(image, ptsMs);
+    m_capturer_->onFrameDisplayed(image, ptsMs);
+}
+
+#if OPENGL_AVAILABLE
+OpenGLVideoWidget::YUVFormat toGLYUVFormat(AVPixelFormat pixelFormat, AVColorSpace colorSpace, AVColorRange colorRange)
+{
+    OpenGLVideoWidget::YUVFormat format;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(pixelFormat);
+    if (!desc)
+        return format;
+
+    if (av_pix_fmt_count_planes(pixelFormat) == 2)
+        format.layout = (pixelFormat == AV_PIX_FMT_NV21) ? OpenGLVideoWidget::LAYOUT_NV21
+                                                                  : OpenGLVideoWidget::LAYOUT_NV12;
+    else if (desc->log2_chroma_w == 0)
+        format.layout = OpenGLVideoWidget::LAYOUT_YUV444P;
+    else if (desc->log2_chroma_h == 0)
+        format.layout = OpenGLVideoWidget::LAYOUT_YUV422P;
+    else
+        format.layout = OpenGLVideoWidget::LAYOUT_YUV420P;
+
+    // P010等格式有效位位于16位样本高位（shift > 0）
+    format.bitDepth = desc->comp[0].depth;
+    format.msbAligned = desc->comp[0].shift > 0;
+
+    switch (colorSpace)
+    {
+    case AVCOL_SPC_BT709:
+        format.hasColorSpace = true;
+        format.colorSpace = OpenGLVideoWidget::COLOR_BT709;
+        break;
+    case AVCOL_SPC_BT470BG:
+    case AVCOL_SPC_SMPTE170M:
+    case AVCOL_SPC_FCC:
+        format.hasColorSpace = true;
+        format.colorSpace = OpenGLVideoWidget::COLOR_BT601;
+        break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+        format.hasColorSpace = true;
+        format.colorSpace = OpenGLVideoWidget::COLOR_BT2020;
+        break;
+    default:
+        break;      // 未指定，由渲染组件按设置或分辨率选择
+    }
+
+    // YUVJ格式默认全范围
+    bool jpegFormat = pixelFormat == AV_PIX_FMT_YUVJ420P ||
+                      pixelFormat == AV_PIX_FMT_YUVJ422P ||
+                      pixelFormat == AV_PIX_FMT_YUVJ444P;
+    format.range = (colorRange == AVCOL_RANGE_JPEG || jpegFormat)
+        ? OpenGLVideoWidget::RANGE_FULL : OpenGLVideoWidget::RANGE_LIMITED;
+
+    return format;
+}
+#endif
+
+void FFmpegPlayer::onFrameReadyYUV(const YUVFrameData &yuvData, qint64 ptsMs)
+{
+    if (m_isClosing)
+        return;
+    if (!yuvData.isValid())
+    {
+        qWarning() << "Received invalid YUV frame";
+        return;
+    }
+    if (!m_firstFrameReceived)
+    {
+        m_firstFrameReceived = true;
+        qDebug() << "First YUV frame received, size:"
+                 << yuvData.width << "x" << yuvData.height;
+    }
+
+#if OPENGL_AVAILABLE
+    // 优先使用OpenGL渲染YUV数据（性能最佳）
+    if (m_useOpenGL && m_glWidget_ && m_glWidget_->isInitialized())
+    {
+        const uint8_t *planes[3] = {
+            reinterpret_cast<const uint8_t*>(yuvData.yData.constData()),
+            reinterpret_cast<const uint8_t*>(yuvData.uData.constData()),
+            reinterpret_cast<const uint8_t*>(yuvData.vData.constData())};
+        const int linesizes[3] = {yuvData.yLinesize, yuvData.uLinesize, yuvData.vLinesize};
+        m_glWidget_->updateFrameYUV(planes, linesizes, yuvData.width, yuvData.height,
+                                    toGLYUVFormat(yuvData.pixelFormat, yuvData.colorSpace, yuvData.colorRange),
+                                    ptsMs);
+
+        // 保留当前显示的YUV帧（隐式共享），截图时在编码线程中再转换为RGB
+        {
+            QMutexLocker lock(&m_frameMutex);
+            m_currentYUV = yuvData;
+        }
+        m_capturer_->onFrameDisplayed([yuvData]() {
+            return FFmpegDecoderThread::convertYUVToImageStatic(yuvData);
+        }, ptsMs);
+        return;
+    }
+#endif
+    // 如果没有OpenGL或OpenGL不可用，转换为RGB再显示
+    QImage rgbImage = FFmpegDecoderThread::convertYUVToImageStatic(yuvData);
+    if (!rgbImage.isNull())
+    {
+        presentFrame(rgbImage, ptsMs);
+        m_capturer_->onFrameDisplayed(rgbImage, ptsMs);
+    }
+    else
+    {
+        qWarning() << "Failed to convert YUV to RGB";
+    }
+}
+
 void FFmpegPlayer::play(const QString &url)
 {
     if (m_isClosing)
@@ -2323,6 +3002,7 @@ void FFmpegPlayer::play(const QString &url)
     {
         QMutexLocker lock(&m_frameMutex);
         m_currentFrame = QImage();
+        m_currentYUV = YUVFrameData();
     }
 
 #if OPENGL_AVAILABLE
@@ -2360,47 +3040,8 @@ void FFmpegPlayer::play(const QString &url)
     if (m_decoder_ && m_decoder_->isRunning())
     {
         qDebug() << "Stopping previous playback before starting new one...";
-        // 断开信号连接，避免旧播放的信号干扰
-        disconnect(m_decoder_, &FFmpegDecoderThread::frameReady, this, nullptr);
-        disconnect(m_decoder_, &FFmpegDecoderThread::frameReadyYUV, this, nullptr);
-
-        // 关闭解码器并等待线程退出
+        // 关闭解码器并等待线程退出（openMedia会清空显示信箱，旧播放的残留帧不会再被显示）
         m_decoder_->close(true);
-
-        // 重新连接信号
-        connect(m_decoder_, &FFmpegDecoderThread::frameReady, this, [this](const QImage &image)
-                {
-                    if (m_isClosing) return;
-                    if (!m_firstFrameReceived) {
-                        m_firstFrameReceived = true;
-                        qDebug() << "First RGB frame received, size:" << image.size();
-                    }
-                    updateFrame(image); }, Qt::QueuedConnection);
-
-        connect(m_decoder_, &FFmpegDecoderThread::frameReadyYUV, this, [this](const YUVFrameData &yuvData)
-                {
-                    if (m_isClosing) return;
-                    if (!yuvData.isValid()) return;
-                    if (!m_firstFrameReceived) {
-                        m_firstFrameReceived = true;
-                        qDebug() << "First YUV frame received, size:" 
-                                 << yuvData.width << "x" << yuvData.height;
-                    }
-#if OPENGL_AVAILABLE
-                    if (m_useOpenGL && m_glWidget_ && m_glWidget_->isInitialized()) {
-                        m_glWidget_->updateFrameYUV(
-                            reinterpret_cast<const uint8_t*>(yuvData.yData.constData()),
-                            reinterpret_cast<const uint8_t*>(yuvData.uData.constData()),
-                            reinterpret_cast<const uint8_t*>(yuvData.vData.constData()),
-                            yuvData.yLinesize, yuvData.uLinesize, yuvData.vLinesize,
-                            yuvData.width, yuvData.height);
-                        return;
-                    }
-#endif
-                    QImage rgbImage = FFmpegDecoderThread::convertYUVToImageStatic(yuvData);
-                    if (!rgbImage.isNull()) {
-                        updateFrame(rgbImage);
-                    } }, Qt::QueuedConnection);
     }
 
     // 打开新媒体
@@ -2433,7 +3074,22 @@ void FFmpegPlayer::setMemoryLimit(int limitMB)
 }
 bool FFmpegPlayer::takeScreenshot(const QString &filePath)
 {
-    return m_decoder_ ? m_decoder_->takeScreenshot(filePath) : false;
+    // 截取屏幕上正在显示的帧，编码在线程池中完成，结果通过FrameCapturer::captureSaved通知
+    // 收到RGB帧时会清空m_currentYUV，因此YUV有效即表示当前显示的是YUV帧
+    QMutexLocker lock(&m_frameMutex);
+    if (m_currentYUV.isValid())
+    {
+        YUVFrameData yuvData = m_currentYUV;
+        return m_capturer_->capture([yuvData]() {
+            return FFmpegDecoderThread::convertYUVToImageStatic(yuvData);
+        }, filePath);
+    }
+
+    if (!m_currentFrame.isNull())
+        return m_capturer_->capture(m_currentFrame, filePath);
+
+    qWarning() << "FFmpegPlayer::takeScreenshot - no frame on screen";
+    return false;
 }
 FFmpegDecoderThread::Statistics FFmpegPlayer::getStatistics() const
 {
@@ -2449,6 +3105,18 @@ float FFmpegPlayer::playbackRate() const
     return m_decoder_ ? m_decoder_->playbackRate() : 1.0f;
 }
 
+void FFmpegPlayer::setSyncMode(AVSyncManager::SyncMode mode)
+{
+    if (m_decoder_)
+        m_decoder_->setSyncMode(mode);
+}
+
+void FFmpegPlayer::setExternalClock(std::shared_ptr<SyncClock> clock)
+{
+    if (m_decoder_)
+        m_decoder_->setExternalClock(std::move(clock));
+}
+
 void FFmpegPlayer::onBufferStatusChanged(int usagePercent, int droppedFrames)
 {
     if (droppedFrames > 0)
@@ -1,6 +1,6 @@
 /*****************************************************************
 File:        ffmpeg_player_widget.h
-Version:     2.1
+Version:     2.2
 Author:
 start date:
 Description: 基于FFmpeg库实现的多线程音视频播放器组件（通用跨平台）
@@ -8,25 +8,36 @@ Description: 基于FFmpeg库实现的多线程音视频播放器组件（通用
         1. 支持本地文件（MP4/AVI/MKV等）和网络流（RTSP/HTTP）播放
         2. 完整的播放控制：播放、暂停、停止、跳转、音量调节、静音
         3. 支持倍速/慢速播放（0.5x ~ 2.0x）
-        4. 基于音频主时钟的精确音视频同步机制
+        4. 音频主时钟/视频主时钟/外部时钟三种同步模式，外部时钟可在多个播放器间共享
         5. 可选帧缓冲队列，支持智能丢帧与缓冲区动态调整
-        6. 网络流自动重连（可配置重试次数与退避延迟）
+        6. 网络流快速重连（仅重开输入，参数不变时沿用解码器与音频设备，抖动退避）
         7. 音频设备自适应容错（自动匹配采样率）
         8. 实时性能统计（帧率、丢帧数、码率、音频欠载）
-        9. 截图保存功能
+        9. 截图/连拍/定时截图，截取屏幕上显示的帧并在线程池中异步编码
         10. 支持OpenGL硬件加速渲染（通过OPENGL_ENABLE宏控制）
     技术特性：
         1. 解码线程与UI线程分离，避免界面卡顿
         2. 支持Qt5/Qt6双版本编译
-        3. 音视频时钟同步算法（差值阈值：-50ms~100ms）
+        3. 音频时钟取自设备播放位置（processedUSecs - 排队数据），丢帧阈值随帧时长自适应
         4. 环形帧缓冲队列，线程安全
         5. 音频非阻塞写入，缓冲状态信号通知
+        6. 无锁（seqlock）同步时钟，非音频主时钟模式下通过重采样补偿音频漂移
+        7. 解码线程经无锁三缓冲信箱向GUI交付最新帧，旧帧直接覆盖不排队；播放位置按界面频率轮询
+        8. 画面隐藏/最小化时仅解码关键帧或丢弃视频包，不做格式转换，音频不受影响
+        9. 单路解码可经引用计数帧分发给多个渲染端点（VideoFrameSink），各端点独立缩放转换
+        10. 时间源可替换为虚拟时钟并注入卡顿/解码耗时/欠载，用于快于实时地测试音画同步
+        11. OpenGL渲染时NV12/P010/YUV422P/YUV444P及10/12位格式直接交给着色器转换，按帧色彩元数据选择矩阵
+        12. 渲染组件上屏后回报时间戳，解码线程据此对齐vsync相位投递并统计显示延迟与节奏抖动
+        13. 无OpenGL时由RasterVideoSurface在paintEvent中绘制复用的缩放图像，新帧只重绘画面区域
 
 Version history
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
 1             2026-4-08      cjx            create
 2             2026-4-10      cjx            添加OpenGL硬件加速支持
 3             2026-4-13      cjx            优化视频定位播放精度
+4             2026-10-19     cjx            新增视频主时钟/外部时钟同步模式与音频漂移补偿
+5             2026-10-19     cjx            重连退避与暂停等待改走时间源，虚拟音频设备按输出格式消耗数据
+6             2026-10-19     cjx            上屏反馈改读倍速/帧间隔快照，消除与解码线程的数据竞争
 
 *****************************************************************/
 
@@ -45,9 +56,15 @@ Version history
 #include <QSemaphore>
 #include <QThread>
 #include <QTimer>
+#include <QVector>
 #include <QWaitCondition>
 #include <QWidget>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
 #if QT_VERSION_MAJOR < 6
 #include <QAudioOutput>
 #include <QAudioDeviceInfo>
@@ -64,12 +81,19 @@ extern "C"
 #include <libavutil/channel_layout.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 #include <libswresample/swresample.h>
 #include <libswscale/swscale.h>
 #include <libavutil/time.h>
 }
 
 #include "base_player_widget.h"
+#include "frame_capturer.h"
+#include "frame_mailbox.h"
+#include "media_clock.h"
+#include "raster_video_surface.h"
+#include "video_frame_sink.h"
+#include "view/widget/opengl/perf_hud.h"
 
 // ==================== OpenGL支持检测 ====================
 // 通过OPENGL_ENABLE宏控制是否启用OpenGL硬件加速渲染
@@ -80,7 +104,168 @@ extern "C"
     #define OPENGL_AVAILABLE 0
 #endif
 
+// ==================== 无锁同步时钟 ====================
+/**
+ * @brief 基于seqlock的无锁时钟（微秒）
+ *
+ * 时钟值 = pts + (now - updated) * speed，暂停时冻结在pts。
+ * 读操作不加锁，遇到写入中的序号时重试；写操作之间通过序号CAS串行，
+ * 因此可以被多个播放器共享作为外部时钟，而不会在音频/解码线程间产生锁竞争。
+ */
+class SyncClock
+{
+public:
+    SyncClock() = default;
+    SyncClock(const SyncClock &) = delete;
+    SyncClock &operator=(const SyncClock &) = delete;
+
+    /** 以当前时间为基准设置时钟 */
+    void set(qint64 pts, qint64 now = av_gettime_relative())
+    {
+        modify([pts, now](State &s) {
+            s.pts = pts;
+            s.updated = now;
+            s.valid = true;
+        });
+    }
+
+    /** 仅在时钟无效时设置（多个播放器共享时由先到者建立基准） */
+    void setIfInvalid(qint64 pts, qint64 now = av_gettime_relative())
+    {
+        modify([pts, now](State &s) {
+            if (s.valid)
+                return;
+            s.pts = pts;
+            s.updated = now;
+            s.valid = true;
+        });
+    }
+
+    /** 获取时钟当前值，无效时返回0 */
+    qint64 get(qint64 now = av_gettime_relative()) const
+    {
+        return valueAt(load(), now);
+    }
+
+    /** 暂停/恢复：暂停时冻结时钟值，恢复时从冻结值继续走 */
+    void setPaused(bool paused, qint64 now = av_gettime_relative())
+    {
+        modify([paused, now](State &s) {
+            if (s.paused == paused)
+                return;
+            s.pts = valueAt(s, now);
+            s.updated = now;
+            s.paused = paused;
+        });
+    }
+
+    /** 设置走时速度（倍速播放），先按旧速度结算到当前时刻 */
+    void setSpeed(double speed, qint64 now = av_gettime_relative())
+    {
+        modify([speed, now](State &s) {
+            s.pts = valueAt(s, now);
+            s.updated = now;
+            s.speed = speed;
+        });
+    }
+
+    /** 使时钟失效（seek、重新打开时调用） */
+    void invalidate()
+    {
+        modify([](State &s) { s.valid = false; });
+    }
+
+    bool isValid() const { return load().valid; }
+    bool isPaused() const { return load().paused; }
+    double speed() const { return load().speed; }
+
+private:
+    struct State
+    {
+        qint64 pts = 0;
+        qint64 updated = 0;
+        double speed = 1.0;
+        bool paused = false;
+        bool valid = false;
+    };
+
+    static qint64 valueAt(const State &s, qint64 now)
+    {
+        if (!s.valid)
+            return 0;
+        if (s.paused)
+            return s.pts;
+        return s.pts + static_cast<qint64>((now - s.updated) * s.speed);
+    }
+
+    State load() const
+    {
+        State s;
+        quint32 begin, end;
+        do
+        {
+            begin = m_seq.load(std::memory_order_acquire);
+            s.pts = m_pts.load(std::memory_order_relaxed);
+            s.updated = m_updated.load(std::memory_order_relaxed);
+            s.speed = m_speed.load(std::memory_order_relaxed);
+            s.paused = m_paused.load(std::memory_order_relaxed);
+            s.valid = m_valid.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            end = m_seq.load(std::memory_order_relaxed);
+        } while ((begin & 1u) || begin != end);
+        return s;
+    }
+
+    template <typename Func>
+    void modify(Func func)
+    {
+        // 只能从偶数（空闲）序号进入写状态，其他写者持有时自旋
+        quint32 seq = m_seq.load(std::memory_order_relaxed);
+        do
+        {
+            seq &= ~1u;
+        } while (!m_seq.compare_exchange_weak(seq, seq + 1,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        State s;
+        s.pts = m_pts.load(std::memory_order_relaxed);
+        s.updated = m_updated.load(std::memory_order_relaxed);
+        s.speed = m_speed.load(std::memory_order_relaxed);
+        s.paused = m_paused.load(std::memory_order_relaxed);
+        s.valid = m_valid.load(std::memory_order_relaxed);
+
+        func(s);
+
+        m_pts.store(s.pts, std::memory_order_relaxed);
+        m_updated.store(s.updated, std::memory_order_relaxed);
+        m_speed.store(s.speed, std::memory_order_relaxed);
+        m_paused.store(s.paused, std::memory_order_relaxed);
+        m_valid.store(s.valid, std::memory_order_relaxed);
+
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    std::atomic<quint32> m_seq{0};
+    std::atomic<qint64> m_pts{0};
+    std::atomic<qint64> m_updated{0};
+    std::atomic<double> m_speed{1.0};
+    std::atomic<bool> m_paused{false};
+    std::atomic<bool> m_valid{false};
+};
+
 // ==================== 音视频同步管理器 ====================
+/**
+ * @brief 音视频同步管理器
+ *
+ * 三种主时钟模式：
+ *   - SYNC_AUDIO_MASTER：视频追随音频时钟（无音频时退化为帧间隔控制）
+ *   - SYNC_VIDEO_MASTER：视频按自身PTS自由走时，音频通过重采样补偿追随视频
+ *   - SYNC_EXTERNAL_CLOCK：音视频均追随外部时钟，外部时钟可在多个播放器间共享实现同步播放
+ *
+ * 所有时钟均为无锁SyncClock，音频线程与解码线程间不存在锁竞争。
+ */
 class AVSyncManager
 {
 public:
@@ -91,40 +276,50 @@ public:
         SYNC_EXTERNAL_CLOCK  // 外部时钟
     };
 
-    AVSyncManager() { reset(); }
+    AVSyncManager()
+        : m_clock(MediaClock::systemClock())
+        , m_externalClock(std::make_shared<SyncClock>())
+    {
+        reset();
+    }
+
+    /**
+     * 设置时间源（须在播放开始前设置，传入nullptr恢复为系统时钟）
+     * 共享外部时钟的多个播放器必须使用同一时间源
+     */
+    void setMediaClock(std::shared_ptr<MediaClock> clock)
+    {
+        m_clock = clock ? std::move(clock) : MediaClock::systemClock();
+    }
+
+    /** 当前时间源的时间（微秒） */
+    qint64 currentTime() const { return m_clock->nowUs(); }
 
-    /** 更新音频时钟 */
-    void updateAudioClock(qint64 pts)
+    /**
+     * @brief 按设备播放位置更新音频时钟
+     * @param heardPts 设备当前正在播放的采样对应的PTS（已写入数据末尾PTS - 设备排队时长）
+     * @param endPts 已写入设备的数据末尾PTS，欠载时音频时钟不会越过该值
+     */
+    void updateAudioClock(qint64 heardPts, qint64 endPts)
     {
-        QMutexLocker lock(&m_mutex);
-        m_audioClock = pts;
-        m_audioClockTime = av_gettime_relative();
-        m_audioClockValid = true;
+        m_audioEndPts.store(endPts, std::memory_order_relaxed);
+        m_audioClock.set(heardPts, currentTime());
     }
 
-    /** 更新视频时钟 */
+    /** 更新视频时钟（视频帧实际显示时调用） */
     void updateVideoClock(qint64 pts)
     {
-        QMutexLocker lock(&m_mutex);
-        m_videoClock = pts;
+        m_videoClock.set(pts, currentTime());
     }
 
     /** 获取当前主时钟值（微秒） */
     qint64 getCurrentClock() const
     {
-        QMutexLocker lock(&m_mutex);
-
-        if (m_syncMode == SYNC_AUDIO_MASTER && m_audioClockValid)
-        {
-            // 音频时钟 = 上次PTS + 经过的时间
-            qint64 elapsed = av_gettime_relative() - m_audioClockTime;
-            return m_audioClock + elapsed;
-        }
-
-        // 视频主时钟模式
-        if (m_videoClock > 0)
-            return m_videoClock;
-        return 0;
+        const SyncClock *master = masterClock();
+        if (!master)
+            return 0;
+        const qint64 t = currentTime();
+        return master == &m_audioClock ? audioClockAt(t) : master->get(t);
     }
 
     /**
@@ -136,110 +331,337 @@ public:
      */
     qint64 calculateWaitTime(qint64 videoPts, qint64 frameDuration, float playbackRate = 1.0f)
     {
-        QMutexLocker lock(&m_mutex);
+        const qint64 now = currentTime();
+        const qint64 wait = rawWaitTime(now, videoPts, frameDuration, playbackRate);
+        return wait < 0 ? wait : alignToVsync(now, wait);
+    }
 
-        // 根据倍速调整帧持续时间
-        qint64 adjustedDuration = static_cast<qint64>(frameDuration / playbackRate);
+    /**
+     * 记录一次实际上屏（GUI线程在frameSwapped后调用）
+     * @param presentTime 上屏时刻（当前时间源，微秒）
+     * @param vsyncIntervalUs 显示器垂直同步间隔（微秒），0表示未知
+     * @param pipelineUs 该帧从投递到上屏的耗时（微秒），0表示未知
+     */
+    void updatePresentTiming(qint64 presentTime, qint64 vsyncIntervalUs, qint64 pipelineUs)
+    {
+        m_vsyncIntervalUs.store(vsyncIntervalUs, std::memory_order_relaxed);
+        m_lastVsyncTime.store(presentTime, std::memory_order_relaxed);
+
+        // 管线耗时取近期下限：变小立即跟随，变大缓慢上调（偶发的慢帧不拉长提前量）
+        if (pipelineUs <= 0)
+            return;
+        qint64 pipeline = m_presentPipelineUs.load(std::memory_order_relaxed);
+        if (pipeline <= 0 || pipelineUs < pipeline)
+            pipeline = pipelineUs;
+        else
+            pipeline += (pipelineUs - pipeline) / 32;
+        m_presentPipelineUs.store(pipeline, std::memory_order_relaxed);
+    }
 
-        if (!m_audioClockValid)
-        {
-            if (m_lastFrameTime > 0)
-            {
-                qint64 elapsed = av_gettime_relative() - m_lastFrameTime;
-                if (elapsed < adjustedDuration)
-                    return adjustedDuration - elapsed;
-            }
-            return 0;
-        }
+    /** 清除上屏时序（切换渲染组件或停止显示时调用，恢复为不对齐vsync） */
+    void clearPresentTiming()
+    {
+        m_vsyncIntervalUs.store(0, std::memory_order_relaxed);
+        m_lastVsyncTime.store(0, std::memory_order_relaxed);
+        m_presentPipelineUs.store(0, std::memory_order_relaxed);
+    }
 
-        // 获取当前主时钟值
-        qint64 elapsed = av_gettime_relative() - m_audioClockTime;
-        qint64 currentClock = m_audioClock + elapsed;
+    /**
+     * 音频漂移补偿（参考ffplay synchronize_audio）
+     * 非音频主时钟模式下，根据音频时钟与主时钟的平均差值计算期望输出采样数，
+     * 调用方通过swr_set_compensation平滑拉伸/压缩音频，单次修正不超过±10%
+     * @param nbSamples 本帧原始采样数
+     * @param sampleRate 输出采样率
+     * @return 期望的采样数，等于nbSamples表示无需补偿
+     */
+    int synchronizeAudio(int nbSamples, int sampleRate)
+    {
+        if (syncMode() == SYNC_AUDIO_MASTER || nbSamples <= 0 || sampleRate <= 0)
+            return nbSamples;
 
-        // 倍速播放时，需要调整PTS比较：视频PTS按倍速缩放后与音频时钟比较
-        // 实际上视频PTS本身不变，但音频时钟的推进速度已经受倍速影响（通过重采样）
-        // 这里直接比较原始值，因为音频时钟的更新频率已经受倍速影响
-        qint64 diff = videoPts - currentClock;
+        const SyncClock *master = masterClock();
+        if (!master || !master->isValid() || !m_audioClock.isValid())
+            return nbSamples;
 
-        const qint64 MAX_DIFF = 100000;      // 最大差值100ms
-        const qint64 MIN_DIFF = -50000;      // 最小差值-50ms
-        const qint64 SYNC_THRESHOLD = 10000; // 10ms内视为同步
+        const qint64 now = currentTime();
+        const double diff = (audioClockAt(now) - master->get(now)) / 1000000.0;
 
-        if (diff > MAX_DIFF)
+        if (std::fabs(diff) >= AV_NOSYNC_THRESHOLD / 1000000.0)
         {
-            // 视频超前太多，限制最大等待时间
-            return MAX_DIFF;
+            // 差距过大（seek/跳变），不做补偿，重新累计
+            m_audioDiffCum = 0.0;
+            m_audioDiffAvgCount = 0;
+            return nbSamples;
         }
 
-        if (diff < MIN_DIFF)
+        m_audioDiffCum = diff + AUDIO_DIFF_AVG_COEF * m_audioDiffCum;
+        if (m_audioDiffAvgCount < AUDIO_DIFF_AVG_NB)
         {
-            // 视频落后太多，丢弃这一帧
-            return -1;
+            // 样本不足，暂不补偿
+            ++m_audioDiffAvgCount;
+            return nbSamples;
         }
 
-        if (diff > SYNC_THRESHOLD)
-        {
-            // 视频超前，需要等待
-            return diff;
-        }
+        const double avgDiff = m_audioDiffCum * (1.0 - AUDIO_DIFF_AVG_COEF);
+        if (std::fabs(avgDiff) < AUDIO_DIFF_THRESHOLD)
+            return nbSamples;
 
-        // 在同步范围内，立即显示
-        return 0;
+        int wanted = nbSamples + static_cast<int>(diff * sampleRate);
+        int minSamples = nbSamples * (100 - SAMPLE_CORRECTION_PERCENT_MAX) / 100;
+        int maxSamples = nbSamples * (100 + SAMPLE_CORRECTION_PERCENT_MAX) / 100;
+        return qBound(minSamples, wanted, maxSamples);
     }
 
     /** 设置同步模式 */
     void setSyncMode(SyncMode mode)
     {
-        QMutexLocker lock(&m_mutex);
-        m_syncMode = mode;
+        m_syncMode.store(mode, std::memory_order_relaxed);
+    }
+
+    /** 获取同步模式 */
+    SyncMode syncMode() const
+    {
+        return static_cast<SyncMode>(m_syncMode.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * 设置外部时钟（传入nullptr恢复为私有时钟）
+     * 多个播放器传入同一个时钟即可同步播放，须在播放开始前设置
+     */
+    void setExternalClock(std::shared_ptr<SyncClock> clock)
+    {
+        m_externalShared = (clock != nullptr);
+        m_externalClock = clock ? std::move(clock) : std::make_shared<SyncClock>();
+    }
+
+    /** 获取外部时钟 */
+    std::shared_ptr<SyncClock> externalClock() const { return m_externalClock; }
+
+    /** 暂停/恢复所有时钟 */
+    void setPaused(bool paused)
+    {
+        const qint64 now = currentTime();
+        m_audioClock.setPaused(paused, now);
+        m_videoClock.setPaused(paused, now);
+        m_externalClock->setPaused(paused, now);
+    }
+
+    /**
+     * 设置视频/外部时钟的走时速度（倍速播放）
+     * 音频时钟由设备播放位置持续重建基准，按设备实际消耗速度走时，不受此影响
+     */
+    void setSpeed(double speed)
+    {
+        const qint64 now = currentTime();
+        m_videoClock.setSpeed(speed, now);
+        m_externalClock->setSpeed(speed, now);
     }
 
     /** 重置所有时钟 */
     void reset()
     {
-        QMutexLocker lock(&m_mutex);
-        m_audioClock = 0;
-        m_videoClock = 0;
-        m_audioClockTime = 0;
-        m_audioClockValid = false;
-        m_lastFrameTime = 0;
+        m_audioClock.invalidate();
+        m_videoClock.invalidate();
+        // 共享的外部时钟由所有者负责重置
+        if (!m_externalShared)
+            m_externalClock->invalidate();
+        m_lastFrameTime.store(0, std::memory_order_relaxed);
+        m_audioEndPts.store(0, std::memory_order_relaxed);
+        m_audioDiffCum = 0.0;
+        m_audioDiffAvgCount = 0;
     }
 
     /** 记录帧已显示 */
-    void frameDisplayed()
+    void frameDisplayed(qint64 pts = AV_NOPTS_VALUE)
     {
-        QMutexLocker lock(&m_mutex);
-        m_lastFrameTime = av_gettime_relative();
+        const qint64 t = currentTime();
+        m_lastFrameTime.store(t, std::memory_order_relaxed);
+        // 视频主时钟由calculateWaitTime维护，这里只记录非主时钟模式下的视频时钟
+        if (pts != AV_NOPTS_VALUE && syncMode() != SYNC_VIDEO_MASTER)
+            m_videoClock.set(pts, t);
     }
 
     /** 检查音频时钟是否有效 */
     bool isAudioClockValid() const
     {
-        QMutexLocker lock(&m_mutex);
-        return m_audioClockValid;
+        return m_audioClock.isValid();
+    }
+
+    /** 当前模式下的主时钟是否已建立 */
+    bool hasMasterClock() const
+    {
+        const SyncClock *master = masterClock();
+        return master && master->isValid();
     }
 
 private:
-    mutable QMutex m_mutex;
-    SyncMode m_syncMode = SYNC_AUDIO_MASTER;
+    /** 按当前同步模式计算的等待时间（未对齐vsync） */
+    qint64 rawWaitTime(qint64 now, qint64 videoPts, qint64 frameDuration, float playbackRate)
+    {
+        const double rate = playbackRate > 0.0f ? playbackRate : 1.0;
 
-    // 音频时钟
-    qint64 m_audioClock = 0;
-    qint64 m_audioClockTime = 0;
-    bool m_audioClockValid = false;
+        // 根据倍速调整帧持续时间
+        const qint64 adjustedDuration = static_cast<qint64>(frameDuration / rate);
 
-    // 视频时钟
-    qint64 m_videoClock = 0;
+        switch (syncMode())
+        {
+        case SYNC_VIDEO_MASTER:
+        {
+            // 视频时钟自由走时：首帧建立基准，之后按PTS差等待，从不丢帧
+            if (!m_videoClock.isValid())
+            {
+                m_videoClock.setSpeed(rate, now);
+                m_videoClock.set(videoPts, now);
+                return 0;
+            }
+
+            qint64 wait = static_cast<qint64>((videoPts - m_videoClock.get(now)) / rate);
+            if (wait < -3 * syncThreshold(adjustedDuration) || wait > AV_NOSYNC_THRESHOLD)
+            {
+                // 解码跟不上或PTS跳变，重建基准
+                m_videoClock.set(videoPts, now);
+                return 0;
+            }
+            return qMax<qint64>(0, wait);
+        }
+
+        case SYNC_EXTERNAL_CLOCK:
+        {
+            // 先到的播放器为共享时钟建立基准
+            std::shared_ptr<SyncClock> ext = m_externalClock;
+            ext->setIfInvalid(videoPts, now);
+
+            double extSpeed = ext->speed() > 0.0 ? ext->speed() : 1.0;
+            qint64 diff = static_cast<qint64>((videoPts - ext->get(now)) / extSpeed);
+            return waitForDiff(diff, adjustedDuration);
+        }
+
+        case SYNC_AUDIO_MASTER:
+        default:
+            break;
+        }
+
+        if (!m_audioClock.isValid())
+        {
+            qint64 lastFrameTime = m_lastFrameTime.load(std::memory_order_relaxed);
+            if (lastFrameTime > 0)
+            {
+                qint64 elapsed = now - lastFrameTime;
+                if (elapsed < adjustedDuration)
+                    return adjustedDuration - elapsed;
+            }
+            return 0;
+        }
+
+        // 音频时钟表示设备正在播放的位置，比较媒体时间后按倍速换算为等待时长
+        qint64 diff = static_cast<qint64>((videoPts - audioClockAt(now)) / rate);
+        return waitForDiff(diff, adjustedDuration);
+    }
+
+    /**
+     * 把等待时间对齐到显示器的垂直同步
+     * 以最近一次上屏时刻为相位推算vsync序列，选出离理想显示时刻最近的一次vsync，
+     * 再按实测的投递到上屏耗时提前投递，使帧恰好赶上该vsync；
+     * 50fps内容在60Hz显示器上由此得到稳定的1/1/1/1/2节奏，而不是随解码抖动随机落在相邻vsync
+     */
+    qint64 alignToVsync(qint64 now, qint64 wait) const
+    {
+        const qint64 interval = m_vsyncIntervalUs.load(std::memory_order_relaxed);
+        const qint64 lastVsync = m_lastVsyncTime.load(std::memory_order_relaxed);
+        if (interval <= 0 || lastVsync <= 0)
+            return wait;
+
+        // 长时间没有上屏（暂停、隐藏、seek）时相位已不可信
+        const qint64 ideal = now + wait;
+        if (ideal <= lastVsync || now - lastVsync > VSYNC_PHASE_VALID_US)
+            return wait;
+
+        const qint64 target = lastVsync + (ideal - lastVsync + interval / 2) / interval * interval;
+        qint64 lead = m_presentPipelineUs.load(std::memory_order_relaxed);
+        lead = (lead > 0) ? qBound(interval / 4, lead + interval / 8, 4 * interval) : interval / 2;
+        return qMax<qint64>(0, target - lead - now);
+    }
+
+    /** 音频时钟当前值，欠载时停在已写入数据末尾 */
+    qint64 audioClockAt(qint64 now) const
+    {
+        return qMin(m_audioClock.get(now), m_audioEndPts.load(std::memory_order_relaxed));
+    }
+
+    /** 同步阈值：一帧时长，限制在[10ms, 100ms] */
+    static qint64 syncThreshold(qint64 frameDuration)
+    {
+        return qBound<qint64>(AV_SYNC_THRESHOLD_MIN, frameDuration, AV_SYNC_THRESHOLD_MAX);
+    }
+
+    /**
+     * 根据视频帧与主时钟的差值（墙上时间）计算等待时间
+     * 超前则精确等待差值（由调用方按帧时长封顶），落后超过一帧阈值则丢弃
+     */
+    static qint64 waitForDiff(qint64 diff, qint64 frameDuration)
+    {
+        if (diff > AV_NOSYNC_THRESHOLD)
+            return frameDuration; // PTS跳变，按帧间隔推进，等待主时钟重建
+        if (diff < -syncThreshold(frameDuration))
+            return -1;
+        return qMax<qint64>(0, diff);
+    }
+
+    const SyncClock *masterClock() const
+    {
+        switch (syncMode())
+        {
+        case SYNC_VIDEO_MASTER:
+            return &m_videoClock;
+        case SYNC_EXTERNAL_CLOCK:
+            return m_externalClock.get();
+        case SYNC_AUDIO_MASTER:
+        default:
+            if (m_audioClock.isValid())
+                return &m_audioClock;
+            return m_videoClock.isValid() ? &m_videoClock : nullptr;
+        }
+    }
+
+    static constexpr qint64 AV_NOSYNC_THRESHOLD = 10000000;  // 超过10s视为跳变，不做同步
+    static constexpr qint64 VSYNC_PHASE_VALID_US = 2000000;  // 上屏相位的有效期
+    static constexpr qint64 AV_SYNC_THRESHOLD_MIN = 10000;   // 丢帧阈值下限10ms
+    static constexpr qint64 AV_SYNC_THRESHOLD_MAX = 100000;  // 丢帧阈值上限100ms
+    static constexpr double AUDIO_DIFF_THRESHOLD = 0.03;     // 平均差值超过30ms才补偿
+    static constexpr int AUDIO_DIFF_AVG_NB = 20;             // 差值平均样本数
+    static constexpr double AUDIO_DIFF_AVG_COEF = 0.7943282347242815; // exp(log(0.01) / AUDIO_DIFF_AVG_NB)
+    static constexpr int SAMPLE_CORRECTION_PERCENT_MAX = 10; // 单次最大修正比例
+
+    std::atomic<int> m_syncMode{SYNC_AUDIO_MASTER};
+    std::shared_ptr<MediaClock> m_clock;          ///< 时间源（系统/虚拟）
+
+    SyncClock m_audioClock;                       ///< 音频时钟（设备播放位置）
+    std::atomic<qint64> m_audioEndPts{0};         ///< 已写入设备的音频数据末尾PTS
+    SyncClock m_videoClock;                       ///< 视频时钟
+    std::shared_ptr<SyncClock> m_externalClock;   ///< 外部时钟（可共享）
+    bool m_externalShared = false;
 
     // 帧间隔控制
-    qint64 m_lastFrameTime = 0;
+    std::atomic<qint64> m_lastFrameTime{0};
+
+    // 上屏时序反馈（GUI线程写，解码线程读）
+    std::atomic<qint64> m_vsyncIntervalUs{0};       ///< 垂直同步间隔
+    std::atomic<qint64> m_lastVsyncTime{0};         ///< 最近一次上屏时刻（vsync相位）
+    std::atomic<qint64> m_presentPipelineUs{0};     ///< 投递到上屏耗时的近期下限
+
+    // 音频漂移补偿（仅音频解码线程访问）
+    double m_audioDiffCum = 0.0;
+    int m_audioDiffAvgCount = 0;
 };
 
 // ==================== YUV帧数据结构 ====================
+/**
+ * @brief 可直接交给OpenGL渲染的YUV帧（平面格式三个平面，NV12/P010等半平面格式vData为空）
+ */
 struct YUVFrameData
 {
     QByteArray yData;
-    QByteArray uData;
+    QByteArray uData;       // 半平面格式为交错的UV
     QByteArray vData;
     int yLinesize = 0;
     int uLinesize = 0;
@@ -248,10 +670,15 @@ struct YUVFrameData
     int height = 0;
     qint64 pts = 0;
     qint64 duration = 40000;
+    AVPixelFormat pixelFormat = AV_PIX_FMT_YUV420P;
+    AVColorSpace colorSpace = AVCOL_SPC_UNSPECIFIED;
+    AVColorRange colorRange = AVCOL_RANGE_UNSPECIFIED;
+
+    bool isSemiPlanar() const { return av_pix_fmt_count_planes(pixelFormat) == 2; }
 
     bool isValid() const
     {
-        return !yData.isEmpty() && !uData.isEmpty() && !vData.isEmpty() &&
+        return !yData.isEmpty() && !uData.isEmpty() && (isSemiPlanar() || !vData.isEmpty()) &&
                 width > 0 && height > 0;
     }
 
@@ -264,9 +691,35 @@ struct YUVFrameData
         width = height = 0;
         pts = 0;
         duration = 40000;
+        pixelFormat = AV_PIX_FMT_YUV420P;
+        colorSpace = AVCOL_SPC_UNSPECIFIED;
+        colorRange = AVCOL_RANGE_UNSPECIFIED;
     }
 };
 
+#if OPENGL_AVAILABLE
+/**
+ * @brief 将FFmpeg的像素格式与色彩元数据映射为OpenGL渲染组件的格式描述
+ */
+OpenGLVideoWidget::YUVFormat toGLYUVFormat(AVPixelFormat pixelFormat, AVColorSpace colorSpace, AVColorRange colorRange);
+#endif
+
+// ==================== 待显示帧 ====================
+/**
+ * @brief 解码线程交给GUI线程显示的帧（经FrameMailbox传递，QImage/QByteArray隐式共享）
+ */
+struct DisplayFrame
+{
+    QImage image;
+    YUVFrameData yuvData;
+    qint64 ptsMs = 0;       // 显示时间戳（毫秒）
+    bool isYUV = false;
+    VideoFramePtr source;   // 原始解码帧引用，仅挂接了分发端点时有效
+
+    bool hasImage() const { return isYUV ? yuvData.isValid() : !image.isNull(); }
+    bool isValid() const { return hasImage() || source != nullptr; }
+};
+
 // ==================== 帧缓冲区 ====================
 class OptionalFrameBuffer
 {
@@ -278,6 +731,7 @@ public:
         qint64 pts;         // 时间戳（微秒）
         qint64 duration;    // 原始帧持续时间（微秒）
         bool isYUV;
+        VideoFramePtr source;   // 原始解码帧引用，仅挂接了分发端点时有效
 
         VideoFrame() : pts(0), duration(40000), isYUV(false) {}
         VideoFrame(const QImage &img, qint64 p, qint64 d = 40000)
@@ -287,9 +741,11 @@ public:
 
         bool isValid() const
         {
-            if (isYUV)
-                return yuvData.isValid() && pts >= 0;
-            return !image.isNull() && pts >= 0;
+            if (pts < 0)
+                return false;
+            if (source)
+                return true;
+            return isYUV ? yuvData.isValid() : !image.isNull();
         }
     };
 
@@ -339,6 +795,11 @@ public:
 
     bool isEnabled() const { return m_maxSize > 0; }
     int droppedFrames() const { return m_droppedFrames; }
+    int maxSize() const
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_maxSize;
+    }
 
     void setMaxSize(int size)
     {
@@ -362,11 +823,18 @@ public:
     AudioWriter() : m_device(nullptr), m_audioOutput(nullptr), m_running(true) {}
     ~AudioWriter() { stop(); }
 
-    void setDevice(QIODevice *device, QObject *audioOutput)
+    /**
+     * @brief 设置输出设备
+     * @param bytesPerSecond 输出格式每秒字节数，用于换算已写入数据的时长
+     * @note 须在设备start()之后调用，已写入字节数随之清零，与processedUSecs同一基准
+     */
+    void setDevice(QIODevice *device, QObject *audioOutput, int bytesPerSecond)
     {
         QMutexLocker lock(&m_mutex);
         m_device = device;
         m_audioOutput = audioOutput;
+        m_bytesPerSecond = bytesPerSecond;
+        m_bytesWritten = 0;
         m_bufferAvailable.release();
     }
 
@@ -402,7 +870,10 @@ public:
             int toWrite = qMin(size - written, freeBytes);
             int w = m_device->write(reinterpret_cast<const char *>(data + written), toWrite);
             if (w > 0)
+            {
                 written += w;
+                m_bytesWritten += w;
+            }
             else
                 return false;
         }
@@ -411,6 +882,29 @@ public:
 
     void notifyBufferReady() { m_bufferAvailable.release(); }
 
+    /**
+     * @brief 已写入但设备尚未播放的数据时长（微秒）
+     * 取"已写入时长 - 设备已处理时长（processedUSecs）"与Qt缓冲区占用中的较大值，
+     * 部分后端的processedUSecs只统计推入系统缓冲的数据，需要用缓冲区占用兜底；欠载时为0
+     * @return 无设备时返回-1
+     */
+    qint64 queuedUSecs()
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_audioOutput || m_bytesPerSecond <= 0)
+            return -1;
+
+        qint64 writtenUs = m_bytesWritten * 1000000 / m_bytesPerSecond;
+#if QT_VERSION_MAJOR < 6
+        QAudioOutput *output = static_cast<QAudioOutput*>(m_audioOutput);
+#else
+        QAudioSink *output = static_cast<QAudioSink*>(m_audioOutput);
+#endif
+        qint64 processedUs = output->processedUSecs();
+        qint64 bufferedUs = static_cast<qint64>(output->bufferSize() - output->bytesFree()) * 1000000 / m_bytesPerSecond;
+        return qMax<qint64>(0, qMax(writtenUs - processedUs, bufferedUs));
+    }
+
 private:
     int getFreeBytes()
     {
@@ -429,6 +923,8 @@ private:
     QIODevice *m_device;
     QObject *m_audioOutput;
     bool m_running;
+    int m_bytesPerSecond = 0;
+    qint64 m_bytesWritten = 0;          // 自setDevice起写入设备的字节数
 };
 
 // ==================== 解码线程 ====================
@@ -460,10 +956,64 @@ public:
     void setMaxBufferSize(int size);
     void setAutoReconnect(bool enabled, int maxRetries = 3);
     void setMemoryLimit(int limitMB);
+    /**
+     * @brief 启用YUV直出：可由OpenGL直接采样的格式不再转换为RGB（其余格式仍转换）
+     */
     void setYUVModeEnabled(bool enabled) { m_useYUVMode = enabled; }
+    /** 该像素格式是否可不经转换直接交给OpenGL渲染 */
+    static bool isDirectRenderFormat(AVPixelFormat format);
 
-    // 截图
-    bool takeScreenshot(const QString &filePath);
+    /**
+     * @brief 设置同步模式（在openMedia前设置，下次打开媒体时生效）
+     * @note 音频主时钟模式下若媒体无音频，自动退化为视频主时钟
+     */
+    void setSyncMode(AVSyncManager::SyncMode mode);
+    /** 获取当前生效的同步模式 */
+    AVSyncManager::SyncMode syncMode() const { return m_syncManager.syncMode(); }
+    /**
+     * @brief 设置外部时钟，多个播放器共享同一时钟可同步播放
+     * @note 须在openMedia前设置，传入nullptr恢复为私有时钟
+     */
+    void setExternalClock(std::shared_ptr<SyncClock> clock);
+    /**
+     * @brief 设置时间源（须在openMedia前设置，传入nullptr恢复为系统时钟）
+     * 虚拟时钟下等待只推进虚拟时间、不使用真实音频设备，可快于实时地复现同步过程
+     */
+    void setMediaClock(std::shared_ptr<MediaClock> clock);
+    /** 设置故障注入钩子（须在openMedia前设置，传入nullptr取消） */
+    void setFaultHooks(std::shared_ptr<PlaybackFaultHooks> hooks) { m_faultHooks = std::move(hooks); }
+
+    /** 画面不可见时的视频处理策略 */
+    enum HiddenVideoPolicy
+    {
+        HIDDEN_KEYFRAMES_ONLY = 0,  ///< 仅解码关键帧（AVDISCARD_NONKEY），不转换不显示
+        HIDDEN_DISCARD_ALL          ///< 丢弃全部视频包，按间隔解码一个关键帧保持解码器状态
+    };
+
+    /**
+     * @brief 设置画面是否可见（线程安全，由解码线程在下一个视频包时生效）
+     * 不可见时跳过视频解码与转换，音频照常播放；恢复可见后从下一个关键帧重新同步显示
+     */
+    void setVideoVisible(bool visible);
+    bool isVideoVisible() const { return m_videoVisible.load(std::memory_order_relaxed); }
+    /**
+     * @brief 设置不可见时的视频处理策略
+     * @param keyframeRefreshMs HIDDEN_DISCARD_ALL模式下解码关键帧的间隔（毫秒）
+     */
+    void setHiddenVideoPolicy(HiddenVideoPolicy policy, int keyframeRefreshMs = 2000);
+
+    /**
+     * @brief 挂接/解除视频帧分发端点（线程安全）
+     * 每个端点收到同一解码帧的引用，按各自输出尺寸转换；removeVideoSink返回后不会再收到帧
+     */
+    void addVideoSink(VideoFrameSink *sink);
+    void removeVideoSink(VideoFrameSink *sink);
+    int videoSinkCount() const { return m_sinkCount.load(std::memory_order_relaxed); }
+    /**
+     * @brief 是否输出自身显示帧（frameAvailable/takeLatestFrame）
+     * 仅向分发端点输出时关闭，省去解码线程中的格式转换
+     */
+    void setPrimaryOutputEnabled(bool enabled) { m_primaryOutput = enabled; }
 
     /**
      * @brief 静态方法：将YUV数据转换为QImage
@@ -486,15 +1036,47 @@ public:
         float currentPlaybackRate = 1.0f;
         float currentFps = 0.0f;
         int memoryUsageMB = 0;
+        qint64 avDriftUs = 0;       // 最近显示帧相对主时钟的偏差（微秒，正值为视频超前）
+        qint64 maxAvDriftUs = 0;    // 偏差绝对值的最大值（微秒）
+        // 以下由渲染组件的上屏反馈（reportFramePresented）得到，未接入反馈时为0
+        qint64 displayLatencyUs = 0;    // 投递到实际上屏的平均耗时（微秒）
+        qint64 vsyncIntervalUs = 0;     // 显示器垂直同步间隔（微秒）
+        qint64 presentDriftUs = 0;      // 上屏时刻相对主时钟的偏差（微秒，正值为视频超前）
+        int presentedFrames = 0;        // 实际上屏的帧数
+        int judderFrames = 0;           // 停留vsync数偏离内容节奏的帧数（重复或过早替换）
+        int skippedFrames = 0;          // 已投递但未能上屏即被覆盖的帧数
     };
     Statistics getStatistics() const;
 
+    /**
+     * @brief 上屏反馈（GUI线程在帧实际显示到屏幕后调用）
+     * @param ptsMs 上屏帧的时间戳（毫秒）
+     * @param vsyncIntervalUs 显示器垂直同步间隔（微秒），0表示未知
+     *
+     * 记录显示延迟与节奏抖动，并把vsync相位交给同步管理器，之后的帧按最近的vsync投递。
+     */
+    void reportFramePresented(qint64 ptsMs, qint64 vsyncIntervalUs);
+    /** 停止上屏反馈（切换到无反馈的渲染组件时调用），之后的帧不再对齐vsync */
+    void clearPresentFeedback() { m_syncManager.clearPresentTiming(); }
+
+    /** 解码端性能计数器（无锁，供性能浮层读取），生命周期与解码线程相同 */
+    std::shared_ptr<const PerfHudCounters> perfCounters() const { return m_perfCounters; }
+
+    /**
+     * @brief 取出最新待显示帧（仅GUI线程调用）
+     * 解码线程只保留最新一帧，GUI来不及显示的旧帧被直接覆盖
+     * @return true表示有新帧
+     */
+    bool takeLatestFrame(DisplayFrame &frame);
+    /** 当前播放位置（毫秒），GUI按界面刷新频率轮询 */
+    qint64 currentPosition() const { return m_positionMs.load(std::memory_order_relaxed); }
+
 signals:
-    /** 视频帧就绪信号 */
-    void frameReady(const QImage &image);
-    void frameReadyYUV(const YUVFrameData &yuvData);
-    /** 播放位置变化信号（毫秒） */
-    void positionChanged(qint64 pos);
+    /**
+     * 有新帧待显示（通过takeLatestFrame获取）
+     * 仅在GUI已取走上一帧时发出，同一时刻最多一个通知在途
+     */
+    void frameAvailable();
     /** 媒体总时长变化信号（毫秒） */
     void durationChanged(qint64 duration);
     /** 播放状态变化信号 */
@@ -520,11 +1102,16 @@ protected:
     void run() override;
 
 private:
+    bool openFormatContext(const QString &url, AVFormatContext **formatCtx, QString *error);
     bool initVideo();
     bool initAudio();
+    bool initAudioDecoder();
     bool initAudioOutput();
     QAudioFormat createAudioFormat() const;
     bool reconnectMedia();
+    bool canReuseDecoders(AVFormatContext *newCtx, int &videoIndex, int &audioIndex) const;
+    bool reinitAudioDecoder();
+    bool waitForReconnect(int delayMs);
     void updateFrameRate();
     void adjustBufferForResolution();
 
@@ -536,11 +1123,20 @@ private:
     YUVFrameData extractYUVData(AVFrame *frame);
     QImage convertFrameToImage(AVFrame *frame);
 
+    void publishFrame(DisplayFrame frame);
+    void applyVideoVisibility();
+    bool acceptVideoPacket(AVPacket *pkt);
+    void paceHiddenPacket(AVPacket *pkt);
     void writeAudioData(const uint8_t *data, int size);
+    void writeVirtualAudio(int size);
+    qint64 audioQueuedUSecs();
+    void updateAudioClockFromDevice(qint64 endPts);
     void applyVolume(int16_t *samples, int count);
     void cleanupResources();
     void updatePerformanceStats();
     void reinitAudioOutput();
+    void reinitResampler();
+    void snapshotPresentTiming();
 
     bool is4KVideo() const;
     void performPreciseSeek(qint64 targetMs);
@@ -558,7 +1154,8 @@ private:
     float m_playbackRate = 1.0f;
     bool m_needReinitAudio = false;
     int m_memoryLimitMB = 512;
-    bool m_useYUVMode = false;          // 默认关闭，稳定后再开启
+    std::atomic<bool> m_useYUVMode{false};  // 默认关闭，由FFmpegPlayer在使用OpenGL渲染时开启
+    AVSyncManager::SyncMode m_preferredSyncMode = AVSyncManager::SYNC_AUDIO_MASTER;  // 用户指定的同步模式
     // 精确seek相关
     qint64 m_seekPos = 0;
     qint64 m_seekTargetPts = -1;        // seek目标PTS（微秒）
@@ -588,6 +1185,31 @@ private:
 
     // 同步管理
     AVSyncManager m_syncManager;
+
+    // 时间源与故障注入
+    std::shared_ptr<MediaClock> m_clock = MediaClock::systemClock();
+    std::shared_ptr<PlaybackFaultHooks> m_faultHooks;
+    qint64 m_packetIndex = 0;           // 已读取的数据包序号
+    qint64 m_virtualAudioEndUs = 0;     // 虚拟音频设备中排队数据播完的时刻（虚拟时间，微秒）
+    static constexpr qint64 VIRTUAL_AUDIO_BUFFER_US = 200000;  // 虚拟音频设备缓冲时长
+
+    // 显示帧信箱（解码线程 -> GUI线程）与播放位置
+    FrameMailbox<DisplayFrame> m_displayMailbox;
+    std::atomic<qint64> m_positionMs{0};
+
+    // 可见性（GUI线程设置，解码线程应用）
+    std::atomic<bool> m_videoVisible{true};
+    std::atomic<int> m_hiddenPolicy{HIDDEN_KEYFRAMES_ONLY};
+    std::atomic<int> m_keyframeRefreshMs{2000};
+    bool m_videoActive = true;          // 解码线程当前应用的可见状态
+    bool m_waitVideoKeyframe = false;   // 恢复可见后等待关键帧
+    qint64 m_lastKeyframeRefresh = 0;   // 上次解码刷新关键帧的时间（微秒）
+
+    // 视频帧分发端点
+    mutable QMutex m_sinkMutex;
+    QVector<VideoFrameSink *> m_sinks;
+    std::atomic<int> m_sinkCount{0};
+    std::atomic<bool> m_primaryOutput{true};
     QString m_currentUrl;
 
     // 缓冲区
@@ -605,6 +1227,36 @@ private:
     // 统计信息
     Statistics m_stats;
     qint64 m_lastStatTime = 0;
+
+    // 上屏反馈：投递时刻按PTS记录，上屏时换算管线耗时（GUI线程与解码线程共用，m_presentMutex保护）
+    static constexpr int PUBLISH_HISTORY_SIZE = 16;
+    struct PresentState
+    {
+        qint64 publishPtsMs[PUBLISH_HISTORY_SIZE];
+        qint64 publishTime[PUBLISH_HISTORY_SIZE];
+        int publishIndex = 0;
+        qint64 lastPtsMs = -1;          // 上一次上屏帧的时间戳
+        qint64 lastTime = 0;            // 上一次上屏时刻
+        qint64 latencyUs = 0;
+        qint64 vsyncUs = 0;
+        qint64 driftUs = 0;
+        int presented = 0;
+        int judder = 0;
+        int skipped = 0;
+        double playbackRate = 1.0;      // 倍速与帧间隔快照（解码线程修改时同步写入，供GUI线程读取）
+        qint64 frameIntervalUs = 40000;
+
+        PresentState()
+        {
+            std::fill(publishPtsMs, publishPtsMs + PUBLISH_HISTORY_SIZE, -1);
+            std::fill(publishTime, publishTime + PUBLISH_HISTORY_SIZE, 0);
+        }
+    };
+    mutable QMutex m_presentMutex;
+    PresentState m_present;
+
+    // 性能浮层计数器（解码线程relaxed写入）
+    std::shared_ptr<PerfHudCounters> m_perfCounters = std::make_shared<PerfHudCounters>();
     qint64 m_lastBitrateCalcTime = 0;
     qint64 m_lastBitrateBytes = 0;
 
@@ -666,11 +1318,22 @@ public:
     /** 获取是否使用OpenGL渲染 */
     bool isUsingOpenGL() const { return m_useOpenGL && m_openglAvailable; }
 
+    /**
+     * @brief 异步截取当前屏幕显示的帧
+     * @return true表示已提交编码，结果通过frameCapturer()的captureSaved信号通知
+     */
     bool takeScreenshot(const QString &filePath);
+    /** 截图/连拍组件，可用于连拍、定时截图及监听保存结果 */
+    FrameCapturer *frameCapturer() const { return m_capturer_; }
     FFmpegDecoderThread::Statistics getStatistics() const;
     void setPlaybackRate(float rate);
     float playbackRate() const;
 
+    /** 设置同步模式，下次播放时生效 */
+    void setSyncMode(AVSyncManager::SyncMode mode);
+    /** 设置外部时钟（多个播放器传入同一时钟实现同步播放），下次播放时生效 */
+    void setExternalClock(std::shared_ptr<SyncClock> clock);
+
 public slots:
     void play(const QString &url);
     void updateFrame(const QImage &image);
@@ -687,16 +1350,28 @@ protected:
 
 private:
     void setupConnections();
+    void onFrameAvailable();
+    void onFrameReady(const QImage &image, qint64 ptsMs);
+    void onFrameReadyYUV(const YUVFrameData &yuvData, qint64 ptsMs);
+    /** 显示帧并记录其时间戳（OpenGL渲染时上屏后经onFramePresented反馈给解码线程） */
+    void presentFrame(const QImage &image, qint64 ptsMs);
+    void onFramePresented(qint64 ptsMs, qint64 vsyncIntervalUs);
+    void pollPosition();
     void updateDisplay();
     void initRenderWidget();
     void cleanupDecoder();
 
-    QWidget *m_displayWidget_;               // 显示组件（QLabel或OpenGLWidget）
-    QLabel *m_displayLabel_;                 // QLabel软件渲染组件（降级备用）
+    QWidget *m_displayWidget_;               // 显示组件（RasterVideoSurface或OpenGLWidget）
+    RasterVideoSurface *m_rasterSurface_;    // 软件渲染组件（降级备用）
     PlayerWidgetBase *m_playerCore_;
     FFmpegDecoderThread *m_decoder_;
+    FrameCapturer *m_capturer_;              // 截图/连拍（线程池编码）
 
     QImage m_currentFrame;
+    qint64 m_currentPtsMs = -1;              // 当前RGB帧的时间戳（-1表示外部传入，无上屏反馈）
+    YUVFrameData m_currentYUV;               // OpenGL YUV渲染时当前显示的帧
+    QTimer *m_positionTimer_;                // 播放位置轮询（合并为界面刷新频率）
+    qint64 m_lastPositionMs = -1;            // 最近一次上报的播放位置（毫秒）
     QMutex m_frameMutex;
     
     bool m_useOpenGL;                        // 是否尝试使用OpenGL渲染
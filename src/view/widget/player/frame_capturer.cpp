@@ -0,0 +1,216 @@
+#include "frame_capturer.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QRunnable>
+#include <QThread>
+
+namespace
+{
+// ==================== 编码任务 ====================
+class EncodeTask : public QRunnable
+{
+public:
+    EncodeTask(FrameCapturer::FrameSource source, const QString &filePath, int quality,
+               std::function<void(const QString &, bool)> onFinished)
+        : m_source(std::move(source))
+        , m_filePath(filePath)
+        , m_quality(quality)
+        , m_onFinished(std::move(onFinished))
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        QImage image = m_source ? m_source() : QImage();
+        bool ok = false;
+        if (!image.isNull())
+        {
+            QImageWriter writer(m_filePath);
+            if (m_quality >= 0)
+                writer.setQuality(m_quality);
+            ok = writer.write(image);
+            if (!ok)
+                qWarning() << "FrameCapturer: failed to save" << m_filePath << writer.errorString();
+        }
+        m_onFinished(m_filePath, ok);
+    }
+
+private:
+    FrameCapturer::FrameSource m_source;
+    QString m_filePath;
+    int m_quality;
+    std::function<void(const QString &, bool)> m_onFinished;
+};
+} // namespace
+
+FrameCapturer::FrameCapturer(QObject *parent)
+    : QObject(parent)
+{
+    // 编码占用CPU较多，限制线程数，避免与解码线程争抢
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 4, 2));
+    m_maxPending = m_pool.maxThreadCount() * 2;
+}
+
+FrameCapturer::~FrameCapturer()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool FrameCapturer::capture(const QImage &frame, const QString &filePath)
+{
+    if (frame.isNull())
+        return false;
+    // 按值捕获QImage仅增加引用计数
+    return submit([frame]() { return frame; }, filePath);
+}
+
+bool FrameCapturer::capture(FrameSource source, const QString &filePath)
+{
+    if (!source)
+        return false;
+    return submit(std::move(source), filePath);
+}
+
+bool FrameCapturer::startBurst(const QString &dirPath, int count, const QString &format)
+{
+    if (count <= 0)
+        return false;
+    return beginSequence(dirPath, 1, 0, count, format);
+}
+
+bool FrameCapturer::startInterval(const QString &dirPath, int everyNFrames, int intervalMs,
+                                  int maxCount, const QString &format)
+{
+    if (everyNFrames <= 0 && intervalMs <= 0)
+    {
+        qWarning() << "FrameCapturer: interval capture needs everyNFrames or intervalMs";
+        return false;
+    }
+    return beginSequence(dirPath, everyNFrames, intervalMs, maxCount, format);
+}
+
+void FrameCapturer::stop()
+{
+    if (m_sequence.active)
+        finishSequence();
+}
+
+void FrameCapturer::onFrameDisplayed(const QImage &frame, qint64 ptsMs)
+{
+    if (!m_sequence.active || frame.isNull())
+        return;
+    onFrameDisplayed([frame]() { return frame; }, ptsMs);
+}
+
+void FrameCapturer::onFrameDisplayed(FrameSource source, qint64 ptsMs)
+{
+    if (!m_sequence.active || !source)
+        return;
+
+    if (!shouldCaptureSequenceFrame(ptsMs))
+        return;
+
+    // 积压时跳过，但不计入已保存张数，下一个满足条件的帧会继续尝试
+    if (submit(std::move(source), nextSequencePath()))
+    {
+        m_sequence.submitted++;
+        m_sequence.lastCapturePtsMs = ptsMs;
+        m_sequence.frameCounter = 0;
+    }
+
+    if (m_sequence.maxCount > 0 && m_sequence.submitted >= m_sequence.maxCount)
+        finishSequence();
+}
+
+void FrameCapturer::setMaxPending(int maxPending)
+{
+    m_maxPending = qMax(1, maxPending);
+}
+
+bool FrameCapturer::submit(FrameSource source, const QString &filePath)
+{
+    // 积压超过上限直接跳过，绝不阻塞调用线程
+    if (m_pending.fetch_add(1) >= m_maxPending)
+    {
+        m_pending.fetch_sub(1);
+        int skipped = ++m_skipped;
+        emit captureSkipped(skipped);
+        return false;
+    }
+
+    QFileInfo info(filePath);
+    QDir().mkpath(info.absolutePath());
+
+    // 析构函数会等待所有任务完成，任务中访问this是安全的；
+    // 结果通过队列投递回对象所在线程，对象销毁时未处理的事件随之丢弃
+    auto onFinished = [this](const QString &path, bool ok) {
+        m_pending.fetch_sub(1);
+        QMetaObject::invokeMethod(this, [this, path, ok]() {
+            emit captureSaved(path, ok);
+        }, Qt::QueuedConnection);
+    };
+
+    m_pool.start(new EncodeTask(std::move(source), filePath, m_quality, std::move(onFinished)));
+    return true;
+}
+
+bool FrameCapturer::beginSequence(const QString &dirPath, int everyNFrames, int intervalMs,
+                                  int maxCount, const QString &format)
+{
+    if (dirPath.isEmpty() || !QDir().mkpath(dirPath))
+    {
+        qWarning() << "FrameCapturer: invalid output directory" << dirPath;
+        return false;
+    }
+
+    if (m_sequence.active)
+        finishSequence();
+
+    m_sequence.active = true;
+    m_sequence.dirPath = dirPath;
+    m_sequence.format = format.isEmpty() ? QStringLiteral("jpg") : format.toLower();
+    m_sequence.everyNFrames = everyNFrames;
+    m_sequence.intervalMs = intervalMs;
+    m_sequence.maxCount = maxCount;
+    m_sequence.frameCounter = 0;
+    m_sequence.submitted = 0;
+    m_sequence.lastCapturePtsMs = -1;
+
+    qDebug() << "FrameCapturer: sequence started, dir:" << dirPath
+             << "everyNFrames:" << everyNFrames << "intervalMs:" << intervalMs
+             << "maxCount:" << maxCount;
+    return true;
+}
+
+bool FrameCapturer::shouldCaptureSequenceFrame(qint64 ptsMs)
+{
+    m_sequence.frameCounter++;
+
+    // 首帧或seek回退后立即截取
+    // 计数只在提交成功后清零，积压跳过的帧不会让下一次截取再等满N帧
+    if (m_sequence.lastCapturePtsMs < 0 || ptsMs < m_sequence.lastCapturePtsMs)
+        return true;
+
+    bool byFrames = m_sequence.everyNFrames > 0 && m_sequence.frameCounter >= m_sequence.everyNFrames;
+    bool byTime = m_sequence.intervalMs > 0 && ptsMs - m_sequence.lastCapturePtsMs >= m_sequence.intervalMs;
+    return byFrames || byTime;
+}
+
+QString FrameCapturer::nextSequencePath()
+{
+    return QDir(m_sequence.dirPath).filePath(
+        QStringLiteral("frame_%1.%2").arg(m_sequence.submitted, 6, 10, QLatin1Char('0')).arg(m_sequence.format));
+}
+
+void FrameCapturer::finishSequence()
+{
+    m_sequence.active = false;
+    qDebug() << "FrameCapturer: sequence finished, submitted:" << m_sequence.submitted
+             << "skipped:" << m_skipped.load();
+    emit sequenceFinished(m_sequence.dirPath, m_sequence.submitted);
+}
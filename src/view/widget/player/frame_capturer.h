@@ -0,0 +1,133 @@
+/*****************************************************************
+File:        frame_capturer.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 播放器截图/连拍组件
+             截取当前屏幕显示的帧（QImage隐式共享，不拷贝像素），
+             PNG/JPEG编码在独立线程池中完成，不阻塞播放与UI线程
+    主要功能：
+        1. 单帧截图
+        2. 连拍（连续N帧）
+        3. 定时截图（每N帧或每T毫秒）输出到目录，按序号命名
+    技术特性：
+        1. 编码积压超过上限时直接跳过本次截图，而不是等待，保证播放不丢帧
+        2. 支持延迟取帧（YUV帧在工作线程中转换为RGB）
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            连拍帧计数改为提交成功后清零
+*****************************************************************/
+
+#ifndef FRAME_CAPTURER_H
+#define FRAME_CAPTURER_H
+
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
+
+class FrameCapturer : public QObject
+{
+    Q_OBJECT
+public:
+    /** 延迟取帧函数，在编码线程中调用（如YUV转RGB） */
+    using FrameSource = std::function<QImage()>;
+
+    explicit FrameCapturer(QObject *parent = nullptr);
+    ~FrameCapturer() override;
+
+    /**
+     * @brief 异步保存单帧
+     * @param frame 当前显示的帧（隐式共享，不拷贝像素）
+     * @param filePath 保存路径，格式由后缀决定（png/jpg）
+     * @return true表示已提交编码，false表示积压已满被跳过
+     */
+    bool capture(const QImage &frame, const QString &filePath);
+    bool capture(FrameSource source, const QString &filePath);
+
+    /**
+     * @brief 开始连拍：从下一帧起连续保存count帧
+     * @param dirPath 输出目录（不存在时自动创建）
+     * @param format 图片格式（"png"/"jpg"）
+     */
+    bool startBurst(const QString &dirPath, int count, const QString &format = QStringLiteral("jpg"));
+
+    /**
+     * @brief 开始定时截图
+     * @param dirPath 输出目录（不存在时自动创建）
+     * @param everyNFrames 每N帧保存一张，<=0表示不按帧数
+     * @param intervalMs 每T毫秒保存一张，<=0表示不按时间（两者同时设置时满足其一即保存）
+     * @param maxCount 最多保存张数，<=0表示直到stop
+     */
+    bool startInterval(const QString &dirPath, int everyNFrames, int intervalMs,
+                       int maxCount = 0, const QString &format = QStringLiteral("jpg"));
+
+    /** 停止连拍/定时截图（已提交的编码任务会继续完成） */
+    void stop();
+
+    /** 是否处于连拍/定时截图中 */
+    bool isSequenceActive() const { return m_sequence.active; }
+
+    /**
+     * @brief 帧显示回调，由播放器在每帧显示时调用（UI线程）
+     * 仅在连拍/定时截图进行中时才会提交编码任务
+     */
+    void onFrameDisplayed(const QImage &frame, qint64 ptsMs);
+    void onFrameDisplayed(FrameSource source, qint64 ptsMs);
+
+    /** 设置编码积压上限（默认=编码线程数*2） */
+    void setMaxPending(int maxPending);
+    /** 设置JPEG质量（0~100，-1为默认） */
+    void setQuality(int quality) { m_quality = quality; }
+    /** 编码线程池，默认最多2个线程 */
+    QThreadPool *threadPool() { return &m_pool; }
+
+    int pendingCount() const { return m_pending.load(); }
+    int skippedCount() const { return m_skipped.load(); }
+
+    /** 等待所有已提交的编码任务完成 */
+    bool waitForDone(int msecs = -1) { return m_pool.waitForDone(msecs); }
+
+signals:
+    /** 单帧保存完成（编码线程结束后在对象所在线程发出） */
+    void captureSaved(const QString &filePath, bool success);
+    /** 因积压被跳过 */
+    void captureSkipped(int totalSkipped);
+    /** 连拍/定时截图结束 */
+    void sequenceFinished(const QString &dirPath, int savedCount);
+
+private:
+    bool submit(FrameSource source, const QString &filePath);
+    bool beginSequence(const QString &dirPath, int everyNFrames, int intervalMs,
+                       int maxCount, const QString &format);
+    bool shouldCaptureSequenceFrame(qint64 ptsMs);
+    QString nextSequencePath();
+    void finishSequence();
+
+    QThreadPool m_pool;
+    std::atomic<int> m_pending{0};
+    std::atomic<int> m_skipped{0};
+    int m_maxPending = 4;
+    int m_quality = -1;
+
+    // 连拍/定时截图状态（仅UI线程访问）
+    struct
+    {
+        bool active = false;
+        QString dirPath;
+        QString format;
+        int everyNFrames = 0;
+        int intervalMs = 0;
+        int maxCount = 0;
+        int frameCounter = 0;
+        int submitted = 0;
+        qint64 lastCapturePtsMs = -1;
+    } m_sequence;
+};
+
+#endif // FRAME_CAPTURER_H
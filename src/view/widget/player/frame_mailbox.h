@@ -0,0 +1,90 @@
+/*****************************************************************
+File:        frame_mailbox.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: 无锁三缓冲"最新帧"信箱（单生产者/单消费者）
+             生产者（解码线程）写入后与中间槽交换，消费者（GUI线程）取走时再交换，
+             双方互不阻塞；消费者来不及取的旧帧被直接覆盖，不会排队积压。
+    使用方式：
+        1. 生产者调用publish()，返回true时表示消费者已取走上一帧，需要发出一次通知
+           （同一时刻最多只有一个通知在途，GUI卡顿时事件队列不会增长）
+        2. 消费者收到通知后调用fetch()，成功则通过current()读取最新帧
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifndef FRAME_MAILBOX_H
+#define FRAME_MAILBOX_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+template <typename T>
+class FrameMailbox
+{
+public:
+    FrameMailbox() = default;
+    FrameMailbox(const FrameMailbox &) = delete;
+    FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+    /**
+     * @brief 发布新帧（仅生产者线程调用）
+     * @return true表示中间槽此前已被消费者取走，调用方需要通知消费者
+     */
+    bool publish(T value)
+    {
+        m_slots[m_write] = std::move(value);
+        uint8_t prev = m_middle.exchange(static_cast<uint8_t>(m_write | DIRTY_BIT), std::memory_order_acq_rel);
+        m_write = prev & INDEX_MASK;
+        return (prev & DIRTY_BIT) == 0;
+    }
+
+    /**
+     * @brief 取最新帧（仅消费者线程调用）
+     * @return true表示有新帧，可通过current()读取
+     */
+    bool fetch()
+    {
+        if ((m_middle.load(std::memory_order_acquire) & DIRTY_BIT) == 0)
+            return false;
+        uint8_t prev = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = prev & INDEX_MASK;
+        return true;
+    }
+
+    /** 消费者当前持有的帧（仅消费者线程访问） */
+    const T &current() const { return m_slots[m_read]; }
+
+    /** 移出消费者当前持有的帧，避免消费者槽长期持有引用计数资源 */
+    T take() { return std::move(m_slots[m_read]); }
+
+    /** 是否有未取走的新帧 */
+    bool hasPending() const { return (m_middle.load(std::memory_order_acquire) & DIRTY_BIT) != 0; }
+
+    /**
+     * @brief 清空（须在生产者停止后由消费者线程调用）
+     */
+    void reset()
+    {
+        for (T &slot : m_slots)
+            slot = T();
+        m_write = 0;
+        m_middle.store(1, std::memory_order_release);
+        m_read = 2;
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+
+    T m_slots[3];
+    uint8_t m_write = 0;                ///< 生产者私有槽
+    std::atomic<uint8_t> m_middle{1};   ///< 中间槽索引 | 新帧标记
+    uint8_t m_read = 2;                 ///< 消费者私有槽
+};
+
+#endif // FRAME_MAILBOX_H
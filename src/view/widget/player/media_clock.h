@@ -0,0 +1,158 @@
+/*****************************************************************
+File:        media_clock.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 播放时间源抽象
+             同步管理器与解码线程的取时、等待都经过MediaClock，
+             默认使用系统单调时钟；替换为虚拟时钟后，等待只推进虚拟时间，
+             可快于实时且可精确复现地运行完整的音视频同步流程
+    主要内容：
+        1. SystemMediaClock：av_gettime_relative + 线程休眠
+        2. VirtualMediaClock：休眠即推进虚拟时间，音频输出同样按虚拟时间消耗
+        3. PlaybackFaultHooks：注入读包卡顿、解码耗时、音频欠载
+    使用方式：
+        decoder->setMediaClock(std::make_shared<VirtualMediaClock>());
+        decoder->setFaultHooks(hooks);   // 可选
+        decoder->openMedia(file);        // 之后按统计信息断言丢帧数与音画偏差
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            新增条件变量等待接口，重连退避与暂停等待同样走时间源
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _MEDIA_CLOCK_H
+#define _MEDIA_CLOCK_H
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+
+extern "C"
+{
+#include <libavutil/time.h>
+}
+
+// ==================== 时间源接口 ====================
+class MediaClock
+{
+public:
+    virtual ~MediaClock() = default;
+
+    /** 单调时间（微秒） */
+    virtual qint64 nowUs() const = 0;
+    /** 等待指定时长（微秒），<=0时立即返回 */
+    virtual void sleepUs(qint64 us) = 0;
+    /**
+     * 持有mutex时在condition上等待至多us微秒（可被唤醒提前返回）
+     * @return 被唤醒返回true，超时返回false
+     */
+    virtual bool wait(QWaitCondition &condition, QMutex &mutex, qint64 us) = 0;
+    /** 是否为虚拟时间（虚拟时间下不使用真实音频设备） */
+    virtual bool isVirtual() const { return false; }
+
+    /** 进程内共享的系统时钟 */
+    static std::shared_ptr<MediaClock> systemClock();
+};
+
+// ==================== 系统时钟 ====================
+class SystemMediaClock final : public MediaClock
+{
+public:
+    qint64 nowUs() const override { return av_gettime_relative(); }
+
+    void sleepUs(qint64 us) override
+    {
+        if (us <= 0)
+            return;
+        if (us < 10000)
+            QThread::usleep(static_cast<unsigned long>(us));
+        else
+            QThread::msleep(static_cast<unsigned long>(us / 1000));
+    }
+
+    bool wait(QWaitCondition &condition, QMutex &mutex, qint64 us) override
+    {
+        return condition.wait(&mutex, static_cast<unsigned long>(qMax<qint64>(1, us / 1000)));
+    }
+};
+
+inline std::shared_ptr<MediaClock> MediaClock::systemClock()
+{
+    static std::shared_ptr<MediaClock> s_clock = std::make_shared<SystemMediaClock>();
+    return s_clock;
+}
+
+// ==================== 虚拟时钟 ====================
+/**
+ * @brief 虚拟时钟：sleepUs直接推进时间而不真正休眠
+ * 解码线程是唯一的等待方，因此整条播放流程以CPU速度运行，时间线完全可复现
+ */
+class VirtualMediaClock final : public MediaClock
+{
+public:
+    explicit VirtualMediaClock(qint64 startUs = 0) : m_now(startUs) {}
+
+    qint64 nowUs() const override { return m_now.load(std::memory_order_acquire); }
+
+    void sleepUs(qint64 us) override
+    {
+        if (us > 0)
+        {
+            m_now.fetch_add(us, std::memory_order_acq_rel);
+            m_sleptUs.fetch_add(us, std::memory_order_relaxed);
+        }
+    }
+
+    /** 直接推进等待时长，再短暂让出锁以便响应停止/恢复等状态变化 */
+    bool wait(QWaitCondition &condition, QMutex &mutex, qint64 us) override
+    {
+        sleepUs(us);
+        return condition.wait(&mutex, 1);
+    }
+
+    bool isVirtual() const override { return true; }
+
+    /** 手动推进时间（模拟外部耗时，不计入sleptUs） */
+    void advance(qint64 us)
+    {
+        if (us > 0)
+            m_now.fetch_add(us, std::memory_order_acq_rel);
+    }
+
+    /** 累计等待时长（微秒） */
+    qint64 sleptUs() const { return m_sleptUs.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_now;
+    std::atomic<qint64> m_sleptUs{0};
+};
+
+// ==================== 故障注入 ====================
+/**
+ * @brief 播放故障注入钩子（在解码线程中调用），默认不注入任何故障
+ * 返回的耗时通过MediaClock::sleepUs体现，虚拟时钟下同样只推进虚拟时间
+ */
+class PlaybackFaultHooks
+{
+public:
+    virtual ~PlaybackFaultHooks() = default;
+
+    /** 读取第packetIndex个数据包前的卡顿（模拟网络阻塞），单位微秒 */
+    virtual qint64 readStallUs(qint64 packetIndex) { Q_UNUSED(packetIndex); return 0; }
+    /** 解码一个数据包的额外耗时（模拟解码负载），单位微秒 */
+    virtual qint64 decodeDelayUs(bool isVideo, qint64 ptsUs) { Q_UNUSED(isVideo); Q_UNUSED(ptsUs); return 0; }
+    /** 是否丢弃本次音频写入（模拟设备欠载） */
+    virtual bool dropAudioWrite(qint64 ptsUs) { Q_UNUSED(ptsUs); return false; }
+};
+
+#endif // _MEDIA_CLOCK_H
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,677 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "quick_video_item.h"
+
+#if defined(QUICK_VIDEO_ENABLE) && defined(OPENGL_ENABLE)
+
+#include <QDebug>
+#include <QMatrix3x3>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGMaterial>
+#include <QSGRectangleNode>
+#include <QSGTexture>
+#include <QVector3D>
+#include <QVector4D>
+
+#if QT_VERSION_MAJOR >= 6
+#include <QSGMaterialShader>
+#include <rhi/qrhi.h>
+#else
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#endif
+
+#include <cstring>
+
+#include "ffmpeg_player_widget.h"
+#include "video_frame_sink.h"
+#include "video_stream_registry.h"
+
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
+// ==================== 平面纹理 ====================
+
+/**
+ * @brief 单个视频平面的场景图纹理
+ * 引用解码帧（或回退转换的图像）直到下一帧到来，上传在渲染线程绑定/提交时进行；
+ * 尺寸与格式不变时复用纹理存储
+ */
+class QuickVideoPlaneTexture : public QSGTexture
+{
+public:
+    QuickVideoPlaneTexture()
+    {
+        setFiltering(QSGTexture::Linear);
+        setHorizontalWrapMode(QSGTexture::ClampToEdge);
+        setVerticalWrapMode(QSGTexture::ClampToEdge);
+    }
+
+    ~QuickVideoPlaneTexture() override
+    {
+#if QT_VERSION_MAJOR >= 6
+        delete m_texture;
+#else
+        // 材质在渲染线程析构，此时场景图上下文为当前上下文
+        QOpenGLContext *ctx = QOpenGLContext::currentContext();
+        if (m_textureId && ctx)
+            ctx->functions()->glDeleteTextures(1, &m_textureId);
+#endif
+    }
+
+    /**
+     * @brief 设置YUV平面数据（零拷贝，持有帧引用）
+     */
+    void setPlane(const VideoFramePtr &frame, const uint8_t *data, int linesize,
+                  int width, int height, int bytesPerPixel)
+    {
+        m_frame = frame;
+        m_image = QImage();
+        m_data = data;
+        m_linesize = linesize;
+        m_size = QSize(width, height);
+        m_bytesPerPixel = bytesPerPixel;
+        m_dirty = true;
+    }
+
+    /**
+     * @brief 设置RGBA8888图像（无法直接采样的格式回退）
+     */
+    void setImage(const QImage &image)
+    {
+        m_frame.reset();
+        m_image = image;
+        m_data = image.constBits();
+        m_linesize = image.bytesPerLine();
+        m_size = image.size();
+        m_bytesPerPixel = 4;
+        m_dirty = true;
+    }
+
+    bool hasData() const { return m_data != nullptr; }
+
+    QSize textureSize() const override { return m_size; }
+    bool hasAlphaChannel() const override { return false; }
+    bool hasMipmaps() const override { return false; }
+
+#if QT_VERSION_MAJOR >= 6
+    qint64 comparisonKey() const override
+    {
+        return m_texture ? qint64(quintptr(m_texture)) : qint64(quintptr(this));
+    }
+
+    QRhiTexture *rhiTexture() const override { return m_texture; }
+
+    void commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates) override
+    {
+        if (!m_dirty || !m_data)
+            return;
+        m_dirty = false;
+
+        const QRhiTexture::Format format = m_bytesPerPixel == 1 ? QRhiTexture::R8
+                                         : m_bytesPerPixel == 2 ? QRhiTexture::RG8
+                                                                : QRhiTexture::RGBA8;
+        if (!m_texture || m_texture->pixelSize() != m_size || m_texture->format() != format)
+        {
+            // 旧纹理可能仍被在途的帧引用，延后到帧结束释放
+            if (m_texture)
+                m_texture->deleteLater();
+            m_texture = rhi->newTexture(format, m_size);
+            if (!m_texture->create())
+            {
+                qWarning() << "QuickVideoItem: failed to create texture" << m_size << format;
+                delete m_texture;
+                m_texture = nullptr;
+                return;
+            }
+        }
+
+        // 直接引用帧数据（帧引用保持到下一帧，晚于本批次提交），行步长由RHI处理
+        const int rowBytes = m_size.width() * m_bytesPerPixel;
+        const int dataSize = m_linesize * (m_size.height() - 1) + rowBytes;
+        QRhiTextureSubresourceUploadDescription desc(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(m_data), dataSize));
+        if (m_linesize != rowBytes)
+            desc.setDataStride(m_linesize);
+        resourceUpdates->uploadTexture(m_texture, QRhiTextureUploadEntry(0, 0, desc));
+    }
+#else
+    int textureId() const override { return static_cast<int>(m_textureId); }
+
+    void bind() override
+    {
+        QOpenGLContext *ctx = QOpenGLContext::currentContext();
+        QOpenGLFunctions *f = ctx->functions();
+        const bool created = m_textureId == 0;
+        if (created)
+            f->glGenTextures(1, &m_textureId);
+        f->glBindTexture(GL_TEXTURE_2D, m_textureId);
+        updateBindOptions(created);
+
+        if (m_dirty && m_data)
+        {
+            m_dirty = false;
+            upload(ctx, f);
+        }
+    }
+#endif
+
+private:
+#if QT_VERSION_MAJOR < 6
+    void upload(QOpenGLContext *ctx, QOpenGLFunctions *f)
+    {
+        const GLenum glFormat = OpenGLVideoWidget::pixelFormatForBytes(m_bytesPerPixel);
+        if (m_allocatedSize != m_size || m_allocatedFormat != glFormat)
+        {
+            f->glTexImage2D(GL_TEXTURE_2D, 0, glFormat, m_size.width(), m_size.height(), 0,
+                            glFormat, GL_UNSIGNED_BYTE, nullptr);
+            m_allocatedSize = m_size;
+            m_allocatedFormat = glFormat;
+        }
+
+        const int version = ctx->format().majorVersion() * 10 + ctx->format().minorVersion();
+        const bool rowLengthSupported = !ctx->isOpenGLES() || version >= 30 || ctx->hasExtension("GL_EXT_unpack_subimage");
+
+        const int rowBytes = m_size.width() * m_bytesPerPixel;
+        const uint8_t *pixels = m_data;
+        int rowLength = 0;
+        if (m_linesize != rowBytes)
+        {
+            if (rowLengthSupported && m_linesize % m_bytesPerPixel == 0)
+            {
+                rowLength = m_linesize / m_bytesPerPixel;
+            }
+            else
+            {
+                m_repackBuffer.resize(rowBytes * m_size.height());
+                uint8_t *dst = reinterpret_cast<uint8_t*>(m_repackBuffer.data());
+                for (int row = 0; row < m_size.height(); ++row)
+                    memcpy(dst + static_cast<size_t>(row) * rowBytes,
+                           m_data + static_cast<size_t>(row) * m_linesize, rowBytes);
+                pixels = dst;
+            }
+        }
+
+        f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (rowLengthSupported)
+            f->glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_size.width(), m_size.height(),
+                           glFormat, GL_UNSIGNED_BYTE, pixels);
+        if (rowLengthSupported)
+            f->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    GLuint m_textureId = 0;
+    QSize m_allocatedSize;
+    GLenum m_allocatedFormat = 0;
+    QByteArray m_repackBuffer;      ///< 不支持行步长时的紧凑重排缓冲
+#else
+    QRhiTexture *m_texture = nullptr;
+#endif
+
+    VideoFramePtr m_frame;          ///< 数据来源帧（保持引用直到下一帧）
+    QImage m_image;                 ///< 回退路径的数据来源
+    const uint8_t *m_data = nullptr;
+    int m_linesize = 0;
+    QSize m_size;
+    int m_bytesPerPixel = 1;
+    bool m_dirty = false;
+};
+
+// ==================== 材质 ====================
+
+/**
+ * @brief 视频材质：各平面纹理与帧格式
+ * 着色器按格式标志选择采样方式（平面/半平面、8/16位、RGBA），色彩矩阵与OpenGLVideoWidget一致
+ */
+class QuickVideoMaterial : public QSGMaterial
+{
+public:
+    QuickVideoMaterial()
+    {
+        // 项透明度通过qt_Opacity作用于输出
+        setFlag(Blending);
+    }
+
+    QSGMaterialType *type() const override
+    {
+        static QSGMaterialType materialType;
+        return &materialType;
+    }
+
+#if QT_VERSION_MAJOR >= 6
+    QSGMaterialShader *createShader(QSGRendererInterface::RenderMode renderMode) const override;
+#else
+    QSGMaterialShader *createShader() const override;
+#endif
+
+    int compare(const QSGMaterial *other) const override
+    {
+        // 每个视频项的纹理不同，不与其他材质合批
+        return this == other ? 0 : (this < other ? -1 : 1);
+    }
+
+    QuickVideoPlaneTexture *plane(int index) { return &m_planes[index]; }
+    int planeCount() const { return rgb ? 1 : format.planeCount(); }
+
+    /** 格式标志（x:半平面 y:VU顺序 z:16位样本 w:RGBA单平面） */
+    QVector4D flags() const
+    {
+        return QVector4D(format.isSemiPlanar() ? 1.0f : 0.0f,
+                         format.layout == OpenGLVideoWidget::LAYOUT_NV21 ? 1.0f : 0.0f,
+                         format.bytesPerSample() > 1 ? 1.0f : 0.0f,
+                         rgb ? 1.0f : 0.0f);
+    }
+
+    OpenGLVideoWidget::YUVFormat format;
+    OpenGLVideoWidget::ColorSpace colorSpace = OpenGLVideoWidget::COLOR_BT601;  ///< 帧未携带色彩空间时使用
+    bool rgb = false;
+    QSize frameSize;                ///< 源视频尺寸（决定显示宽高比）
+
+private:
+    QuickVideoPlaneTexture m_planes[3];
+};
+
+// ==================== 着色器 ====================
+
+#if QT_VERSION_MAJOR >= 6
+
+/**
+ * @brief RHI着色器（quick_video.vert/frag，构建时编译为qsb）
+ * uniform块布局（std140）：qt_Matrix@0 colorMatrix@64 colorOffset@128 flags@144 qt_Opacity@160
+ */
+class QuickVideoShader : public QSGMaterialShader
+{
+public:
+    QuickVideoShader()
+    {
+        setShaderFileName(VertexStage, QStringLiteral(":/shaders/quick_video.vert.qsb"));
+        setShaderFileName(FragmentStage, QStringLiteral(":/shaders/quick_video.frag.qsb"));
+    }
+
+    bool updateUniformData(RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) override
+    {
+        Q_UNUSED(oldMaterial);
+        QuickVideoMaterial *material = static_cast<QuickVideoMaterial*>(newMaterial);
+        QByteArray *buffer = state.uniformData();
+        Q_ASSERT(buffer->size() >= 164);
+        char *data = buffer->data();
+
+        if (state.isMatrixDirty())
+        {
+            const QMatrix4x4 matrix = state.combinedMatrix();
+            memcpy(data, matrix.constData(), 64);
+        }
+
+        // 帧格式可能逐帧变化，参数每次写入（共几十字节）
+        const OpenGLVideoWidget::YUVFormat &format = material->format;
+        QMatrix3x3 colorMatrix;
+        QVector3D colorOffset;
+        OpenGLVideoWidget::computeColorMatrix(format.hasColorSpace ? format.colorSpace : material->colorSpace,
+                                              format.range, format.bitDepth, colorMatrix, colorOffset);
+        // 3x3矩阵按列存为mat4（std140中mat3每列也占16字节）
+        float matrix4[16] = {};
+        for (int col = 0; col < 3; ++col)
+            for (int row = 0; row < 3; ++row)
+                matrix4[col * 4 + row] = colorMatrix(row, col);
+        matrix4[15] = 1.0f;
+        memcpy(data + 64, matrix4, 64);
+
+        const float offset[4] = {colorOffset.x(), colorOffset.y(), colorOffset.z(),
+                                 OpenGLVideoWidget::sampleScale(format)};
+        memcpy(data + 128, offset, 16);
+
+        const QVector4D flags = material->flags();
+        const float flagValues[4] = {flags.x(), flags.y(), flags.z(), flags.w()};
+        memcpy(data + 144, flagValues, 16);
+
+        if (state.isOpacityDirty())
+        {
+            const float opacity = state.opacity();
+            memcpy(data + 160, &opacity, 4);
+        }
+        return true;
+    }
+
+    void updateSampledImage(RenderState &state, int binding, QSGTexture **texture,
+                            QSGMaterial *newMaterial, QSGMaterial *oldMaterial) override
+    {
+        Q_UNUSED(oldMaterial);
+        QuickVideoMaterial *material = static_cast<QuickVideoMaterial*>(newMaterial);
+
+        // 绑定点1/2/3对应Y/U/V；未使用的采样器绑定到已有平面（半平面的V取UV平面，RGBA取唯一平面）
+        const int index = qMin(binding - 1, material->planeCount() - 1);
+        QuickVideoPlaneTexture *plane = material->plane(qMax(index, 0));
+        plane->commitTextureOperations(state.rhi(), state.resourceUpdateBatch());
+        *texture = plane;
+    }
+};
+
+QSGMaterialShader *QuickVideoMaterial::createShader(QSGRendererInterface::RenderMode renderMode) const
+{
+    Q_UNUSED(renderMode);
+    return new QuickVideoShader;
+}
+
+#else
+
+// 顶点属性与场景图的TexturedPoint2D一致
+static const char *quickVertexSource =
+    "attribute highp vec4 qt_VertexPosition;\n"
+    "attribute highp vec2 qt_VertexTexCoord;\n"
+    "uniform highp mat4 qt_Matrix;\n"
+    "varying highp vec2 v_texCoord;\n"
+    "void main() {\n"
+    "    v_texCoord = qt_VertexTexCoord;\n"
+    "    gl_Position = qt_Matrix * qt_VertexPosition;\n"
+    "}\n";
+
+// uniform命名与OpenGLVideoWidget的YUV着色器一致，可直接复用setYUVUniforms；
+// 采样方式由u_flags选择（同一项的格式可能逐帧变化，不按变体编译多份）
+static const char *quickFragmentSource =
+    "#ifdef GL_ES\n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "#endif\n"
+    "uniform sampler2D u_textureY;\n"
+    "uniform sampler2D u_textureU;\n"
+    "uniform sampler2D u_textureV;\n"
+    "uniform mat3 u_colorMatrix;\n"
+    "uniform vec3 u_colorOffset;\n"
+    "uniform float u_sampleScale;\n"
+    "uniform vec4 u_flags;\n"                // x:半平面 y:VU顺序 z:16位样本 w:RGBA单平面
+    "uniform float qt_Opacity;\n"
+    "varying vec2 v_texCoord;\n"
+    "float sample16(vec2 lh) {\n"
+    "    return (lh.x * 255.0 + lh.y * 65280.0) / 65535.0;\n"
+    "}\n"
+    "void main() {\n"
+    "    if (u_flags.w > 0.5) {\n"
+    "        gl_FragColor = texture2D(u_textureY, v_texCoord) * qt_Opacity;\n"
+    "        return;\n"
+    "    }\n"
+    "    bool is16 = u_flags.z > 0.5;\n"
+    "    vec3 yuv;\n"
+    "    vec4 y = texture2D(u_textureY, v_texCoord);\n"
+    "    yuv.x = is16 ? sample16(y.ra) : y.r;\n"
+    "    if (u_flags.x > 0.5) {\n"
+    "        vec4 c = texture2D(u_textureU, v_texCoord);\n"
+    "        yuv.yz = is16 ? vec2(sample16(c.rg), sample16(c.ba)) : c.ra;\n"
+    "        if (u_flags.y > 0.5)\n"
+    "            yuv.yz = yuv.zy;\n"
+    "    } else {\n"
+    "        vec4 u = texture2D(u_textureU, v_texCoord);\n"
+    "        vec4 v = texture2D(u_textureV, v_texCoord);\n"
+    "        yuv.y = is16 ? sample16(u.ra) : u.r;\n"
+    "        yuv.z = is16 ? sample16(v.ra) : v.r;\n"
+    "    }\n"
+    "    yuv *= u_sampleScale;\n"
+    "    vec3 rgb = u_colorMatrix * (yuv - u_colorOffset);\n"
+    "    gl_FragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0) * qt_Opacity;\n"
+    "}\n";
+
+/**
+ * @brief OpenGL场景图着色器
+ */
+class QuickVideoShader : public QSGMaterialShader
+{
+public:
+    const char *vertexShader() const override { return quickVertexSource; }
+    const char *fragmentShader() const override { return quickFragmentSource; }
+
+    char const *const *attributeNames() const override
+    {
+        static const char *const names[] = {"qt_VertexPosition", "qt_VertexTexCoord", nullptr};
+        return names;
+    }
+
+    void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) override
+    {
+        Q_UNUSED(oldMaterial);
+        QOpenGLShaderProgram *program = this->program();
+        if (state.isMatrixDirty())
+            program->setUniformValue(m_matrixId, state.combinedMatrix());
+        if (state.isOpacityDirty())
+            program->setUniformValue(m_opacityId, state.opacity());
+
+        QuickVideoMaterial *material = static_cast<QuickVideoMaterial*>(newMaterial);
+        QOpenGLFunctions *f = state.context()->functions();
+        // 纹理单元与setYUVUniforms一致（Y=0 U=1 V=2），最后回到单元0
+        for (int i = material->planeCount() - 1; i >= 0; --i)
+        {
+            f->glActiveTexture(GL_TEXTURE0 + i);
+            material->plane(i)->bind();
+        }
+
+        OpenGLVideoWidget::setYUVUniforms(program, material->format, material->colorSpace);
+        program->setUniformValue(m_flagsId, material->flags());
+    }
+
+protected:
+    void initialize() override
+    {
+        m_matrixId = program()->uniformLocation("qt_Matrix");
+        m_opacityId = program()->uniformLocation("qt_Opacity");
+        m_flagsId = program()->uniformLocation("u_flags");
+    }
+
+private:
+    int m_matrixId = -1;
+    int m_opacityId = -1;
+    int m_flagsId = -1;
+};
+
+QSGMaterialShader *QuickVideoMaterial::createShader() const
+{
+    return new QuickVideoShader;
+}
+
+#endif
+
+// ==================== 帧上传 ====================
+
+/**
+ * @brief 把解码帧设置到材质（渲染线程调用），实际上传在纹理绑定/提交时进行
+ */
+static bool applyFrame(QuickVideoMaterial *material, VideoFrameSink *sink, const VideoFramePtr &frame)
+{
+    const AVPixelFormat pixelFormat = static_cast<AVPixelFormat>(frame->format);
+    if (FFmpegDecoderThread::isDirectRenderFormat(pixelFormat))
+    {
+        const OpenGLVideoWidget::YUVFormat format =
+            toGLYUVFormat(pixelFormat, frame->colorspace, frame->color_range);
+
+        int widths[3], heights[3], bytesPerPixel[3];
+        const int count = OpenGLVideoWidget::planeGeometry(format, frame->width, frame->height,
+                                                           widths, heights, bytesPerPixel);
+        bool direct = true;
+        for (int i = 0; i < count; ++i)
+        {
+            // 负步长（倒置帧）交给RGB回退
+            if (!frame->data[i] || frame->linesize[i] <= 0)
+                direct = false;
+        }
+
+        if (direct)
+        {
+            for (int i = 0; i < count; ++i)
+                material->plane(i)->setPlane(frame, frame->data[i], frame->linesize[i],
+                                             widths[i], heights[i], bytesPerPixel[i]);
+            material->format = format;
+            material->colorSpace = OpenGLVideoWidget::autoSelectColorSpace(frame->width, frame->height);
+            material->rgb = false;
+            material->frameSize = QSize(frame->width, frame->height);
+            return true;
+        }
+    }
+
+    // 无法直接采样的格式按显示尺寸转换后上传
+    QImage image = sink->convertToImage(frame.get());
+    if (image.isNull())
+        return false;
+    material->plane(0)->setImage(image.convertToFormat(QImage::Format_RGBA8888));
+    material->rgb = true;
+    material->frameSize = QSize(frame->width, frame->height);
+    return true;
+}
+
+// ==================== QuickVideoItem ====================
+
+QuickVideoItem::QuickVideoItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_sink_(new VideoFrameSink(this))
+{
+    setFlag(ItemHasContents, true);
+    // 端点在解码线程中发出通知，update()只请求下一次同步，多帧到达时自然合并
+    connect(m_sink_, &VideoFrameSink::frameAvailable, this, &QQuickItem::update, Qt::QueuedConnection);
+}
+
+QuickVideoItem::~QuickVideoItem()
+{
+    closeSource();
+}
+
+void QuickVideoItem::registerQmlType()
+{
+    static bool registered = false;
+    if (registered)
+        return;
+    registered = true;
+    qmlRegisterType<QuickVideoItem>("ViewTools.Media", 1, 0, "FFmpegVideoItem");
+}
+
+void QuickVideoItem::setSource(const QString &url)
+{
+    if (url == m_source)
+        return;
+
+    closeSource();
+    m_source = url;
+    if (!url.isEmpty())
+    {
+        m_session = SingletonTemplate<VideoStreamRegistry>::getSingletonInstance().acquire(url);
+        if (m_session)
+        {
+            updateOutputSize();
+            m_session->addVideoSink(m_sink_);
+        }
+        else
+        {
+            qWarning() << "QuickVideoItem: failed to open" << url;
+        }
+    }
+    emit sourceChanged();
+    update();
+}
+
+void QuickVideoItem::closeSource()
+{
+    if (!m_session)
+        return;
+
+    // 先解除挂接，确保解码线程不再访问本项的端点
+    m_session->removeVideoSink(m_sink_);
+    m_session.reset();
+    m_lastPtsMs = 0;
+}
+
+void QuickVideoItem::updateOutputSize()
+{
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    m_sink_->setOutputSize(QSizeF(width() * dpr, height() * dpr).toSize());
+}
+
+#if QT_VERSION_MAJOR >= 6
+void QuickVideoItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    updateOutputSize();
+    update();
+}
+#else
+void QuickVideoItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    updateOutputSize();
+    update();
+}
+#endif
+
+QSGNode *QuickVideoItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    // 根节点为黑底矩形，画面节点作为其子节点按比例居中
+    QSGRectangleNode *root = static_cast<QSGRectangleNode*>(oldNode);
+    if (!root)
+    {
+        root = window()->createRectangleNode();
+        root->setColor(Qt::black);
+    }
+    const QRectF bounds = boundingRect();
+    root->setRect(bounds);
+
+    QSGGeometryNode *videoNode = static_cast<QSGGeometryNode*>(root->firstChild());
+
+    // 会话关闭后清除画面
+    if (!m_session && videoNode)
+    {
+        root->removeChildNode(videoNode);
+        delete videoNode;
+        videoNode = nullptr;
+    }
+
+    VideoFramePtr frame;
+    qint64 ptsMs = 0;
+    if (m_session && m_sink_->takeLatestFrame(frame, &ptsMs))
+    {
+        if (!videoNode)
+        {
+            videoNode = new QSGGeometryNode;
+            QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4);
+            geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+            videoNode->setGeometry(geometry);
+            videoNode->setMaterial(new QuickVideoMaterial);
+            videoNode->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+            root->appendChildNode(videoNode);
+        }
+
+        QuickVideoMaterial *material = static_cast<QuickVideoMaterial*>(videoNode->material());
+        if (applyFrame(material, m_sink_, frame))
+        {
+            m_lastPtsMs = ptsMs;
+            videoNode->markDirty(QSGNode::DirtyMaterial);
+        }
+    }
+
+    if (videoNode)
+    {
+        QuickVideoMaterial *material = static_cast<QuickVideoMaterial*>(videoNode->material());
+        if (!material->plane(0)->hasData())
+        {
+            // 首帧转换失败，暂不显示
+            root->removeChildNode(videoNode);
+            delete videoNode;
+            return root;
+        }
+
+        QSizeF fitted = QSizeF(material->frameSize).scaled(bounds.size(), Qt::KeepAspectRatio);
+        QRectF videoRect(QPointF(0, 0), fitted);
+        videoRect.moveCenter(bounds.center());
+        QSGGeometry::updateTexturedRectGeometry(videoNode->geometry(), videoRect, QRectF(0, 0, 1, 1));
+        videoNode->markDirty(QSGNode::DirtyGeometry);
+    }
+    return root;
+}
+
+#endif // QUICK_VIDEO_ENABLE && OPENGL_ENABLE
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,93 @@
+/*****************************************************************
+File:        quick_video_item.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: QtQuick场景图视频项
+             通过VideoStreamRegistry附加到共享的FFmpeg解码会话，与OpenGLVideoWidget、视频墙
+             使用同一套帧接口（VideoFrameSink）与同一套YUV格式/色彩矩阵
+             - 在场景图渲染线程的updatePaintNode中取零拷贝的原始帧，上传为各平面QSGTexture
+             - QSGMaterial着色器直接采样YUV平面（8/16位、平面/半平面），无法直接采样的格式回退为RGBA
+             - Qt5为OpenGL场景图；Qt6经RHI（任意图形API），着色器构建时编译为qsb
+    使用方式：
+        QuickVideoItem::registerQmlType();
+        // QML:
+        // import ViewTools.Media 1.0
+        // FFmpegVideoItem { anchors.fill: parent; source: "rtsp://..." }
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _QUICK_VIDEO_ITEM_H
+#define _QUICK_VIDEO_ITEM_H
+
+#if defined(QUICK_VIDEO_ENABLE) && defined(OPENGL_ENABLE)
+
+#include <QQuickItem>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+class FFmpegDecoderThread;
+class VideoFrameSink;
+
+class QuickVideoItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QString source READ source WRITE setSource NOTIFY sourceChanged)
+
+public:
+    explicit QuickVideoItem(QQuickItem *parent = nullptr);
+    ~QuickVideoItem() override;
+
+    /**
+     * @brief 注册QML类型（import ViewTools.Media 1.0 / FFmpegVideoItem）
+     */
+    static void registerQmlType();
+
+    QString source() const { return m_source; }
+
+    /**
+     * @brief 设置视频源，打开（或附加到）对应URL的解码会话；空字符串表示关闭
+     */
+    void setSource(const QString &url);
+
+    /** 最近显示帧的时间戳（毫秒） */
+    qint64 lastPtsMs() const { return m_lastPtsMs.load(); }
+
+signals:
+    void sourceChanged();
+
+protected:
+    /**
+     * @brief 场景图同步（渲染线程调用，GUI线程阻塞）：取最新帧并更新纹理与几何
+     */
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+#if QT_VERSION_MAJOR >= 6
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#else
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#endif
+
+private:
+    void closeSource();
+    /** 回退路径的转换尺寸跟随显示尺寸 */
+    void updateOutputSize();
+
+    std::shared_ptr<FFmpegDecoderThread> m_session;
+    VideoFrameSink *m_sink_ = nullptr;
+    QString m_source;
+    std::atomic<qint64> m_lastPtsMs{0};     ///< 渲染线程写入
+};
+
+#endif // QUICK_VIDEO_ENABLE && OPENGL_ENABLE
+
+#endif // _QUICK_VIDEO_ITEM_H
+
+#endif // CAN_USE_FFMPEG
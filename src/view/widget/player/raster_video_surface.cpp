@@ -0,0 +1,156 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "raster_video_surface.h"
+
+#include <QElapsedTimer>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+
+#include <cstdlib>
+
+RasterVideoSurface::RasterVideoSurface(QWidget *parent)
+    : QWidget(parent)
+{
+    // 每次绘制都会覆盖重绘区域内的全部像素，无需Qt先擦除背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAutoFillBackground(false);
+}
+
+void RasterVideoSurface::setFrame(const QImage &frame)
+{
+    if (frame.isNull())
+    {
+        clear();
+        return;
+    }
+
+    const QRect oldRect = m_videoRect;
+    const QSize oldSize = m_frame.size();
+    m_frame = frame;
+    m_scaledDirty = true;
+    m_framePending = true;
+    ++m_stats.frames;
+
+    if (frame.size() != oldSize)
+        layoutVideoRect();
+
+    // 画面区域不变时只重绘画面，黑边保持不动
+    if (m_videoRect == oldRect)
+        update(m_videoRect);
+    else
+        update();
+}
+
+void RasterVideoSurface::clear()
+{
+    m_frame = QImage();
+    m_scaledDirty = false;
+    m_framePending = false;
+    layoutVideoRect();
+    update();
+}
+
+void RasterVideoSurface::setSmoothScaling(bool smooth)
+{
+    if (m_smooth == smooth)
+        return;
+
+    m_smooth = smooth;
+    m_scaledDirty = true;
+    update(m_videoRect);
+}
+
+void RasterVideoSurface::resetStats()
+{
+    m_stats = Stats();
+    m_scaleTotalMs = 0.0;
+}
+
+void RasterVideoSurface::layoutVideoRect()
+{
+    if (m_frame.isNull() || width() <= 0 || height() <= 0)
+    {
+        m_videoRect = QRect();
+        m_targetSize = QSize();
+        m_direct = false;
+        return;
+    }
+
+    const qreal dpr = devicePixelRatioF();
+    const QSize deviceSize = size() * dpr;
+    QSize target = m_frame.size().scaled(deviceSize, Qt::KeepAspectRatio);
+
+    // 解码端已按显示尺寸缩放时，取整误差内视为一致，直接按帧尺寸绘制
+    const QSize frameSize = m_frame.size();
+    m_direct = frameSize.width() <= deviceSize.width() && frameSize.height() <= deviceSize.height()
+               && std::abs(frameSize.width() - target.width()) <= 1
+               && std::abs(frameSize.height() - target.height()) <= 1;
+    if (m_direct)
+        target = frameSize;
+
+    m_targetSize = target;
+    const QSize logicalSize(qRound(target.width() / dpr), qRound(target.height() / dpr));
+    m_videoRect = QRect(QPoint(0, 0), logicalSize);
+    m_videoRect.moveCenter(rect().center());
+    m_scaledDirty = true;
+}
+
+void RasterVideoSurface::updateScaledImage()
+{
+    m_scaledDirty = false;
+    if (m_direct || m_targetSize.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 显示尺寸不变时复用同一块存储
+    if (m_scaled.size() != m_targetSize)
+        m_scaled = QImage(m_targetSize, QImage::Format_RGB32);
+
+    QPainter painter(&m_scaled);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_smooth);
+    painter.drawImage(m_scaled.rect(), m_frame);
+    painter.end();
+
+    ++m_stats.scaledFrames;
+    m_stats.lastScaleMs = timer.nsecsElapsed() / 1e6;
+    m_scaleTotalMs += m_stats.lastScaleMs;
+    m_stats.avgScaleMs = m_scaleTotalMs / m_stats.scaledFrames;
+}
+
+void RasterVideoSurface::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+
+    // 黑边：只填充本次重绘区域中画面以外的部分
+    const QRegion bars = m_videoRect.isEmpty() ? event->region() : event->region().subtracted(m_videoRect);
+    for (const QRect &bar : bars)
+        painter.fillRect(bar, Qt::black);
+
+    if (m_frame.isNull() || m_videoRect.isEmpty() || !event->rect().intersects(m_videoRect))
+        return;
+
+    if (m_scaledDirty)
+        updateScaledImage();
+    if (m_framePending)
+    {
+        m_framePending = false;
+        ++m_stats.paintedFrames;
+    }
+
+    // 源图像已是设备像素尺寸，绘制时不再缩放
+    painter.drawImage(QRectF(m_videoRect), m_direct ? m_frame : m_scaled);
+}
+
+void RasterVideoSurface::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    layoutVideoRect();
+    update();
+}
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,96 @@
+/*****************************************************************
+File:        raster_video_surface.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: 软件渲染视频表面（无GPU时的显示组件）
+             在paintEvent中直接绘制最新帧，替代逐帧新建QPixmap、平滑缩放再QLabel::setPixmap的方式
+             - 缩放结果写入复用的QImage，显示尺寸不变时不重新分配；仅在绘制时缩放，被合并的更新不做缩放
+             - 帧已由解码端缩放到显示尺寸（相差不超过1像素）时按1:1绘制，不做平滑缩放
+             - WA_OpaquePaintEvent，新帧只更新画面区域，黑边仅在其所在区域需要重绘时填充
+    使用方式：
+        RasterVideoSurface *surface = new RasterVideoSurface(parent);
+        surface->setFrame(image);    // GUI线程，图像隐式共享不拷贝
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _RASTER_VIDEO_SURFACE_H
+#define _RASTER_VIDEO_SURFACE_H
+
+#include <QImage>
+#include <QRect>
+#include <QWidget>
+
+class RasterVideoSurface : public QWidget
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 缩放统计
+     */
+    struct Stats
+    {
+        qint64 frames = 0;          ///< 已设置的帧数
+        qint64 paintedFrames = 0;   ///< 实际绘制的新帧数（其余被合并）
+        qint64 scaledFrames = 0;    ///< 需要缩放的帧数（其余按1:1绘制）
+        double lastScaleMs = 0.0;   ///< 最近一次缩放耗时
+        double avgScaleMs = 0.0;    ///< 平均缩放耗时
+    };
+
+    explicit RasterVideoSurface(QWidget *parent = nullptr);
+
+    /**
+     * @brief 设置新帧（GUI线程调用）
+     * @param frame 视频帧，RGB32/ARGB32格式无需转换
+     */
+    void setFrame(const QImage &frame);
+
+    /** 清空画面（显示黑屏） */
+    void clear();
+
+    bool hasFrame() const { return !m_frame.isNull(); }
+    QImage frame() const { return m_frame; }
+
+    /**
+     * @brief 需要缩放时是否平滑插值（默认开启，关闭可降低低端CPU的缩放耗时）
+     * 帧尺寸已与显示区域一致时始终按1:1绘制，与此设置无关
+     */
+    void setSmoothScaling(bool smooth);
+    bool smoothScaling() const { return m_smooth; }
+
+    /** 画面区域（逻辑坐标，保持宽高比居中） */
+    QRect videoRect() const { return m_videoRect; }
+
+    Stats stats() const { return m_stats; }
+    void resetStats();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    /** 按帧尺寸与组件尺寸计算画面区域与设备像素尺寸 */
+    void layoutVideoRect();
+    /** 把当前帧缩放到复用图像中（仅在绘制时调用） */
+    void updateScaledImage();
+
+    QImage m_frame;                 ///< 最新帧（隐式共享）
+    QImage m_scaled;                ///< 缩放后的帧（尺寸不变时复用存储）
+    QRect m_videoRect;              ///< 画面区域（逻辑坐标）
+    QSize m_targetSize;             ///< 画面区域的设备像素尺寸
+    bool m_direct = false;          ///< 帧尺寸与显示区域一致，按1:1绘制
+    bool m_scaledDirty = false;     ///< 缩放图像需要更新
+    bool m_framePending = false;    ///< 新帧尚未绘制
+    bool m_smooth = true;
+    Stats m_stats;
+    double m_scaleTotalMs = 0.0;
+};
+
+#endif // _RASTER_VIDEO_SURFACE_H
+
+#endif // CAN_USE_FFMPEG
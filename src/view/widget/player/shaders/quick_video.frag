@@ -0,0 +1,54 @@
+#version 440
+
+// QuickVideoItem片段着色器（Qt6 RHI）
+// 平面纹理格式：8位样本为R8；16位样本为RG8（低字节在r，高字节在g）；
+// 半平面色度8位为RG8（U在r，V在g），16位为RGBA8（U在rg，V在ba）
+
+layout(location = 0) in vec2 v_texCoord;
+layout(location = 0) out vec4 fragColor;
+
+layout(std140, binding = 0) uniform buf {
+    mat4 qt_Matrix;
+    mat4 colorMatrix;
+    vec4 colorOffset;
+    vec4 flags;
+    float qt_Opacity;
+};
+
+layout(binding = 1) uniform sampler2D textureY;
+layout(binding = 2) uniform sampler2D textureU;
+layout(binding = 3) uniform sampler2D textureV;
+
+float sample16(vec2 lh)
+{
+    return (lh.x * 255.0 + lh.y * 65280.0) / 65535.0;
+}
+
+void main()
+{
+    if (flags.w > 0.5) {
+        fragColor = texture(textureY, v_texCoord) * qt_Opacity;
+        return;
+    }
+
+    bool is16 = flags.z > 0.5;
+    vec3 yuv;
+    vec4 y = texture(textureY, v_texCoord);
+    yuv.x = is16 ? sample16(y.rg) : y.r;
+
+    if (flags.x > 0.5) {
+        vec4 c = texture(textureU, v_texCoord);
+        yuv.yz = is16 ? vec2(sample16(c.rg), sample16(c.ba)) : c.rg;
+        if (flags.y > 0.5)
+            yuv.yz = yuv.zy;
+    } else {
+        vec4 u = texture(textureU, v_texCoord);
+        vec4 v = texture(textureV, v_texCoord);
+        yuv.y = is16 ? sample16(u.rg) : u.r;
+        yuv.z = is16 ? sample16(v.rg) : v.r;
+    }
+
+    yuv *= colorOffset.w;
+    vec3 rgb = mat3(colorMatrix) * (yuv - colorOffset.xyz);
+    fragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0) * qt_Opacity;
+}
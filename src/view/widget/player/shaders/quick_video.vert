@@ -0,0 +1,23 @@
+#version 440
+
+// QuickVideoItem顶点着色器（Qt6 RHI，构建时经qt6_add_shaders编译为qsb）
+
+layout(location = 0) in vec4 qt_VertexPosition;
+layout(location = 1) in vec2 qt_VertexTexCoord;
+
+layout(location = 0) out vec2 v_texCoord;
+
+// 与片段着色器共用的uniform块，布局与QuickVideoShader::updateUniformData一致
+layout(std140, binding = 0) uniform buf {
+    mat4 qt_Matrix;         // 偏移0
+    mat4 colorMatrix;       // 偏移64，YUV到RGB矩阵（按mat4存放，避免std140的mat3填充）
+    vec4 colorOffset;       // 偏移128，xyz为YUV偏移，w为16位样本归一化系数
+    vec4 flags;             // 偏移144，x:半平面 y:VU顺序 z:16位样本 w:RGBA单平面
+    float qt_Opacity;       // 偏移160
+};
+
+void main()
+{
+    v_texCoord = qt_VertexTexCoord;
+    gl_Position = qt_Matrix * qt_VertexPosition;
+}
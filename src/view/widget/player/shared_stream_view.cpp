@@ -0,0 +1,76 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "shared_stream_view.h"
+
+#include <QDebug>
+#include <QResizeEvent>
+
+#include "ffmpeg_player_widget.h"
+#include "video_frame_sink.h"
+#include "video_stream_registry.h"
+
+SharedStreamView::SharedStreamView(QWidget *parent)
+    : RasterVideoSurface(parent)
+    , m_sink_(new VideoFrameSink(this))
+{
+    connect(m_sink_, &VideoFrameSink::frameAvailable, this, &SharedStreamView::onFrameAvailable, Qt::QueuedConnection);
+}
+
+SharedStreamView::~SharedStreamView()
+{
+    close();
+}
+
+bool SharedStreamView::open(const QString &url)
+{
+    close();
+
+    m_session = SingletonTemplate<VideoStreamRegistry>::getSingletonInstance().acquire(url);
+    if (!m_session)
+        return false;
+
+    m_url = url;
+    updateOutputSize();
+    m_session->addVideoSink(m_sink_);
+    return true;
+}
+
+void SharedStreamView::close()
+{
+    if (!m_session)
+        return;
+
+    // 先解除挂接，确保解码线程不再访问本视图的端点
+    m_session->removeVideoSink(m_sink_);
+    m_session.reset();
+    m_url.clear();
+    clear();
+}
+
+void SharedStreamView::onFrameAvailable()
+{
+    // 不可见时仍需取走帧，否则端点不会再发出通知；此时跳过转换
+    if (!isVisible())
+    {
+        VideoFramePtr frame;
+        m_sink_->takeLatestFrame(frame, &m_lastPtsMs);
+        return;
+    }
+
+    QImage image;
+    if (m_sink_->takeLatestImage(image, &m_lastPtsMs))
+        setFrame(image);
+}
+
+void SharedStreamView::updateOutputSize()
+{
+    m_sink_->setOutputSize(size() * devicePixelRatioF());
+}
+
+void SharedStreamView::resizeEvent(QResizeEvent *event)
+{
+    RasterVideoSurface::resizeEvent(event);
+    updateOutputSize();
+}
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,63 @@
+/*****************************************************************
+File:        shared_stream_view.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 共享解码会话的轻量视频视图
+             通过VideoStreamRegistry按URL附加到已有解码会话，
+             按自身显示尺寸缩放转换，适用于电视墙分格、放大详情等同一路流多处显示的场景
+             端点已按显示尺寸缩放，经RasterVideoSurface按1:1绘制，不再二次缩放
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            改为继承RasterVideoSurface绘制
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _SHARED_STREAM_VIEW_H
+#define _SHARED_STREAM_VIEW_H
+
+#include <memory>
+
+#include "raster_video_surface.h"
+
+class FFmpegDecoderThread;
+class VideoFrameSink;
+
+class SharedStreamView : public RasterVideoSurface
+{
+    Q_OBJECT
+public:
+    explicit SharedStreamView(QWidget *parent = nullptr);
+    ~SharedStreamView() override;
+
+    /**
+     * @brief 打开（或附加到）指定URL的解码会话
+     * @return false表示会话打开失败
+     */
+    bool open(const QString &url);
+    /** 解除附加，最后一个视图解除时会话自动关闭 */
+    void close();
+
+    QString url() const { return m_url; }
+    /** 最近显示帧的时间戳（毫秒） */
+    qint64 lastPtsMs() const { return m_lastPtsMs; }
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void onFrameAvailable();
+    void updateOutputSize();
+
+    std::shared_ptr<FFmpegDecoderThread> m_session;
+    VideoFrameSink *m_sink_;
+    QString m_url;
+    qint64 m_lastPtsMs = 0;
+};
+
+#endif // _SHARED_STREAM_VIEW_H
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,122 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "video_frame_sink.h"
+
+#include <QDebug>
+
+VideoFramePtr makeVideoFramePtr(const AVFrame *frame)
+{
+    if (!frame)
+        return VideoFramePtr();
+
+    AVFrame *ref = av_frame_clone(frame);
+    if (!ref)
+        return VideoFramePtr();
+
+    return VideoFramePtr(ref, [](AVFrame *f) { av_frame_free(&f); });
+}
+
+VideoFrameSink::VideoFrameSink(QObject *parent)
+    : QObject(parent)
+{
+}
+
+VideoFrameSink::~VideoFrameSink()
+{
+    if (m_swsCtx)
+    {
+        sws_freeContext(m_swsCtx);
+        m_swsCtx = nullptr;
+    }
+}
+
+void VideoFrameSink::pushFrame(const VideoFramePtr &frame, qint64 ptsMs)
+{
+    if (!frame)
+        return;
+
+    PendingFrame pending;
+    pending.frame = frame;
+    pending.ptsMs = ptsMs;
+    if (m_mailbox.publish(std::move(pending)))
+        emit frameAvailable();
+}
+
+bool VideoFrameSink::takeLatestFrame(VideoFramePtr &frame, qint64 *ptsMs)
+{
+    if (!m_mailbox.fetch())
+        return false;
+
+    PendingFrame pending = m_mailbox.take();
+    if (!pending.frame)
+        return false;
+
+    frame = std::move(pending.frame);
+    if (ptsMs)
+        *ptsMs = pending.ptsMs;
+    return true;
+}
+
+bool VideoFrameSink::takeLatestImage(QImage &image, qint64 *ptsMs)
+{
+    VideoFramePtr frame;
+    if (!takeLatestFrame(frame, ptsMs))
+        return false;
+
+    QImage converted = convertToImage(frame.get());
+    if (converted.isNull())
+        return false;
+
+    image = converted;
+    return true;
+}
+
+QImage VideoFrameSink::convertToImage(const AVFrame *frame)
+{
+    if (!frame || frame->width <= 0 || frame->height <= 0)
+        return QImage();
+
+    // 按源宽高比缩放到不超过输出尺寸，且不放大（放大交给渲染端）
+    QSize dstSize(frame->width, frame->height);
+    if (m_outputSize.isValid() &&
+        (m_outputSize.width() < frame->width || m_outputSize.height() < frame->height))
+    {
+        dstSize.scale(m_outputSize, Qt::KeepAspectRatio);
+        dstSize = dstSize.expandedTo(QSize(2, 2));
+    }
+
+    if (!m_swsCtx || m_srcWidth != frame->width || m_srcHeight != frame->height ||
+        m_srcFormat != frame->format || m_dstSize != dstSize)
+    {
+        if (m_swsCtx)
+            sws_freeContext(m_swsCtx);
+
+        m_swsCtx = sws_getContext(frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                  dstSize.width(), dstSize.height(), AV_PIX_FMT_RGB32,
+                                  SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!m_swsCtx)
+        {
+            qWarning() << "VideoFrameSink: failed to create sws context for" << dstSize;
+            return QImage();
+        }
+        m_srcWidth = frame->width;
+        m_srcHeight = frame->height;
+        m_srcFormat = frame->format;
+        m_dstSize = dstSize;
+    }
+
+    // 直接写入QImage的像素缓冲，省去中间拷贝
+    QImage image(dstSize, QImage::Format_RGB32);
+    if (image.isNull())
+        return QImage();
+
+    uint8_t *dstData[1] = {image.bits()};
+    int dstLinesize[1] = {static_cast<int>(image.bytesPerLine())};
+    int ret = sws_scale(m_swsCtx, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+    if (ret <= 0)
+        return QImage();
+
+    return image;
+}
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,109 @@
+/*****************************************************************
+File:        video_frame_sink.h
+Version:     1.0
+Author:      cjx
+Date:        2026-10-19
+Description: 视频帧分发端点，一个解码线程可同时向多个渲染目标输出
+             解码线程只投递引用计数的AVFrame（av_frame_ref，不拷贝像素），
+             每个端点按自己的输出尺寸在消费者线程中转换，且只转换真正要显示的帧
+    使用方式：
+        1. 创建端点并设置输出尺寸，通过FFmpegDecoderThread::addVideoSink()挂接
+        2. 收到frameAvailable后调用takeLatestImage()（RGB32）或takeLatestFrame()（原始帧）
+        3. 销毁前调用removeVideoSink()解除挂接
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _VIDEO_FRAME_SINK_H
+#define _VIDEO_FRAME_SINK_H
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+
+#include <memory>
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+#include "frame_mailbox.h"
+
+/** 引用计数的解码帧，最后一个持有者释放时归还解码器缓冲 */
+using VideoFramePtr = std::shared_ptr<AVFrame>;
+
+/**
+ * @brief 为解码帧新建一个引用（不拷贝像素数据）
+ * @return 失败返回空指针
+ */
+VideoFramePtr makeVideoFramePtr(const AVFrame *frame);
+
+class VideoFrameSink : public QObject
+{
+    Q_OBJECT
+public:
+    explicit VideoFrameSink(QObject *parent = nullptr);
+    ~VideoFrameSink() override;
+
+    /**
+     * @brief 设置输出尺寸（消费者线程调用）
+     * @param size 目标尺寸，无效尺寸表示保持源尺寸；按源宽高比缩放到不超过该尺寸
+     */
+    void setOutputSize(const QSize &size) { m_outputSize = size; }
+    QSize outputSize() const { return m_outputSize; }
+
+    /**
+     * @brief 投递新帧（解码线程调用）
+     * 只保留最新一帧，消费者来不及取走的旧帧直接释放
+     */
+    void pushFrame(const VideoFramePtr &frame, qint64 ptsMs);
+
+    /**
+     * @brief 取出最新原始帧（零拷贝，供自行上传纹理的渲染器使用）
+     * @return true表示有新帧
+     */
+    bool takeLatestFrame(VideoFramePtr &frame, qint64 *ptsMs = nullptr);
+
+    /**
+     * @brief 取出最新帧并按输出尺寸转换为RGB32
+     * @return true表示有新帧且转换成功
+     */
+    bool takeLatestImage(QImage &image, qint64 *ptsMs = nullptr);
+
+    /**
+     * @brief 按输出尺寸把原始帧转换为RGB32（消费者线程调用，复用本端点的转换上下文）
+     * 供自行上传纹理的渲染器处理无法直接采样的像素格式
+     */
+    QImage convertToImage(const AVFrame *frame);
+
+signals:
+    /** 有新帧待取（仅在上一帧已被取走时发出，最多一个在途通知） */
+    void frameAvailable();
+
+private:
+    struct PendingFrame
+    {
+        VideoFramePtr frame;
+        qint64 ptsMs = 0;
+    };
+
+    FrameMailbox<PendingFrame> m_mailbox;
+    QSize m_outputSize;
+
+    // 转换上下文（仅消费者线程访问），源或目标参数变化时重建
+    SwsContext *m_swsCtx = nullptr;
+    int m_srcWidth = 0;
+    int m_srcHeight = 0;
+    int m_srcFormat = -1;
+    QSize m_dstSize;
+};
+
+#endif // _VIDEO_FRAME_SINK_H
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,110 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "video_stream_registry.h"
+
+#include <QDebug>
+
+#include "ffmpeg_player_widget.h"
+
+VideoStreamRegistry::DecoderPtr VideoStreamRegistry::acquire(const QString &url)
+{
+    const QString key = normalizeUrl(url);
+    if (key.isEmpty())
+        return nullptr;
+
+    DecoderPtr existing;
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_sessions.find(key);
+        if (it != m_sessions.end())
+        {
+            existing = it.value().lock();
+            if (!existing)
+                m_sessions.erase(it);
+        }
+    }
+
+    if (existing)
+    {
+        // 解码线程已结束（本地文件播放到结尾、重连失败）时原地重新打开，已挂接的分发端点保持不变
+        if (!existing->isRunning())
+        {
+            qDebug() << "VideoStreamRegistry: session stopped, reopening" << key;
+            if (!existing->openMedia(key))
+            {
+                qWarning() << "VideoStreamRegistry: failed to reopen" << key;
+                return nullptr;
+            }
+        }
+        qDebug() << "VideoStreamRegistry: attach to existing session" << key
+                 << "holders:" << existing.use_count() - 1;
+        return existing;
+    }
+
+    // 新建会话：只向分发端点输出，解码线程不做自身格式转换
+    FFmpegDecoderThread *decoder = new FFmpegDecoderThread();
+    decoder->setPrimaryOutputEnabled(false);
+    if (key.startsWith("rtsp://") || key.startsWith("http://"))
+        decoder->setAutoReconnect(true);
+
+    if (!decoder->openMedia(key))
+    {
+        qWarning() << "VideoStreamRegistry: failed to open" << key;
+        decoder->close(true);
+        delete decoder;
+        return nullptr;
+    }
+    // 共享会话由多个视图使用，默认静音（setMute为切换语义）
+    decoder->setMute();
+
+    DecoderPtr session(decoder, [this, key](FFmpegDecoderThread *d) { release(key, d); });
+
+    QMutexLocker lock(&m_mutex);
+    m_sessions.insert(key, session);
+    qDebug() << "VideoStreamRegistry: session created" << key << "total:" << m_sessions.size();
+    return session;
+}
+
+VideoStreamRegistry::DecoderPtr VideoStreamRegistry::find(const QString &url) const
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_sessions.constFind(normalizeUrl(url));
+    return it != m_sessions.constEnd() ? it.value().lock() : nullptr;
+}
+
+int VideoStreamRegistry::sessionCount() const
+{
+    QMutexLocker lock(&m_mutex);
+    int count = 0;
+    for (const auto &session : m_sessions)
+    {
+        if (!session.expired())
+            count++;
+    }
+    return count;
+}
+
+QString VideoStreamRegistry::normalizeUrl(const QString &url)
+{
+    return url.trimmed();
+}
+
+/**
+ * @brief 最后一个持有者释放时调用：关闭解码线程并移除注册项
+ * 释放期间同一URL可能已被重新打开，只移除已失效的注册项
+ */
+void VideoStreamRegistry::release(const QString &key, FFmpegDecoderThread *decoder)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_sessions.find(key);
+        if (it != m_sessions.end() && it.value().expired())
+            m_sessions.erase(it);
+    }
+
+    qDebug() << "VideoStreamRegistry: session released" << key;
+    decoder->close(true);
+    decoder->deleteLater();
+}
+
+#endif // CAN_USE_FFMPEG
@@ -0,0 +1,66 @@
+/*****************************************************************
+File:        video_stream_registry.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 按URL共享解码会话的注册表
+             同一路流被多个视图（如电视墙分格与放大详情）同时打开时，
+             第二次打开直接附加到已有会话，只保留一条网络连接、一路解码
+    使用方式：
+        1. acquire(url)获取会话，通过addVideoSink()挂接自己的分发端点
+        2. 释放最后一个持有的智能指针时会话自动关闭并从注册表移除
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            已结束的会话在acquire时重新打开
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _VIDEO_STREAM_REGISTRY_H
+#define _VIDEO_STREAM_REGISTRY_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+
+#include "singleton.h"
+
+class FFmpegDecoderThread;
+
+class VideoStreamRegistry
+{
+public:
+    friend SingletonTemplate<VideoStreamRegistry>;
+
+    using DecoderPtr = std::shared_ptr<FFmpegDecoderThread>;
+
+    /**
+     * @brief 获取URL对应的解码会话（GUI线程调用）
+     * 已有会话时直接返回（解码线程已结束时先重新打开）；否则新建会话并打开媒体（仅向分发端点输出、静音、网络流自动重连）
+     * @return 打开失败返回nullptr
+     */
+    DecoderPtr acquire(const QString &url);
+
+    /** 查找已存在的会话，不存在时返回nullptr */
+    DecoderPtr find(const QString &url) const;
+
+    /** 当前存活的会话数 */
+    int sessionCount() const;
+
+private:
+    VideoStreamRegistry() = default;
+
+    static QString normalizeUrl(const QString &url);
+    void release(const QString &key, FFmpegDecoderThread *decoder);
+
+    mutable QMutex m_mutex;
+    QHash<QString, std::weak_ptr<FFmpegDecoderThread>> m_sessions;
+};
+
+#endif // _VIDEO_STREAM_REGISTRY_H
+
+#endif // CAN_USE_FFMPEG
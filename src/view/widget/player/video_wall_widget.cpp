@@ -0,0 +1,916 @@
+#ifdef CAN_USE_FFMPEG
+
+#include "video_wall_widget.h"
+
+#ifdef OPENGL_ENABLE
+
+#include <QDebug>
+#include <QFontMetrics>
+#include <QMatrix4x4>
+#include <QMouseEvent>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QSurfaceFormat>
+#include <QtMath>
+
+#include <cstring>
+
+#include "factory/opengl/program_cache.h"
+#include "ffmpeg_player_widget.h"
+#include "video_frame_sink.h"
+#include "video_stream_registry.h"
+
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
+// ==================== 着色器源码 ====================
+
+// RGBA纹理：RGB回退分格与标签图集共用（变换矩阵与YUV着色器的顶点着色器保持一致）
+static const char *textureVertexSource =
+    "attribute vec4 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform mat4 u_transform;\n"
+    "void main() {\n"
+    "    gl_Position = u_transform * a_position;\n"
+    "    v_texCoord = a_texCoord;\n"
+    "}\n";
+
+static const char *textureFragmentSource =
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform sampler2D u_texture;\n"
+    "varying vec2 v_texCoord;\n"
+    "void main() {\n"
+    "    gl_FragColor = texture2D(u_texture, v_texCoord);\n"
+    "}\n";
+
+// 顶点颜色：所有分格的边框合并为一批三角形
+static const char *solidVertexSource =
+    "attribute vec4 a_position;\n"
+    "attribute vec4 a_color;\n"
+    "varying vec4 v_color;\n"
+    "void main() {\n"
+    "    gl_Position = a_position;\n"
+    "    v_color = a_color;\n"
+    "}\n";
+
+static const char *solidFragmentSource =
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "varying vec4 v_color;\n"
+    "void main() {\n"
+    "    gl_FragColor = v_color;\n"
+    "}\n";
+
+static constexpr int LABEL_PADDING = 4;         // 标签文字内边距（逻辑像素）
+static constexpr int LABEL_MARGIN = 4;          // 标签距分格左上角的距离（逻辑像素）
+
+// 程序取自共享组缓存（SsProgramCache），同组的多面视频墙与播放窗口共用，调用方不得delete
+static QOpenGLShaderProgram *buildProgram(const char *vertex, const char *fragment, const char *name)
+{
+    QOpenGLShaderProgram *program = SsProgramCache::program(vertex, fragment);
+    if (!program)
+        qWarning() << "VideoWallGLWidget:" << name << "shader build failed";
+    return program;
+}
+
+VideoWallGLWidget::VideoWallGLWidget(QWidget *parent)
+    : QOpenGLWidget(parent)
+    , m_quadBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_borderBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_labelBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    // 与OpenGLVideoWidget相同的上下文格式，便于复用其YUV着色器
+    QSurfaceFormat format;
+    format.setRenderableType(QSurfaceFormat::OpenGL);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    format.setVersion(2, 1);
+    format.setSwapInterval(1);
+    format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
+    setFormat(format);
+
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAutoFillBackground(false);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    m_tiles.resize(1);
+    m_fpsTimer.start();
+}
+
+VideoWallGLWidget::~VideoWallGLWidget()
+{
+    closeAll();
+
+    makeCurrent();
+    cleanupGL();
+    doneCurrent();
+}
+
+// ==================== 分格管理 ====================
+
+void VideoWallGLWidget::setGrid(int rows, int columns)
+{
+    rows = qMax(1, rows);
+    columns = qMax(1, columns);
+    if (rows == m_rows && columns == m_columns)
+        return;
+
+    const int count = rows * columns;
+    for (int i = count; i < m_tiles.size(); ++i)
+        closeTile(i);
+
+    m_rows = rows;
+    m_columns = columns;
+    m_tiles.resize(count);
+    if (m_selectedTile >= count)
+        m_selectedTile = -1;
+
+    m_overlayDirty = true;
+    m_labelsDirty = true;
+    updateSinkOutputSizes();
+    update();
+}
+
+bool VideoWallGLWidget::openTile(int index, const QString &url)
+{
+    if (index < 0 || index >= m_tiles.size())
+        return false;
+
+    closeTile(index);
+
+    std::shared_ptr<FFmpegDecoderThread> session =
+        SingletonTemplate<VideoStreamRegistry>::getSingletonInstance().acquire(url);
+    if (!session)
+        return false;
+
+    Tile &tile = m_tiles[index];
+    tile.url = url;
+    tile.session = session;
+    tile.sink = new VideoFrameSink(this);
+    tile.fpsTimer.start();
+    // 端点在解码线程中发出通知；多路同时到达时update()会合并为一次重绘
+    connect(tile.sink, &VideoFrameSink::frameAvailable,
+            this, QOverload<>::of(&VideoWallGLWidget::update), Qt::QueuedConnection);
+    tile.sink->setOutputSize((tileRect(index).size() * devicePixelRatioF()).toSize());
+    session->addVideoSink(tile.sink);
+
+    qDebug() << "VideoWallGLWidget: tile" << index << "opened" << url;
+    return true;
+}
+
+void VideoWallGLWidget::closeTile(int index)
+{
+    if (index < 0 || index >= m_tiles.size())
+        return;
+
+    Tile &tile = m_tiles[index];
+    if (tile.session)
+    {
+        // 先解除挂接，确保解码线程不再访问该端点
+        tile.session->removeVideoSink(tile.sink);
+        tile.session.reset();
+    }
+    delete tile.sink;
+    tile.sink = nullptr;
+
+    // 纹理组回到池中，存储保留给下一路复用
+    releaseTextureSet(tile);
+
+    Tile cleared;
+    cleared.label = tile.label;
+    tile = cleared;
+    update();
+}
+
+void VideoWallGLWidget::closeAll()
+{
+    for (int i = 0; i < m_tiles.size(); ++i)
+        closeTile(i);
+}
+
+QString VideoWallGLWidget::tileUrl(int index) const
+{
+    return (index >= 0 && index < m_tiles.size()) ? m_tiles[index].url : QString();
+}
+
+void VideoWallGLWidget::setTileLabel(int index, const QString &label)
+{
+    if (index < 0 || index >= m_tiles.size() || m_tiles[index].label == label)
+        return;
+
+    m_tiles[index].label = label;
+    m_labelsDirty = true;
+    m_overlayDirty = true;
+    update();
+}
+
+void VideoWallGLWidget::setBorder(int width, const QColor &color, const QColor &selectedColor)
+{
+    m_borderWidth = qMax(0, width);
+    m_borderColor = color;
+    m_selectedColor = selectedColor;
+    m_overlayDirty = true;
+    updateSinkOutputSizes();
+    update();
+}
+
+void VideoWallGLWidget::setSelectedTile(int index)
+{
+    if (index >= m_tiles.size())
+        index = -1;
+    if (index == m_selectedTile)
+        return;
+
+    m_selectedTile = index;
+    m_overlayDirty = true;
+    update();
+}
+
+QRectF VideoWallGLWidget::cellRect(int index) const
+{
+    if (index < 0 || index >= m_tiles.size())
+        return QRectF();
+
+    const qreal cellWidth = static_cast<qreal>(width()) / m_columns;
+    const qreal cellHeight = static_cast<qreal>(height()) / m_rows;
+    return QRectF((index % m_columns) * cellWidth, (index / m_columns) * cellHeight, cellWidth, cellHeight);
+}
+
+QRectF VideoWallGLWidget::tileRect(int index) const
+{
+    return cellRect(index).adjusted(m_borderWidth, m_borderWidth, -m_borderWidth, -m_borderWidth);
+}
+
+int VideoWallGLWidget::tileAt(const QPoint &pos) const
+{
+    if (width() <= 0 || height() <= 0 || !rect().contains(pos))
+        return -1;
+
+    const int column = qMin(m_columns - 1, pos.x() * m_columns / width());
+    const int row = qMin(m_rows - 1, pos.y() * m_rows / height());
+    return row * m_columns + column;
+}
+
+void VideoWallGLWidget::updateSinkOutputSizes()
+{
+    // 输出尺寸只影响无法直接采样、需转换为RGB的格式
+    const qreal dpr = devicePixelRatioF();
+    for (int i = 0; i < m_tiles.size(); ++i)
+    {
+        if (m_tiles[i].sink)
+            m_tiles[i].sink->setOutputSize((tileRect(i).size() * dpr).toSize());
+    }
+}
+
+// ==================== 统计 ====================
+
+VideoWallGLWidget::TileStats VideoWallGLWidget::tileStats(int index) const
+{
+    return (index >= 0 && index < m_tiles.size()) ? m_tiles[index].stats : TileStats();
+}
+
+void VideoWallGLWidget::resetStats()
+{
+    for (Tile &tile : m_tiles)
+    {
+        tile.stats = TileStats();
+        tile.uploadTotalMs = 0.0;
+        tile.fpsFrames = 0;
+        tile.fpsTimer.restart();
+    }
+    m_wallStats = WallStats();
+    m_frameTotalMs = 0.0;
+    m_paintCount = 0;
+    m_fpsFrames = 0;
+    m_fpsTimer.restart();
+}
+
+void VideoWallGLWidget::updateTileFps(Tile &tile)
+{
+    ++tile.fpsFrames;
+    const qint64 elapsed = tile.fpsTimer.elapsed();
+    if (elapsed >= 1000)
+    {
+        tile.stats.fps = tile.fpsFrames * 1000.0f / elapsed;
+        tile.fpsFrames = 0;
+        tile.fpsTimer.restart();
+    }
+}
+
+// ==================== OpenGL ====================
+
+void VideoWallGLWidget::initializeGL()
+{
+    initializeOpenGLFunctions();
+
+    // 上下文重建（如重新挂接父窗口）后旧资源已随旧上下文失效
+    cleanupGL();
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glDisable(GL_DEPTH_TEST);
+
+    QOpenGLContext *ctx = context();
+    const int version = ctx->format().majorVersion() * 10 + ctx->format().minorVersion();
+    m_rowLengthSupported = !ctx->isOpenGLES() || version >= 30 || ctx->hasExtension("GL_EXT_unpack_subimage");
+
+    if (!createPrograms())
+    {
+        qWarning() << "VideoWallGLWidget: failed to create shaders, wall will stay black";
+        return;
+    }
+
+    // 全视口四边形（三角形带），每个分格通过glViewport限定绘制区域
+    const float quad[] = {
+        // 位置(x,y)    纹理坐标(u,v)
+        -1.0f, -1.0f,   0.0f, 1.0f,
+         1.0f, -1.0f,   1.0f, 1.0f,
+        -1.0f,  1.0f,   0.0f, 0.0f,
+         1.0f,  1.0f,   1.0f, 0.0f
+    };
+    m_quadBuffer.create();
+    m_quadBuffer.bind();
+    m_quadBuffer.allocate(quad, sizeof(quad));
+    m_quadBuffer.release();
+
+    m_borderBuffer.create();
+    m_labelBuffer.create();
+
+    glGenTextures(1, &m_labelTexture);
+    glBindTexture(GL_TEXTURE_2D, m_labelTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_overlayDirty = true;
+    m_labelsDirty = true;
+    m_initialized = true;
+
+    qDebug() << "VideoWallGLWidget initialized, grid:" << m_rows << "x" << m_columns
+             << "row length:" << m_rowLengthSupported;
+}
+
+bool VideoWallGLWidget::createPrograms()
+{
+    m_programTexture = buildProgram(textureVertexSource, textureFragmentSource, "texture");
+    m_programSolid = buildProgram(solidVertexSource, solidFragmentSource, "solid");
+    // 最常用的三平面8位变体预先编译，其余变体首次遇到对应格式时编译
+    return m_programTexture && m_programSolid && yuvProgram(OpenGLVideoWidget::SHADER_PLANAR8);
+}
+
+QOpenGLShaderProgram *VideoWallGLWidget::yuvProgram(OpenGLVideoWidget::ShaderVariant variant)
+{
+    if (!m_programsYUV[variant])
+        m_programsYUV[variant] = OpenGLVideoWidget::sharedYUVProgram(variant);
+    return m_programsYUV[variant];
+}
+
+void VideoWallGLWidget::cleanupGL()
+{
+    m_initialized = false;
+    if (!context())
+        return;
+
+    // 程序归共享组缓存所有，这里只放弃引用
+    for (QOpenGLShaderProgram *&program : m_programsYUV)
+        program = nullptr;
+    m_programTexture = nullptr;
+    m_programSolid = nullptr;
+
+    m_quadBuffer.destroy();
+    m_borderBuffer.destroy();
+    m_labelBuffer.destroy();
+    m_borderVertexCount = 0;
+    m_labelVertexCount = 0;
+
+    if (m_labelTexture)
+    {
+        glDeleteTextures(1, &m_labelTexture);
+        m_labelTexture = 0;
+    }
+
+    for (TextureSet &set : m_texturePool)
+    {
+        if (set.textures[0])
+            glDeleteTextures(3, set.textures);
+    }
+    m_texturePool.clear();
+    m_freeTextureSets.clear();
+    for (Tile &tile : m_tiles)
+    {
+        tile.textureSet = -1;
+        tile.hasFrame = false;
+    }
+}
+
+void VideoWallGLWidget::resizeGL(int w, int h)
+{
+    Q_UNUSED(w);
+    Q_UNUSED(h);
+
+    // 设备像素比可能随屏幕变化，标签图集一并重建
+    m_overlayDirty = true;
+    m_labelsDirty = true;
+    updateSinkOutputSizes();
+}
+
+// ==================== 纹理池 ====================
+
+int VideoWallGLWidget::acquireTextureSet()
+{
+    if (!m_freeTextureSets.isEmpty())
+        return m_freeTextureSets.takeLast();
+
+    TextureSet set;
+    glGenTextures(3, set.textures);
+    for (GLuint tex : set.textures)
+    {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_texturePool.append(set);
+    return m_texturePool.size() - 1;
+}
+
+void VideoWallGLWidget::releaseTextureSet(Tile &tile)
+{
+    if (tile.textureSet >= 0)
+        m_freeTextureSets.append(tile.textureSet);
+    tile.textureSet = -1;
+    tile.hasFrame = false;
+}
+
+// ==================== 纹理上传 ====================
+
+void VideoWallGLWidget::uploadTile(Tile &tile)
+{
+    VideoFramePtr frame;
+    qint64 ptsMs = 0;
+    if (!tile.sink || !tile.sink->takeLatestFrame(frame, &ptsMs))
+        return;
+
+    if (tile.textureSet < 0)
+        tile.textureSet = acquireTextureSet();
+    TextureSet &set = m_texturePool[tile.textureSet];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const AVPixelFormat pixelFormat = static_cast<AVPixelFormat>(frame->format);
+    const bool direct = FFmpegDecoderThread::isDirectRenderFormat(pixelFormat);
+    const bool ok = direct ? uploadYUVFrame(tile, set, frame.get()) : uploadRGBFrame(tile, set, frame.get());
+    if (!ok)
+        return;
+
+    TileStats &stats = tile.stats;
+    stats.uploadMs = timer.nsecsElapsed() / 1000000.0;
+    stats.frames++;
+    tile.uploadTotalMs += stats.uploadMs;
+    stats.avgUploadMs = tile.uploadTotalMs / stats.frames;
+    stats.lastPtsMs = ptsMs;
+    stats.frameSize = QSize(frame->width, frame->height);
+    stats.direct = direct;
+    tile.hasFrame = true;
+    updateTileFps(tile);
+}
+
+bool VideoWallGLWidget::uploadYUVFrame(Tile &tile, TextureSet &set, const AVFrame *frame)
+{
+    const OpenGLVideoWidget::YUVFormat format =
+        toGLYUVFormat(static_cast<AVPixelFormat>(frame->format), frame->colorspace, frame->color_range);
+
+    int widths[3], heights[3], bytesPerPixel[3];
+    const int count = OpenGLVideoWidget::planeGeometry(format, frame->width, frame->height,
+                                                       widths, heights, bytesPerPixel);
+    for (int i = 0; i < count; ++i)
+    {
+        // 负步长（倒置帧）无法用行步长表达，交给RGB回退
+        if (!frame->data[i] || frame->linesize[i] <= 0)
+            return uploadRGBFrame(tile, set, frame);
+    }
+
+    // 分辨率或格式变化时才重新分配存储（纹理组来自池，可能残留上一路的尺寸）
+    if (!set.allocated || set.rgb || set.width != frame->width || set.height != frame->height ||
+        set.format.layout != format.layout || set.format.bytesPerSample() != format.bytesPerSample())
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const GLenum glFormat = OpenGLVideoWidget::pixelFormatForBytes(bytesPerPixel[i]);
+            glBindTexture(GL_TEXTURE_2D, set.textures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, glFormat, widths[i], heights[i], 0, glFormat, GL_UNSIGNED_BYTE, nullptr);
+        }
+        set.width = frame->width;
+        set.height = frame->height;
+        set.format = format;
+        set.rgb = false;
+        set.allocated = true;
+    }
+
+    // 直接从解码帧的引用上传，支持行步长时不做任何CPU拷贝
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < count; ++i)
+    {
+        const int rowBytes = widths[i] * bytesPerPixel[i];
+        const uint8_t *pixels = frame->data[i];
+        int rowLength = 0;
+
+        if (frame->linesize[i] != rowBytes)
+        {
+            if (m_rowLengthSupported && frame->linesize[i] % bytesPerPixel[i] == 0)
+            {
+                rowLength = frame->linesize[i] / bytesPerPixel[i];
+            }
+            else
+            {
+                m_repackBuffer.resize(rowBytes * heights[i]);
+                uint8_t *dst = reinterpret_cast<uint8_t*>(m_repackBuffer.data());
+                for (int row = 0; row < heights[i]; ++row)
+                    memcpy(dst + static_cast<size_t>(row) * rowBytes,
+                           frame->data[i] + static_cast<size_t>(row) * frame->linesize[i], rowBytes);
+                pixels = dst;
+            }
+        }
+        if (m_rowLengthSupported)
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+
+        glBindTexture(GL_TEXTURE_2D, set.textures[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, widths[i], heights[i],
+                        OpenGLVideoWidget::pixelFormatForBytes(bytesPerPixel[i]), GL_UNSIGNED_BYTE, pixels);
+    }
+    if (m_rowLengthSupported)
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    tile.format = format;
+    tile.frameWidth = frame->width;
+    tile.frameHeight = frame->height;
+    tile.rgb = false;
+    return true;
+}
+
+bool VideoWallGLWidget::uploadRGBFrame(Tile &tile, TextureSet &set, const AVFrame *frame)
+{
+    // 无法直接采样的格式按分格尺寸缩放转换后上传
+    QImage image = tile.sink->convertToImage(frame);
+    if (image.isNull())
+        return false;
+    image = image.convertToFormat(QImage::Format_RGBA8888);
+
+    if (!set.allocated || !set.rgb || set.width != image.width() || set.height != image.height())
+    {
+        glBindTexture(GL_TEXTURE_2D, set.textures[0]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width(), image.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        set.width = image.width();
+        set.height = image.height();
+        set.rgb = true;
+        set.allocated = true;
+    }
+
+    // RGBA8888每行天然4字节对齐，无需行步长
+    glBindTexture(GL_TEXTURE_2D, set.textures[0]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width(), image.height(), GL_RGBA, GL_UNSIGNED_BYTE, image.constBits());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 宽高比取源尺寸（转换结果已按源宽高比缩放）
+    tile.frameWidth = frame->width;
+    tile.frameHeight = frame->height;
+    tile.rgb = true;
+    return true;
+}
+
+// ==================== 边框与标签 ====================
+
+void VideoWallGLWidget::rebuildLabelAtlas()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QFontMetrics metrics(font());
+    const int labelHeight = qCeil((metrics.height() + LABEL_PADDING) * dpr);
+
+    // 所有标签纵向排列在同一张图集中，一次上传、一次绘制
+    m_labelRects = QVector<QRect>(m_tiles.size());
+    int atlasWidth = 1;
+    int atlasHeight = 0;
+    for (int i = 0; i < m_tiles.size(); ++i)
+    {
+        if (m_tiles[i].label.isEmpty())
+            continue;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        const int textWidth = metrics.horizontalAdvance(m_tiles[i].label);
+#else
+        const int textWidth = metrics.width(m_tiles[i].label);
+#endif
+        const int labelWidth = qCeil((textWidth + 2 * LABEL_PADDING) * dpr);
+        m_labelRects[i] = QRect(0, atlasHeight, labelWidth, labelHeight);
+        atlasWidth = qMax(atlasWidth, labelWidth);
+        atlasHeight += labelHeight;
+    }
+
+    m_labelsDirty = false;
+    if (atlasHeight == 0)
+    {
+        m_labelAtlas = QImage();
+        return;
+    }
+
+    m_labelAtlas = QImage(atlasWidth, atlasHeight, QImage::Format_RGBA8888_Premultiplied);
+    m_labelAtlas.fill(Qt::transparent);
+
+    QPainter painter(&m_labelAtlas);
+    painter.setFont(font());
+    painter.scale(dpr, dpr);
+    for (int i = 0; i < m_tiles.size(); ++i)
+    {
+        if (m_labelRects[i].isEmpty())
+            continue;
+
+        const QRectF logical(m_labelRects[i].x() / dpr, m_labelRects[i].y() / dpr,
+                             m_labelRects[i].width() / dpr, m_labelRects[i].height() / dpr);
+        painter.fillRect(logical, QColor(0, 0, 0, 160));
+        painter.setPen(Qt::white);
+        painter.drawText(logical, Qt::AlignCenter, m_tiles[i].label);
+    }
+    painter.end();
+
+    glBindTexture(GL_TEXTURE_2D, m_labelTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_labelAtlas.width(), m_labelAtlas.height(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, m_labelAtlas.constBits());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void VideoWallGLWidget::rebuildOverlay()
+{
+    if (m_labelsDirty)
+        rebuildLabelAtlas();
+
+    const qreal w = width();
+    const qreal h = height();
+    if (w <= 0 || h <= 0)
+        return;
+
+    // 逻辑坐标转NDC（y轴向上）
+    auto toNdcX = [w](qreal x) { return static_cast<float>(2.0 * x / w - 1.0); };
+    auto toNdcY = [h](qreal y) { return static_cast<float>(1.0 - 2.0 * y / h); };
+
+    // ==================== 边框：每个分格4条矩形，共用一个顶点缓冲 ====================
+    QVector<float> border;
+    if (m_borderWidth > 0)
+    {
+        border.reserve(m_tiles.size() * 4 * 6 * 6);
+        auto appendRect = [&](const QRectF &r, const QColor &c) {
+            const float x0 = toNdcX(r.left()), x1 = toNdcX(r.right());
+            const float y0 = toNdcY(r.top()), y1 = toNdcY(r.bottom());
+            const float corners[6][2] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y0}, {x1, y1}, {x0, y1}};
+            for (const auto &p : corners)
+                border << p[0] << p[1] << c.redF() << c.greenF() << c.blueF() << c.alphaF();
+        };
+
+        const qreal b = m_borderWidth;
+        for (int i = 0; i < m_tiles.size(); ++i)
+        {
+            const QRectF cell = cellRect(i);
+            const QColor &color = (i == m_selectedTile) ? m_selectedColor : m_borderColor;
+            appendRect(QRectF(cell.left(), cell.top(), cell.width(), b), color);
+            appendRect(QRectF(cell.left(), cell.bottom() - b, cell.width(), b), color);
+            appendRect(QRectF(cell.left(), cell.top() + b, b, cell.height() - 2 * b), color);
+            appendRect(QRectF(cell.right() - b, cell.top() + b, b, cell.height() - 2 * b), color);
+        }
+    }
+    m_borderVertexCount = border.size() / 6;
+    m_borderBuffer.bind();
+    m_borderBuffer.allocate(border.constData(), border.size() * static_cast<int>(sizeof(float)));
+    m_borderBuffer.release();
+
+    // ==================== 标签：图集中的子矩形，超出分格宽度时裁剪 ====================
+    QVector<float> labels;
+    if (!m_labelAtlas.isNull())
+    {
+        const qreal dpr = devicePixelRatioF();
+        const float atlasWidth = m_labelAtlas.width();
+        const float atlasHeight = m_labelAtlas.height();
+        for (int i = 0; i < m_tiles.size() && i < m_labelRects.size(); ++i)
+        {
+            const QRect &src = m_labelRects[i];
+            if (src.isEmpty())
+                continue;
+
+            const QRectF tile = tileRect(i);
+            const qreal labelWidth = qMin(src.width() / dpr, tile.width() - 2 * LABEL_MARGIN);
+            const qreal labelHeight = qMin(src.height() / dpr, tile.height() - 2 * LABEL_MARGIN);
+            if (labelWidth <= 0 || labelHeight <= 0)
+                continue;
+
+            const QRectF dst(tile.left() + LABEL_MARGIN, tile.top() + LABEL_MARGIN, labelWidth, labelHeight);
+            const float x0 = toNdcX(dst.left()), x1 = toNdcX(dst.right());
+            const float y0 = toNdcY(dst.top()), y1 = toNdcY(dst.bottom());
+            const float u0 = src.x() / atlasWidth, u1 = (src.x() + labelWidth * dpr) / atlasWidth;
+            const float v0 = src.y() / atlasHeight, v1 = (src.y() + labelHeight * dpr) / atlasHeight;
+            labels << x0 << y0 << u0 << v0 << x1 << y0 << u1 << v0 << x1 << y1 << u1 << v1
+                   << x0 << y0 << u0 << v0 << x1 << y1 << u1 << v1 << x0 << y1 << u0 << v1;
+        }
+    }
+    m_labelVertexCount = labels.size() / 4;
+    m_labelBuffer.bind();
+    m_labelBuffer.allocate(labels.constData(), labels.size() * static_cast<int>(sizeof(float)));
+    m_labelBuffer.release();
+
+    m_overlayDirty = false;
+}
+
+// ==================== 绘制 ====================
+
+void VideoWallGLWidget::paintGL()
+{
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    const qreal dpr = devicePixelRatioF();
+    const int fbWidth = qRound(width() * dpr);
+    const int fbHeight = qRound(height() * dpr);
+    glViewport(0, 0, fbWidth, fbHeight);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!m_initialized)
+        return;
+
+    if (m_overlayDirty)
+        rebuildOverlay();
+
+    int drawCalls = 0;
+    int activeTiles = 0;
+    const QMatrix4x4 identity;
+
+    // ==================== 视频分格：每格一次绘制，视口限定到保持宽高比的区域 ====================
+    m_quadBuffer.bind();
+    for (int i = 0; i < m_tiles.size(); ++i)
+    {
+        Tile &tile = m_tiles[i];
+        uploadTile(tile);
+        if (!tile.hasFrame || tile.textureSet < 0 || tile.frameWidth <= 0 || tile.frameHeight <= 0)
+            continue;
+
+        QElapsedTimer drawTimer;
+        drawTimer.start();
+
+        const QRectF area = tileRect(i);
+        QRectF target(QPointF(0, 0), QSizeF(tile.frameWidth, tile.frameHeight).scaled(area.size(), Qt::KeepAspectRatio));
+        target.moveCenter(area.center());
+        const int vx = qRound(target.left() * dpr);
+        const int vy = fbHeight - qRound(target.bottom() * dpr);    // GL视口原点在左下角
+        const int vw = qRound(target.width() * dpr);
+        const int vh = qRound(target.height() * dpr);
+        if (vw <= 0 || vh <= 0)
+            continue;
+        glViewport(vx, vy, vw, vh);
+
+        const TextureSet &set = m_texturePool[tile.textureSet];
+        QOpenGLShaderProgram *program = tile.rgb
+            ? m_programTexture : yuvProgram(OpenGLVideoWidget::shaderVariantFor(tile.format));
+        if (!program || !program->bind())
+            continue;
+
+        if (tile.rgb)
+        {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, set.textures[0]);
+            program->setUniformValue("u_texture", 0);
+        }
+        else
+        {
+            const int planes = tile.format.planeCount();
+            for (int p = planes - 1; p >= 0; --p)
+            {
+                glActiveTexture(GL_TEXTURE0 + p);
+                glBindTexture(GL_TEXTURE_2D, set.textures[p]);
+            }
+            OpenGLVideoWidget::setYUVUniforms(program, tile.format,
+                OpenGLVideoWidget::autoSelectColorSpace(tile.frameWidth, tile.frameHeight));
+        }
+        program->setUniformValue("u_transform", identity);
+
+        const int posLocation = program->attributeLocation("a_position");
+        const int texCoordLocation = program->attributeLocation("a_texCoord");
+        program->enableAttributeArray(posLocation);
+        program->setAttributeBuffer(posLocation, GL_FLOAT, 0, 2, 4 * sizeof(float));
+        program->enableAttributeArray(texCoordLocation);
+        program->setAttributeBuffer(texCoordLocation, GL_FLOAT, 2 * sizeof(float), 2, 4 * sizeof(float));
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        ++drawCalls;
+        ++activeTiles;
+
+        program->disableAttributeArray(posLocation);
+        program->disableAttributeArray(texCoordLocation);
+        program->release();
+
+        tile.stats.drawMs = drawTimer.nsecsElapsed() / 1000000.0;
+    }
+    m_quadBuffer.release();
+    glViewport(0, 0, fbWidth, fbHeight);
+
+    // ==================== 边框：一次绘制 ====================
+    if (m_borderVertexCount > 0 && m_programSolid->bind())
+    {
+        m_borderBuffer.bind();
+        const int posLocation = m_programSolid->attributeLocation("a_position");
+        const int colorLocation = m_programSolid->attributeLocation("a_color");
+        m_programSolid->enableAttributeArray(posLocation);
+        m_programSolid->setAttributeBuffer(posLocation, GL_FLOAT, 0, 2, 6 * sizeof(float));
+        m_programSolid->enableAttributeArray(colorLocation);
+        m_programSolid->setAttributeBuffer(colorLocation, GL_FLOAT, 2 * sizeof(float), 4, 6 * sizeof(float));
+
+        glDrawArrays(GL_TRIANGLES, 0, m_borderVertexCount);
+        ++drawCalls;
+
+        m_programSolid->disableAttributeArray(posLocation);
+        m_programSolid->disableAttributeArray(colorLocation);
+        m_borderBuffer.release();
+        m_programSolid->release();
+    }
+
+    // ==================== 标签：图集一次绘制（预乘alpha混合） ====================
+    if (m_labelVertexCount > 0 && m_programTexture->bind())
+    {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_labelTexture);
+        m_programTexture->setUniformValue("u_texture", 0);
+        m_programTexture->setUniformValue("u_transform", identity);
+
+        m_labelBuffer.bind();
+        const int posLocation = m_programTexture->attributeLocation("a_position");
+        const int texCoordLocation = m_programTexture->attributeLocation("a_texCoord");
+        m_programTexture->enableAttributeArray(posLocation);
+        m_programTexture->setAttributeBuffer(posLocation, GL_FLOAT, 0, 2, 4 * sizeof(float));
+        m_programTexture->enableAttributeArray(texCoordLocation);
+        m_programTexture->setAttributeBuffer(texCoordLocation, GL_FLOAT, 2 * sizeof(float), 2, 4 * sizeof(float));
+
+        glDrawArrays(GL_TRIANGLES, 0, m_labelVertexCount);
+        ++drawCalls;
+
+        m_programTexture->disableAttributeArray(posLocation);
+        m_programTexture->disableAttributeArray(texCoordLocation);
+        m_labelBuffer.release();
+        m_programTexture->release();
+        glDisable(GL_BLEND);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // ==================== 整墙统计 ====================
+    const double frameMs = frameTimer.nsecsElapsed() / 1000000.0;
+    ++m_paintCount;
+    m_frameTotalMs += frameMs;
+    m_wallStats.frameMs = frameMs;
+    m_wallStats.avgFrameMs = m_frameTotalMs / m_paintCount;
+    m_wallStats.maxFrameMs = qMax(m_wallStats.maxFrameMs, frameMs);
+    m_wallStats.drawCalls = drawCalls;
+    m_wallStats.activeTiles = activeTiles;
+    m_wallStats.texturePoolSize = m_texturePool.size();
+
+    ++m_fpsFrames;
+    const qint64 elapsed = m_fpsTimer.elapsed();
+    if (elapsed >= 1000)
+    {
+        m_wallStats.fps = m_fpsFrames * 1000.0f / elapsed;
+        m_fpsFrames = 0;
+        m_fpsTimer.restart();
+    }
+}
+
+// ==================== 交互 ====================
+
+void VideoWallGLWidget::mousePressEvent(QMouseEvent *event)
+{
+    const int index = tileAt(event->pos());
+    if (index >= 0 && event->button() == Qt::LeftButton)
+    {
+        setSelectedTile(index);
+        emit tileClicked(index);
+    }
+    QOpenGLWidget::mousePressEvent(event);
+}
+
+void VideoWallGLWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    const int index = tileAt(event->pos());
+    if (index >= 0 && event->button() == Qt::LeftButton)
+        emit tileDoubleClicked(index);
+    QOpenGLWidget::mouseDoubleClickEvent(event);
+}
+
+#endif // OPENGL_ENABLE
+
+#endif // CAN_USE_FFMPEG
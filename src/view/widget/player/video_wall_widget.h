@@ -0,0 +1,234 @@
+/*****************************************************************
+File:        video_wall_widget.h
+Version:     1.1
+Author:      cjx
+Date:        2026-10-19
+Description: 单上下文视频墙渲染组件
+             所有分格在同一个QOpenGLWidget中一次绘制完成，避免每路一个OpenGLVideoWidget
+             带来的独立FBO、上下文切换与窗口合成开销
+             - 分格通过VideoStreamRegistry附加到共享解码会话，取零拷贝的原始帧直接上传为YUV纹理
+             - 纹理组放在复用池中，分格关闭后其纹理存储留给下一路，分辨率相同时不重新分配
+             - 每个分格以glViewport限定到保持宽高比的显示区域后绘制一次
+             - 所有边框合并为一次绘制，所有标签绘制到同一张图集后合并为一次绘制
+             - 统计每个分格的上传/绘制耗时与整墙单帧耗时
+    使用方式：
+        VideoWallGLWidget *wall = new VideoWallGLWidget(parent);
+        wall->setGrid(6, 6);
+        wall->openTile(0, "rtsp://...");
+        wall->setTileLabel(0, "Camera 1");
+
+Version history
+[序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            create
+2             2026-10-19     cjx            着色器程序改取共享组缓存；标签宽度按Qt版本选择接口
+*****************************************************************/
+
+#ifdef CAN_USE_FFMPEG
+
+#ifndef _VIDEO_WALL_WIDGET_H
+#define _VIDEO_WALL_WIDGET_H
+
+#ifdef OPENGL_ENABLE
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLWidget>
+#include <QVector>
+
+#include <memory>
+
+#include "view/widget/opengl/opengl_video_widget.h"
+
+struct AVFrame;
+class FFmpegDecoderThread;
+class VideoFrameSink;
+
+class VideoWallGLWidget : public QOpenGLWidget, protected QOpenGLFunctions
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 单个分格的统计
+     */
+    struct TileStats
+    {
+        qint64 frames = 0;          ///< 已上传显示的帧数
+        float fps = 0.0f;           ///< 最近一秒的显示帧率
+        double uploadMs = 0.0;      ///< 最近一帧纹理上传耗时（GUI线程）
+        double avgUploadMs = 0.0;   ///< 平均纹理上传耗时
+        double drawMs = 0.0;        ///< 最近一帧绘制命令提交耗时
+        qint64 lastPtsMs = 0;       ///< 最近显示帧的时间戳
+        QSize frameSize;            ///< 视频尺寸
+        bool direct = false;        ///< 是否直接采样YUV（否则经RGB转换）
+    };
+
+    /**
+     * @brief 整墙统计
+     */
+    struct WallStats
+    {
+        double frameMs = 0.0;       ///< 最近一帧paintGL耗时
+        double avgFrameMs = 0.0;    ///< 平均paintGL耗时
+        double maxFrameMs = 0.0;    ///< 最大paintGL耗时
+        float fps = 0.0f;           ///< 整墙重绘帧率
+        int drawCalls = 0;          ///< 最近一帧的绘制调用次数
+        int activeTiles = 0;        ///< 有画面的分格数
+        int texturePoolSize = 0;    ///< 纹理池中的纹理组数量（含空闲）
+    };
+
+    explicit VideoWallGLWidget(QWidget *parent = nullptr);
+    ~VideoWallGLWidget() override;
+
+    /**
+     * @brief 设置分格行列数，超出新分格数的分格会被关闭
+     */
+    void setGrid(int rows, int columns);
+    int rows() const { return m_rows; }
+    int columns() const { return m_columns; }
+    int tileCount() const { return m_tiles.size(); }
+
+    /**
+     * @brief 在指定分格打开（或附加到）URL对应的解码会话
+     * @return false表示分格序号无效或会话打开失败
+     */
+    bool openTile(int index, const QString &url);
+    /** 关闭分格，其纹理组回到纹理池 */
+    void closeTile(int index);
+    void closeAll();
+    QString tileUrl(int index) const;
+
+    /** 设置分格左上角的标签文字（空字符串表示不显示） */
+    void setTileLabel(int index, const QString &label);
+
+    /**
+     * @brief 设置边框
+     * @param width 边框宽度（逻辑像素，0表示无边框）
+     * @param color 普通分格的边框颜色
+     * @param selectedColor 选中分格的边框颜色
+     */
+    void setBorder(int width, const QColor &color, const QColor &selectedColor = QColor(255, 200, 0));
+
+    /** 设置选中分格（-1表示不选中） */
+    void setSelectedTile(int index);
+    int selectedTile() const { return m_selectedTile; }
+
+    /** 逻辑坐标所在的分格，不在任何分格内时返回-1 */
+    int tileAt(const QPoint &pos) const;
+
+    TileStats tileStats(int index) const;
+    WallStats wallStats() const { return m_wallStats; }
+    void resetStats();
+
+signals:
+    void tileClicked(int index);
+    void tileDoubleClicked(int index);
+
+protected:
+    void initializeGL() override;
+    void resizeGL(int w, int h) override;
+    void paintGL() override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    /**
+     * @brief 纹理池中的一组纹理（YUV三个平面，RGB回退时只用第一个）
+     */
+    struct TextureSet
+    {
+        GLuint textures[3] = {0, 0, 0};
+        int width = 0;                          ///< 已分配的视频尺寸
+        int height = 0;
+        OpenGLVideoWidget::YUVFormat format;    ///< 已分配的格式
+        bool rgb = false;                       ///< 已分配为RGBA单平面
+        bool allocated = false;
+    };
+
+    struct Tile
+    {
+        QString url;
+        std::shared_ptr<FFmpegDecoderThread> session;
+        VideoFrameSink *sink = nullptr;
+        int textureSet = -1;                    ///< 纹理池序号，首帧上传时分配
+        OpenGLVideoWidget::YUVFormat format;    ///< 当前纹理内容的格式
+        int frameWidth = 0;                     ///< 当前纹理内容的尺寸
+        int frameHeight = 0;
+        bool rgb = false;                       ///< 当前内容为RGB回退
+        bool hasFrame = false;
+        QString label;
+
+        TileStats stats;
+        double uploadTotalMs = 0.0;
+        int fpsFrames = 0;
+        QElapsedTimer fpsTimer;
+    };
+
+    void cleanupGL();
+    bool createPrograms();
+    QOpenGLShaderProgram *yuvProgram(OpenGLVideoWidget::ShaderVariant variant);
+
+    /** 分格单元区域（逻辑坐标，含边框） */
+    QRectF cellRect(int index) const;
+    /** 分格画面区域（逻辑坐标，已扣除边框） */
+    QRectF tileRect(int index) const;
+    /** 取出分格的最新帧并上传到纹理组（GL上下文为当前上下文时调用） */
+    void uploadTile(Tile &tile);
+    bool uploadYUVFrame(Tile &tile, TextureSet &set, const AVFrame *frame);
+    bool uploadRGBFrame(Tile &tile, TextureSet &set, const AVFrame *frame);
+    int acquireTextureSet();
+    void releaseTextureSet(Tile &tile);
+
+    /** 边框与标签几何体按布局/选中/标签变化重建 */
+    void rebuildOverlay();
+    void rebuildLabelAtlas();
+    void updateSinkOutputSizes();
+    void updateTileFps(Tile &tile);
+
+    int m_rows = 1;
+    int m_columns = 1;
+    QVector<Tile> m_tiles;
+
+    int m_borderWidth = 1;
+    QColor m_borderColor = QColor(64, 64, 64);
+    QColor m_selectedColor = QColor(255, 200, 0);
+    int m_selectedTile = -1;
+
+    // ==================== OpenGL资源 ====================
+    // 着色器程序由共享组缓存（SsProgramCache）持有，这里只保存引用
+    QOpenGLShaderProgram *m_programsYUV[OpenGLVideoWidget::SHADER_VARIANT_COUNT] = {};
+    QOpenGLShaderProgram *m_programTexture = nullptr;   ///< RGBA纹理（RGB回退分格与标签图集）
+    QOpenGLShaderProgram *m_programSolid = nullptr;     ///< 顶点颜色（边框）
+    QOpenGLBuffer m_quadBuffer;                         ///< 全视口四边形（位置+纹理坐标）
+    QOpenGLBuffer m_borderBuffer;                       ///< 所有边框三角形（位置+颜色）
+    QOpenGLBuffer m_labelBuffer;                        ///< 所有标签四边形（位置+纹理坐标）
+    int m_borderVertexCount = 0;
+    int m_labelVertexCount = 0;
+    GLuint m_labelTexture = 0;
+    QImage m_labelAtlas;                                ///< 标签图集（预乘alpha）
+    QVector<QRect> m_labelRects;                        ///< 各分格标签在图集中的位置（空矩形表示无标签）
+    bool m_overlayDirty = true;
+    bool m_labelsDirty = true;
+    bool m_rowLengthSupported = false;
+    QByteArray m_repackBuffer;                          ///< 不支持行步长时的紧凑重排缓冲
+    bool m_initialized = false;
+
+    QVector<TextureSet> m_texturePool;
+    QVector<int> m_freeTextureSets;
+
+    // ==================== 统计 ====================
+    WallStats m_wallStats;
+    double m_frameTotalMs = 0.0;
+    qint64 m_paintCount = 0;
+    int m_fpsFrames = 0;
+    QElapsedTimer m_fpsTimer;
+};
+
+#endif // OPENGL_ENABLE
+
+#endif // _VIDEO_WALL_WIDGET_H
+
+#endif // CAN_USE_FFMPEG
@@ -15,6 +15,9 @@
 #include "player/player_window.h"
 #endif
 #include "view/component/joystick_wheel.h"
+#ifdef QUICK_VIDEO_ENABLE
+#include "view/widget/player/quick_video_item.h"
+#endif
 #ifdef MAP_COMPONENT_ENABLE
 #include "view/widget/map/multi_mapview.h"
 #include "view/widget/map/layers/route_layer.h"
@@ -95,6 +98,11 @@ void ExampleWindow::showQmlWindow()
         qDebug() << "无法打开QML资源文件";
     }
     
+#if defined(QUICK_VIDEO_ENABLE) && defined(CAN_USE_FFMPEG)
+    // 视频项需在加载QML前注册（import ViewTools.Media 1.0）
+    QuickVideoItem::registerQmlType();
+#endif
+
     // 尝试加载QML
     qmlWidget->setSource(QUrl("qrc:/ui/qml/example.qml"));
     
@@ -1,5 +1,10 @@
 #include "baseGLScene.h"
 
+#include <QDebug>
+#include <QKeyEvent>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+
 SsBaseGLScene::SsBaseGLScene(QWidget *parent)
     : QOpenGLWidget(parent)
 {
@@ -17,7 +22,30 @@ SsBaseGLScene::SsBaseGLScene(QWidget *parent)
 
 SsBaseGLScene::~SsBaseGLScene()
 {
+    if (isValid())
+    {
+        makeCurrent();
+        m_perfHud_.cleanup();
+        m_frameBlock_.destroy();
+        m_viewBlock_.destroy();
+        doneCurrent();
+    }
+}
+
+void SsBaseGLScene::releaseGLResources()
+{
+    makeCurrent();
+    m_perfHud_.cleanup();
+    m_frameBlock_.destroy();
+    m_viewBlock_.destroy();
+    m_boundPrograms_.clear();
+    doneCurrent();
+}
 
+void SsBaseGLScene::setPerfHudVisible(bool visible)
+{
+    m_perfHud_.setVisible(visible);
+    update();
 }
 
 void SsBaseGLScene::initializeGL()
@@ -26,15 +54,123 @@ void SsBaseGLScene::initializeGL()
 
     glClearColor(m_backgroundColor_.redF(), m_backgroundColor_.greenF(), m_backgroundColor_.blueF(), 1.0f);
 
-    
+    m_perfHud_.initialize();
+
+    // 旧上下文销毁时已释放缓冲名（releaseGLResources），这里总是在新上下文中创建
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, &SsBaseGLScene::releaseGLResources, Qt::UniqueConnection);
+
+    // 场景Uniform块：上下文重建后重新创建，已绑定的程序记录随之失效
+    m_boundPrograms_.clear();
+    if (SsUniformBuffer::isSupported(context()))
+    {
+        m_frameBlock_.create();
+        m_viewBlock_.create();
+    }
+    else
+    {
+        qWarning() << "SsBaseGLScene: uniform buffer objects not supported, scene blocks disabled";
+    }
+    m_viewDirty_ = true;
+    m_clock_.start();
+    m_lastFrameTime_ = 0.0;
+    updateSceneBlocks();
 }
 
 void SsBaseGLScene::resizeGL(int w, int h)
 {
+    m_viewportSize_ = QSize(w, h);
+    m_viewDirty_ = true;
+}
+
+void SsBaseGLScene::setProjectionMatrix(const QMatrix4x4 &projection)
+{
+    m_projection_ = projection;
+    m_viewDirty_ = true;
+}
 
+void SsBaseGLScene::setViewMatrix(const QMatrix4x4 &view)
+{
+    m_view_ = view;
+    m_viewDirty_ = true;
+}
+
+void SsBaseGLScene::bindSceneBlocks(QOpenGLShaderProgram *program)
+{
+    if (!program || !hasSceneBlocks() || m_boundPrograms_.contains(program->programId()))
+    {
+        return;
+    }
+    SsUniformBlocks::bindProgram(program->programId());
+    m_boundPrograms_.insert(program->programId());
+}
+
+void SsBaseGLScene::updateSceneBlocks()
+{
+    if (!hasSceneBlocks())
+    {
+        return;
+    }
+
+    // 帧块每帧更新（仅16字节）
+    const double now = m_clock_.isValid() ? m_clock_.nsecsElapsed() / 1e9 : 0.0;
+    SsStd140Writer frame;
+    frame.vec4(QVector4D(static_cast<float>(now), static_cast<float>(now - m_lastFrameTime_),
+                         static_cast<float>(m_frameIndex_), static_cast<float>(devicePixelRatioF())));
+    m_frameBlock_.update(frame.data());
+    m_lastFrameTime_ = now;
+    ++m_frameIndex_;
+
+    // 视图块只在矩阵或尺寸变化时上传
+    if (m_viewDirty_)
+    {
+        const qreal dpr = devicePixelRatioF();
+        SsStd140Writer view;
+        view.mat4(m_projection_)
+            .mat4(m_view_)
+            .mat4(m_projection_ * m_view_)
+            .vec4(QVector4D(m_viewportSize_.width(), m_viewportSize_.height(),
+                            static_cast<float>(m_viewportSize_.width() * dpr),
+                            static_cast<float>(m_viewportSize_.height() * dpr)));
+        m_viewBlock_.update(view.data());
+        m_viewDirty_ = false;
+    }
+
+    // 绑定点属于上下文状态，每帧绑定一次即对场景内所有程序生效
+    m_frameBlock_.bind(SsUniformBlocks::FRAME_BINDING);
+    m_viewBlock_.bind(SsUniformBlocks::VIEW_BINDING);
 }
 
 void SsBaseGLScene::paintGL()
 {
     
+}
+
+void SsBaseGLScene::paintEvent(QPaintEvent *event)
+{
+    m_perfHud_.beginFrame();
+
+    // 场景公共块在子类绘制前统一上传，各程序不再逐个设置投影/视图/时间
+    if (hasSceneBlocks())
+    {
+        makeCurrent();
+        updateSceneBlocks();
+    }
+    QOpenGLWidget::paintEvent(event);                               // 内部调用子类paintGL
+
+    // paintGL返回后帧缓冲尚未合成（多重采样也在合成时才解析），此时叠加仍属于同一帧
+    if (m_perfHud_.isVisible())
+    {
+        makeCurrent();
+    }
+    m_perfHud_.render(width(), height(), devicePixelRatioF());
+}
+
+void SsBaseGLScene::keyPressEvent(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_F12)
+    {
+        setPerfHudVisible(!m_perfHud_.isVisible());
+        return;
+    }
+    QOpenGLWidget::keyPressEvent(event);
 }
\ No newline at end of file
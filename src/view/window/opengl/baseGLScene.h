@@ -2,21 +2,36 @@
 Copyright (c) 2022-2030, shisan233@sszc.live.
 All rights reserved.
 File:        baseGLScene.h
-Version:     1.0
+Version:     1.2
 Author:      cjx
 start date: 
 Description: 
+    场景基类；子类只需实现绘制，性能浮层（F12切换）在子类paintGL完成后叠加到同一帧
+    场景公共参数（投影、视图、视口、时间）放在std140 UBO中（SsFrameBlock/SsViewBlock），
+    每帧在paintGL之前上传并绑定一次；着色器声明SsUniformBlocks::glslSource()中的块即可使用，
+    经SsSharderManager加载的程序链接后自动绑定，其余程序调用bindSceneBlocks一次
 Version history
 
 [序号]    |   [修改日期]  |   [修改者]   |   [修改内容]
+1             2026-10-19     cjx            新增性能浮层
+2             2026-10-19     cjx            新增场景公共Uniform块（UBO）
+3             2026-10-19     cjx            上下文销毁时释放UBO，重建后重新创建
 
 *****************************************************************/
 
 #ifndef BASE_OPENGL_SCENE_H_
 #define BASE_OPENGL_SCENE_H_
 
+#include <QElapsedTimer>
+#include <QMatrix4x4>
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QSet>
+
+#include "factory/opengl/uniform_block.h"
+#include "view/widget/opengl/perf_hud.h"
+
+class QOpenGLShaderProgram;
 
 class SsBaseGLScene : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -25,7 +40,21 @@ public:
     explicit SsBaseGLScene(QWidget *parent = nullptr);
     virtual ~SsBaseGLScene();
 
+    // 显示/隐藏性能浮层
+    void setPerfHudVisible(bool visible);
+    bool isPerfHudVisible() const { return m_perfHud_.isVisible(); }
+
+    // 性能浮层，子类可设置标题或挂接自己的计数器
+    PerfHud &perfHud() { return m_perfHud_; }
 
+    // 设置投影/视图矩阵（写入SsViewBlock，下一帧开始时上传）
+    void setProjectionMatrix(const QMatrix4x4 &projection);
+    void setViewMatrix(const QMatrix4x4 &view);
+    const QMatrix4x4 &projectionMatrix() const { return m_projection_; }
+    const QMatrix4x4 &viewMatrix() const { return m_view_; }
+
+    // 当前上下文是否启用了场景Uniform块（GL 3.1+/GLES 3.0+）
+    bool hasSceneBlocks() const { return m_frameBlock_.isCreated(); }
 
 protected:
     // 初始化Opengl窗口
@@ -37,9 +66,36 @@ protected:
     // 渲染主体
     virtual void paintGL() override;
 
+    // 包裹子类的paintGL，之后在同一帧缓冲上叠加性能浮层
+    virtual void paintEvent(QPaintEvent *event) override;
+
+    // F12切换性能浮层（子类重写时需调用基类以保留该快捷键）
+    virtual void keyPressEvent(QKeyEvent *event) override;
+
+    // 把程序中的场景公共块绑定到约定绑定点（每个程序只需一次，重复调用直接返回）
+    void bindSceneBlocks(QOpenGLShaderProgram *program);
 
 private:
+    // 上传并绑定场景Uniform块（上下文为当前上下文时调用）
+    void updateSceneBlocks();
+
+    // 上下文销毁前（重设父窗口/切换顶层窗口时）释放GL资源，initializeGL中重新创建
+    void releaseGLResources();
+
     QColor m_backgroundColor_;   // 背景颜色
+    PerfHud m_perfHud_;          // 性能浮层
+
+    // 场景Uniform块
+    SsUniformBuffer m_frameBlock_;      // SsFrameBlock：时间
+    SsUniformBuffer m_viewBlock_;       // SsViewBlock：投影、视图、视口
+    QMatrix4x4 m_projection_;
+    QMatrix4x4 m_view_;
+    QSize m_viewportSize_;              // 逻辑尺寸
+    bool m_viewDirty_ = true;           // 视图块需要重新上传
+    QElapsedTimer m_clock_;
+    double m_lastFrameTime_ = 0.0;
+    qint64 m_frameIndex_ = 0;
+    QSet<GLuint> m_boundPrograms_;      // 已绑定公共块的程序
 
 };
 
@@ -2,40 +2,18 @@
 
 #include "fixedPipelineGL.h"
 
-// #ifndef APIENTRY
-// #  if defined(_WIN32) && !defined(_WIN32_WCE) && !defined(__SCITECH_SNAP__)
-// #    define APIENTRY __stdcall
-// #  else
-// #    define APIENTRY
-// #  endif
-// #endif
-
-// // 根据 Qt 版本选择 GLU 头文件
-// #if defined(_WIN32) && QT_VERSION_MAJOR >= 6
-// #include <windows.h>  // 确保 Windows.h 在 glu.h 之前包含
-// #endif
-// #include <GL/glu.h>
-
 #include <cmath>
+#include <cstring>
+#include <QKeyEvent>
 #include <QPainter>
 
-// 添加 GLU 头文件
-#if QT_VERSION_MAJOR < 6
-// Qt5 及之前版本包含系统的 GLU
-#  if defined(_WIN32)
-#    include <windows.h>
-#  endif
-#  include <GL/glu.h>
-#endif
-
-#define PICKSIZE 1024
-#define PICK_TOL 8                                                  // 拾取阈值（可读取配置文件，依据当前绘制要素，动态变化）
-
 SsFixedPipelineGLWidgetBase::SsFixedPipelineGLWidgetBase(QWidget * parent)
     : QOpenGLWidget(parent)
     , m_viewCenter_(0.0f, 0.0f, 0.0f)                               // 初始中心点为 (0,0)
     , m_viewCoordFactor_(1.0f)                                      // 初始系数为1，和逻辑坐标系（QPointF)比例直接对应
-    , m_isPickStatus_(false)
+    , m_pickName_(0)
+    , m_batchingEnabled_(false)
+    , m_modelViewValid_(false)
 {
     // 在构造函数中设置 OpenGL 上下文格式
     QSurfaceFormat format;
@@ -43,10 +21,19 @@ SsFixedPipelineGLWidgetBase::SsFixedPipelineGLWidgetBase(QWidget * parent)
     format.setProfile(QSurfaceFormat::CompatibilityProfile);        // 兼容模式
     format.setSamples(4);                                           // 启用4x MSAA
     setFormat(format);                                              // 关键：为当前 widget 设置格式
+
+    setFocusPolicy(Qt::ClickFocus);                                 // 点击获得焦点后可用F12切换性能浮层
 }
 
 SsFixedPipelineGLWidgetBase::~SsFixedPipelineGLWidgetBase()
 {
+    if (isValid())
+    {
+        makeCurrent();
+        m_perfHud_.cleanup();
+        m_batcher_.cleanup();
+        doneCurrent();
+    }
 }
 
 void SsFixedPipelineGLWidgetBase::initializeGL()
@@ -65,6 +52,9 @@ void SsFixedPipelineGLWidgetBase::initializeGL()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glEnable(GL_MULTISAMPLE);
+
+    m_perfHud_.initialize();
+    m_batcher_.initialize(this);
 }
 
 void SsFixedPipelineGLWidgetBase::resizeGL(int w, int h)
@@ -96,6 +86,50 @@ void SsFixedPipelineGLWidgetBase::paintGL()
     /* 添加绘制代码 */
 }
 
+void SsFixedPipelineGLWidgetBase::paintEvent(QPaintEvent *event)
+{
+    m_perfHud_.beginFrame();
+
+    // 拾取索引只保留最近一帧绘制的图元
+    m_pickIndex_.clear();
+    m_pickName_ = 0;
+    // 子类paintGL通常会重置矩阵，本帧第一次draw*时重新读取
+    m_modelViewValid_ = false;
+    m_modelViewStack_.clear();
+    QOpenGLWidget::paintEvent(event);                               // 内部调用子类paintGL
+
+    // 子类paintGL中累积的批次在同一帧缓冲上统一绘制
+    if (isValid())
+    {
+        makeCurrent();
+        m_batcher_.flush();
+        m_batcher_.endFrame();
+    }
+
+    // paintGL返回后帧缓冲尚未合成（多重采样也在合成时才解析），此时叠加仍属于同一帧
+    if (m_perfHud_.isVisible())
+    {
+        makeCurrent();
+    }
+    m_perfHud_.render(width(), height(), devicePixelRatioF());
+}
+
+void SsFixedPipelineGLWidgetBase::keyPressEvent(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_F12)
+    {
+        setPerfHudVisible(!m_perfHud_.isVisible());
+        return;
+    }
+    QOpenGLWidget::keyPressEvent(event);
+}
+
+void SsFixedPipelineGLWidgetBase::setPerfHudVisible(bool visible)
+{
+    m_perfHud_.setVisible(visible);
+    update();
+}
+
 void SsFixedPipelineGLWidgetBase::setBackgroundColor(const QColor &color)
 {
     m_backgroundColor_ = color;
@@ -141,13 +175,127 @@ void SsFixedPipelineGLWidgetBase::setViewRect(const QVector3D &topLeft, const QV
     m_viewCenter_.setZ((topLeft.z() + bottomRight.z()) / 2);
 }
 
+QMatrix4x4 SsFixedPipelineGLWidgetBase::currentModelView()
+{
+    // 批处理时每个draw*都读取GL矩阵会在多线程驱动上逐图元同步，改为使用CPU端跟踪的矩阵
+    if (m_batchingEnabled_ && m_modelViewValid_)
+    {
+        return m_modelView_;
+    }
+
+    // GL按列主序返回，与QMatrix4x4::data()的存储一致
+    GLfloat values[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, values);
+    QMatrix4x4 matrix;
+    memcpy(matrix.data(), values, sizeof(values));
+    if (m_batchingEnabled_)
+    {
+        m_modelView_ = matrix;
+        m_modelViewValid_ = true;
+    }
+    return matrix;
+}
+
+void SsFixedPipelineGLWidgetBase::pushModelView()
+{
+    glPushMatrix();
+    m_modelViewStack_.append(qMakePair(m_modelView_, m_modelViewValid_));
+}
+
+void SsFixedPipelineGLWidgetBase::popModelView()
+{
+    glPopMatrix();
+    if (m_modelViewStack_.isEmpty())
+    {
+        m_modelViewValid_ = false;
+        return;
+    }
+    const QPair<QMatrix4x4, bool> saved = m_modelViewStack_.takeLast();
+    m_modelView_ = saved.first;
+    m_modelViewValid_ = saved.second;
+}
+
+void SsFixedPipelineGLWidgetBase::loadModelView(const QMatrix4x4 &matrix)
+{
+    glLoadMatrixf(matrix.constData());
+    m_modelView_ = matrix;
+    m_modelViewValid_ = true;
+}
+
+void SsFixedPipelineGLWidgetBase::translateModelView(const QVector3D &offset)
+{
+    glTranslatef(offset.x(), offset.y(), offset.z());
+    m_modelView_.translate(offset);
+}
+
+void SsFixedPipelineGLWidgetBase::rotateModelView(float angle, const QVector3D &axis)
+{
+    glRotatef(angle, axis.x(), axis.y(), axis.z());
+    m_modelView_.rotate(angle, axis);
+}
+
+void SsFixedPipelineGLWidgetBase::scaleModelView(const QVector3D &factor)
+{
+    glScalef(factor.x(), factor.y(), factor.z());
+    m_modelView_.scale(factor);
+}
+
+QVector<QVector3D> SsFixedPipelineGLWidgetBase::mapPoints(const QMatrix4x4 &modelView, const QVector<QVector3D> &points)
+{
+    if (modelView.isIdentity())
+    {
+        return points;
+    }
+    QVector<QVector3D> mapped;
+    mapped.reserve(points.size());
+    for (const QVector3D &point : points)
+    {
+        mapped.append(modelView.map(point));
+    }
+    return mapped;
+}
+
 bool SsFixedPipelineGLWidgetBase::isPickMode() const
 {
-    return m_isPickStatus_;
+    return false;
+}
+
+void SsFixedPipelineGLWidgetBase::setBatchingEnabled(bool enabled)
+{
+    m_batchingEnabled_ = enabled;
+    m_modelViewValid_ = false;
+    update();
+}
+
+void SsFixedPipelineGLWidgetBase::flushBatches()
+{
+    m_batcher_.flush();
+
+    // 调用方可能直接修改了GL矩阵，跟踪的矩阵（含已保存的）全部作废
+    m_modelViewValid_ = false;
+    for (QPair<QMatrix4x4, bool> &saved : m_modelViewStack_)
+    {
+        saved.second = false;
+    }
 }
 
 void SsFixedPipelineGLWidgetBase::drawPoint(const QVector3D &point, float size, const QColor &color)
 {
+    if (m_pickName_ || m_batchingEnabled_)
+    {
+        // 拾取与批处理都使用按当前模型视图矩阵换算后的世界坐标
+        const QVector3D world = currentModelView().map(point);
+        if (m_pickName_)
+        {
+            m_pickIndex_.addPoint(m_pickName_, world, size);
+        }
+        if (m_batchingEnabled_)
+        {
+            m_batcher_.addPoint(world, size, color);
+            return;
+        }
+    }
+
     glPointSize(size);
 
     glBegin(GL_POINTS);
@@ -158,6 +306,22 @@ void SsFixedPipelineGLWidgetBase::drawPoint(const QVector3D &point, float size,
 
 void SsFixedPipelineGLWidgetBase::drawLine(const QVector3D &start, const QVector3D &end, float width, const QColor &color)
 {
+    if (m_pickName_ || m_batchingEnabled_)
+    {
+        const QMatrix4x4 modelView = currentModelView();
+        const QVector3D worldStart = modelView.map(start);
+        const QVector3D worldEnd = modelView.map(end);
+        if (m_pickName_)
+        {
+            m_pickIndex_.addLine(m_pickName_, worldStart, worldEnd, width);
+        }
+        if (m_batchingEnabled_)
+        {
+            m_batcher_.addLine(worldStart, worldEnd, width, color);
+            return;
+        }
+    }
+
     glLineWidth(width);
     glBegin(GL_LINES);
         glColor3f(color.redF(), color.greenF(), color.blueF());
@@ -168,6 +332,32 @@ void SsFixedPipelineGLWidgetBase::drawLine(const QVector3D &start, const QVector
 
 void SsFixedPipelineGLWidgetBase::drawPolygon(const QVector<QVector3D> &points, const QColor &borderColor, const QColor &fillColor)
 {
+    if (borderColor == Qt::transparent && fillColor == Qt::transparent)
+    {
+        return;
+    }
+
+    if (m_pickName_ || m_batchingEnabled_)
+    {
+        const QVector<QVector3D> world = mapPoints(currentModelView(), points);
+        if (m_pickName_)
+        {
+            m_pickIndex_.addPolygon(m_pickName_, world, fillColor != Qt::transparent);
+        }
+        if (m_batchingEnabled_)
+        {
+            if (borderColor != Qt::transparent)
+            {
+                m_batcher_.addPolygonOutline(world, borderColor);
+            }
+            if (fillColor != Qt::transparent)
+            {
+                m_batcher_.addPolygonFill(world, fillColor);
+            }
+            return;
+        }
+    }
+
     if (borderColor != Qt::transparent)
     {
         glLineWidth(1.0f);
@@ -194,6 +384,9 @@ void SsFixedPipelineGLWidgetBase::drawPolygon(const QVector<QVector3D> &points,
 
 void SsFixedPipelineGLWidgetBase::drawText(const QPointF &position, const QString &text, const QColor &color, int fontSize)
 {
+    // QPainter会改写GL状态，先画出已累积的批次以保持绘制顺序
+    m_batcher_.flush();
+
     // 使用 QPainter 绘制文字
     QPainter painter(this);
 
@@ -204,6 +397,7 @@ void SsFixedPipelineGLWidgetBase::drawText(const QPointF &position, const QStrin
     painter.setFont(QFont("Arial", fontSize));
     painter.drawText(position.toPoint(), text);
     painter.end();
+    m_modelViewValid_ = false;                                      // QPainter可能改写GL矩阵，下次draw*重新读取
 }
 
 void SsFixedPipelineGLWidgetBase::drawTexture(const QVector2D &position, const QSize &size, QOpenGLTexture *texture)
@@ -212,6 +406,20 @@ void SsFixedPipelineGLWidgetBase::drawTexture(const QVector2D &position, const Q
         return;  // 纹理无效
     }
 
+    // 纹理按其矩形整体参与拾取
+    if (m_pickName_)
+    {
+        const QVector<QVector3D> corners = {
+            QVector3D(position.x(), position.y(), 0.0f),
+            QVector3D(position.x() + size.width(), position.y(), 0.0f),
+            QVector3D(position.x() + size.width(), position.y() + size.height(), 0.0f),
+            QVector3D(position.x(), position.y() + size.height(), 0.0f)
+        };
+        m_pickIndex_.addPolygon(m_pickName_, mapPoints(currentModelView(), corners), true);
+    }
+
+    m_batcher_.flush();                                             // 保持与之前几何的绘制顺序
+
     // 绑定纹理
     texture->bind(); // glBindTexture(GL_TEXTURE_2D, texture->textureId());
 
@@ -227,97 +435,31 @@ void SsFixedPipelineGLWidgetBase::drawTexture(const QVector2D &position, const Q
     glDisable(GL_TEXTURE_2D);
 }
 
-void SsFixedPipelineGLWidgetBase::onMousePick(const QPointF &pos)
+QVector<quint32> SsFixedPipelineGLWidgetBase::pickAt(const QPointF &pos, float tolerance) const
 {
-    /* 初始化阶段 */
-    GLuint pickBuffer[PICKSIZE] = {0};              // 创建一个保存选择结果的数组
-    GLint numPicks = 0;
-    GLint vp[4] = {0};
-    
-    glGetIntegerv(GL_VIEWPORT, vp);                 // 获取当前视口参数(vp[2]=width, vp[3]=height)
-    glSelectBuffer(PICKSIZE, pickBuffer);           // 设置选择缓冲区
-
-    // 复用 resizeGL 中的投影计算逻辑
-    float width = vp[2] / m_viewCoordFactor_;
-    float height = vp[3] / m_viewCoordFactor_;
-    float left = m_viewCenter_.x() - width / 2;
-    float right = m_viewCenter_.x() + width / 2;
-    float bottom = m_viewCenter_.y() - height / 2;
-    float top = m_viewCenter_.y() + height / 2;
-
-    /* 选择模式配置 */
-    glRenderMode(GL_SELECT);                        // 激活选择模式
-    glInitNames();                                  // 初始化名字堆栈
-    glPushName(0);                                  // 在名字栈中放入一个初始化名字，这里为‘0’ (防止空栈错误)
+    QVector<quint32> names;
+    if (m_pickIndex_.isEmpty())
+    {
+        return names;
+    }
 
-    m_isPickStatus_ = true;
+    // 视图逻辑坐标转世界坐标（与resizeGL中的正交投影一致，y轴向上）
+    const float worldPerPixel = 1.0f / m_viewCoordFactor_;
+    const QVector2D world(m_viewCenter_.x() + (pos.x() - width() / 2.0f) * worldPerPixel,
+                          m_viewCenter_.y() + (height() / 2.0f - pos.y()) * worldPerPixel);
 
-    /* 投影矩阵操作 */
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();                                 // 保存原有投影矩阵
-    glLoadIdentity();
+    const QVector<SsPickIndex::Hit> hits = m_pickIndex_.pick(world, tolerance * worldPerPixel, worldPerPixel);
+    names.reserve(hits.size());
+    for (const SsPickIndex::Hit &hit : hits)
+    {
+        names.append(hit.name);
+    }
+    return names;
+}
 
-    glOrtho(left, right, bottom, top, -1.0, 1.0);   // 先应用原始投影矩阵
-
-    // 叠加拾取矩阵
-#if QT_VERSION_MAJOR < 6
-    // Qt5 及之前版本使用系统 GLU
-    gluPickMatrix(GLdouble(pos.x()), GLdouble(vp[3] - pos.y()), PICK_TOL, PICK_TOL, vp);
-#else
-    // Qt6 使用自定义实现
-    customPickMatrix(GLdouble(pos.x()), GLdouble(vp[3] - pos.y()), PICK_TOL, PICK_TOL, vp);
-#endif
-
-    /* 绘制场景 */
-    paintGL();                                      // 触发绘制（夹取的一帧）(update()同样)
-
-    /* 结果处理 */
-    glMatrixMode(GL_PROJECTION);                    // 恢复矩阵
-    glPopMatrix();                                  // 返回正常的投影变换 
-
-    numPicks = glRenderMode(GL_RENDER);             // 从选择模式返回正常模式,该函数返回选择到对象的个数
-    m_isPickStatus_ = false;
-
-    /* 拾取结果pickBuffer解析，通过glPushName存入的名字来映射到具体要素 */
-    /* // 示例：两个命中记录
-        pickBuffer[] = {
-            // 第一个命中记录
-            2,          // 名称堆栈深度（n=2）
-            minDepth1,  // 最小深度
-            maxDepth1,  // 最大深度
-            name1_1,    // 名称1（堆栈底部名称）
-            name1_2,    // 名称2（堆栈顶部名称）
-
-            // 第二个命中记录
-            1,          // 名称堆栈深度（n=1）
-            minDepth2,  // 最小深度
-            maxDepth2,  // 最大深度
-            name2       // 名称
-        };
-     */
-}
-
-#if QT_VERSION_MAJOR >= 6
-void SsFixedPipelineGLWidgetBase::customPickMatrix(GLdouble x, GLdouble y, GLdouble width, GLdouble height, GLint viewport[4])
-{
-    GLfloat m[16];
-    GLfloat sx, sy;
-    GLfloat tx, ty;
-    
-    sx = viewport[2] / width;
-    sy = viewport[3] / height;
-    tx = (viewport[2] + 2.0 * (viewport[0] - x)) / width;
-    ty = (viewport[3] + 2.0 * (viewport[1] - y)) / height;
-    
-    #define M(row,col) m[col*4+row]
-    M(0,0) = sx; M(0,1) = 0.0; M(0,2) = 0.0; M(0,3) = tx;
-    M(1,0) = 0.0; M(1,1) = sy; M(1,2) = 0.0; M(1,3) = ty;
-    M(2,0) = 0.0; M(2,1) = 0.0; M(2,2) = 1.0; M(2,3) = 0.0;
-    M(3,0) = 0.0; M(3,1) = 0.0; M(3,2) = 0.0; M(3,3) = 1.0;
-    #undef M
-    
-    glMultMatrixf(m);
-}
-#endif
+void SsFixedPipelineGLWidgetBase::onMousePick(const QPointF &pos)
+{
+    emit picked(pos, pickAt(pos));
+}
 
 #endif  // QT_OPENGL_ES_2
\ No newline at end of file
@@ -1,13 +1,26 @@
 /*****************************************************************
 File:        fixedPipelineGL.h
-Version:     1.0
+Version:     1.3
 Author:
 start date:
 Description:
     基于固定管道渲染的绘制窗口及方法类
     方便快速实现，效果检验逐渐废弃    
+    性能浮层（F12切换）在子类paintGL完成后叠加到同一帧
+    拾取：绘制前setPickName设置拾取名，之后的drawPoint/drawLine/drawPolygon/drawTexture按当前模型视图矩阵
+    换算到世界坐标后记录到CPU空间索引，pickAt按最近一帧的几何返回命中的拾取名，无需重绘
+    批处理（默认关闭，setBatchingEnabled(true)开启）：drawPoint/drawLine/drawPolygon按调用时的模型视图矩阵把顶点
+    换算为世界坐标，连续的同类图元合并为一个VBO批次，按调用顺序在flushBatches或paintGL结束后绘制
+    （顶点未变化的批次不重新上传）。开启后子类需注意：
+        - 模型视图矩阵在CPU端跟踪，绘制之间用pushModelView/translateModelView等修改，
+          直接调用gl修改矩阵后需调用flushBatches
+        - 直接调用gl绘制且依赖与draw*的先后遮挡时，先调用flushBatches
 Version history
 [序号][修改日期][修改者][修改内容]
+1             2026-10-19     cjx            新增性能浮层
+2             2026-10-19     cjx            GL_SELECT拾取改为CPU空间索引拾取
+3             2026-10-19     cjx            基础绘制接口改为VBO批处理
+4             2026-10-19     cjx            批处理改为默认关闭并保持调用顺序，模型视图矩阵改为CPU端跟踪
 
 *****************************************************************/
 
@@ -16,12 +29,19 @@ Version history
 #ifndef FIXED_PIPELINE_OPENGL_VIEW_H_
 #define FIXED_PIPELINE_OPENGL_VIEW_H_
 
+#include <QMatrix4x4>
 #include <QOpenGLFunctions_2_1>
 #include <QOpenGLTexture>
 #include <QOpenGLWidget>
+#include <QPair>
+#include <QVector>
 #include <QVector2D>
 #include <QVector3D>
 
+#include "view/widget/opengl/perf_hud.h"
+#include "geometry_batch.h"
+#include "pick_index.h"
+
 
 class SsFixedPipelineGLWidgetBase : public QOpenGLWidget, QOpenGLFunctions_2_1 
 {
@@ -43,9 +63,40 @@ public:
     // 功能同上
     void setViewRect(const QVector3D &topLeft, const QVector3D &bottomRight);
 
-    // 当前是否在拾取状态（外部查询，便于给绘制要素glPushName)
+    // 当前是否在拾取状态（GL_SELECT已移除，恒为false，仅为兼容保留；拾取名请用setPickName设置）
     bool isPickMode() const;
 
+    // 设置之后绘制图元的拾取名（0表示不参与拾取，每帧开始时重置为0）
+    void setPickName(quint32 name) { m_pickName_ = name; }
+    quint32 pickName() const { return m_pickName_; }
+
+    /**
+     * @brief 拾取（按最近一帧记录的几何，不触发重绘）
+     * @param pos 视图逻辑坐标（原点左上）
+     * @param tolerance 拾取半径（像素）
+     * @return 命中的拾取名，由近到远
+     */
+    QVector<quint32> pickAt(const QPointF &pos, float tolerance = 4.0f) const;
+
+    // 显示/隐藏性能浮层
+    void setPerfHudVisible(bool visible);
+    bool isPerfHudVisible() const { return m_perfHud_.isVisible(); }
+
+    // 性能浮层，子类可设置标题或挂接自己的计数器
+    PerfHud &perfHud() { return m_perfHud_; }
+
+
+    // 批处理开关（默认关闭）；关闭时draw*立即以glBegin/glEnd绘制
+    void setBatchingEnabled(bool enabled);
+    bool isBatchingEnabled() const { return m_batchingEnabled_; }
+
+    // 立即绘制已累积的批次，并在下次draw*时重新读取GL的模型视图矩阵
+    // （直接调用gl绘制或修改矩阵前后调用，需要当前上下文）
+    void flushBatches();
+
+    // 最近一帧的批处理统计
+    const SsGeometryBatcher::Stats &batchStats() const { return m_batcher_.stats(); }
+
 
     /* 基础绘制接口封装，入参的点坐标系，依赖于上下文中，当前处理的什么矩阵(默认模型视图矩阵--模型坐标系=世界坐标系) */
 
@@ -64,6 +115,10 @@ public:
     // 绘制纹理(3d纹理需额外生成)
     void drawTexture(const QVector2D &position, const QSize &size, QOpenGLTexture *texture);
 
+signals:
+    // onMousePick的拾取结果（未命中时names为空）
+    void picked(const QPointF &pos, const QVector<quint32> &names);
+
 protected:
     // 初始化Opengl窗口
     virtual void initializeGL() override;
@@ -74,27 +129,58 @@ protected:
     // 渲染主体
     virtual void paintGL() override;
 
+    // 包裹子类的paintGL，之后在同一帧缓冲上叠加性能浮层
+    virtual void paintEvent(QPaintEvent *event) override;
+
+    // F12切换性能浮层（子类重写时需调用基类以保留该快捷键）
+    virtual void keyPressEvent(QKeyEvent *event) override;
+
     // 鼠标事件(针对拖拽（改变视图中心）处理)
     // void mousePressEvent(QMouseEvent* event) override;
     // void mouseMoveEvent(QMouseEvent* event) override;
 
-    //拾取
+    //拾取（默认调用pickAt并发出picked）
     virtual void onMousePick(const QPointF &pos);
 
+    // 拾取索引，子类直接用gl调用绘制的要素可自行记录（需传入世界坐标）
+    SsPickIndex &pickIndex() { return m_pickIndex_; }
+
+    // 当前模型视图矩阵（draw*的入参坐标经该矩阵换算为世界坐标）
+    // 批处理开启时每帧（及每次flushBatches后）只从GL读取一次，之后由下面的接口在CPU端同步更新
+    QMatrix4x4 currentModelView();
+
+    // 修改模型视图矩阵（当前矩阵模式须为GL_MODELVIEW），同时更新CPU端跟踪的矩阵
+    void pushModelView();
+    void popModelView();
+    void loadModelView(const QMatrix4x4 &matrix);
+    void translateModelView(const QVector3D &offset);
+    void rotateModelView(float angle, const QVector3D &axis);
+    void scaleModelView(const QVector3D &factor);
+
 private:
+
+    // 按模型视图矩阵换算顶点（单位矩阵时原样返回）
+    static QVector<QVector3D> mapPoints(const QMatrix4x4 &modelView, const QVector<QVector3D> &points);
+
     QColor m_backgroundColor_;   // 背景颜色
     QVector3D m_viewCenter_;     // 视图中心点（世界坐标系）
     // 存在坐标系转换时每个方向转换的比例不一样的情况，暂不考虑
     float m_viewCoordFactor_;    // 世界坐标系转界面坐标系的系数
 
-    bool m_isPickStatus_;        // 处于拾取状体
+    SsPickIndex m_pickIndex_;    // 本帧已绘制图元的拾取索引
+    quint32 m_pickName_;         // 当前拾取名
+
+    SsGeometryBatcher m_batcher_;   // 几何批处理
+    bool m_batchingEnabled_;        // 是否启用批处理
+
+    QMatrix4x4 m_modelView_;                        // CPU端跟踪的模型视图矩阵（仅批处理时使用）
+    bool m_modelViewValid_;                         // 跟踪的矩阵是否与GL一致
+    QVector<QPair<QMatrix4x4, bool>> m_modelViewStack_; // pushModelView保存的矩阵及其有效性
 
     QVector3D m_lastviewCenter_; // 记录前一次视图中心点
     float m_wheelZoomFactor_;    // 鼠标缩放系数
 
-#if QT_VERSION_MAJOR >= 6
-    void customPickMatrix(GLdouble x, GLdouble y, GLdouble width, GLdouble height, GLint viewport[4]);
-#endif
+    PerfHud m_perfHud_;          // 性能浮层
 };
 
 
@@ -0,0 +1,241 @@
+#ifndef QT_OPENGL_ES_2
+
+#include "geometry_batch.h"
+
+#include <cstddef>
+#include <cstring>
+
+#define BATCH_MAX_IDLE_FRAMES 120                                   // 连续未使用超过该帧数的批次被回收
+
+SsGeometryBatcher::~SsGeometryBatcher()
+{
+    // VBO需要在上下文中释放（见cleanup），这里只回收CPU端对象
+    for (Batch &batch : m_batches)
+    {
+        delete batch.buffer;
+    }
+}
+
+void SsGeometryBatcher::initialize(QOpenGLFunctions_2_1 *functions)
+{
+    m_functions = functions;
+}
+
+void SsGeometryBatcher::cleanup()
+{
+    for (Batch &batch : m_batches)
+    {
+        if (batch.buffer)
+        {
+            batch.buffer->destroy();
+            delete batch.buffer;
+            batch.buffer = nullptr;
+        }
+    }
+    m_batches.clear();
+    m_batchCount = 0;
+    m_firstPending = 0;
+    m_pendingVertices = 0;
+}
+
+SsGeometryBatcher::Vertex SsGeometryBatcher::vertex(const QVector3D &point, const QColor &color)
+{
+    // 与原glColor3f一致，忽略颜色的alpha
+    Vertex v;
+    v.x = point.x();
+    v.y = point.y();
+    v.z = point.z();
+    v.r = static_cast<quint8>(color.red());
+    v.g = static_cast<quint8>(color.green());
+    v.b = static_cast<quint8>(color.blue());
+    v.a = 255;
+    return v;
+}
+
+SsGeometryBatcher::Batch &SsGeometryBatcher::batch(GLenum mode, float size)
+{
+    // 与上一个未绘制的批次同类时继续追加，否则开始新批次以保持调用顺序
+    if (m_batchCount > m_firstPending)
+    {
+        Batch &last = m_batches[m_batchCount - 1];
+        if (last.mode == mode && last.size == size)
+        {
+            return last;
+        }
+    }
+
+    if (m_batchCount == m_batches.size())
+    {
+        m_batches.append(Batch());
+    }
+    Batch &target = m_batches[m_batchCount++];
+    target.mode = mode;
+    target.size = size;
+    target.vertices.resize(0);
+    return target;
+}
+
+void SsGeometryBatcher::addPoint(const QVector3D &point, float size, const QColor &color)
+{
+    batch(GL_POINTS, size).vertices.append(vertex(point, color));
+    m_pendingVertices += 1;
+}
+
+void SsGeometryBatcher::addLine(const QVector3D &start, const QVector3D &end, float width, const QColor &color)
+{
+    QVector<Vertex> &vertices = batch(GL_LINES, width).vertices;
+    vertices.append(vertex(start, color));
+    vertices.append(vertex(end, color));
+    m_pendingVertices += 2;
+}
+
+void SsGeometryBatcher::addPolygonOutline(const QVector<QVector3D> &points, const QColor &color)
+{
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    // GL_LINE_LOOP拆成首尾相接的线段
+    QVector<Vertex> &vertices = batch(GL_LINES, 1.0f).vertices;
+    for (int i = 0; i < points.size(); ++i)
+    {
+        vertices.append(vertex(points[i], color));
+        vertices.append(vertex(points[(i + 1) % points.size()], color));
+    }
+    m_pendingVertices += points.size() * 2;
+}
+
+void SsGeometryBatcher::addPolygonFill(const QVector<QVector3D> &points, const QColor &color)
+{
+    if (points.size() < 3)
+    {
+        return;
+    }
+
+    // 以第一个点为扇心三角化
+    QVector<Vertex> &vertices = batch(GL_TRIANGLES, 0.0f).vertices;
+    const Vertex origin = vertex(points[0], color);
+    for (int i = 1; i + 1 < points.size(); ++i)
+    {
+        vertices.append(origin);
+        vertices.append(vertex(points[i], color));
+        vertices.append(vertex(points[i + 1], color));
+    }
+    m_pendingVertices += (points.size() - 2) * 3;
+}
+
+void SsGeometryBatcher::flush()
+{
+    if (m_pendingVertices == 0 || !m_functions)
+    {
+        return;
+    }
+
+    QOpenGLFunctions_2_1 *f = m_functions;
+    f->glMatrixMode(GL_MODELVIEW);
+    f->glPushMatrix();
+    f->glLoadIdentity();                                            // 顶点已是世界坐标
+    f->glEnableClientState(GL_VERTEX_ARRAY);
+    f->glEnableClientState(GL_COLOR_ARRAY);
+
+    for (int i = m_firstPending; i < m_batchCount; ++i)
+    {
+        if (!m_batches[i].vertices.isEmpty())
+        {
+            drawBatch(m_batches[i]);
+        }
+    }
+
+    f->glDisableClientState(GL_COLOR_ARRAY);
+    f->glDisableClientState(GL_VERTEX_ARRAY);
+    f->glPopMatrix();
+
+    m_pendingVertices = 0;
+    m_firstPending = m_batchCount;
+}
+
+void SsGeometryBatcher::drawBatch(Batch &batch)
+{
+    QOpenGLFunctions_2_1 *f = m_functions;
+    const int count = batch.vertices.size();
+    const int bytes = count * static_cast<int>(sizeof(Vertex));
+
+    if (!batch.buffer)
+    {
+        batch.buffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+        batch.buffer->setUsagePattern(QOpenGLBuffer::DynamicDraw);
+        batch.buffer->create();
+    }
+    batch.buffer->bind();
+
+    // 顶点与上次上传的相同时直接复用VBO
+    const bool unchanged = batch.uploaded.size() == count
+                           && memcmp(batch.uploaded.constData(), batch.vertices.constData(), static_cast<size_t>(bytes)) == 0;
+    if (unchanged)
+    {
+        ++m_stats.reused;
+    }
+    else
+    {
+        if (batch.buffer->size() == bytes)
+        {
+            batch.buffer->write(0, batch.vertices.constData(), bytes);
+        }
+        else
+        {
+            batch.buffer->allocate(batch.vertices.constData(), bytes);
+        }
+        ++m_stats.uploads;
+        batch.uploaded.swap(batch.vertices);
+    }
+
+    f->glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, x)));
+    f->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, r)));
+    if (batch.mode == GL_POINTS)
+    {
+        f->glPointSize(batch.size);
+    }
+    else if (batch.mode == GL_LINES)
+    {
+        f->glLineWidth(batch.size);
+    }
+    f->glDrawArrays(batch.mode, 0, count);
+    batch.buffer->release();
+
+    // resize(0)保留容量，下一帧追加时不再重新分配
+    batch.vertices.resize(0);
+    ++m_stats.batches;
+    m_stats.vertices += count;
+}
+
+void SsGeometryBatcher::endFrame()
+{
+    // 未flush的顶点直接丢弃
+    for (int i = 0; i < m_batches.size(); ++i)
+    {
+        Batch &batch = m_batches[i];
+        batch.vertices.resize(0);
+        batch.idleFrames = i < m_batchCount ? 0 : batch.idleFrames + 1;
+    }
+
+    // 批次按序号使用，只回收末尾长期未用到的批次
+    while (!m_batches.isEmpty() && m_batches.last().idleFrames > BATCH_MAX_IDLE_FRAMES)
+    {
+        Batch &batch = m_batches.last();
+        if (batch.buffer)
+        {
+            batch.buffer->destroy();
+            delete batch.buffer;
+        }
+        m_batches.removeLast();
+    }
+
+    m_batchCount = 0;
+    m_firstPending = 0;
+    m_pendingVertices = 0;
+    m_lastStats = m_stats;
+    m_stats = Stats();
+}
+
+#endif  // QT_OPENGL_ES_2
@@ -0,0 +1,131 @@
+/*****************************************************************
+File:        geometry_batch.h
+Version:     1.2
+Author:      cjx
+start date:  2026-10-19
+Description: 固定管线的几何批处理
+             drawPoint/drawLine/drawPolygon不再逐个glBegin/glEnd，而是把顶点（位置+颜色）追加到批次中，
+             连续加入的同类图元（类型与点大小/线宽相同）合并为一个批次，flush时每个批次一次glDrawArrays
+             - 图元类型或点大小/线宽变化时开始新批次，批次按加入顺序绘制，与逐个立即绘制的先后遮挡一致
+             - 批次按帧内序号跨帧保留VBO，顶点与上次上传的完全相同时不再上传
+             - 多边形填充按扇形三角化（与GL_POLYGON一致，只支持凸多边形），边框拆成线段
+             - 顶点由调用方按加入时的模型视图矩阵换算为世界坐标，flush时以单位模型视图矩阵绘制，
+               调用方在两次加入之间修改矩阵不影响已加入的顶点
+    使用方式：
+        batcher.addLine(a, b, 2.0f, Qt::white);
+        ...
+        batcher.flush();                        // 每帧结束（或修改GL状态前）
+
+Version history
+[序号][修改日期][修改者][修改内容]
+1     2026-10-19  cjx    create
+2     2026-10-19  cjx    顶点改为世界坐标，不再按段记录模型视图矩阵
+3     2026-10-19  cjx    批次改为按加入顺序划分，不再按类型重排绘制顺序
+
+*****************************************************************/
+
+#ifndef QT_OPENGL_ES_2      // 安卓不支持固定渲染管线
+
+#ifndef GEOMETRY_BATCH_H_
+#define GEOMETRY_BATCH_H_
+
+#include <QColor>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions_2_1>
+#include <QVector>
+#include <QVector3D>
+
+class SsGeometryBatcher
+{
+public:
+    /**
+     * @brief 批处理统计（最近一帧）
+     */
+    struct Stats
+    {
+        int batches = 0;            ///< glDrawArrays次数
+        int vertices = 0;           ///< 顶点数
+        int uploads = 0;            ///< 实际上传的批次数
+        int reused = 0;             ///< 顶点未变化、复用VBO的批次数
+    };
+
+    SsGeometryBatcher() = default;
+    ~SsGeometryBatcher();
+
+    SsGeometryBatcher(const SsGeometryBatcher &) = delete;
+    SsGeometryBatcher &operator=(const SsGeometryBatcher &) = delete;
+
+    /** 绑定GL函数（initializeGL中调用） */
+    void initialize(QOpenGLFunctions_2_1 *functions);
+
+    /** 释放VBO（需要当前上下文） */
+    void cleanup();
+
+    /* 以下坐标均为世界坐标（已乘模型视图矩阵） */
+    void addPoint(const QVector3D &point, float size, const QColor &color);
+    void addLine(const QVector3D &start, const QVector3D &end, float width, const QColor &color);
+    /** 多边形边框（线宽1） */
+    void addPolygonOutline(const QVector<QVector3D> &points, const QColor &color);
+    /** 多边形填充（扇形三角化） */
+    void addPolygonFill(const QVector<QVector3D> &points, const QColor &color);
+
+    /** 是否有待绘制的顶点 */
+    bool isEmpty() const { return m_pendingVertices == 0; }
+
+    /**
+     * @brief 按加入顺序绘制尚未绘制的批次（需要当前上下文）
+     * 一帧可以flush多次，之后加入的图元总是开始新批次
+     */
+    void flush();
+
+    /**
+     * @brief 帧结束：回收多帧未使用的批次，重置批次序号与统计
+     */
+    void endFrame();
+
+    /** 最近一帧的统计 */
+    const Stats &stats() const { return m_lastStats; }
+
+private:
+    /**
+     * @brief 顶点（16字节：位置 + RGBA8颜色）
+     */
+    struct Vertex
+    {
+        float x, y, z;
+        quint8 r, g, b, a;
+    };
+
+    /**
+     * @brief 批次（按帧内序号跨帧保留）
+     */
+    struct Batch
+    {
+        QVector<Vertex> vertices;           ///< 本帧追加的顶点
+        QVector<Vertex> uploaded;           ///< 上次上传到VBO的顶点（用于判断是否需要重新上传）
+        GLenum mode = GL_POINTS;
+        float size = 1.0f;                  ///< 点大小/线宽
+        QOpenGLBuffer *buffer = nullptr;
+        int idleFrames = 0;                 ///< 连续未使用的帧数
+    };
+
+    /** 取得当前批次，图元类型或点大小/线宽与上一个批次不同（或已flush）时开始新批次 */
+    Batch &batch(GLenum mode, float size);
+
+    static Vertex vertex(const QVector3D &point, const QColor &color);
+
+    /** 上传（必要时）并绘制一个批次 */
+    void drawBatch(Batch &batch);
+
+    QOpenGLFunctions_2_1 *m_functions = nullptr;
+    QVector<Batch> m_batches;               ///< 下标为帧内批次序号
+    int m_batchCount = 0;                   ///< 本帧已使用的批次数
+    int m_firstPending = 0;                 ///< 第一个尚未绘制的批次序号
+    int m_pendingVertices = 0;              ///< 待绘制的顶点数
+    Stats m_stats;
+    Stats m_lastStats;
+};
+
+#endif // GEOMETRY_BATCH_H_
+
+#endif  // QT_OPENGL_ES_2
@@ -0,0 +1,337 @@
+#include "pick_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#define PICK_MAX_CELLS 262144                                       // 网格格子数上限（512*512）
+#define PICK_OVERSIZED_CELLS 64                                     // 覆盖格子数超过该值的图元单独存放
+
+namespace
+{
+
+// 点到线段的距离
+float segmentDistance(const QVector2D &p, const QVector2D &a, const QVector2D &b)
+{
+    const QVector2D ab = b - a;
+    const float lengthSquared = ab.lengthSquared();
+    if (lengthSquared <= 0.0f)
+    {
+        return (p - a).length();
+    }
+    const float t = qBound(0.0f, QVector2D::dotProduct(p - a, ab) / lengthSquared, 1.0f);
+    return (p - (a + ab * t)).length();
+}
+
+QRectF boundsOf(const QVector2D *points, int count)
+{
+    float minX = points[0].x(), maxX = points[0].x();
+    float minY = points[0].y(), maxY = points[0].y();
+    for (int i = 1; i < count; ++i)
+    {
+        minX = qMin(minX, points[i].x());
+        maxX = qMax(maxX, points[i].x());
+        minY = qMin(minY, points[i].y());
+        maxY = qMax(maxY, points[i].y());
+    }
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+}
+
+void SsPickIndex::clear()
+{
+    m_primitives.clear();
+    m_vertices.clear();
+    m_bounds = QRectF();
+    m_maxPixelRadius = 0.0f;
+    m_gridValid = false;
+}
+
+void SsPickIndex::addPoint(quint32 name, const QVector3D &point, float size)
+{
+    Primitive primitive;
+    primitive.name = name;
+    primitive.type = Point;
+    primitive.first = m_vertices.size();
+    primitive.count = 1;
+    primitive.pixelRadius = size * 0.5f;
+    m_vertices.append(point.toVector2D());
+    primitive.bounds = QRectF(m_vertices.last().toPointF(), QSizeF(0, 0));
+
+    extendBounds(primitive.bounds);
+    m_maxPixelRadius = qMax(m_maxPixelRadius, primitive.pixelRadius);
+    m_primitives.append(primitive);
+    m_gridValid = false;
+}
+
+void SsPickIndex::addLine(quint32 name, const QVector3D &start, const QVector3D &end, float width)
+{
+    Primitive primitive;
+    primitive.name = name;
+    primitive.type = Line;
+    primitive.first = m_vertices.size();
+    primitive.count = 2;
+    primitive.pixelRadius = width * 0.5f;
+    m_vertices.append(start.toVector2D());
+    m_vertices.append(end.toVector2D());
+    primitive.bounds = boundsOf(m_vertices.constData() + primitive.first, 2);
+
+    extendBounds(primitive.bounds);
+    m_maxPixelRadius = qMax(m_maxPixelRadius, primitive.pixelRadius);
+    m_primitives.append(primitive);
+    m_gridValid = false;
+}
+
+void SsPickIndex::addPolygon(quint32 name, const QVector<QVector3D> &points, bool filled)
+{
+    if (points.isEmpty())
+    {
+        return;
+    }
+
+    Primitive primitive;
+    primitive.name = name;
+    primitive.type = filled ? Polygon : PolygonOutline;
+    primitive.first = m_vertices.size();
+    primitive.count = points.size();
+    primitive.pixelRadius = 0.5f;                                   // 边框线宽固定为1
+    for (const QVector3D &point : points)
+    {
+        m_vertices.append(point.toVector2D());
+    }
+    primitive.bounds = boundsOf(m_vertices.constData() + primitive.first, primitive.count);
+
+    extendBounds(primitive.bounds);
+    m_maxPixelRadius = qMax(m_maxPixelRadius, primitive.pixelRadius);
+    m_primitives.append(primitive);
+    m_gridValid = false;
+}
+
+void SsPickIndex::extendBounds(const QRectF &bounds)
+{
+    // QRectF::united会忽略宽高为0的矩形（单点），这里逐边取极值
+    if (m_primitives.isEmpty())
+    {
+        m_bounds = bounds;
+        return;
+    }
+    m_bounds.setLeft(qMin(m_bounds.left(), bounds.left()));
+    m_bounds.setTop(qMin(m_bounds.top(), bounds.top()));
+    m_bounds.setRight(qMax(m_bounds.right(), bounds.right()));
+    m_bounds.setBottom(qMax(m_bounds.bottom(), bounds.bottom()));
+}
+
+int SsPickIndex::cellX(qreal x) const
+{
+    return qBound(0, static_cast<int>((x - m_bounds.left()) / m_cellSize), m_gridWidth - 1);
+}
+
+int SsPickIndex::cellY(qreal y) const
+{
+    return qBound(0, static_cast<int>((y - m_bounds.top()) / m_cellSize), m_gridHeight - 1);
+}
+
+void SsPickIndex::build() const
+{
+    m_gridValid = true;
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_oversized.clear();
+
+    const int count = m_primitives.size();
+    if (count == 0)
+    {
+        m_gridWidth = m_gridHeight = 0;
+        return;
+    }
+
+    // 格子数与图元数相当，每格平均约一个图元
+    const qreal width = m_bounds.width();
+    const qreal height = m_bounds.height();
+    const qreal extent = qMax(width, height);
+    const qreal targetCells = qMin<qreal>(count, PICK_MAX_CELLS);
+    if (extent <= 0.0)
+    {
+        m_cellSize = 1.0;
+    }
+    else if (width <= 0.0 || height <= 0.0)
+    {
+        m_cellSize = extent / targetCells;                          // 所有图元共线时按一维划分
+    }
+    else
+    {
+        m_cellSize = std::sqrt(width * height / targetCells);
+    }
+    m_cellSize = qMax(m_cellSize, extent / std::sqrt(static_cast<qreal>(PICK_MAX_CELLS)));
+    if (m_cellSize <= 0.0)
+    {
+        m_cellSize = 1.0;
+    }
+    m_gridWidth = static_cast<int>(width / m_cellSize) + 1;
+    m_gridHeight = static_cast<int>(height / m_cellSize) + 1;
+
+    // 第一遍统计每格图元数，第二遍填充（CSR）
+    const int cells = m_gridWidth * m_gridHeight;
+    m_cellStart.fill(0, cells + 1);
+    for (int i = 0; i < count; ++i)
+    {
+        const QRectF &bounds = m_primitives[i].bounds;
+        const int x0 = cellX(bounds.left()), x1 = cellX(bounds.right());
+        const int y0 = cellY(bounds.top()), y1 = cellY(bounds.bottom());
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > PICK_OVERSIZED_CELLS)
+        {
+            m_oversized.append(i);
+            continue;
+        }
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                ++m_cellStart[y * m_gridWidth + x + 1];
+            }
+        }
+    }
+    for (int c = 0; c < cells; ++c)
+    {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+
+    m_cellItems.resize(m_cellStart[cells]);
+    QVector<int> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+    int oversizedIndex = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (oversizedIndex < m_oversized.size() && m_oversized[oversizedIndex] == i)
+        {
+            ++oversizedIndex;
+            continue;
+        }
+        const QRectF &bounds = m_primitives[i].bounds;
+        const int x0 = cellX(bounds.left()), x1 = cellX(bounds.right());
+        const int y0 = cellY(bounds.top()), y1 = cellY(bounds.bottom());
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                m_cellItems[cursor[y * m_gridWidth + x]++] = i;
+            }
+        }
+    }
+}
+
+float SsPickIndex::distanceTo(const Primitive &primitive, const QVector2D &pos, float maxDistance, float worldPerPixel) const
+{
+    const float slack = primitive.pixelRadius * worldPerPixel;
+    const float reach = maxDistance + slack;
+    const QRectF &bounds = primitive.bounds;
+    if (pos.x() < bounds.left() - reach || pos.x() > bounds.right() + reach
+        || pos.y() < bounds.top() - reach || pos.y() > bounds.bottom() + reach)
+    {
+        return -1.0f;
+    }
+
+    const QVector2D *points = m_vertices.constData() + primitive.first;
+    float distance = 0.0f;
+    switch (primitive.type)
+    {
+    case Point:
+        distance = (pos - points[0]).length();
+        break;
+    case Line:
+        distance = segmentDistance(pos, points[0], points[1]);
+        break;
+    case Polygon:
+    case PolygonOutline:
+    {
+        // 填充多边形先做奇偶规则的点在多边形内判断
+        bool inside = false;
+        distance = std::numeric_limits<float>::max();
+        for (int i = 0, j = primitive.count - 1; i < primitive.count; j = i++)
+        {
+            const QVector2D &a = points[i];
+            const QVector2D &b = points[j];
+            if (primitive.type == Polygon && ((a.y() > pos.y()) != (b.y() > pos.y()))
+                && pos.x() < (b.x() - a.x()) * (pos.y() - a.y()) / (b.y() - a.y()) + a.x())
+            {
+                inside = !inside;
+            }
+            distance = qMin(distance, segmentDistance(pos, a, b));
+        }
+        if (inside)
+        {
+            return 0.0f;
+        }
+        break;
+    }
+    }
+
+    distance = qMax(0.0f, distance - slack);
+    return distance <= maxDistance ? distance : -1.0f;
+}
+
+QVector<SsPickIndex::Hit> SsPickIndex::pick(const QVector2D &pos, float tolerance, float worldPerPixel) const
+{
+    QVector<Hit> hits;
+    if (m_primitives.isEmpty())
+    {
+        return hits;
+    }
+    if (!m_gridValid)
+    {
+        build();
+    }
+
+    auto test = [&](int index) {
+        const Primitive &primitive = m_primitives[index];
+        const float distance = distanceTo(primitive, pos, tolerance, worldPerPixel);
+        if (distance >= 0.0f)
+        {
+            Hit hit;
+            hit.name = primitive.name;
+            hit.distance = distance;
+            hits.append(hit);
+        }
+    };
+
+    // 查询范围按拾取半径与最大的点大小/线宽放宽
+    const qreal reach = tolerance + m_maxPixelRadius * worldPerPixel;
+    const QRectF query(pos.x() - reach, pos.y() - reach, 2 * reach, 2 * reach);
+    // 不用QRectF::intersects：包围盒宽或高为0时它总是返回false
+    if (query.right() >= m_bounds.left() && query.left() <= m_bounds.right()
+        && query.bottom() >= m_bounds.top() && query.top() <= m_bounds.bottom())
+    {
+        const int x0 = cellX(query.left()), x1 = cellX(query.right());
+        const int y0 = cellY(query.top()), y1 = cellY(query.bottom());
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                const int cell = y * m_gridWidth + x;
+                for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k)
+                {
+                    test(m_cellItems[k]);
+                }
+            }
+        }
+    }
+    for (int index : m_oversized)
+    {
+        test(index);
+    }
+
+    // 按距离排序，同名只保留最近的一项（跨格图元可能被检查多次）
+    std::sort(hits.begin(), hits.end(), [](const Hit &a, const Hit &b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.name < b.name);
+    });
+    QVector<Hit> unique;
+    unique.reserve(hits.size());
+    for (const Hit &hit : hits)
+    {
+        if (std::none_of(unique.cbegin(), unique.cend(), [&](const Hit &h) { return h.name == hit.name; }))
+        {
+            unique.append(hit);
+        }
+    }
+    return unique;
+}
@@ -0,0 +1,128 @@
+/*****************************************************************
+File:        pick_index.h
+Version:     1.0
+Author:      cjx
+start date:  2026-10-19
+Description: 拾取用的CPU空间索引
+             绘制时按拾取名记录每个图元（点、线段、多边形）的几何，首次拾取时按图元包围盒
+             建立均匀网格（CSR紧凑存储），之后的拾取只检查鼠标所在格子内的图元，
+             不再像GL_SELECT那样为一次拾取重绘整个场景
+             - 点、线段按到鼠标的距离（含点大小/线宽的一半）判断
+             - 填充多边形按点在多边形内判断，仅有边框的多边形按到各边的距离判断
+             - 覆盖格子过多的大图元单独存放，每次拾取都检查
+    使用方式：
+        index.clear();                                  // 每帧开始
+        index.addLine(1001, a, b, 2.0f);                // 绘制时记录
+        QVector<SsPickIndex::Hit> hits = index.pick(worldPos, worldTolerance, worldPerPixel);
+
+Version history
+[序号][修改日期][修改者][修改内容]
+1     2026-10-19  cjx    create
+
+*****************************************************************/
+
+#ifndef PICK_INDEX_H_
+#define PICK_INDEX_H_
+
+#include <QRectF>
+#include <QVector>
+#include <QVector2D>
+#include <QVector3D>
+
+class SsPickIndex
+{
+public:
+    /**
+     * @brief 拾取命中项
+     */
+    struct Hit
+    {
+        quint32 name = 0;           ///< 拾取名
+        float distance = 0.0f;      ///< 到图元的距离（世界坐标，多边形内部为0）
+    };
+
+    /** 清空所有图元（每帧绘制开始时调用） */
+    void clear();
+
+    /**
+     * @brief 记录点
+     * @param size 点大小（像素），拾取时按半径size/2放宽
+     */
+    void addPoint(quint32 name, const QVector3D &point, float size);
+
+    /**
+     * @brief 记录线段
+     * @param width 线宽（像素），拾取时按width/2放宽
+     */
+    void addLine(quint32 name, const QVector3D &start, const QVector3D &end, float width);
+
+    /**
+     * @brief 记录多边形
+     * @param filled 是否填充（填充时内部可拾取，否则只有边框可拾取）
+     */
+    void addPolygon(quint32 name, const QVector<QVector3D> &points, bool filled);
+
+    /**
+     * @brief 拾取
+     * @param pos 拾取位置（世界坐标，仅使用xy）
+     * @param tolerance 拾取半径（世界坐标）
+     * @param worldPerPixel 每像素对应的世界长度（用于换算点大小与线宽）
+     * @return 命中的图元，按距离由近到远排序，同名只保留最近的一项
+     */
+    QVector<Hit> pick(const QVector2D &pos, float tolerance, float worldPerPixel) const;
+
+    /** 已记录的图元数 */
+    int size() const { return m_primitives.size(); }
+    bool isEmpty() const { return m_primitives.isEmpty(); }
+
+private:
+    enum Type
+    {
+        Point,
+        Line,
+        Polygon,
+        PolygonOutline
+    };
+
+    /**
+     * @brief 图元（顶点存放在m_vertices中的[first, first + count)）
+     */
+    struct Primitive
+    {
+        quint32 name = 0;
+        Type type = Point;
+        int first = 0;
+        int count = 0;
+        float pixelRadius = 0.0f;   ///< 点大小/线宽的一半（像素）
+        QRectF bounds;              ///< 包围盒（世界坐标，不含像素放宽）
+    };
+
+    /** 合并到总包围盒 */
+    void extendBounds(const QRectF &bounds);
+
+    /** 按当前图元建立网格 */
+    void build() const;
+
+    /** 图元到pos的距离（超出maxDistance时返回负数） */
+    float distanceTo(const Primitive &primitive, const QVector2D &pos, float maxDistance, float worldPerPixel) const;
+
+    /** 格子坐标 */
+    int cellX(qreal x) const;
+    int cellY(qreal y) const;
+
+    QVector<Primitive> m_primitives;
+    QVector<QVector2D> m_vertices;
+    QRectF m_bounds;                        ///< 所有图元的包围盒
+    float m_maxPixelRadius = 0.0f;          ///< 最大的点大小/线宽的一半（像素）
+
+    // 网格（首次拾取时建立，图元变化后失效）
+    mutable bool m_gridValid = false;
+    mutable int m_gridWidth = 0;
+    mutable int m_gridHeight = 0;
+    mutable qreal m_cellSize = 1.0;
+    mutable QVector<int> m_cellStart;       ///< 每个格子在m_cellItems中的起始位置（长度为格子数+1）
+    mutable QVector<int> m_cellItems;       ///< 图元下标
+    mutable QVector<int> m_oversized;       ///< 覆盖格子过多、每次都检查的图元
+};
+
+#endif // PICK_INDEX_H_